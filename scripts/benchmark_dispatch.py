@@ -0,0 +1,40 @@
+#!/usr/bin/python
+
+# Micro-benchmark for the method dispatch of the Python binding
+#
+# Usage: python scripts/benchmark_dispatch.py [<calls>]
+#    or: klayout -b -r scripts/benchmark_dispatch.py
+#
+# Times repeated calls of overloaded methods (Box#enlarged, Point#+ and
+# Shapes#insert). These calls are resolved through the overload resolution
+# cache after the first call.
+
+import sys
+import time
+
+try:
+  import pya
+except ImportError:
+  import klayout.db as pya
+
+n = 10000000
+if __name__ == "__main__" and len(sys.argv) > 1:
+  n = int(sys.argv[1])
+
+def bench(name, n, f):
+  t = time.time()
+  for i in range(0, n):
+    f()
+  dt = time.time() - t
+  print("%-20s %10d calls  %8.3fs  %8.1fns/call" % (name, n, dt, dt * 1e9 / n))
+
+box = pya.Box(0, 0, 100, 200)
+v = pya.Vector(1, 2)
+bench("Box#enlarged", n, lambda: box.enlarged(v))
+
+pt = pya.Point(1, 2)
+bench("Point#+", n, lambda: pt + v)
+
+ly = pya.Layout()
+shapes = ly.create_cell("TOP").shapes(ly.layer(1, 0))
+bench("Shapes#insert", n, lambda: shapes.insert(box))
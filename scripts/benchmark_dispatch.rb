@@ -0,0 +1,29 @@
+#!/usr/bin/ruby
+
+# Micro-benchmark for the method dispatch of the Ruby binding
+#
+# Usage: klayout -b -r scripts/benchmark_dispatch.rb [-rd n=<calls>]
+#
+# Times repeated calls of overloaded methods (Box#enlarged, Point#+ and
+# Shapes#insert). These calls are resolved through the overload resolution
+# cache after the first call.
+
+n = ($n || 10000000).to_i
+
+def bench(name, n)
+  t = Time.now
+  n.times { yield }
+  dt = Time.now - t
+  puts "%-20s %10d calls  %8.3fs  %8.1fns/call" % [ name, n, dt, dt * 1e9 / n ]
+end
+
+box = RBA::Box::new(0, 0, 100, 200)
+v = RBA::Vector::new(1, 2)
+bench("Box#enlarged", n) { box.enlarged(v) }
+
+pt = RBA::Point::new(1, 2)
+bench("Point#+", n) { pt + v }
+
+ly = RBA::Layout::new
+shapes = ly.create_cell("TOP").shapes(ly.layer(1, 0))
+bench("Shapes#insert", n) { shapes.insert(box) }
@@ -9,6 +9,7 @@ DEFINES += MAKE_DB_LIBRARY
 SOURCES = \
   dbArray.cc \
   dbBox.cc \
+  dbBoxTree.cc \
   dbBoxConvert.cc \
   dbBoxScanner.cc \
   dbCell.cc \
@@ -48,8 +49,10 @@ SOURCES = \
   dbMatrix.cc \
   dbMemStatistics.cc \
   dbObject.cc \
+  dbPackedCoordinates.cc \
   dbPath.cc \
   dbPCellDeclaration.cc \
+  dbPCellCache.cc \
   dbPCellHeader.cc \
   dbPCellVariant.cc \
   dbPoint.cc \
@@ -91,6 +94,7 @@ SOURCES = \
   gsiDeclDbCellMapping.cc \
   gsiDeclDbCommonStreamOptions.cc \
   gsiDeclDbEdge.cc \
+  gsiDeclDbFillTool.cc \
   gsiDeclDbEdgePair.cc \
   gsiDeclDbEdgePairs.cc \
   gsiDeclDbEdgeProcessor.cc \
@@ -119,6 +123,7 @@ SOURCES = \
   gsiDeclDbVector.cc \
   gsiDeclDbLayoutDiff.cc \
   gsiDeclDbGlyphs.cc \
+  gsiDeclDbThreadSettings.cc \
     dbConverters.cc \
     dbAsIfFlatRegion.cc \
     dbEmptyRegion.cc \
@@ -161,6 +166,7 @@ SOURCES = \
     dbPin.cc \
     dbLayoutToNetlistReader.cc \
     dbLayoutToNetlistWriter.cc \
+    dbLayoutToNetlistBinaryFormat.cc \
     dbLayoutToNetlistFormatDefs.cc \
     dbDeviceAbstract.cc \
     dbLocalOperationUtils.cc \
@@ -247,8 +253,10 @@ HEADERS = \
   dbObject.h \
   dbObjectTag.h \
   dbObjectWithProperties.h \
+  dbPackedCoordinates.h \
   dbPath.h \
   dbPCellDeclaration.h \
+  dbPCellCache.h \
   dbPCellHeader.h \
   dbPCellVariant.h \
   dbPoint.h \
@@ -323,6 +331,7 @@ HEADERS = \
     dbSubCircuit.h \
     dbLayoutToNetlistReader.h \
     dbLayoutToNetlistWriter.h \
+    dbLayoutToNetlistBinaryFormat.h \
     dbLayoutToNetlistFormatDefs.h \
     dbDeviceAbstract.h \
     dbLocalOperationUtils.h \
@@ -356,6 +356,42 @@ AsIfFlatRegion::selected_interacting_generic (const Edges &other, bool inverse)
   scanner.reserve2 (other.size ());
 
   std::auto_ptr<FlatRegion> output (new FlatRegion (false));
+
+  unsigned int threads = db::box_scanner_threads ();
+  if (threads > 0 && size () >= db::box_scanner_parallel_threshold) {
+
+    //  multi-threaded scan: the interacting polygons are collected per slab and
+    //  the output is produced in the original order
+
+    std::vector<const db::Polygon *> polygons;
+    polygons.reserve (size ());
+
+    AddressablePolygonDelivery p (begin_merged (), has_valid_merged_polygons ());
+
+    for ( ; ! p.at_end (); ++p) {
+      scanner.insert1 (p.operator-> (), 0);
+      polygons.push_back (p.operator-> ());
+    }
+
+    AddressableEdgeDelivery e (other.addressable_edges ());
+
+    for ( ; ! e.at_end (); ++e) {
+      scanner.insert2 (e.operator-> (), 0);
+    }
+
+    region_to_edge_interaction_collector collector;
+    scanner.process (collector, threads, size_t (threads) * 4, 1, db::box_convert<db::Polygon> (), db::box_convert<db::Edge> ());
+
+    for (std::vector<const db::Polygon *>::const_iterator i = polygons.begin (); i != polygons.end (); ++i) {
+      if (collector.interacts (*i) != inverse) {
+        output->raw_polygons ().insert (**i);
+      }
+    }
+
+    return output.release ();
+
+  }
+
   region_to_edge_interaction_filter<Shapes, db::Polygon> filter (output->raw_polygons (), inverse);
 
   AddressablePolygonDelivery p (begin_merged (), has_valid_merged_polygons ());
@@ -23,3 +23,102 @@
 
 #include "dbBoxScanner.h"
 
+
+#include "tlThreadedWorkers.h"
+#include "tlEnv.h"
+#include "tlString.h"
+
+namespace db
+{
+
+/**
+ *  @brief A task for the multi-threaded box scanner: scans one slab
+ */
+class BoxScannerSlabTask
+  : public tl::Task
+{
+public:
+  BoxScannerSlabTask (box_scanner_slab_base *slab)
+    : mp_slab (slab)
+  { }
+
+  box_scanner_slab_base *mp_slab;
+};
+
+/**
+ *  @brief The worker for the multi-threaded box scanner
+ */
+class BoxScannerSlabWorker
+  : public tl::Worker
+{
+public:
+  BoxScannerSlabWorker ()
+    : tl::Worker ()
+  { }
+
+  virtual void perform_task (tl::Task *task)
+  {
+    static_cast<BoxScannerSlabTask *> (task)->mp_slab->run ();
+  }
+};
+
+static unsigned int initial_box_scanner_threads ()
+{
+  //  single-threaded by default as long as only a few operations use the multi-threaded scan
+  int threads = 0;
+
+  std::string s = tl::get_env ("KLAYOUT_BOX_SCANNER_THREADS");
+  if (! s.empty ()) {
+    try {
+      tl::from_string (s, threads);
+    } catch (...) {
+      threads = 0;
+    }
+  }
+  return threads > 0 ? (unsigned int) threads : 0;
+}
+
+static unsigned int s_box_scanner_threads = initial_box_scanner_threads ();
+
+void set_box_scanner_threads (unsigned int threads)
+{
+  s_box_scanner_threads = threads;
+}
+
+unsigned int box_scanner_threads ()
+{
+  return s_box_scanner_threads;
+}
+
+void run_box_scanner_slabs (const std::vector<box_scanner_slab_base *> &slabs, unsigned int nthreads)
+{
+  if (nthreads == 0 || slabs.size () < 2) {
+
+    for (std::vector<box_scanner_slab_base *>::const_iterator s = slabs.begin (); s != slabs.end (); ++s) {
+      (*s)->run ();
+    }
+
+  } else {
+
+    tl::Job<BoxScannerSlabWorker> job (nthreads);
+
+    for (std::vector<box_scanner_slab_base *>::const_iterator s = slabs.begin (); s != slabs.end (); ++s) {
+      job.schedule (new BoxScannerSlabTask (*s));
+    }
+
+    try {
+      job.start ();
+      job.wait ();
+    } catch (...) {
+      job.terminate ();
+      throw;
+    }
+
+    if (job.has_error ()) {
+      throw tl::Exception (job.error_messages ().front ());
+    }
+
+  }
+}
+
+}
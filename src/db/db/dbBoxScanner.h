@@ -35,6 +35,7 @@
 #include <set>
 #include <functional>
 #include <memory>
+#include <algorithm>
 
 namespace db
 {
@@ -154,6 +155,136 @@ struct box_scanner_receiver
   void finalize (bool) { }
 };
 
+/**
+ *  @brief The base class for a slab of the multi-threaded box scanner
+ */
+class DB_PUBLIC box_scanner_slab_base
+{
+public:
+  box_scanner_slab_base () { }
+  virtual ~box_scanner_slab_base () { }
+
+  /**
+   *  @brief Scans the slab
+   */
+  virtual void run () = 0;
+};
+
+/**
+ *  @brief Scans the given slabs using "nthreads" threads
+ *
+ *  If "nthreads" is 0, the slabs are scanned in the calling thread.
+ */
+DB_PUBLIC void run_box_scanner_slabs (const std::vector<box_scanner_slab_base *> &slabs, unsigned int nthreads);
+
+/**
+ *  @brief Gets the number of threads the flat region operations use for the box scanner
+ *
+ *  A value of 0 means the box scanner runs single-threaded. The default is 0. It can be
+ *  overridden with the KLAYOUT_BOX_SCANNER_THREADS environment variable.
+ *
+ *  Currently, only the flat polygon-to-edge interaction (Region#interacting and
+ *  Region#not_interacting with Edges) uses the multi-threaded scan. The other interaction and
+ *  check operations are single-threaded regardless of this setting.
+ */
+DB_PUBLIC unsigned int box_scanner_threads ();
+
+/**
+ *  @brief Sets the number of threads the flat region operations use for the box scanner
+ */
+DB_PUBLIC void set_box_scanner_threads (unsigned int threads);
+
+/**
+ *  @brief The minimum number of objects for which the flat region operations use the multi-threaded box scanner
+ */
+const size_t box_scanner_parallel_threshold = 10000;
+
+/**
+ *  @brief A merge step which does nothing
+ *
+ *  This is the merge step of the multi-threaded "process" version which takes the slab receivers
+ *  from the caller.
+ */
+struct bs_no_merge
+{
+  void operator() () const { }
+};
+
+/**
+ *  @brief A merge step which merges the slab receivers into the main receiver
+ *
+ *  The slab receivers are merged in slab order by calling "merge" on the main receiver.
+ */
+template <class Rec, class SlabRec>
+struct bs_merge_slab_receivers
+{
+  bs_merge_slab_receivers (Rec &rec, const std::vector<SlabRec *> &slab_recs)
+    : mp_rec (&rec), mp_slab_recs (&slab_recs)
+  { }
+
+  void operator() () const
+  {
+    for (typename std::vector<SlabRec *>::const_iterator r = mp_slab_recs->begin (); r != mp_slab_recs->end (); ++r) {
+      mp_rec->merge (**r);
+    }
+  }
+
+  Rec *mp_rec;
+  const std::vector<SlabRec *> *mp_slab_recs;
+};
+
+/**
+ *  @brief Computes the slab limits for the multi-threaded box scanner
+ *
+ *  "bottoms" is the sorted list of bottom coordinates. This function delivers
+ *  nslabs - 1 limits such that each slab holds roughly the same number of objects.
+ */
+template <class C>
+std::vector<C> bs_slab_limits (const std::vector<C> &bottoms, size_t nslabs)
+{
+  std::vector<C> limits;
+  for (size_t i = 1; i < nslabs; ++i) {
+    limits.push_back (bottoms [(bottoms.size () * i) / nslabs]);
+  }
+  return limits;
+}
+
+/**
+ *  @brief A utility class describing the y range a slab is responsible for
+ *
+ *  An interaction is reported by the slab which contains the larger of the two
+ *  bottom coordinates. The first slab is open at the bottom and the last one is
+ *  open at the top.
+ */
+template <class C>
+struct bs_slab_range
+{
+  bs_slab_range (const std::vector<C> &limits, size_t n)
+    : has_min (n > 0), has_max (n < limits.size ()),
+      ymin (n > 0 ? limits [n - 1] : C (0)), ymax (n < limits.size () ? limits [n] : C (0))
+  {
+    //  .. nothing yet ..
+  }
+
+  bool empty () const
+  {
+    return has_min && has_max && ymin >= ymax;
+  }
+
+  bool contains (C y) const
+  {
+    return (! has_min || y >= ymin) && (! has_max || y < ymax);
+  }
+
+  bool needs (C bottom, C top, C enl) const
+  {
+    return (! has_max || bottom < ymax) && (! has_min || bottom >= ymin || top + enl > ymin);
+  }
+
+  bool has_min, has_max;
+  C ymin, ymax;
+};
+
 /**
  *  @brief A box scanner framework
  *
@@ -287,7 +418,125 @@ public:
     return ret;
   }
 
+  /**
+   *  @brief Multi-threaded version of "process"
+   *
+   *  This version partitions the sweep axis into slabs holding roughly the same number of
+   *  objects. The slabs are scanned independently and are distributed over "nthreads" worker
+   *  threads. Objects crossing a slab boundary are replicated into the slabs above. Each
+   *  interaction is reported exactly once, by the slab which contains the larger of the two
+   *  bottom coordinates.
+   *
+   *  The number of slabs is given by the number of slab receivers. Each slab has its own
+   *  receiver which receives "add" calls from the worker threads. "stop" is checked on the slab
+   *  receivers too. After all slabs have been scanned, "finish" is called on "rec" for all
+   *  objects from the calling thread. Merging the results of the slab receivers is up to the caller -
+   *  see the version with thread-local receivers below for one which merges them into "rec".
+   *
+   *  The slab partitioning does not depend on the number of threads, so each slab receiver
+   *  sees the same interactions for every thread count. If "nthreads" is 0, the slabs are
+   *  scanned in the calling thread.
+   */
+  template <class Rec, class SlabRec, class BoxConvert>
+  bool process (Rec &rec, const std::vector<SlabRec *> &slab_recs, unsigned int nthreads, typename BoxConvert::box_type::coord_type enl, const BoxConvert &bc = BoxConvert ())
+  {
+    rec.initialize ();
+    bool ret = do_process_slabs (rec, slab_recs, nthreads, enl, bc, bs_no_merge ());
+    rec.finalize (ret);
+    return ret;
+  }
+
+  /**
+   *  @brief Multi-threaded version of "process" with thread-local receivers
+   *
+   *  This version uses "nslabs" slabs like the version above, but creates the slab receivers
+   *  itself. "Rec" needs to provide a "slab_receiver_type" typedef, a "make_slab_receiver" method
+   *  delivering a fresh slab receiver and a "merge" method taking a slab receiver. After all
+   *  slabs have been scanned, the slab receivers are merged into "rec" in slab order from the
+   *  calling thread. "finish" is called after the merge.
+   *
+   *  As the slabs do not depend on the number of threads, the merged result is the same for
+   *  every thread count.
+   */
+  template <class Rec, class BoxConvert>
+  bool process (Rec &rec, unsigned int nthreads, size_t nslabs, typename BoxConvert::box_type::coord_type enl, const BoxConvert &bc = BoxConvert ())
+  {
+    typedef typename Rec::slab_receiver_type slab_receiver_type;
+
+    std::vector<slab_receiver_type> slab_recs (std::max (nslabs, size_t (1)), rec.make_slab_receiver ());
+    std::vector<slab_receiver_type *> slab_rec_ptrs;
+    for (size_t i = 0; i < slab_recs.size (); ++i) {
+      slab_rec_ptrs.push_back (&slab_recs [i]);
+    }
+
+    rec.initialize ();
+    bool ret = do_process_slabs (rec, slab_rec_ptrs, nthreads, enl, bc, bs_merge_slab_receivers<Rec, slab_receiver_type> (rec, slab_rec_ptrs));
+    rec.finalize (ret);
+    return ret;
+  }
+
 private:
+  template <class SlabRec, class BoxConvert>
+  class slab
+    : public box_scanner_slab_base
+  {
+  public:
+    typedef typename BoxConvert::box_type::coord_type coord_type;
+
+    slab (SlabRec *rec, const bs_slab_range<coord_type> &range, coord_type enl, const BoxConvert &bc, size_t scanner_thr, double fill_factor)
+      : m_rec (rec, range, bc), m_enl (enl), m_bc (bc), m_result (true)
+    {
+      m_scanner.set_scanner_threshold (scanner_thr);
+      m_scanner.set_fill_factor (fill_factor);
+    }
+
+    void insert (const Obj *obj, const Prop &prop)
+    {
+      m_scanner.insert (obj, prop);
+    }
+
+    virtual void run ()
+    {
+      m_result = m_scanner.process (m_rec, m_enl, m_bc);
+    }
+
+    bool result () const
+    {
+      return m_result;
+    }
+
+  private:
+    struct receiver
+      : public box_scanner_receiver<Obj, Prop>
+    {
+      receiver (SlabRec *rec, const bs_slab_range<coord_type> &range, const BoxConvert &bc)
+        : mp_rec (rec), m_range (range), m_bc (bc)
+      { }
+
+      void add (const Obj *o1, const Prop &p1, const Obj *o2, const Prop &p2)
+      {
+        if (m_range.contains (std::max (m_bc (*o1).bottom (), m_bc (*o2).bottom ()))) {
+          mp_rec->add (o1, p1, o2, p2);
+        }
+      }
+
+      bool stop () const
+      {
+        return mp_rec->stop ();
+      }
+
+      SlabRec *mp_rec;
+      bs_slab_range<coord_type> m_range;
+      BoxConvert m_bc;
+    };
+
+    box_scanner<Obj, Prop> m_scanner;
+    receiver m_rec;
+    coord_type m_enl;
+    BoxConvert m_bc;
+    bool m_result;
+  };
+
   container_type m_pp;
   double m_fill_factor;
   size_t m_scanner_thr;
@@ -452,6 +701,84 @@ private:
     return true;
 
   }
+
+  template <class Rec, class SlabRec, class BoxConvert, class Merge>
+  bool do_process_slabs (Rec &rec, const std::vector<SlabRec *> &slab_recs, unsigned int nthreads, typename BoxConvert::box_type::coord_type enl, const BoxConvert &bc, const Merge &merge)
+  {
+    typedef typename BoxConvert::box_type box_type;
+    typedef typename box_type::coord_type coord_type;
+    typedef bs_side_compare_func<BoxConvert, Obj, Prop, box_bottom<Box> > bottom_side_compare_func;
+    typedef slab<SlabRec, BoxConvert> slab_type;
+
+    //  sort out the entries with an empty bbox (we must not put that into sort)
+
+    typename container_type::iterator wi = m_pp.begin ();
+    for (typename container_type::iterator ri = m_pp.begin (); ri != m_pp.end (); ++ri) {
+      if (! bc (*ri->first).empty ()) {
+        if (wi != ri) {
+          *wi = *ri;
+        }
+        ++wi;
+      } else {
+        //  we call finish on empty elements though
+        rec.finish (ri->first, ri->second);
+      }
+    }
+
+    if (wi != m_pp.end ()) {
+      m_pp.erase (wi, m_pp.end ());
+    }
+
+    std::sort (m_pp.begin (), m_pp.end (), bottom_side_compare_func (bc));
+
+    std::vector<coord_type> bottoms;
+    bottoms.reserve (m_pp.size ());
+    for (iterator_type i = m_pp.begin (); i != m_pp.end (); ++i) {
+      bottoms.push_back (bc (*i->first).bottom ());
+    }
+
+    std::vector<coord_type> limits = bs_slab_limits (bottoms, slab_recs.size ());
+
+    std::list<slab_type> slabs;
+    std::vector<box_scanner_slab_base *> slab_ptrs;
+
+    for (size_t n = 0; n < slab_recs.size (); ++n) {
+
+      bs_slab_range<coord_type> range (limits, n);
+      if (range.empty ()) {
+        continue;
+      }
+
+      slabs.push_back (slab_type (slab_recs [n], range, enl, bc, m_scanner_thr, m_fill_factor));
+      slab_ptrs.push_back (&slabs.back ());
+
+      for (iterator_type i = m_pp.begin (); i != m_pp.end (); ++i) {
+        box_type b = bc (*i->first);
+        if (range.has_max && b.bottom () >= range.ymax) {
+          break;
+        } else if (range.needs (b.bottom (), b.top (), enl)) {
+          slabs.back ().insert (i->first, i->second);
+        }
+      }
+
+    }
+
+    run_box_scanner_slabs (slab_ptrs, nthreads);
+
+    for (typename std::list<slab_type>::const_iterator s = slabs.begin (); s != slabs.end (); ++s) {
+      if (! s->result ()) {
+        return false;
+      }
+    }
+
+    merge ();
+
+    for (iterator_type i = m_pp.begin (); i != m_pp.end (); ++i) {
+      rec.finish (i->first, i->second);
+    }
+
+    return true;
+  }
 };
 
 /**
@@ -660,7 +987,121 @@ public:
     return ret;
   }
 
+  /**
+   *  @brief Multi-threaded version of "process"
+   *
+   *  This version partitions the sweep axis into slabs which are scanned independently by
+   *  "nthreads" worker threads. Each slab has its own receiver which receives "add" calls
+   *  from the worker threads. Each interaction is reported exactly once, by the slab which
+   *  contains the larger of the two bottom coordinates. After all slabs have been scanned,
+   *  "finish1" and "finish2" are called on "rec" from the calling thread.
+   *
+   *  See the multi-threaded version of box_scanner::process for more details.
+   */
+  template <class Rec, class SlabRec, class BoxConvert1, class BoxConvert2>
+  bool process (Rec &rec, const std::vector<SlabRec *> &slab_recs, unsigned int nthreads, typename BoxConvert1::box_type::coord_type enl, const BoxConvert1 &bc1 = BoxConvert1 (), const BoxConvert2 &bc2 = BoxConvert2 ())
+  {
+    rec.initialize ();
+    bool ret = do_process_slabs (rec, slab_recs, nthreads, enl, bc1, bc2, bs_no_merge ());
+    rec.finalize (ret);
+    return ret;
+  }
+
+  /**
+   *  @brief Multi-threaded version of "process" with thread-local receivers
+   *
+   *  The slab receivers are created from "rec" with "make_slab_receiver" and merged into
+   *  "rec" with "merge" in slab order after all slabs have been scanned. "finish1" and "finish2"
+   *  are called after the merge.
+   *
+   *  See the corresponding version of box_scanner::process for more details.
+   */
+  template <class Rec, class BoxConvert1, class BoxConvert2>
+  bool process (Rec &rec, unsigned int nthreads, size_t nslabs, typename BoxConvert1::box_type::coord_type enl, const BoxConvert1 &bc1 = BoxConvert1 (), const BoxConvert2 &bc2 = BoxConvert2 ())
+  {
+    typedef typename Rec::slab_receiver_type slab_receiver_type;
+
+    std::vector<slab_receiver_type> slab_recs (std::max (nslabs, size_t (1)), rec.make_slab_receiver ());
+    std::vector<slab_receiver_type *> slab_rec_ptrs;
+    for (size_t i = 0; i < slab_recs.size (); ++i) {
+      slab_rec_ptrs.push_back (&slab_recs [i]);
+    }
+
+    rec.initialize ();
+    bool ret = do_process_slabs (rec, slab_rec_ptrs, nthreads, enl, bc1, bc2, bs_merge_slab_receivers<Rec, slab_receiver_type> (rec, slab_rec_ptrs));
+    rec.finalize (ret);
+    return ret;
+  }
+
 private:
+  template <class SlabRec, class BoxConvert1, class BoxConvert2>
+  class slab
+    : public box_scanner_slab_base
+  {
+  public:
+    typedef typename BoxConvert1::box_type::coord_type coord_type;
+
+    slab (SlabRec *rec, const bs_slab_range<coord_type> &range, coord_type enl, const BoxConvert1 &bc1, const BoxConvert2 &bc2, size_t scanner_thr, double fill_factor)
+      : m_rec (rec, range, bc1, bc2), m_enl (enl), m_bc1 (bc1), m_bc2 (bc2), m_result (true)
+    {
+      m_scanner.set_scanner_threshold (scanner_thr);
+      m_scanner.set_fill_factor (fill_factor);
+    }
+
+    void insert1 (const Obj1 *obj, const Prop1 &prop)
+    {
+      m_scanner.insert1 (obj, prop);
+    }
+
+    void insert2 (const Obj2 *obj, const Prop2 &prop)
+    {
+      m_scanner.insert2 (obj, prop);
+    }
+
+    virtual void run ()
+    {
+      m_result = m_scanner.process (m_rec, m_enl, m_bc1, m_bc2);
+    }
+
+    bool result () const
+    {
+      return m_result;
+    }
+
+  private:
+    struct receiver
+      : public box_scanner_receiver2<Obj1, Prop1, Obj2, Prop2>
+    {
+      receiver (SlabRec *rec, const bs_slab_range<coord_type> &range, const BoxConvert1 &bc1, const BoxConvert2 &bc2)
+        : mp_rec (rec), m_range (range), m_bc1 (bc1), m_bc2 (bc2)
+      { }
+
+      void add (const Obj1 *o1, const Prop1 &p1, const Obj2 *o2, const Prop2 &p2)
+      {
+        if (m_range.contains (std::max (m_bc1 (*o1).bottom (), m_bc2 (*o2).bottom ()))) {
+          mp_rec->add (o1, p1, o2, p2);
+        }
+      }
+
+      bool stop () const
+      {
+        return mp_rec->stop ();
+      }
+
+      SlabRec *mp_rec;
+      bs_slab_range<coord_type> m_range;
+      BoxConvert1 m_bc1;
+      BoxConvert2 m_bc2;
+    };
+
+    box_scanner2<Obj1, Prop1, Obj2, Prop2> m_scanner;
+    receiver m_rec;
+    coord_type m_enl;
+    BoxConvert1 m_bc1;
+    BoxConvert2 m_bc2;
+    bool m_result;
+  };
+
   container_type1 m_pp1;
   container_type2 m_pp2;
   double m_fill_factor;
@@ -902,6 +1343,123 @@ private:
     return true;
 
   }
+
+  template <class Rec, class SlabRec, class BoxConvert1, class BoxConvert2, class Merge>
+  bool do_process_slabs (Rec &rec, const std::vector<SlabRec *> &slab_recs, unsigned int nthreads, typename BoxConvert1::box_type::coord_type enl, const BoxConvert1 &bc1, const BoxConvert2 &bc2, const Merge &merge)
+  {
+    typedef typename BoxConvert1::box_type box_type; //  must be same as BoxConvert2::box_type
+    typedef typename box_type::coord_type coord_type;
+    typedef bs_side_compare_func<BoxConvert1, Obj1, Prop1, box_bottom<Box> > bottom_side_compare_func1;
+    typedef bs_side_compare_func<BoxConvert2, Obj2, Prop2, box_bottom<Box> > bottom_side_compare_func2;
+    typedef slab<SlabRec, BoxConvert1, BoxConvert2> slab_type;
+
+    //  sort out the entries with an empty bbox (we must not put that into sort)
+
+    typename container_type1::iterator wi1 = m_pp1.begin ();
+    for (typename container_type1::iterator ri1 = m_pp1.begin (); ri1 != m_pp1.end (); ++ri1) {
+      if (! bc1 (*ri1->first).empty ()) {
+        if (wi1 != ri1) {
+          *wi1 = *ri1;
+        }
+        ++wi1;
+      } else {
+        //  we call finish on empty elements though
+        rec.finish1 (ri1->first, ri1->second);
+      }
+    }
+
+    if (wi1 != m_pp1.end ()) {
+      m_pp1.erase (wi1, m_pp1.end ());
+    }
+
+    typename container_type2::iterator wi2 = m_pp2.begin ();
+    for (typename container_type2::iterator ri2 = m_pp2.begin (); ri2 != m_pp2.end (); ++ri2) {
+      if (! bc2 (*ri2->first).empty ()) {
+        if (wi2 != ri2) {
+          *wi2 = *ri2;
+        }
+        ++wi2;
+      } else {
+        //  we call finish on empty elements though
+        rec.finish2 (ri2->first, ri2->second);
+      }
+    }
+
+    if (wi2 != m_pp2.end ()) {
+      m_pp2.erase (wi2, m_pp2.end ());
+    }
+
+    if (! m_pp1.empty () && ! m_pp2.empty ()) {
+
+      std::sort (m_pp1.begin (), m_pp1.end (), bottom_side_compare_func1 (bc1));
+      std::sort (m_pp2.begin (), m_pp2.end (), bottom_side_compare_func2 (bc2));
+
+      std::vector<coord_type> bottoms;
+      bottoms.reserve (m_pp1.size () + m_pp2.size ());
+      for (iterator_type1 i = m_pp1.begin (); i != m_pp1.end (); ++i) {
+        bottoms.push_back (bc1 (*i->first).bottom ());
+      }
+      for (iterator_type2 i = m_pp2.begin (); i != m_pp2.end (); ++i) {
+        bottoms.push_back (bc2 (*i->first).bottom ());
+      }
+      std::sort (bottoms.begin (), bottoms.end ());
+
+      std::vector<coord_type> limits = bs_slab_limits (bottoms, slab_recs.size ());
+
+      std::list<slab_type> slabs;
+      std::vector<box_scanner_slab_base *> slab_ptrs;
+
+      for (size_t n = 0; n < slab_recs.size (); ++n) {
+
+        bs_slab_range<coord_type> range (limits, n);
+        if (range.empty ()) {
+          continue;
+        }
+
+        slabs.push_back (slab_type (slab_recs [n], range, enl, bc1, bc2, m_scanner_thr, m_fill_factor));
+        slab_ptrs.push_back (&slabs.back ());
+
+        for (iterator_type1 i = m_pp1.begin (); i != m_pp1.end (); ++i) {
+          box_type b = bc1 (*i->first);
+          if (range.has_max && b.bottom () >= range.ymax) {
+            break;
+          } else if (range.needs (b.bottom (), b.top (), enl)) {
+            slabs.back ().insert1 (i->first, i->second);
+          }
+        }
+
+        for (iterator_type2 i = m_pp2.begin (); i != m_pp2.end (); ++i) {
+          box_type b = bc2 (*i->first);
+          if (range.has_max && b.bottom () >= range.ymax) {
+            break;
+          } else if (range.needs (b.bottom (), b.top (), enl)) {
+            slabs.back ().insert2 (i->first, i->second);
+          }
+        }
+
+      }
+
+      run_box_scanner_slabs (slab_ptrs, nthreads);
+
+      for (typename std::list<slab_type>::const_iterator s = slabs.begin (); s != slabs.end (); ++s) {
+        if (! s->result ()) {
+          return false;
+        }
+      }
+
+      merge ();
+
+    }
+
+    for (iterator_type1 i = m_pp1.begin (); i != m_pp1.end (); ++i) {
+      rec.finish1 (i->first, i->second);
+    }
+    for (iterator_type2 i = m_pp2.begin (); i != m_pp2.end (); ++i) {
+      rec.finish2 (i->first, i->second);
+    }
+
+    return true;
+  }
 };
 
 /**
@@ -0,0 +1,136 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2020 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+#include "dbBoxTree.h"
+#include "tlException.h"
+#include "tlEnv.h"
+#include "tlString.h"
+#include "tlThreads.h"
+
+namespace db
+{
+
+static int initial_box_tree_sort_threads ()
+{
+  //  by default, use all cores if there is more than one
+  int threads = tl::available_cores ();
+  if (threads < 2) {
+    threads = 0;
+  }
+
+  std::string s = tl::get_env ("KLAYOUT_BOX_TREE_SORT_THREADS");
+  if (! s.empty ()) {
+    try {
+      tl::from_string (s, threads);
+    } catch (...) {
+      threads = 0;
+    }
+  }
+  return threads;
+}
+
+static int s_box_tree_sort_threads = initial_box_tree_sort_threads ();
+
+void set_box_tree_sort_threads (int threads)
+{
+  s_box_tree_sort_threads = threads;
+}
+
+int box_tree_sort_threads ()
+{
+  return s_box_tree_sort_threads;
+}
+
+namespace
+{
+
+/**
+ *  @brief The worker for the parallel box tree sort
+ */
+class BoxTreeSortWorker
+  : public tl::Worker
+{
+public:
+  BoxTreeSortWorker ()
+    : tl::Worker ()
+  { }
+
+  virtual void perform_task (tl::Task *task)
+  {
+    box_tree_sort_task *st = dynamic_cast<box_tree_sort_task *> (task);
+    tl_assert (st != 0);
+    st->run ();
+  }
+};
+
+}
+
+void box_tree_run_sort_tasks (std::vector<box_tree_sort_task *> &tasks, box_tree_sort_context &ctx)
+{
+  if (ctx.threads <= 0 || tasks.size () < 2) {
+
+    for (std::vector<box_tree_sort_task *>::iterator t = tasks.begin (); t != tasks.end (); ++t) {
+      box_tree_sort_task *task = *t;
+      *t = 0;
+      try {
+        task->run ();
+      } catch (...) {
+        delete task;
+        throw;
+      }
+      delete task;
+    }
+
+  } else {
+
+    if (! ctx.job) {
+      ctx.job = new tl::Job<BoxTreeSortWorker> (ctx.threads);
+    }
+
+    tl::JobBase &job = *ctx.job;
+
+    for (std::vector<box_tree_sort_task *>::iterator t = tasks.begin (); t != tasks.end (); ++t) {
+      job.schedule (*t);
+      *t = 0;
+    }
+
+    try {
+      job.start ();
+      job.wait ();
+    } catch (...) {
+      job.terminate ();
+      tasks.clear ();
+      throw;
+    }
+
+    if (job.has_error ()) {
+      tasks.clear ();
+      throw tl::Exception (job.error_messages ().front ());
+    }
+
+  }
+
+  tasks.clear ();
+}
+
+}
@@ -26,11 +26,14 @@
 
 #include "tlVector.h"
 #include "tlReuseVector.h"
+#include "tlThreadedWorkers.h"
+#include "dbCommon.h"
 #include "dbBox.h"
 #include "dbMemStatistics.h"
 
 #include <limits>
 #include <vector>
+#include <algorithm>
 
 namespace db
 {
@@ -39,6 +42,9 @@ namespace db
 struct simple_bbox_tag;
 struct complex_bbox_tag;
 
+template <class C> class text;
+template <class Obj> class object_with_properties;
+
 /// @brief a helper class required for the box_tree implementation
 
 template <class Box, class Obj, class BoxConv, class Vector>
@@ -156,6 +162,181 @@ private:
   tl::vector<box_type> m_boxes;
 };
 
+/**
+ *  @brief Sets the number of threads used for sorting big box trees
+ *
+ *  With a value of 0, box trees are sorted in the calling thread. Otherwise, box trees
+ *  with at least box_tree_parallel_sort_threshold objects are sorted with the given
+ *  number of worker threads. Smaller trees are always sorted in the calling thread.
+ *  The resulting tree and object order are identical to the ones of the single-threaded
+ *  sort. The default is the number of available cores (0 on a single-core machine),
+ *  unless the KLAYOUT_BOX_TREE_SORT_THREADS environment variable specifies a value.
+ */
+DB_PUBLIC void set_box_tree_sort_threads (int threads);
+
+/**
+ *  @brief Gets the number of threads used for sorting big box trees
+ */
+DB_PUBLIC int box_tree_sort_threads ();
+
+/**
+ *  @brief The minimum number of objects for which a box tree is sorted in parallel
+ */
+const size_t box_tree_parallel_sort_threshold = 100000;
+
+/**
+ *  @brief Determines the bin of a box for the box tree sort (internal)
+ *
+ *  Bin 0 is the "overall" bin taking the boxes not fitting into one quadrant,
+ *  bins 1 to 4 are the quadrants. Empty boxes are put into "empty_bin".
+ */
+template <class Box, class Point>
+inline int box_tree_bin (const Box &b, const Point &center, int empty_bin)
+{
+  if (b.empty ()) {
+    return empty_bin;
+  } else if (b.right () <= center.x ()) {
+    if (b.top () <= center.y ()) {
+      return 3;
+    } else if (b.bottom () >= center.y ()) {
+      return 2;
+    }
+  } else if (b.left () >= center.x ()) {
+    if (b.top () <= center.y ()) {
+      return 4;
+    } else if (b.bottom () >= center.y ()) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+ *  @brief Tells whether the objects can be copied from different threads at the same time (internal)
+ *
+ *  Texts may share reference-counted strings. The unstable box tree moves the objects
+ *  while sorting, so for texts only the bin classification is done in parallel.
+ */
+template <class Obj>
+struct box_tree_concurrent_moves
+{
+  static const bool value = true;
+};
+
+template <class C>
+struct box_tree_concurrent_moves<db::text<C> >
+{
+  static const bool value = false;
+};
+
+template <class Obj>
+struct box_tree_concurrent_moves<db::object_with_properties<Obj> >
+  : public box_tree_concurrent_moves<Obj>
+{ };
+
+/**
+ *  @brief A task of the parallel box tree sort (internal)
+ */
+class DB_PUBLIC box_tree_sort_task
+  : public tl::Task
+{
+public:
+  box_tree_sort_task () { }
+  virtual ~box_tree_sort_task () { }
+
+  virtual void run () = 0;
+};
+
+/**
+ *  @brief The state of a parallel box tree sort (internal)
+ *
+ *  Subtrees with up to "split_size" objects are not sorted immediately but
+ *  collected as tasks which are executed in parallel after the upper levels
+ *  of the tree have been built. The job executing the tasks is created on first
+ *  use and its worker threads are reused for all steps of the sort.
+ */
+struct box_tree_sort_context
+{
+  box_tree_sort_context (int _threads, size_t n)
+    : threads (_threads), split_size (std::max (size_t (1000), n / size_t (_threads * 8))), job (0)
+  { }
+
+  ~box_tree_sort_context ()
+  {
+    for (std::vector<box_tree_sort_task *>::const_iterator t = tasks.begin (); t != tasks.end (); ++t) {
+      delete *t;
+    }
+    delete job;
+  }
+
+  int threads;
+  size_t split_size;
+  std::vector<box_tree_sort_task *> tasks;
+  tl::JobBase *job;
+
+private:
+  box_tree_sort_context (const box_tree_sort_context &);
+  box_tree_sort_context &operator= (const box_tree_sort_context &);
+};
+
+/**
+ *  @brief Executes the given tasks with the threads of the given sort context (internal)
+ *
+ *  The tasks are consumed and the vector is cleared.
+ */
+DB_PUBLIC void box_tree_run_sort_tasks (std::vector<box_tree_sort_task *> &tasks, box_tree_sort_context &ctx);
+
+/**
+ *  @brief A task computing the bins for a range of objects (internal)
+ */
+template <class Tree, class Iter, class Picker>
+class box_tree_classify_task
+  : public box_tree_sort_task
+{
+public:
+  box_tree_classify_task (const Tree *tree, Iter from, Iter to, Picker *picker, const typename Tree::point_type &center, unsigned char *bins)
+    : mp_tree (tree), m_from (from), m_to (to), mp_picker (picker), m_center (center), mp_bins (bins)
+  { }
+
+  virtual void run ()
+  {
+    mp_tree->classify (m_from, m_to, *mp_picker, m_center, mp_bins);
+  }
+
+private:
+  const Tree *mp_tree;
+  Iter m_from, m_to;
+  Picker *mp_picker;
+  typename Tree::point_type m_center;
+  unsigned char *mp_bins;
+};
+
+/**
+ *  @brief A task sorting a subtree (internal)
+ */
+template <class Tree, class Iter, class Picker>
+class box_tree_subtree_task
+  : public box_tree_sort_task
+{
+public:
+  box_tree_subtree_task (Tree *tree, typename Tree::box_tree_node *parent, Iter from, Iter to, Picker *picker, const typename Tree::box_type &bbox, int quad)
+    : mp_tree (tree), mp_parent (parent), m_from (from), m_to (to), mp_picker (picker), m_bbox (bbox), m_quad (quad)
+  { }
+
+  virtual void run ()
+  {
+    mp_tree->tree_sort (mp_parent, m_from, m_to, *mp_picker, m_bbox, m_quad, 0);
+  }
+
+private:
+  Tree *mp_tree;
+  typename Tree::box_tree_node *mp_parent;
+  Iter m_from, m_to;
+  Picker *mp_picker;
+  typename Tree::box_type m_bbox;
+  int m_quad;
+};
+
 /**
  *  @brief The node object
  */
@@ -1134,7 +1315,7 @@ private:
 
       //  TODO: resize m_elements to actual size ?
 
-      tree_sort (0, m_elements.begin (), m_elements.end (), picker, bbox, 0);
+      start_tree_sort (picker, bbox);
 
     }
   }
@@ -1160,42 +1341,73 @@ private:
 
       //  TODO: resize m_elements to actual size ?
 
-      tree_sort (0, m_elements.begin (), m_elements.end (), picker, picker.bbox (), 0);
+      start_tree_sort (picker, picker.bbox ());
+
+    }
+  }
+
+  template <class T, class I, class P> friend class box_tree_classify_task;
+  template <class T, class I, class P> friend class box_tree_subtree_task;
+
+  template <class CoordPicker>
+  void start_tree_sort (const CoordPicker &picker, const box_type &bbox)
+  {
+    int threads = box_tree_sort_threads ();
+    if (threads > 0 && m_elements.size () >= box_tree_parallel_sort_threshold) {
+      //  builds the upper levels, then the subtrees in parallel
+      box_tree_sort_context ctx (threads, m_elements.size ());
+      tree_sort (0, m_elements.begin (), m_elements.end (), picker, bbox, 0, &ctx);
+      box_tree_run_sort_tasks (ctx.tasks, ctx);
+    } else {
+      tree_sort (0, m_elements.begin (), m_elements.end (), picker, bbox, 0, 0);
+    }
+  }
 
+  template <class CoordPicker>
+  void classify (element_iterator from, element_iterator to, const CoordPicker &picker, const point_type &center, unsigned char *bins) const
+  {
+    for (element_iterator e = from; e != to; ++e) {
+      *bins++ = (unsigned char) box_tree_bin (picker (&m_objects.item (*e)), center, 5);
     }
   }
 
   template <class CoordPicker>
-  void tree_sort (box_tree_node *parent, element_iterator from, element_iterator to, const CoordPicker &picker, const box_type &bbox, int quad)
+  void tree_sort (box_tree_node *parent, element_iterator from, element_iterator to, const CoordPicker &picker, const box_type &bbox, int quad, box_tree_sort_context *ctx)
   {
     size_t ntot = size_t (to - from);
     if (ntot <= min_bin || (bbox.width () < 2 && bbox.height () < 2)) {
       return; //  not worth splitting
     } 
 
+    if (ctx && ntot <= ctx->split_size) {
+      //  sort this subtree later in parallel with the other ones
+      ctx->tasks.push_back (new box_tree_subtree_task<box_tree_type, element_iterator, const CoordPicker> (this, parent, from, to, &picker, bbox, quad));
+      return;
+    }
+
     //  the bins are: overall, ur, ul, ll, lr, empty
     element_iterator qloc [6] = { from, from, from, from, from, from };
     point_type center (bbox.center ());
 
-    for (element_iterator e = from; e != to; ++e) {
+    //  for big ranges, determine the bins in parallel before moving the elements
+    std::vector<unsigned char> bins;
+    if (ctx && ntot >= box_tree_parallel_sort_threshold) {
+      bins.resize (ntot);
+      size_t chunk = std::max (size_t (10000), (ntot + ctx->threads - 1) / size_t (ctx->threads));
+      std::vector<box_tree_sort_task *> tasks;
+      for (size_t i = 0; i < ntot; i += chunk) {
+        tasks.push_back (new box_tree_classify_task<box_tree_type, element_iterator, const CoordPicker> (this, from + i, from + std::min (ntot, i + chunk), &picker, center, &bins.front () + i));
+      }
+      box_tree_run_sort_tasks (tasks, *ctx);
+    }
 
-      box_type b = picker (&m_objects.item (*e));
+    for (element_iterator e = from; e != to; ++e) {
 
-      int q = 0;
-      if (b.empty ()) {
-        q = 5;
-      } else if (b.right () <= center.x ()) {
-        if (b.top () <= center.y ()) {
-          q = 3;
-        } else if (b.bottom () >= center.y ()) {
-          q = 2;
-        }
-      } else if (b.left () >= center.x ()) {
-        if (b.top () <= center.y ()) {
-          q = 4;
-        } else if (b.bottom () >= center.y ()) {
-          q = 1;
-        }
+      int q;
+      if (bins.empty ()) {
+        q = box_tree_bin (picker (&m_objects.item (*e)), center, 5);
+      } else {
+        q = int (bins [e - from]);
       }
 
       //  make space for the element and swap the new element into position 
@@ -1241,7 +1453,7 @@ private:
       for (unsigned int q = 0; q < 4; ++q) {
         if (n[q] > 0) {
           node->lenq (q, n[q]);
-          tree_sort (node, qloc[q], qloc[q + 1], picker, qboxes [q], int (q));
+          tree_sort (node, qloc[q], qloc[q + 1], picker, qboxes [q], int (q), ctx);
         }
       }
 
@@ -2074,7 +2286,7 @@ private:
       }
     }
 
-    tree_sort (0, m_objects.begin (), m_objects.end (), picker, bbox, 0);
+    start_tree_sort (picker, bbox);
   }
 
   /// Sort implementation for complex bboxes - with caching
@@ -2091,39 +2303,73 @@ private:
     }
     mp_root = 0;
 
-    tree_sort (0, m_objects.begin (), m_objects.end (), picker, picker.bbox (), 0);
+    start_tree_sort (picker, picker.bbox ());
+  }
+
+  template <class T, class I, class P> friend class box_tree_classify_task;
+  template <class T, class I, class P> friend class box_tree_subtree_task;
+
+  template <class CoordPicker>
+  void start_tree_sort (CoordPicker &picker, const box_type &bbox)
+  {
+    int threads = box_tree_sort_threads ();
+    if (threads > 0 && m_objects.size () >= box_tree_parallel_sort_threshold) {
+      //  builds the upper levels, then the subtrees in parallel (if the objects can be moved concurrently)
+      box_tree_sort_context ctx (threads, m_objects.size ());
+      if (! box_tree_concurrent_moves<object_type>::value) {
+        ctx.split_size = 0;
+      }
+      tree_sort (0, m_objects.begin (), m_objects.end (), picker, bbox, 0, &ctx);
+      box_tree_run_sort_tasks (ctx.tasks, ctx);
+    } else {
+      tree_sort (0, m_objects.begin (), m_objects.end (), picker, bbox, 0, 0);
+    }
   }
 
   template <class CoordPicker>
-  void tree_sort (box_tree_node *parent, obj_iterator from, obj_iterator to, CoordPicker &picker, const box_type &bbox, int quad)
+  void classify (obj_iterator from, obj_iterator to, CoordPicker &picker, const point_type &center, unsigned char *bins) const
+  {
+    for (obj_iterator e = from; e != to; ++e) {
+      *bins++ = (unsigned char) box_tree_bin (picker (&*e), center, 0);
+    }
+  }
+
+  template <class CoordPicker>
+  void tree_sort (box_tree_node *parent, obj_iterator from, obj_iterator to, CoordPicker &picker, const box_type &bbox, int quad, box_tree_sort_context *ctx)
   {
     size_t ntot = size_t (to - from);
     if (ntot <= min_bin || (bbox.width () < 2 && bbox.height () < 2)) {
       return; //  not worth splitting
     } 
 
+    if (ctx && ntot <= ctx->split_size) {
+      //  sort this subtree later in parallel with the other ones
+      ctx->tasks.push_back (new box_tree_subtree_task<box_tree_type, obj_iterator, CoordPicker> (this, parent, from, to, &picker, bbox, quad));
+      return;
+    }
+
     obj_iterator qloc [5] = { from, from, from, from, from };
     point_type center (bbox.center ());
 
-    for (obj_iterator e = from; e != to; ++e) {
+    //  for big ranges, determine the bins in parallel before moving the objects
+    std::vector<unsigned char> bins;
+    if (ctx && ntot >= box_tree_parallel_sort_threshold) {
+      bins.resize (ntot);
+      size_t chunk = std::max (size_t (10000), (ntot + ctx->threads - 1) / size_t (ctx->threads));
+      std::vector<box_tree_sort_task *> tasks;
+      for (size_t i = 0; i < ntot; i += chunk) {
+        tasks.push_back (new box_tree_classify_task<box_tree_type, obj_iterator, CoordPicker> (this, from + i, from + std::min (ntot, i + chunk), &picker, center, &bins.front () + i));
+      }
+      box_tree_run_sort_tasks (tasks, *ctx);
+    }
 
-      box_type b = picker (&*e);
+    for (obj_iterator e = from; e != to; ++e) {
 
-      int q = 0;
-      if (! b.empty ()) {
-        if (b.right () <= center.x ()) {
-          if (b.top () <= center.y ()) {
-            q = 3;
-          } else if (b.bottom () >= center.y ()) {
-            q = 2;
-          }
-        } else if (b.left () >= center.x ()) {
-          if (b.top () <= center.y ()) {
-            q = 4;
-          } else if (b.bottom () >= center.y ()) {
-            q = 1;
-          }
-        }
+      int q;
+      if (bins.empty ()) {
+        q = box_tree_bin (picker (&*e), center, 0);
+      } else {
+        q = int (bins [e - from]);
       }
 
       //  make space for the element and swap the new element into position 
@@ -2175,7 +2421,7 @@ private:
       for (unsigned int q = 0; q < 4; ++q) {
         if (n[q] > 0) {
           node->lenq (q, n[q]);
-          tree_sort (node, qloc[q], qloc[q + 1], picker, qboxes [q], int (q));
+          tree_sort (node, qloc[q], qloc[q + 1], picker, qboxes [q], int (q), ctx);
         }
       }
 
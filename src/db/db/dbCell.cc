@@ -379,6 +379,18 @@ Cell::sort_shapes ()
   }
 }
 
+void 
+Cell::update_shapes (bool with_texts)
+{
+  for (shapes_map::iterator s = m_shapes_map.begin (); s != m_shapes_map.end (); ++s) {
+    if (with_texts) {
+      s->second.update ();
+    } else {
+      s->second.update_except (db::ShapeIterator::Texts);
+    }
+  }
+}
+
 void
 Cell::prop_id (db::properties_id_type id) 
 {
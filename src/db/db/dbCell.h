@@ -480,6 +480,21 @@ public:
    */
   void sort_shapes ();
 
+  /**
+   *  @brief Sorts the shapes lists and updates their bounding boxes
+   *
+   *  This is equivalent to calling sort_shapes and updating the bounding
+   *  boxes of the individual shape containers. It does not touch the
+   *  instances nor the cell's bounding box. As the method only modifies the
+   *  shape containers of this cell, it can be used from a worker thread
+   *  while other cells are being populated.
+   *
+   *  If "with_texts" is false, the text layers are left for the next layout update.
+   *  Texts may share reference-counted strings with texts from other cells (e.g. OASIS
+   *  forward references), so they must not be copied while other threads do the same.
+   */
+  void update_shapes (bool with_texts = true);
+
   /**
    *  @brief Retrieve the bounding box of the cell
    *
@@ -24,6 +24,9 @@
 #include "dbCellVariants.h"
 #include "dbRegionUtils.h"
 #include "tlUtils.h"
+#include "tlThreadedWorkers.h"
+
+#include <algorithm>
 
 namespace db
 {
@@ -168,8 +171,49 @@ VariantsCollectorBase::VariantsCollectorBase (const TransformationReducer *red)
   //  .. nothing yet ..
 }
 
+/**
+ *  @brief A task computing the variants for a chunk of cells from the same hierarchy level
+ */
+class VariantsCollectorTask
+  : public tl::Task
+{
+public:
+  VariantsCollectorTask (const VariantsCollectorBase *collector, const db::Layout *layout, const db::cell_index_type *from, const db::cell_index_type *to, const std::vector<std::map<db::ICplxTrans, size_t> *> *targets)
+    : mp_collector (collector), mp_layout (layout), mp_from (from), mp_to (to), mp_targets (targets)
+  { }
+
+  void perform () const
+  {
+    for (const db::cell_index_type *c = mp_from; c != mp_to; ++c) {
+      mp_collector->collect_cell (*mp_layout, *c, *(*mp_targets) [*c]);
+    }
+  }
+
+private:
+  const VariantsCollectorBase *mp_collector;
+  const db::Layout *mp_layout;
+  const db::cell_index_type *mp_from, *mp_to;
+  const std::vector<std::map<db::ICplxTrans, size_t> *> *mp_targets;
+};
+
+class VariantsCollectorWorker
+  : public tl::Worker
+{
+public:
+  VariantsCollectorWorker ()
+    : tl::Worker ()
+  { }
+
+  virtual void perform_task (tl::Task *task)
+  {
+    VariantsCollectorTask *vt = dynamic_cast<VariantsCollectorTask *> (task);
+    tl_assert (vt != 0);
+    vt->perform ();
+  }
+};
+
 void
-VariantsCollectorBase::collect (const db::Layout &layout, const db::Cell &top_cell)
+VariantsCollectorBase::collect (const db::Layout &layout, const db::Cell &top_cell, int threads)
 {
   tl_assert (mp_red != 0);
 
@@ -179,31 +223,96 @@ VariantsCollectorBase::collect (const db::Layout &layout, const db::Cell &top_ce
   std::set<db::cell_index_type> called;
   top_cell.collect_called_cells (called);
 
+  //  Sort the cells into hierarchy levels: the variants of a cell depend on the variants of
+  //  the parent cells only, so cells of the same level can be computed independently.
+  //  The entries of m_variants are created beforehand, so the map is not modified later.
+
+  std::vector<int> level (layout.cells (), 0);
+  std::vector<std::map<db::ICplxTrans, size_t> *> targets (layout.cells (), (std::map<db::ICplxTrans, size_t> *) 0);
+  std::vector<std::vector<db::cell_index_type> > cells_per_level;
+
   for (db::Layout::top_down_const_iterator c = layout.begin_top_down (); c != layout.end_top_down (); ++c) {
 
     if (called.find (*c) == called.end ()) {
       continue;
     }
 
-    //  collect the parent variants per parent cell
+    int l = 0;
+    for (db::Cell::parent_cell_iterator pc = layout.cell (*c).begin_parent_cells (); pc != layout.cell (*c).end_parent_cells (); ++pc) {
+      if (called.find (*pc) != called.end ()) {
+        l = std::max (l, level [*pc] + 1);
+      }
+    }
+
+    level [*c] = l;
+    if (l >= int (cells_per_level.size ())) {
+      cells_per_level.resize (l + 1);
+    }
+    cells_per_level [l].push_back (*c);
+
+    targets [*c] = &m_variants [*c];
+
+  }
+
+  //  parallelization makes sense for larger levels only
+  const size_t min_cells_for_threads = 1000;
+  const size_t cells_per_task = 100;
+
+  for (std::vector<std::vector<db::cell_index_type> >::const_iterator cl = cells_per_level.begin (); cl != cells_per_level.end (); ++cl) {
 
-    std::map<db::cell_index_type, std::map<db::ICplxTrans, size_t> > variants_per_parent_cell;
-    for (db::Cell::parent_inst_iterator pi = layout.cell (*c).begin_parent_insts (); ! pi.at_end (); ++pi) {
-      std::map<db::ICplxTrans, size_t> &variants = variants_per_parent_cell [pi->inst ().object ().cell_index ()];
-      add_variant (variants, pi->child_inst ().cell_inst (), mp_red->is_translation_invariant ());
+    if (cl->empty ()) {
+      continue;
     }
 
-    //  compute the resulting variants
+    const db::cell_index_type *from = &cl->front ();
+    const db::cell_index_type *to = from + cl->size ();
+
+    if (threads <= 0 || cl->size () < min_cells_for_threads) {
+
+      VariantsCollectorTask (this, &layout, from, to, &targets).perform ();
+
+    } else {
+
+      tl::Job<VariantsCollectorWorker> job (threads);
+      for (const db::cell_index_type *c = from; c < to; c += std::min (cells_per_task, size_t (to - c))) {
+        job.schedule (new VariantsCollectorTask (this, &layout, c, c + std::min (cells_per_task, size_t (to - c)), &targets));
+      }
 
-    std::map<db::ICplxTrans, size_t> &new_variants = m_variants [*c];
+      try {
+        job.start ();
+        job.wait ();
+      } catch (...) {
+        job.terminate ();
+        throw;
+      }
+
+      if (job.has_error ()) {
+        throw tl::Exception (job.error_messages ().front ());
+      }
 
-    for (std::map<db::cell_index_type, std::map<db::ICplxTrans, size_t> >::const_iterator pv = variants_per_parent_cell.begin (); pv != variants_per_parent_cell.end (); ++pv) {
-      product (variants (pv->first), pv->second, new_variants);
     }
 
   }
 }
 
+void
+VariantsCollectorBase::collect_cell (const db::Layout &layout, db::cell_index_type ci, std::map<db::ICplxTrans, size_t> &new_variants) const
+{
+  //  collect the parent variants per parent cell
+
+  std::map<db::cell_index_type, std::map<db::ICplxTrans, size_t> > variants_per_parent_cell;
+  for (db::Cell::parent_inst_iterator pi = layout.cell (ci).begin_parent_insts (); ! pi.at_end (); ++pi) {
+    std::map<db::ICplxTrans, size_t> &variants = variants_per_parent_cell [pi->inst ().object ().cell_index ()];
+    add_variant (variants, pi->child_inst ().cell_inst (), mp_red->is_translation_invariant ());
+  }
+
+  //  compute the resulting variants
+
+  for (std::map<db::cell_index_type, std::map<db::ICplxTrans, size_t> >::const_iterator pv = variants_per_parent_cell.begin (); pv != variants_per_parent_cell.end (); ++pv) {
+    product (variants (pv->first), pv->second, new_variants);
+  }
+}
+
 void
 VariantsCollectorBase::separate_variants (db::Layout &layout, db::Cell &top_cell, std::map<db::cell_index_type, std::map<db::ICplxTrans, db::cell_index_type> > *var_table)
 {
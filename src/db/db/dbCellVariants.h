@@ -169,8 +169,11 @@ public:
 
   /**
    *  @brief Collects cell variants for the given layout starting from the top cell
+   *
+   *  The cells are processed level by level. If "threads" is larger than zero, the cells of
+   *  one hierarchy level are distributed over the given number of worker threads.
    */
-  void collect (const db::Layout &layout, const db::Cell &top_cell);
+  void collect (const db::Layout &layout, const db::Cell &top_cell, int threads = 0);
 
   /**
    *  @brief Creates cell variants for singularization of the different variants
@@ -211,9 +214,13 @@ public:
   static void copy_shapes (db::Layout &layout, db::cell_index_type ci_to, db::cell_index_type ci_from);
 
 private:
+  friend class VariantsCollectorTask;
+
   std::map<db::cell_index_type, std::map<db::ICplxTrans, size_t> > m_variants;
   const TransformationReducer *mp_red;
 
+  void collect_cell (const db::Layout &layout, db::cell_index_type ci, std::map<db::ICplxTrans, size_t> &new_variants) const;
+
   void add_variant (std::map<db::ICplxTrans, size_t> &variants, const db::CellInstArray &inst, bool tl_invariant) const;
   void add_variant_non_tl_invariant (std::map<db::ICplxTrans, size_t> &variants, const db::CellInstArray &inst) const;
   void add_variant_tl_invariant (std::map<db::ICplxTrans, size_t> &variants, const db::CellInstArray &inst) const;
@@ -24,7 +24,9 @@
 
 #include "dbCommonReader.h"
 #include "dbStream.h"
+#include "dbCell.h"
 #include "tlXMLParser.h"
+#include "tlThreadedWorkers.h"
 
 namespace db
 {
@@ -81,12 +83,140 @@ public:
       tl::make_member (&db::CommonReaderOptions::create_other_layers, "create-other-layers") +
       tl::make_member (&db::CommonReaderOptions::layer_map, "layer-map") +
       tl::make_member (&db::CommonReaderOptions::enable_properties, "enable-properties") +
-      tl::make_member (&db::CommonReaderOptions::enable_text_objects, "enable-text-objects")
+      tl::make_member (&db::CommonReaderOptions::enable_text_objects, "enable-text-objects") +
+      tl::make_member (&db::CommonReaderOptions::pipeline_threads, "pipeline-threads")
     );
   }
 };
 
 static tl::RegisteredClass<db::StreamFormatDeclaration> reader_decl (new CommonFormatDeclaration (), 20, "Common");
 
+// ---------------------------------------------------------------
+//  CellPreparationPipeline implementation
+
+namespace
+{
+
+class CellPreparationTask
+  : public tl::Task
+{
+public:
+  CellPreparationTask (db::Cell *cell)
+    : mp_cell (cell)
+  {
+    //  .. nothing yet ..
+  }
+
+  db::Cell *cell () const
+  {
+    return mp_cell;
+  }
+
+private:
+  db::Cell *mp_cell;
+};
+
+class CellPreparationWorker
+  : public tl::Worker
+{
+public:
+  CellPreparationWorker ()
+    : tl::Worker ()
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform_task (tl::Task *task)
+  {
+    CellPreparationTask *cell_task = dynamic_cast<CellPreparationTask *> (task);
+    if (cell_task) {
+      //  texts are not sorted here: they may share strings with texts the parser is creating
+      cell_task->cell ()->update_shapes (false);
+    }
+  }
+};
+
+}
+
+CellPreparationPipeline::CellPreparationPipeline (unsigned int threads)
+  : m_threads (threads), mp_job (0)
+{
+  //  .. nothing yet ..
+}
+
+CellPreparationPipeline::~CellPreparationPipeline ()
+{
+  cancel ();
+}
+
+void
+CellPreparationPipeline::set_threads (unsigned int threads)
+{
+  cancel ();
+  m_threads = threads;
+}
+
+void
+CellPreparationPipeline::cell_finished (db::Cell &cell)
+{
+  if (m_threads == 0) {
+    return;
+  }
+
+  if (! mp_job) {
+    mp_job = new tl::Job<CellPreparationWorker> (int (m_threads));
+  }
+
+  m_pending.insert (&cell);
+  mp_job->schedule (new CellPreparationTask (&cell));
+
+  //  The job stops when it runs out of tasks. A task scheduled while the job is not running
+  //  is only queued, so we need to restart it. Restarting clears the error messages, hence
+  //  we collect them before.
+  if (! mp_job->is_running ()) {
+    if (mp_job->has_error ()) {
+      std::vector<std::string> errors = mp_job->error_messages ();
+      m_errors.insert (m_errors.end (), errors.begin (), errors.end ());
+    }
+    mp_job->start ();
+  }
+}
+
+void
+CellPreparationPipeline::wait ()
+{
+  if (mp_job) {
+
+    mp_job->wait ();
+
+    if (mp_job->has_error ()) {
+      std::vector<std::string> errors = mp_job->error_messages ();
+      m_errors.insert (m_errors.end (), errors.begin (), errors.end ());
+    }
+
+  }
+
+  m_pending.clear ();
+
+  if (! m_errors.empty ()) {
+    std::string msg = m_errors.front ();
+    m_errors.clear ();
+    throw tl::Exception (msg);
+  }
+}
+
+void
+CellPreparationPipeline::cancel ()
+{
+  if (mp_job) {
+    mp_job->terminate ();
+    delete mp_job;
+    mp_job = 0;
+  }
+
+  m_pending.clear ();
+  m_errors.clear ();
+}
+
 }
 
@@ -27,6 +27,13 @@
 
 #include "dbReader.h"
 
+#include <set>
+
+namespace tl
+{
+  class JobBase;
+}
+
 
 namespace db
 {
@@ -44,7 +51,8 @@ public:
   CommonReaderOptions ()
     : create_other_layers (true),
       enable_text_objects (true),
-      enable_properties (true)
+      enable_properties (true),
+      pipeline_threads (0)
   {
     //  .. nothing yet ..
   }
@@ -83,6 +91,17 @@ public:
    */
   bool enable_properties;
 
+  /**
+   *  @brief The number of threads used for preparing cells while reading
+   *
+   *  If this value is larger than zero, cells whose definition is complete
+   *  are handed over to worker threads which sort the shapes and compute
+   *  the shape bounding boxes while the reader continues parsing the stream.
+   *  A value of zero disables this feature and leaves this work to the
+   *  final layout update.
+   */
+  unsigned int pipeline_threads;
+
   /** 
    *  @brief Implementation of FormatSpecificReaderOptions
    */
@@ -101,6 +120,87 @@ public:
   }
 };
 
+/**
+ *  @brief A helper for preparing finished cells in the background while reading
+ *
+ *  The readers report cells whose definition is complete through "cell_finished".
+ *  With a thread count larger than zero, the shape containers of these cells are
+ *  sorted and their bounding boxes are computed by worker threads (see Cell::update_shapes)
+ *  while the reader continues. Text layers are excluded as texts may share strings across
+ *  cells - these are sorted by the final layout update. The reader must not modify a cell after it has been
+ *  reported unless it has called "wait" before (see "is_pending"). "wait" must also
+ *  be called before the layout is updated or post-processed.
+ *
+ *  With a thread count of zero, this object does nothing.
+ */
+class DB_PUBLIC CellPreparationPipeline
+{
+public:
+  /**
+   *  @brief Constructor
+   */
+  CellPreparationPipeline (unsigned int threads = 0);
+
+  /**
+   *  @brief Destructor
+   *
+   *  The destructor will cancel pending operations.
+   */
+  ~CellPreparationPipeline ();
+
+  /**
+   *  @brief Sets the number of threads
+   *
+   *  Pending operations are cancelled.
+   */
+  void set_threads (unsigned int threads);
+
+  /**
+   *  @brief Gets the number of threads
+   */
+  unsigned int threads () const
+  {
+    return m_threads;
+  }
+
+  /**
+   *  @brief Reports a cell as being complete
+   */
+  void cell_finished (db::Cell &cell);
+
+  /**
+   *  @brief Returns true, if the given cell has been reported and "wait" has not been called yet
+   */
+  bool is_pending (const db::Cell &cell) const
+  {
+    return m_pending.find (&cell) != m_pending.end ();
+  }
+
+  /**
+   *  @brief Waits until all reported cells are prepared
+   *
+   *  If an error happened inside the workers, an exception is thrown.
+   */
+  void wait ();
+
+  /**
+   *  @brief Cancels all pending operations
+   *
+   *  This method must be called before the layout is destroyed or discarded,
+   *  i.e. when the reader terminates with an exception.
+   */
+  void cancel ();
+
+private:
+  unsigned int m_threads;
+  tl::JobBase *mp_job;
+  std::set<const db::Cell *> m_pending;
+  std::vector<std::string> m_errors;
+
+  CellPreparationPipeline (const CellPreparationPipeline &);
+  CellPreparationPipeline &operator= (const CellPreparationPipeline &);
+};
+
 }
 
 #endif
@@ -486,7 +486,7 @@ DeepEdges::length_type DeepEdges::length (const db::Box &box) const
 
     db::MagnificationReducer red;
     db::cell_variants_collector<db::MagnificationReducer> vars (red);
-    vars.collect (edges.layout (), edges.initial_cell ());
+    vars.collect (edges.layout (), edges.initial_cell (), edges.store ()->threads ());
 
     DeepEdges::length_type l = 0;
 
@@ -564,7 +564,7 @@ DeepEdges::apply_filter (const EdgeFilterBase &filter) const
 
     vars.reset (new db::VariantsCollectorBase (filter.vars ()));
 
-    vars->collect (edges.layout (), edges.initial_cell ());
+    vars->collect (edges.layout (), edges.initial_cell (), edges.store ()->threads ());
 
     if (filter.wants_variants ()) {
       const_cast<db::DeepLayer &> (edges).separate_variants (*vars);
@@ -942,7 +942,7 @@ RegionDelegate *DeepEdges::extended (coord_type ext_b, coord_type ext_e, coord_t
   //  dots formally don't have an orientation, hence the interpretation is x and y.
   db::MagnificationReducer red;
   db::cell_variants_collector<db::MagnificationReducer> vars (red);
-  vars.collect (edges.layout (), edges.initial_cell ());
+  vars.collect (edges.layout (), edges.initial_cell (), edges.store ()->threads ());
 
   std::map<db::cell_index_type, std::map<db::ICplxTrans, db::Shapes> > to_commit;
 
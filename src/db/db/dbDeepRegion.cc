@@ -687,7 +687,7 @@ DeepRegion::area (const db::Box &box) const
     const db::DeepLayer &polygons = merged_deep_layer ();
 
     db::cell_variants_collector<db::MagnificationReducer> vars;
-    vars.collect (polygons.layout (), polygons.initial_cell ());
+    vars.collect (polygons.layout (), polygons.initial_cell (), polygons.store ()->threads ());
 
     DeepRegion::area_type a = 0;
 
@@ -720,7 +720,7 @@ DeepRegion::perimeter (const db::Box &box) const
     const db::DeepLayer &polygons = merged_deep_layer ();
 
     db::cell_variants_collector<db::MagnificationReducer> vars;
-    vars.collect (polygons.layout (), polygons.initial_cell ());
+    vars.collect (polygons.layout (), polygons.initial_cell (), polygons.store ()->threads ());
 
     DeepRegion::perimeter_type p = 0;
 
@@ -777,7 +777,7 @@ DeepRegion::grid_check (db::Coord gx, db::Coord gy) const
   db::Layout &layout = const_cast<db::Layout &> (polygons.layout ());
 
   db::cell_variants_collector<db::GridReducer> vars (gx);
-  vars.collect (layout, polygons.initial_cell ());
+  vars.collect (layout, polygons.initial_cell (), polygons.store ()->threads ());
 
   std::map<db::cell_index_type, std::map<db::ICplxTrans, db::Shapes> > to_commit;
   std::auto_ptr<db::DeepEdgePairs> res (new db::DeepEdgePairs (polygons.derived ()));
@@ -859,7 +859,7 @@ DeepRegion::snapped (db::Coord gx, db::Coord gy)
 
   db::cell_variants_collector<db::GridReducer> vars (gx);
 
-  vars.collect (polygons.layout (), polygons.initial_cell ());
+  vars.collect (polygons.layout (), polygons.initial_cell (), polygons.store ()->threads ());
 
   //  NOTE: m_merged_polygons is mutable, so why is the const_cast needed?
   const_cast<db::DeepLayer &> (polygons).separate_variants (vars);
@@ -904,7 +904,7 @@ DeepRegion::edges (const EdgeFilterBase *filter) const
 
     vars.reset (new db::VariantsCollectorBase (filter->vars ()));
 
-    vars->collect (polygons.layout (), polygons.initial_cell ());
+    vars->collect (polygons.layout (), polygons.initial_cell (), polygons.store ()->threads ());
 
     //  NOTE: m_merged_polygons is mutable, so why is the const_cast needed?
     const_cast<db::DeepLayer &> (polygons).separate_variants (*vars);
@@ -994,7 +994,7 @@ DeepRegion::apply_filter (const PolygonFilterBase &filter) const
 
     vars.reset (new db::VariantsCollectorBase (filter.vars ()));
 
-    vars->collect (polygons.layout (), polygons.initial_cell ());
+    vars->collect (polygons.layout (), polygons.initial_cell (), polygons.store ()->threads ());
 
     if (filter.wants_variants ()) {
       const_cast<db::DeepLayer &> (polygons).separate_variants (*vars);
@@ -1148,7 +1148,7 @@ DeepRegion::sized (coord_type d, unsigned int mode) const
   db::Layout &layout = const_cast<db::Layout &> (polygons.layout ());
 
   db::cell_variants_collector<db::MagnificationReducer> vars;
-  vars.collect (polygons.layout (), polygons.initial_cell ());
+  vars.collect (polygons.layout (), polygons.initial_cell (), polygons.store ()->threads ());
 
   //  NOTE: m_merged_polygons is mutable, so why is the const_cast needed?
   const_cast<db::DeepLayer &> (polygons).separate_variants (vars);
@@ -1203,7 +1203,7 @@ DeepRegion::sized (coord_type dx, coord_type dy, unsigned int mode) const
   db::Layout &layout = const_cast<db::Layout &> (polygons.layout ());
 
   db::cell_variants_collector<db::XYAnisotropyAndMagnificationReducer> vars;
-  vars.collect (polygons.layout (), polygons.initial_cell ());
+  vars.collect (polygons.layout (), polygons.initial_cell (), polygons.store ()->threads ());
 
   //  NOTE: m_merged_polygons is mutable, so why is the const_cast needed?
   const_cast<db::DeepLayer &> (polygons).separate_variants (vars);
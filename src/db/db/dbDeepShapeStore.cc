@@ -654,6 +654,32 @@ void DeepShapeStore::pop_state ()
   }
 }
 
+void DeepShapeStore::mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, bool no_self, void *parent) const
+{
+  tl::MutexLocker locker (&const_cast<DeepShapeStore *> (this)->m_lock);
+
+  if (! no_self) {
+    stat->add (typeid (*this), (void *) this, sizeof (*this), sizeof (*this), parent, purpose, cat);
+  }
+
+  db::mem_stat (stat, purpose, cat, m_layouts, true, (void *) this);
+  for (std::vector<LayoutHolder *>::const_iterator h = m_layouts.begin (); h != m_layouts.end (); ++h) {
+    if (*h) {
+      stat->add (typeid (LayoutHolder), (void *) *h, sizeof (LayoutHolder), sizeof (LayoutHolder), (void *) this, purpose, cat);
+      db::mem_stat (stat, purpose, cat, (*h)->layer_refs, true, (void *) *h);
+      (*h)->layout.mem_stat (stat, MemStatistics::LayoutInfo, cat, true, (void *) *h);
+    }
+  }
+
+  db::mem_stat (stat, purpose, cat, m_layers_for_flat, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_flat_region_id, true, (void *) this);
+
+  for (std::map<DeliveryMappingCacheKey, db::CellMapping>::const_iterator c = m_delivery_mapping_cache.begin (); c != m_delivery_mapping_cache.end (); ++c) {
+    stat->add (typeid (db::CellMapping), (void *) &c->second, sizeof (db::CellMapping), sizeof (db::CellMapping), (void *) this, purpose, cat);
+    db::mem_stat (stat, purpose, cat, c->second.table (), true, (void *) &c->second);
+  }
+}
+
 bool DeepShapeStore::is_valid_layout_index (unsigned int n) const
 {
   return (n < (unsigned int) m_layouts.size () && m_layouts[n] != 0);
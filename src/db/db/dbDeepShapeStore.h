@@ -707,6 +707,15 @@ public:
    */
   void pop_state ();
 
+  /**
+   *  @brief Collects memory statistics
+   *
+   *  The working layouts report their content with the layout-specific purposes
+   *  (cell info, shape trees etc.). The bookkeeping data of the store is reported
+   *  with the given purpose.
+   */
+  void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, bool no_self = false, void *parent = 0) const;
+
 private:
   friend class DeepLayer;
 
@@ -765,6 +774,14 @@ private:
   std::map<DeliveryMappingCacheKey, db::CellMapping> m_delivery_mapping_cache;
 };
 
+/**
+ *  @brief Collects memory statistics
+ */
+inline void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, const DeepShapeStore &x, bool no_self = false, void *parent = 0)
+{
+  x.mem_stat (stat, purpose, cat, no_self, parent);
+}
+
 template <class VarCollector>
 void DeepLayer::separate_variants (VarCollector &collector)
 {
@@ -270,7 +270,7 @@ DeepTexts *DeepTexts::apply_filter (const TextFilterBase &filter) const
 
     vars.reset (new db::VariantsCollectorBase (filter.vars ()));
 
-    vars->collect (texts.layout (), texts.initial_cell ());
+    vars->collect (texts.layout (), texts.initial_cell (), texts.store ()->threads ());
 
     if (filter.wants_variants ()) {
       const_cast<db::DeepLayer &> (texts).separate_variants (*vars);
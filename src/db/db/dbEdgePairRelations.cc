@@ -346,7 +346,127 @@ EdgeRelationFilter::set_ignore_angle (double a)
   m_ignore_angle_cos = cos (m_ignore_angle * M_PI / 180.0);
 }
 
-bool 
+namespace
+{
+
+/**
+ *  @brief The number of edge pairs processed by one pass of the prefilter kernel
+ */
+const size_t prefilter_block_size = 64;
+
+/**
+ *  @brief The coordinates of a block of edges in structure-of-arrays layout
+ */
+struct EdgeBlock
+{
+  double x1 [prefilter_block_size], y1 [prefilter_block_size], x2 [prefilter_block_size], y2 [prefilter_block_size];
+
+  void load (const db::Edge *e, size_t n, bool swapped)
+  {
+    for (size_t i = 0; i < n; ++i, ++e) {
+      const db::Point &p1 = swapped ? e->p2 () : e->p1 ();
+      const db::Point &p2 = swapped ? e->p1 () : e->p2 ();
+      x1 [i] = p1.x ();
+      y1 [i] = p1.y ();
+      x2 [i] = p2.x ();
+      y2 [i] = p2.y ();
+    }
+  }
+};
+
+/**
+ *  @brief Returns false if no part of g can be on the inside of e and closer than d
+ *
+ *  This is a necessary condition for all "near_part_of_edge" functions.
+ *  The computation is done in floating-point arithmetics with a margin covering the
+ *  rounding errors. The function is free of branches so it can be vectorized.
+ */
+inline bool
+may_have_near_part (double ex1, double ey1, double ex2, double ey2, double gx1, double gy1, double gx2, double gy2, double d)
+{
+  double ex = ex2 - ex1, ey = ey2 - ey1;
+  double r1x = gx1 - ex1, r1y = gy1 - ey1;
+  double r2x = gx2 - ex1, r2y = gy2 - ey1;
+
+  //  NOTE: one database unit is added to the distance to account for the rounding of
+  //  cut points in the "near_part_of_edge" functions
+  double l2 = ex * ex + ey * ey;
+  double dl = (d + 1.0) * sqrt (l2) * (1.0 + 1e-9);
+
+  //  margin for the rounding errors of the products below
+  double m = 1.0 + 1e-12 * (fabs (ex) + fabs (ey)) * (fabs (r1x) + fabs (r1y) + fabs (r2x) + fabs (r2y));
+
+  //  perpendicular distance and projection (both multiplied by the length of e)
+  double v1 = ex * r1y - ey * r1x;
+  double v2 = ex * r2y - ey * r2x;
+  double t1 = ex * r1x + ey * r1y;
+  double t2 = ex * r2x + ey * r2y;
+
+  bool outside = (v1 > m) & (v2 > m);
+  bool far = std::max (v1, v2) < -(dl + m);
+  bool before = std::max (t1, t2) < -(dl + m);
+  bool beyond = std::min (t1, t2) > l2 + dl + m;
+
+  return ! (outside | far | before | beyond);
+}
+
+}
+
+void
+EdgeRelationFilter::prefilter (const db::Edge *a, const db::Edge *b, size_t n, char *candidate) const
+{
+  //  see "check" for the orientation conventions
+  bool swap_a = (m_r == SpaceRelation || m_r == InsideRelation);
+  bool swap_b = (m_r == SpaceRelation || m_r == OverlapRelation);
+  bool swap_aa = (m_r == OverlapRelation || m_r == InsideRelation);
+
+  //  For ignore_angle = 90 degree, edges are rejected if sprod >= 0. Otherwise
+  //  the angle criterion is "-sprod / (la * lb) < cos + 1e-10".
+  bool right_angle = (m_ignore_angle == 90.0);
+  double cos_thr = right_angle ? 0.0 : m_ignore_angle_cos + 1e-10;
+  double cos_tol = right_angle ? 0.0 : 1e-9;
+  double d = double (m_d);
+
+  //  signs to restore the orientation of "aa" and "b" from the normalized edges
+  double sa = (swap_aa != swap_a) ? -1.0 : 1.0;
+  double sb = swap_b ? -1.0 : 1.0;
+
+  EdgeBlock ab, bb;
+
+  while (n > 0) {
+
+    size_t nb = std::min (n, prefilter_block_size);
+
+    ab.load (a, nb, swap_a);
+    bb.load (b, nb, swap_b);
+
+    for (size_t i = 0; i < nb; ++i) {
+
+      //  angle criterion
+      double adx = sa * (ab.x2 [i] - ab.x1 [i]), ady = sa * (ab.y2 [i] - ab.y1 [i]);
+      double bdx = sb * (bb.x2 [i] - bb.x1 [i]), bdy = sb * (bb.y2 [i] - bb.y1 [i]);
+
+      double sp = adx * bdx + ady * bdy;
+      double m = 1.0 + 1e-12 * (fabs (adx) + fabs (ady)) * (fabs (bdx) + fabs (bdy));
+      double lab = sqrt ((adx * adx + ady * ady) * (bdx * bdx + bdy * bdy));
+      bool angle_ok = (sp + cos_thr * lab < m + cos_tol * lab);
+
+      bool in2 = may_have_near_part (ab.x1 [i], ab.y1 [i], ab.x2 [i], ab.y2 [i], bb.x1 [i], bb.y1 [i], bb.x2 [i], bb.y2 [i], d);
+      bool in1 = may_have_near_part (bb.x1 [i], bb.y1 [i], bb.x2 [i], bb.y2 [i], ab.x1 [i], ab.y1 [i], ab.x2 [i], ab.y2 [i], d);
+
+      candidate [i] = char (angle_ok & in1 & in2);
+
+    }
+
+    a += nb;
+    b += nb;
+    candidate += nb;
+    n -= nb;
+
+  }
+}
+
+bool
 EdgeRelationFilter::check (const db::Edge &a, const db::Edge &b, db::EdgePair *output) const
 {
   //  check projection criterion
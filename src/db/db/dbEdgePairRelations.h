@@ -133,6 +133,17 @@ struct DB_PUBLIC EdgeRelationFilter
    */
   bool check (const db::Edge &a, const db::Edge &b, db::EdgePair *output = 0) const;
 
+  /**
+   *  @brief Performs a quick rejection test on a batch of edge pairs
+   *
+   *  For each pair a[i], b[i] (i < n), candidate[i] is set to 0 if "check" is guaranteed
+   *  to return false for this pair and to 1 otherwise. The test is a conservative
+   *  approximation of "check" using the angle, side and distance criteria which are common
+   *  to all metrics. The kernel is formulated as a branch-free loop over blocks of
+   *  coordinates, so the compiler can vectorize it.
+   */
+  void prefilter (const db::Edge *a, const db::Edge *b, size_t n, char *candidate) const;
+
   /**
    *  @brief Sets a flag indicating whether to report whole edges instead of partial ones
    */
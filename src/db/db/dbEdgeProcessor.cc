@@ -454,9 +454,21 @@ static inline double edge_xaty2 (db::Edge e, db::Coord y)
  */
 struct EdgeXAtYCompare2
 {
+  //  HINT: "volatile" forces x values into memory and disables FPU register optimisation.
+  //  That way, we can exactly compare doubles afterwards.
+  typedef volatile double x_type;
+
   EdgeXAtYCompare2 (db::Coord y)
     : m_y (y) { }
 
+  /**
+   *  @brief Gets the position at which the edge crosses the scanline
+   */
+  double xaty (const db::Edge &e) const
+  {
+    return edge_xaty (e, m_y);
+  }
+
   bool operator() (const db::Edge &a, const db::Edge &b) const
   {
     //  simple cases ..
@@ -557,6 +569,43 @@ private:
   db::Coord m_y;
 };
 
+/**
+ *  @brief The Manhattan version of EdgeXAtYCompare2
+ *  This operator requires all edges to be horizontal or vertical. It delivers
+ *  the same order as EdgeXAtYCompare2, but works on integer coordinates only:
+ *  on the scanline, a vertical edge is located at its x coordinate and a horizontal
+ *  edge at its left end.
+ */
+struct EdgeXAtYCompare2_90
+{
+  typedef db::Coord x_type;
+
+  EdgeXAtYCompare2_90 (db::Coord /*y*/) { }
+
+  db::Coord xaty (const db::Edge &e) const
+  {
+    return e.p1 ().x ();
+  }
+
+  bool operator() (const db::Edge &a, const db::Edge &b) const
+  {
+    db::Coord xa = a.dy () == 0 ? std::min (a.p1 ().x (), a.p2 ().x ()) : a.p1 ().x ();
+    db::Coord xb = b.dy () == 0 ? std::min (b.p1 ().x (), b.p2 ().x ()) : b.p1 ().x ();
+    if (xa != xb) {
+      return xa < xb;
+    } else {
+      return a.dy () != 0 && b.dy () == 0;
+    }
+  }
+
+  bool equal (const db::Edge &a, const db::Edge &b) const
+  {
+    db::Coord xa = a.dy () == 0 ? std::min (a.p1 ().x (), a.p2 ().x ()) : a.p1 ().x ();
+    db::Coord xb = b.dy () == 0 ? std::min (b.p1 ().x (), b.p2 ().x ()) : b.p1 ().x ();
+    return xa == xb && (a.dy () == 0) == (b.dy () == 0);
+  }
+};
+
 // -------------------------------------------------------------------------------
 //  EdgePolygonOp implementation
 
@@ -1537,255 +1586,41 @@ get_intersections_per_band_any (std::vector <CutPoints> &cutpoints, std::vector
   }
 }
 
-void 
-EdgeProcessor::process (db::EdgeSink &es, EdgeEvaluatorBase &op)
+/**
+ *  @brief Computes the result edges from the cut edges (step 4 of EdgeProcessor::process)
+ *
+ *  XAtYCompare is the scanline order. EdgeXAtYCompare2 is the general one. For
+ *  Manhattan input, EdgeXAtYCompare2_90 is used which works on integer coordinates only.
+ */
+template <class XAtYCompare>
+static void
+process_scanlines (std::vector <WorkEdge> &work_edges, db::EdgeSink &es, EdgeEvaluatorBase &op, bool prefer_touch, bool selects_edges, tl::AbsoluteProgress *progress, size_t todo_next, size_t todo_max)
 {
-  tl::SelfTimer timer (tl::verbosity () >= m_base_verbosity, "EdgeProcessor: process");
-
-  bool prefer_touch = op.prefer_touch (); 
-  bool selects_edges = op.selects_edges (); 
-  
   db::Coord y;
   std::vector <WorkEdge>::iterator future;
-
-  //  step 1: preparation
-
-  if (mp_work_edges->empty ()) {
-    es.start ();
-    es.flush ();
-    return;
-  }
-
-  mp_cpvector->clear ();
-
-  property_type n_props = 0;
-  for (std::vector <WorkEdge>::iterator e = mp_work_edges->begin (); e != mp_work_edges->end (); ++e) {
-    if (e->prop > n_props) {
-      n_props = e->prop;
-    }
-  }
-  ++n_props;
-
-  size_t todo_max = 1000000;
-
-  std::auto_ptr<tl::AbsoluteProgress> progress (0);
-  if (m_report_progress) {
-    if (m_progress_desc.empty ()) {
-      progress.reset (new tl::AbsoluteProgress (tl::to_string (tr ("Processing")), 1000));
-    } else {
-      progress.reset (new tl::AbsoluteProgress (m_progress_desc, 1000));
-    }
-    progress->set_format (tl::to_string (tr ("%.0f%%")));
-    progress->set_unit (todo_max / 100);
-  }
-
-  size_t todo_next = 0;
-  size_t todo = todo_next;
-  todo_next += (todo_max - todo) / 5;
-
-
-  //  step 2: find intersections
-  std::sort (mp_work_edges->begin (), mp_work_edges->end (), edge_ymin_compare<db::Coord> ());
-
-  y = edge_ymin ((*mp_work_edges) [0]);
-  future = mp_work_edges->begin ();
-
-  for (std::vector <WorkEdge>::iterator current = mp_work_edges->begin (); current != mp_work_edges->end (); ) {
-
-    if (m_report_progress) {
-      double p = double (std::distance (mp_work_edges->begin (), current)) / double (mp_work_edges->size ());
-      progress->set (size_t (double (todo_next - todo) * p) + todo);
-    }
-
-    size_t n = std::distance (current, future);
-    db::Coord yy = y;
-
-    //  Use as many scanlines as to fetch approx. 50% new edges into the scanline (this
-    //  is an empirically determined factor)
-    do {
-
-      while (future != mp_work_edges->end () && edge_ymin (*future) <= yy) {
-        ++future;
-      }
-
-      if (future != mp_work_edges->end ()) {
-        yy = edge_ymin (*future);
-      } else {
-        yy = std::numeric_limits <db::Coord>::max ();
-      }
-
-    } while (future != mp_work_edges->end () && std::distance (current, future) < long (n + n / 2));
-
-    bool is90 = true;
-
-    if (current != future) {
-
-      for (std::vector <WorkEdge>::iterator c = current; c != future && is90; ++c) {
-        if (c->dx () != 0 && c->dy () != 0) {
-          is90 = false;
-        }
-      }
-
-      if (is90) {
-        get_intersections_per_band_90 (*mp_cpvector, current, future, y, yy, selects_edges);
-      } else {
-        get_intersections_per_band_any (*mp_cpvector, current, future, y, yy, selects_edges);
-      }
-
-    }
-
-    y = yy;
-    for (std::vector <WorkEdge>::iterator c = current; c != future; ++c) {
-      //  Hint: we have to keep the edges ending a y (the new lower band limit) in the all angle case because these edges
-      //  may receive cutpoints because the enter the -0.5DBU region below the band
-      if ((!is90 && edge_ymax (*c) < y) || (is90 && edge_ymax (*c) <= y)) {
-        if (current != c) {
-          std::swap (*current, *c);
-        }
-        ++current;
-      }
-    }
-    
-  }
-
-  //  step 3: create new edges from the ones with cutpoints
-  //
-  //  Hint: when we create the edges from the cutpoints we use the projection to sort the cutpoints along the
-  //  edge. However, we have some freedom to connect the points which we use to avoid "z" configurations which could
-  //  create new intersections in a 1x1 pixel box.
   
-  todo = todo_next;
-  todo_next += (todo_max - todo) / 5;
-
-  size_t n_work = mp_work_edges->size ();
-  size_t nw = 0;
-  for (size_t n = 0; n < n_work; ++n) {
-
-    if (m_report_progress) {
-      double p = double (n) / double (n_work);
-      progress->set (size_t (double (todo_next - todo) * p) + todo);
-    }
-
-    WorkEdge &ew = (*mp_work_edges) [n];
-
-    CutPoints *cut_points = ew.data ? & ((*mp_cpvector) [ew.data - 1]) : 0;
-    ew.data = 0;
-
-    if (ew.dy () == 0 && ! selects_edges) {
-
-      //  don't care about horizontal edges 
-
-    } else if (cut_points) {
-
-      if (cut_points->has_cutpoints && ! cut_points->cut_points.empty ()) {
-
-        db::Edge e = ew;
-        property_type p = ew.prop;
-        std::sort (cut_points->cut_points.begin (), cut_points->cut_points.end (), ProjectionCompare (e));
-
-        db::Point pll = e.p1 ();
-        db::Point pl = e.p1 ();
-
-        for (std::vector <db::Point>::iterator cp = cut_points->cut_points.begin (); cp != cut_points->cut_points.end (); ++cp) {
-          if (*cp != pl) {
-            WorkEdge ne = WorkEdge (db::Edge (pl, *cp), p);
-            if (pl.y () == pll.y () && ne.p2 ().x () != pl.x () && ne.p2 ().x () == pll.x ()) {
-              ne = db::Edge (pll, ne.p2 ());
-            } else if (pl.x () == pll.x () && ne.p2 ().y () != pl.y () && ne.p2 ().y () == pll.y ()) {
-              ne = db::Edge (ne.p1 (), pll);
-            } else {
-              pll = pl;
-            }
-            pl = *cp;
-            if (selects_edges || ne.dy () != 0) {
-              if (nw <= n) {
-                (*mp_work_edges) [nw++] = ne;
-              } else {
-                mp_work_edges->push_back (ne);
-              }
-            }
-          }
-        }
-
-        if (cut_points->cut_points.back () != e.p2 ()) {
-          WorkEdge ne = WorkEdge (db::Edge (pl, e.p2 ()), p);
-          if (pl.y () == pll.y () && ne.p2 ().x () != pl.x () && ne.p2 ().x () == pll.x ()) {
-            ne = db::Edge (pll, ne.p2 ());
-          } else if (pl.x () == pll.x () && ne.p2 ().y () != pl.y () && ne.p2 ().y () == pll.y ()) {
-            ne = db::Edge (ne.p1 (), pll);
-          }
-          if (selects_edges || ne.dy () != 0) {
-            if (nw <= n) {
-              (*mp_work_edges) [nw++] = ne;
-            } else {
-              mp_work_edges->push_back (ne);
-            }
-          }
-        }
-
-      } else {
-
-        if (nw < n) {
-          (*mp_work_edges) [nw] = (*mp_work_edges) [n];
-        }
-        ++nw;
+  std::sort (work_edges.begin (), work_edges.end (), edge_ymin_compare<db::Coord> ());
 
-      }
-
-    } else {
-
-      if (nw < n) {
-        (*mp_work_edges) [nw] = (*mp_work_edges) [n];
-      }
-      ++nw;
-
-    }
-
-  }
-
-  if (nw != n_work) {
-    mp_work_edges->erase (mp_work_edges->begin () + nw, mp_work_edges->begin () + n_work);
-  }
-
-#ifdef DEBUG_EDGE_PROCESSOR
-  printf ("Output edges:\n");
-  for (std::vector <WorkEdge>::iterator c1 = mp_work_edges->begin (); c1 != mp_work_edges->end (); ++c1) { 
-    printf ("%s\n", c1->to_string().c_str ()); 
-  } 
-#endif
-
-
-  tl::SelfTimer timer2 (tl::verbosity () >= m_base_verbosity + 10, "EdgeProcessor: production");
-
-  //  step 4: compute the result edges 
-  
-  es.start (); // call this as late as possible. This way, input containers can be identical with output containers ("clear" is done after the input is read)
-
-  op.reset ();
-  op.reserve (n_props);
-
-  std::sort (mp_work_edges->begin (), mp_work_edges->end (), edge_ymin_compare<db::Coord> ());
-
-  y = edge_ymin ((*mp_work_edges) [0]);
+  y = edge_ymin (work_edges [0]);
   size_t skip_unit = 1;
 
-  future = mp_work_edges->begin ();
-  for (std::vector <WorkEdge>::iterator current = mp_work_edges->begin (); current != mp_work_edges->end (); ) {
+  future = work_edges.begin ();
+  for (std::vector <WorkEdge>::iterator current = work_edges.begin (); current != work_edges.end (); ) {
 
-    if (m_report_progress) {
-      double p = double (std::distance (mp_work_edges->begin (), current)) / double (mp_work_edges->size ());
+    if (progress) {
+      double p = double (std::distance (work_edges.begin (), current)) / double (work_edges.size ());
       progress->set (size_t (double (todo_max - todo_next) * p) + todo_next);
     }
 
     std::vector <WorkEdge>::iterator f0 = future;
-    while (future != mp_work_edges->end () && edge_ymin (*future) <= y) {
+    while (future != work_edges.end () && edge_ymin (*future) <= y) {
       tl_assert (future->data == 0); // HINT: for development
       ++future;
     }
-    std::sort (f0, future, EdgeXAtYCompare2 (y));
+    std::sort (f0, future, XAtYCompare (y));
 
     db::Coord yy = std::numeric_limits <db::Coord>::max ();
-    if (future != mp_work_edges->end ()) {
+    if (future != work_edges.end ()) {
       yy = edge_ymin (*future);
     }
     for (std::vector <WorkEdge>::const_iterator c = current; c != future; ++c) {
@@ -1801,7 +1636,7 @@ EdgeProcessor::process (db::EdgeSink &es, EdgeEvaluatorBase &op)
 
     if (current != future) {
 
-      std::inplace_merge (current, f0, future, EdgeXAtYCompare2 (y));
+      std::inplace_merge (current, f0, future, XAtYCompare (y));
 #ifdef DEBUG_EDGE_PROCESSOR
       printf ("y=%d ", y);
       for (std::vector <WorkEdge>::iterator c = current; c != future; ++c) { 
@@ -1846,10 +1681,10 @@ EdgeProcessor::process (db::EdgeSink &es, EdgeEvaluatorBase &op)
 
             //  HINT: "volatile" forces x and xx into memory and disables FPU register optimisation.
             //  That way, we can exactly compare doubles afterwards.
-            volatile double x = edge_xaty (*c, y);
+            typename XAtYCompare::x_type x = XAtYCompare (y).xaty (*c);
 
             while (f != future) {
-              volatile double xx = edge_xaty (*f, y);
+              typename XAtYCompare::x_type xx = XAtYCompare (y).xaty (*f);
               if (xx != x) {
                 break;
               }
@@ -1864,7 +1699,7 @@ EdgeProcessor::process (db::EdgeSink &es, EdgeEvaluatorBase &op)
             //  treat all edges crossing the scanline in a certain point
             for (std::vector <WorkEdge>::iterator cc = c; cc != f; ) {
 
-              std::vector <WorkEdge>::iterator e = mp_work_edges->end ();
+              std::vector <WorkEdge>::iterator e = work_edges.end ();
 
               int pn = 0, ps = 0;
 
@@ -1873,7 +1708,7 @@ EdgeProcessor::process (db::EdgeSink &es, EdgeEvaluatorBase &op)
               std::vector <WorkEdge>::iterator fc = cc;
               do {
                 ++fc;
-              } while (fc != f && EdgeXAtYCompare2 (y).equal (*fc, *cc));
+              } while (fc != f && XAtYCompare (y).equal (*fc, *cc));
 
               //  sort the coincident edges by property ID - that will
               //  simplify algorithms like "inside" and "outside".
@@ -1893,7 +1728,7 @@ EdgeProcessor::process (db::EdgeSink &es, EdgeEvaluatorBase &op)
 
                 if (cc->dy () != 0) {
 
-                  if (e == mp_work_edges->end () && edge_ymax (*cc) > y) {
+                  if (e == work_edges.end () && edge_ymax (*cc) > y) {
                     e = cc;
                   }
                   
@@ -1962,7 +1797,7 @@ EdgeProcessor::process (db::EdgeSink &es, EdgeEvaluatorBase &op)
 
               }
 
-              if (e != mp_work_edges->end ()) {
+              if (e != work_edges.end ()) {
 
                 db::Edge edge (*e);
 
@@ -2062,6 +1897,249 @@ EdgeProcessor::process (db::EdgeSink &es, EdgeEvaluatorBase &op)
     es.end_scanline (ysl);
 
   }
+}
+
+void 
+EdgeProcessor::process (db::EdgeSink &es, EdgeEvaluatorBase &op)
+{
+  tl::SelfTimer timer (tl::verbosity () >= m_base_verbosity, "EdgeProcessor: process");
+
+  bool prefer_touch = op.prefer_touch (); 
+  bool selects_edges = op.selects_edges (); 
+  
+  db::Coord y;
+  std::vector <WorkEdge>::iterator future;
+
+  //  step 1: preparation
+
+  if (mp_work_edges->empty ()) {
+    es.start ();
+    es.flush ();
+    return;
+  }
+
+  mp_cpvector->clear ();
+
+  property_type n_props = 0;
+  for (std::vector <WorkEdge>::iterator e = mp_work_edges->begin (); e != mp_work_edges->end (); ++e) {
+    if (e->prop > n_props) {
+      n_props = e->prop;
+    }
+  }
+  ++n_props;
+
+  //  Manhattan input stays Manhattan when cut at intersection points, so we can use the
+  //  integer-only scanline algorithms in that case
+  bool manhattan = true;
+  for (std::vector <WorkEdge>::const_iterator e = mp_work_edges->begin (); e != mp_work_edges->end () && manhattan; ++e) {
+    if (e->dx () != 0 && e->dy () != 0) {
+      manhattan = false;
+    }
+  }
+
+  size_t todo_max = 1000000;
+
+  std::auto_ptr<tl::AbsoluteProgress> progress (0);
+  if (m_report_progress) {
+    if (m_progress_desc.empty ()) {
+      progress.reset (new tl::AbsoluteProgress (tl::to_string (tr ("Processing")), 1000));
+    } else {
+      progress.reset (new tl::AbsoluteProgress (m_progress_desc, 1000));
+    }
+    progress->set_format (tl::to_string (tr ("%.0f%%")));
+    progress->set_unit (todo_max / 100);
+  }
+
+  size_t todo_next = 0;
+  size_t todo = todo_next;
+  todo_next += (todo_max - todo) / 5;
+
+
+  //  step 2: find intersections
+  std::sort (mp_work_edges->begin (), mp_work_edges->end (), edge_ymin_compare<db::Coord> ());
+
+  y = edge_ymin ((*mp_work_edges) [0]);
+  future = mp_work_edges->begin ();
+
+  for (std::vector <WorkEdge>::iterator current = mp_work_edges->begin (); current != mp_work_edges->end (); ) {
+
+    if (m_report_progress) {
+      double p = double (std::distance (mp_work_edges->begin (), current)) / double (mp_work_edges->size ());
+      progress->set (size_t (double (todo_next - todo) * p) + todo);
+    }
+
+    size_t n = std::distance (current, future);
+    db::Coord yy = y;
+
+    //  Use as many scanlines as to fetch approx. 50% new edges into the scanline (this
+    //  is an empirically determined factor)
+    do {
+
+      while (future != mp_work_edges->end () && edge_ymin (*future) <= yy) {
+        ++future;
+      }
+
+      if (future != mp_work_edges->end ()) {
+        yy = edge_ymin (*future);
+      } else {
+        yy = std::numeric_limits <db::Coord>::max ();
+      }
+
+    } while (future != mp_work_edges->end () && std::distance (current, future) < long (n + n / 2));
+
+    bool is90 = true;
+
+    if (current != future) {
+
+      for (std::vector <WorkEdge>::iterator c = current; c != future && is90 && ! manhattan; ++c) {
+        if (c->dx () != 0 && c->dy () != 0) {
+          is90 = false;
+        }
+      }
+
+      if (is90) {
+        get_intersections_per_band_90 (*mp_cpvector, current, future, y, yy, selects_edges);
+      } else {
+        get_intersections_per_band_any (*mp_cpvector, current, future, y, yy, selects_edges);
+      }
+
+    }
+
+    y = yy;
+    for (std::vector <WorkEdge>::iterator c = current; c != future; ++c) {
+      //  Hint: we have to keep the edges ending a y (the new lower band limit) in the all angle case because these edges
+      //  may receive cutpoints because the enter the -0.5DBU region below the band
+      if ((!is90 && edge_ymax (*c) < y) || (is90 && edge_ymax (*c) <= y)) {
+        if (current != c) {
+          std::swap (*current, *c);
+        }
+        ++current;
+      }
+    }
+    
+  }
+
+  //  step 3: create new edges from the ones with cutpoints
+  //
+  //  Hint: when we create the edges from the cutpoints we use the projection to sort the cutpoints along the
+  //  edge. However, we have some freedom to connect the points which we use to avoid "z" configurations which could
+  //  create new intersections in a 1x1 pixel box.
+  
+  todo = todo_next;
+  todo_next += (todo_max - todo) / 5;
+
+  size_t n_work = mp_work_edges->size ();
+  size_t nw = 0;
+  for (size_t n = 0; n < n_work; ++n) {
+
+    if (m_report_progress) {
+      double p = double (n) / double (n_work);
+      progress->set (size_t (double (todo_next - todo) * p) + todo);
+    }
+
+    WorkEdge &ew = (*mp_work_edges) [n];
+
+    CutPoints *cut_points = ew.data ? & ((*mp_cpvector) [ew.data - 1]) : 0;
+    ew.data = 0;
+
+    if (ew.dy () == 0 && ! selects_edges) {
+
+      //  don't care about horizontal edges 
+
+    } else if (cut_points) {
+
+      if (cut_points->has_cutpoints && ! cut_points->cut_points.empty ()) {
+
+        db::Edge e = ew;
+        property_type p = ew.prop;
+        std::sort (cut_points->cut_points.begin (), cut_points->cut_points.end (), ProjectionCompare (e));
+
+        db::Point pll = e.p1 ();
+        db::Point pl = e.p1 ();
+
+        for (std::vector <db::Point>::iterator cp = cut_points->cut_points.begin (); cp != cut_points->cut_points.end (); ++cp) {
+          if (*cp != pl) {
+            WorkEdge ne = WorkEdge (db::Edge (pl, *cp), p);
+            if (pl.y () == pll.y () && ne.p2 ().x () != pl.x () && ne.p2 ().x () == pll.x ()) {
+              ne = db::Edge (pll, ne.p2 ());
+            } else if (pl.x () == pll.x () && ne.p2 ().y () != pl.y () && ne.p2 ().y () == pll.y ()) {
+              ne = db::Edge (ne.p1 (), pll);
+            } else {
+              pll = pl;
+            }
+            pl = *cp;
+            if (selects_edges || ne.dy () != 0) {
+              if (nw <= n) {
+                (*mp_work_edges) [nw++] = ne;
+              } else {
+                mp_work_edges->push_back (ne);
+              }
+            }
+          }
+        }
+
+        if (cut_points->cut_points.back () != e.p2 ()) {
+          WorkEdge ne = WorkEdge (db::Edge (pl, e.p2 ()), p);
+          if (pl.y () == pll.y () && ne.p2 ().x () != pl.x () && ne.p2 ().x () == pll.x ()) {
+            ne = db::Edge (pll, ne.p2 ());
+          } else if (pl.x () == pll.x () && ne.p2 ().y () != pl.y () && ne.p2 ().y () == pll.y ()) {
+            ne = db::Edge (ne.p1 (), pll);
+          }
+          if (selects_edges || ne.dy () != 0) {
+            if (nw <= n) {
+              (*mp_work_edges) [nw++] = ne;
+            } else {
+              mp_work_edges->push_back (ne);
+            }
+          }
+        }
+
+      } else {
+
+        if (nw < n) {
+          (*mp_work_edges) [nw] = (*mp_work_edges) [n];
+        }
+        ++nw;
+
+      }
+
+    } else {
+
+      if (nw < n) {
+        (*mp_work_edges) [nw] = (*mp_work_edges) [n];
+      }
+      ++nw;
+
+    }
+
+  }
+
+  if (nw != n_work) {
+    mp_work_edges->erase (mp_work_edges->begin () + nw, mp_work_edges->begin () + n_work);
+  }
+
+#ifdef DEBUG_EDGE_PROCESSOR
+  printf ("Output edges:\n");
+  for (std::vector <WorkEdge>::iterator c1 = mp_work_edges->begin (); c1 != mp_work_edges->end (); ++c1) { 
+    printf ("%s\n", c1->to_string().c_str ()); 
+  } 
+#endif
+
+
+  tl::SelfTimer timer2 (tl::verbosity () >= m_base_verbosity + 10, "EdgeProcessor: production");
+
+  //  step 4: compute the result edges 
+  
+  es.start (); // call this as late as possible. This way, input containers can be identical with output containers ("clear" is done after the input is read)
+
+  op.reset ();
+  op.reserve (n_props);
+
+  if (manhattan) {
+    process_scanlines<EdgeXAtYCompare2_90> (*mp_work_edges, es, op, prefer_touch, selects_edges, progress.get (), todo_next, todo_max);
+  } else {
+    process_scanlines<EdgeXAtYCompare2> (*mp_work_edges, es, op, prefer_touch, selects_edges, progress.get (), todo_next, todo_max);
+  }
 
   es.flush ();
 
@@ -26,7 +26,13 @@
 #include "dbEdgeProcessor.h"
 #include "dbRegion.h"
 #include "dbCell.h"
+#include "dbClip.h"
 #include "tlIntervalMap.h"
+#include "tlThreadedWorkers.h"
+#include "tlTimer.h"
+
+#include <map>
+#include <algorithm>
 
 namespace db
 {
@@ -529,4 +535,544 @@ fill_region (db::Cell *cell, const db::Region &fr, db::cell_index_type fill_cell
   }
 }
 
+// -------------------------------------------------------------------------------------------
+//  FillEngine implementation
+
+namespace
+{
+
+/**
+ *  @brief A regular array of fill cells produced for a tile
+ */
+struct FillArray
+{
+  FillArray (size_t _fill_cell, const db::Point &_p0, unsigned long _na, unsigned long _nb)
+    : fill_cell (_fill_cell), p0 (_p0), na (_na), nb (_nb)
+  { }
+
+  size_t fill_cell;
+  db::Point p0;
+  unsigned long na, nb;
+};
+
+/**
+ *  @brief The state of one tile
+ */
+struct FillTile
+{
+  FillTile ()
+    : budget (-1.0)
+  { }
+
+  db::Box box;
+  std::vector<size_t> polygons;
+  std::vector<size_t> reference;
+  double budget;
+  std::vector<FillArray> primary;
+  std::vector<FillArray> secondary;
+};
+
+/**
+ *  @brief The state shared by all fill tasks
+ */
+struct FillState
+{
+  std::vector<db::FillEngine::FillCell> fill_cells;
+  std::vector<db::Polygon> polygons;
+  const std::vector<db::Polygon> *reference;
+  std::vector<FillTile> tiles;
+  size_t ntx, nty;
+  db::Point origin;
+  db::Vector fill_margin;
+  double density_target;
+};
+
+static db::Box
+footprint (const FillState &state, const FillArray &a)
+{
+  const db::Box &fc_box = state.fill_cells [a.fill_cell].fc_box;
+  return db::Box (a.p0, a.p0 + db::Vector (db::Coord (fc_box.width ()) * db::Coord (a.na), db::Coord (fc_box.height ()) * db::Coord (a.nb)));
+}
+
+static db::Coord
+snap_down (db::Coord x, db::Coord o, db::Coord d)
+{
+  db::Coord r = (x - o) % d;
+  if (r < 0) {
+    r += d;
+  }
+  return x - r;
+}
+
+/**
+ *  @brief Places one fill cell in the given window of a tile
+ *
+ *  Candidates are all raster positions whose footprint is entirely covered by "polygons" and
+ *  whose lower-left corner is inside "corner_box" (right and top edges excluded). The candidates
+ *  are thinned out evenly according to the density budget and compacted into regular arrays.
+ */
+static void
+place_fill_cell (const FillState &state, FillTile &tile, size_t fc, const db::Box &window, const db::Box &corner_box, const std::vector<db::Polygon> &polygons, std::vector<FillArray> &arrays)
+{
+  const db::Box &fc_box = state.fill_cells [fc].fc_box;
+  db::Coord dx = fc_box.width ();
+  db::Coord dy = fc_box.height ();
+
+  db::Coord x0 = snap_down (window.left (), state.origin.x (), dx);
+  db::Coord y0 = snap_down (window.bottom (), state.origin.y (), dy);
+  size_t nx = size_t ((window.right () - x0) / dx);
+  size_t ny = size_t ((window.top () - y0) / dy);
+
+  if (nx == 0 || ny == 0 || polygons.empty ()) {
+    return;
+  }
+
+  db::AreaMap am (db::Point (x0, y0), db::Vector (dx, dy), nx, ny);
+  for (std::vector<db::Polygon>::const_iterator p = polygons.begin (); p != polygons.end (); ++p) {
+    db::rasterize (*p, am);
+  }
+
+  db::AreaMap::area_type amax = am.pixel_area ();
+
+  //  collect the candidates in row-major order
+  std::vector<std::pair<size_t, size_t> > candidates;
+  for (size_t j = 0; j < ny; ++j) {
+    db::Coord y = y0 + db::Coord (j) * dy;
+    if (y < corner_box.bottom () || y >= corner_box.top ()) {
+      continue;
+    }
+    for (size_t i = 0; i < nx; ++i) {
+      db::Coord x = x0 + db::Coord (i) * dx;
+      if (x >= corner_box.left () && x < corner_box.right () && am.get (i, j) >= amax) {
+        candidates.push_back (std::make_pair (i, j));
+      }
+    }
+  }
+
+  if (candidates.empty ()) {
+    return;
+  }
+
+  //  thin out the candidates evenly if the density budget does not allow all of them
+  size_t n = candidates.size ();
+  size_t m = n;
+  if (tile.budget >= 0.0) {
+    double cells = std::max (0.0, tile.budget) / (double (dx) * double (dy));
+    if (cells < double (n)) {
+      m = size_t (cells + 1e-10);
+    }
+  }
+
+  if (m == 0) {
+    return;
+  }
+
+  std::vector<bool> selected (nx * ny, false);
+  for (size_t k = 0; k < n; ++k) {
+    if (m == n || k == 0 || (uint64_t (k) * m) / n > (uint64_t (k - 1) * m) / n) {
+      selected [candidates [k].second * nx + candidates [k].first] = true;
+    }
+  }
+
+  if (tile.budget >= 0.0) {
+    tile.budget -= double (m) * double (dx) * double (dy);
+  }
+
+  //  compact the selected positions into arrays: identical runs in consecutive rows form one array
+  std::map<std::pair<size_t, size_t>, size_t> open_arrays;
+
+  for (size_t j = 0; j < ny; ++j) {
+
+    std::map<std::pair<size_t, size_t>, size_t> new_open_arrays;
+
+    for (size_t i = 0; i < nx; ) {
+
+      if (! selected [j * nx + i]) {
+        ++i;
+        continue;
+      }
+
+      size_t ii = i + 1;
+      while (ii < nx && selected [j * nx + ii]) {
+        ++ii;
+      }
+
+      std::pair<size_t, size_t> run (i, ii);
+      std::map<std::pair<size_t, size_t>, size_t>::const_iterator o = open_arrays.find (run);
+      if (o != open_arrays.end ()) {
+        arrays [o->second].nb += 1;
+        new_open_arrays.insert (std::make_pair (run, o->second));
+      } else {
+        new_open_arrays.insert (std::make_pair (run, arrays.size ()));
+        arrays.push_back (FillArray (fc, db::Point (x0 + db::Coord (i) * dx, y0 + db::Coord (j) * dy), (unsigned long) (ii - i), 1));
+      }
+
+      i = ii;
+
+    }
+
+    open_arrays.swap (new_open_arrays);
+
+  }
+}
+
+static void
+clip_polygons (const FillState &state, const std::vector<db::Polygon> &from, const std::vector<size_t> &indexes, const db::Box &box, std::vector<db::Polygon> &clipped)
+{
+  for (std::vector<size_t>::const_iterator i = indexes.begin (); i != indexes.end (); ++i) {
+    const db::Polygon &p = from [*i];
+    if (p.box ().inside (box)) {
+      clipped.push_back (p);
+    } else if (p.box ().touches (box)) {
+      db::clip_poly (p, box, clipped, false /*=don't resolve holes*/);
+    }
+  }
+}
+
+/**
+ *  @brief Places the primary fill cell into a tile and computes the density budget
+ */
+static void
+fill_tile_primary (FillState &state, size_t t)
+{
+  FillTile &tile = state.tiles [t];
+
+  if (state.density_target < 1.0) {
+
+    std::vector<db::Polygon> existing;
+    clip_polygons (state, *state.reference, tile.reference, tile.box, existing);
+
+    double area = 0.0;
+    for (std::vector<db::Polygon>::const_iterator p = existing.begin (); p != existing.end (); ++p) {
+      area += double (p->area ());
+    }
+
+    tile.budget = std::max (0.0, state.density_target * double (tile.box.area ()) - area);
+
+  }
+
+  const db::Box &fc_box = state.fill_cells.front ().fc_box;
+
+  //  the primary fill cells are owned by the tile containing their lower-left corner, so
+  //  they may extend beyond the tile's right and top edges
+  db::Box window (tile.box.p1 (), tile.box.p2 () + db::Vector (fc_box.width (), fc_box.height ()));
+
+  std::vector<db::Polygon> polygons;
+  clip_polygons (state, state.polygons, tile.polygons, window, polygons);
+
+  place_fill_cell (state, tile, 0, window, tile.box, polygons, tile.primary);
+}
+
+/**
+ *  @brief Places the secondary fill cells into a tile
+ */
+static void
+fill_tile_secondary (FillState &state, size_t t)
+{
+  FillTile &tile = state.tiles [t];
+
+  //  secondary fill cells stay inside the tile with half the fill margin, so they keep
+  //  the fill margin to the fill cells of the neighbor tiles
+  db::Coord mx = (state.fill_margin.x () + 1) / 2;
+  db::Coord my = (state.fill_margin.y () + 1) / 2;
+  db::Box inner (tile.box.left () + mx, tile.box.bottom () + my, tile.box.right () - mx, tile.box.top () - my);
+  if (inner.empty ()) {
+    return;
+  }
+
+  std::vector<db::Polygon> polygons;
+  clip_polygons (state, state.polygons, tile.polygons, inner, polygons);
+  if (polygons.empty ()) {
+    return;
+  }
+
+  //  the primary fill cells of this tile and the neighbor tiles block the area
+  std::vector<db::Polygon> blocked;
+
+  size_t tx = t % state.ntx, ty = t / state.ntx;
+  for (size_t j = (ty > 0 ? ty - 1 : 0); j <= ty + 1 && j < state.nty; ++j) {
+    for (size_t i = (tx > 0 ? tx - 1 : 0); i <= tx + 1 && i < state.ntx; ++i) {
+      const std::vector<FillArray> &primary = state.tiles [j * state.ntx + i].primary;
+      for (std::vector<FillArray>::const_iterator a = primary.begin (); a != primary.end (); ++a) {
+        db::Box b = footprint (state, *a).enlarged (state.fill_margin);
+        if (b.touches (inner)) {
+          blocked.push_back (db::Polygon (b));
+        }
+      }
+    }
+  }
+
+  db::EdgeProcessor ep;
+
+  for (size_t fc = 1; fc < state.fill_cells.size (); ++fc) {
+
+    size_t n0 = tile.secondary.size ();
+
+    if (! blocked.empty ()) {
+      std::vector<db::Polygon> remaining;
+      ep.boolean (polygons, blocked, remaining, db::BooleanOp::ANotB, false /*=don't resolve holes*/);
+      polygons.swap (remaining);
+    }
+
+    place_fill_cell (state, tile, fc, inner, inner, polygons, tile.secondary);
+
+    blocked.clear ();
+    for (std::vector<FillArray>::const_iterator a = tile.secondary.begin () + n0; a != tile.secondary.end (); ++a) {
+      blocked.push_back (db::Polygon (footprint (state, *a).enlarged (state.fill_margin)));
+    }
+
+  }
+}
+
+/**
+ *  @brief A task filling one tile
+ */
+class FillTileTask
+  : public tl::Task
+{
+public:
+  FillTileTask (FillState *state, size_t tile, bool primary)
+    : mp_state (state), m_tile (tile), m_primary (primary)
+  { }
+
+  void run ()
+  {
+    if (m_primary) {
+      fill_tile_primary (*mp_state, m_tile);
+    } else {
+      fill_tile_secondary (*mp_state, m_tile);
+    }
+  }
+
+private:
+  FillState *mp_state;
+  size_t m_tile;
+  bool m_primary;
+};
+
+/**
+ *  @brief The worker for the parallel fill
+ */
+class FillWorker
+  : public tl::Worker
+{
+public:
+  FillWorker ()
+    : tl::Worker ()
+  { }
+
+  virtual void perform_task (tl::Task *task)
+  {
+    FillTileTask *ft = dynamic_cast<FillTileTask *> (task);
+    tl_assert (ft != 0);
+    ft->run ();
+  }
+};
+
+static void
+run_fill_tasks (FillState &state, bool primary, int threads)
+{
+  if (threads <= 0 || state.tiles.size () < 2) {
+
+    for (size_t t = 0; t < state.tiles.size (); ++t) {
+      FillTileTask (&state, t, primary).run ();
+    }
+
+  } else {
+
+    tl::Job<FillWorker> job (threads);
+
+    for (size_t t = 0; t < state.tiles.size (); ++t) {
+      job.schedule (new FillTileTask (&state, t, primary));
+    }
+
+    try {
+      job.start ();
+      job.wait ();
+    } catch (...) {
+      job.terminate ();
+      throw;
+    }
+
+    if (job.has_error ()) {
+      throw tl::Exception (job.error_messages ().front ());
+    }
+
+  }
+}
+
+static void
+assign_to_tiles (FillState &state, const std::vector<db::Polygon> &polygons, const db::Box &bbox, const db::Vector &tile_size, const db::Vector &halo, std::vector<size_t> FillTile::*member)
+{
+  for (size_t i = 0; i < polygons.size (); ++i) {
+
+    //  a polygon is relevant for all tiles whose extended window it touches
+    db::Box b = polygons [i].box ();
+    db::Coord l = b.left () - halo.x (), bt = b.bottom () - halo.y ();
+
+    size_t i0 = size_t (std::max (db::Coord (0), (l - bbox.left ()) / tile_size.x ()));
+    size_t i1 = std::min (state.ntx - 1, size_t (std::max (db::Coord (0), (b.right () - bbox.left ()) / tile_size.x ())));
+    size_t j0 = size_t (std::max (db::Coord (0), (bt - bbox.bottom ()) / tile_size.y ()));
+    size_t j1 = std::min (state.nty - 1, size_t (std::max (db::Coord (0), (b.top () - bbox.bottom ()) / tile_size.y ())));
+
+    for (size_t j = j0; j <= j1; ++j) {
+      for (size_t ii = i0; ii <= i1; ++ii) {
+        (state.tiles [j * state.ntx + ii].*member).push_back (i);
+      }
+    }
+
+  }
+}
+
+struct FillCellPriorityCompare
+{
+  bool operator() (const db::FillEngine::FillCell &a, const db::FillEngine::FillCell &b) const
+  {
+    return a.priority > b.priority;
+  }
+};
+
+}
+
+FillEngine::FillEngine ()
+  : m_threads (0), m_density_target (1.0), m_instances (0), m_arrays (0)
+{
+  //  .. nothing yet ..
+}
+
+void
+FillEngine::add_fill_cell (db::cell_index_type fill_cell_index, const db::Box &fc_box, int priority)
+{
+  if (fc_box.empty () || fc_box.width () <= 0 || fc_box.height () <= 0) {
+    throw tl::Exception (tl::to_string (tr ("Fill cell footprint must not be empty")));
+  }
+  m_fill_cells.push_back (FillCell (fill_cell_index, fc_box, priority));
+}
+
+void
+FillEngine::set_density_reference (const db::Region &region)
+{
+  m_density_reference.clear ();
+  for (db::Region::const_iterator p = region.begin_merged (); ! p.at_end (); ++p) {
+    m_density_reference.push_back (*p);
+  }
+}
+
+void
+FillEngine::fill (db::Cell *cell, const db::Region &fr, db::Region *remaining_parts)
+{
+  tl::SelfTimer timer (tl::verbosity () >= 21, tl::to_string (tr ("Fill")));
+
+  m_instances = 0;
+  m_arrays = 0;
+
+  FillState state;
+  state.fill_cells = m_fill_cells;
+  std::stable_sort (state.fill_cells.begin (), state.fill_cells.end (), FillCellPriorityCompare ());
+  state.reference = &m_density_reference;
+  state.origin = m_origin;
+  state.fill_margin = m_fill_margin;
+  state.density_target = m_density_target;
+  state.ntx = state.nty = 0;
+
+  for (db::Region::const_iterator p = fr.begin_merged (); ! p.at_end (); ++p) {
+    state.polygons.push_back (*p);
+  }
+
+  db::Box bbox;
+  for (std::vector<db::Polygon>::const_iterator p = state.polygons.begin (); p != state.polygons.end (); ++p) {
+    bbox += p->box ();
+  }
+
+  if (! state.fill_cells.empty () && ! bbox.empty () && bbox.width () > 0 && bbox.height () > 0) {
+
+    //  the tiles need to be as large as the largest fill cell
+    db::Coord wmax = 0, hmax = 0;
+    for (std::vector<FillCell>::const_iterator fc = state.fill_cells.begin (); fc != state.fill_cells.end (); ++fc) {
+      wmax = std::max (wmax, db::Coord (fc->fc_box.width ()));
+      hmax = std::max (hmax, db::Coord (fc->fc_box.height ()));
+    }
+
+    db::Coord tw = m_tile_size.x () > 0 ? m_tile_size.x () : db::Coord (bbox.width ());
+    db::Coord th = m_tile_size.y () > 0 ? m_tile_size.y () : db::Coord (bbox.height ());
+    tw = std::max (tw, wmax);
+    th = std::max (th, hmax);
+
+    state.ntx = size_t ((db::Coord (bbox.width ()) + tw - 1) / tw);
+    state.nty = size_t ((db::Coord (bbox.height ()) + th - 1) / th);
+
+    state.tiles.resize (state.ntx * state.nty);
+    for (size_t j = 0; j < state.nty; ++j) {
+      for (size_t i = 0; i < state.ntx; ++i) {
+        db::Point p1 = bbox.p1 () + db::Vector (db::Coord (i) * tw, db::Coord (j) * th);
+        state.tiles [j * state.ntx + i].box = db::Box (p1, p1 + db::Vector (tw, th));
+      }
+    }
+
+    const db::Box &fc_box = state.fill_cells.front ().fc_box;
+    assign_to_tiles (state, state.polygons, bbox, db::Vector (tw, th), db::Vector (fc_box.width (), fc_box.height ()), &FillTile::polygons);
+    if (state.density_target < 1.0) {
+      assign_to_tiles (state, m_density_reference, bbox, db::Vector (tw, th), db::Vector (), &FillTile::reference);
+    }
+
+    run_fill_tasks (state, true, m_threads);
+    if (state.fill_cells.size () > 1) {
+      run_fill_tasks (state, false, m_threads);
+    }
+
+  }
+
+  //  produce the instances
+
+  std::vector<db::Polygon> filled;
+
+  for (int pass = 0; pass < 2; ++pass) {
+
+    for (std::vector<FillTile>::const_iterator t = state.tiles.begin (); t != state.tiles.end (); ++t) {
+
+      const std::vector<FillArray> &arrays = (pass == 0 ? t->primary : t->secondary);
+      for (std::vector<FillArray>::const_iterator a = arrays.begin (); a != arrays.end (); ++a) {
+
+        const FillCell &fc = state.fill_cells [a->fill_cell];
+        db::Trans trans (a->p0 - fc.fc_box.p1 ());
+
+        if (a->na > 1 || a->nb > 1) {
+          cell->insert (db::CellInstArray (db::CellInst (fc.cell_index), trans, db::Vector (fc.fc_box.width (), 0), db::Vector (0, fc.fc_box.height ()), a->na, a->nb));
+        } else {
+          cell->insert (db::CellInstArray (db::CellInst (fc.cell_index), trans));
+        }
+
+        m_instances += size_t (a->na) * size_t (a->nb);
+        m_arrays += 1;
+
+        if (remaining_parts) {
+          filled.push_back (db::Polygon (footprint (state, *a).enlarged (m_fill_margin)));
+        }
+
+      }
+
+    }
+
+  }
+
+  if (tl::verbosity () >= 30) {
+    tl::info << "Created " << m_instances << " fill cell instances in " << m_arrays << " arrays";
+  }
+
+  if (remaining_parts) {
+
+    std::vector<db::Polygon> remaining;
+    db::EdgeProcessor ep;
+    ep.boolean (state.polygons, filled, remaining, db::BooleanOp::ANotB, false /*=don't resolve holes*/);
+
+    if (remaining_parts == &fr) {
+      remaining_parts->clear ();
+    }
+    for (std::vector<db::Polygon>::const_iterator p = remaining.begin (); p != remaining.end (); ++p) {
+      remaining_parts->insert (*p);
+    }
+
+  }
+}
+
 }
@@ -21,8 +21,14 @@
 */
 
 
+#ifndef HDR_dbFillTool
+#define HDR_dbFillTool
+
 #include "dbTypes.h"
 #include "dbPolygon.h"
+#include "dbBox.h"
+
+#include <vector>
 
 namespace db
 {
@@ -65,5 +71,216 @@ DB_PUBLIC void
 fill_region (db::Cell *cell, const db::Region &fr, db::cell_index_type fill_cell_index, const db::Box &fc_box, const db::Point &origin, bool enhanced_fill, 
              db::Region *remaining_parts = 0, const db::Vector &fill_margin = db::Vector (), db::Region *remaining_polygons = 0);
 
+/**
+ *  @brief A tiled, multi-threaded fill engine for multiple fill cells
+ *
+ *  The fill engine fills a region with instances of one or more fill cells. The
+ *  fill region is cut into tiles which are filled in parallel. The fill cells are
+ *  placed in compact regular arrays rather than single instances.
+ *
+ *  Fill cells are placed in the order of their priority: the fill cell with the highest
+ *  priority is placed first on a global raster which is anchored at the origin. Hence
+ *  this fill pattern is seamless across tiles and does not depend on the tiling.
+ *  Fill cells with a lower priority fill the space left over by the previous ones.
+ *  They keep a distance of "fill_margin" to the fill cells placed before and to the
+ *  tile borders. Those are rasterized on the same origin.
+ *
+ *  The tiles also act as density windows: if a density target is given, the fill
+ *  cells are thinned out evenly such that the footprint area of the fill cells per
+ *  tile (plus the area of the density reference shapes) does not exceed the target.
+ */
+class DB_PUBLIC FillEngine
+{
+public:
+  /**
+   *  @brief A fill cell specification
+   */
+  struct FillCell
+  {
+    FillCell (db::cell_index_type _cell_index, const db::Box &_fc_box, int _priority)
+      : cell_index (_cell_index), fc_box (_fc_box), priority (_priority)
+    { }
+
+    db::cell_index_type cell_index;
+    db::Box fc_box;
+    int priority;
+  };
+
+  /**
+   *  @brief Constructor
+   */
+  FillEngine ();
+
+  /**
+   *  @brief Adds a fill cell
+   *
+   *  @param fill_cell_index The index of the fill cell
+   *  @param fc_box The footprint of the fill cell
+   *  @param priority The priority - fill cells with a higher priority are placed first
+   *
+   *  Fill cells with the same priority are placed in the order they are added.
+   */
+  void add_fill_cell (db::cell_index_type fill_cell_index, const db::Box &fc_box, int priority = 0);
+
+  /**
+   *  @brief Removes all fill cells
+   */
+  void clear_fill_cells ()
+  {
+    m_fill_cells.clear ();
+  }
+
+  /**
+   *  @brief Gets the fill cells
+   */
+  const std::vector<FillCell> &fill_cells () const
+  {
+    return m_fill_cells;
+  }
+
+  /**
+   *  @brief Sets the origin of the fill raster
+   */
+  void set_origin (const db::Point &origin)
+  {
+    m_origin = origin;
+  }
+
+  /**
+   *  @brief Gets the origin of the fill raster
+   */
+  const db::Point &origin () const
+  {
+    return m_origin;
+  }
+
+  /**
+   *  @brief Sets the fill margin
+   *
+   *  The fill margin is the minimum distance in x and y direction between fill cells of
+   *  different kind and the distance kept by the remaining parts from the filled area.
+   */
+  void set_fill_margin (const db::Vector &fill_margin)
+  {
+    m_fill_margin = fill_margin;
+  }
+
+  /**
+   *  @brief Gets the fill margin
+   */
+  const db::Vector &fill_margin () const
+  {
+    return m_fill_margin;
+  }
+
+  /**
+   *  @brief Sets the tile size
+   *
+   *  The tiles are anchored at the lower-left corner of the fill region's bounding box.
+   *  A zero tile size means a single tile. Tiles are made at least as large as the largest
+   *  fill cell footprint.
+   */
+  void set_tile_size (const db::Vector &tile_size)
+  {
+    m_tile_size = tile_size;
+  }
+
+  /**
+   *  @brief Gets the tile size
+   */
+  const db::Vector &tile_size () const
+  {
+    return m_tile_size;
+  }
+
+  /**
+   *  @brief Sets the number of threads to use (0 for no threads)
+   */
+  void set_threads (int threads)
+  {
+    m_threads = threads;
+  }
+
+  /**
+   *  @brief Gets the number of threads to use
+   */
+  int threads () const
+  {
+    return m_threads;
+  }
+
+  /**
+   *  @brief Sets the density target per tile
+   *
+   *  The density target is a value between 0 and 1. A value of 1 or larger
+   *  disables the density control.
+   */
+  void set_density_target (double density)
+  {
+    m_density_target = density;
+  }
+
+  /**
+   *  @brief Gets the density target per tile
+   */
+  double density_target () const
+  {
+    return m_density_target;
+  }
+
+  /**
+   *  @brief Sets the shapes which count against the density target
+   *
+   *  Typically these are the existing shapes on the layer which is filled.
+   */
+  void set_density_reference (const db::Region &region);
+
+  /**
+   *  @brief Clears the density reference
+   */
+  void clear_density_reference ()
+  {
+    m_density_reference.clear ();
+  }
+
+  /**
+   *  @brief Fills the given region
+   *
+   *  @param cell The cell where to instantiate the fill cells
+   *  @param fr The region to fill
+   *  @param remaining_parts If non-null, this region receives the parts of the fill region not covered by fill cells (plus the fill margin)
+   *
+   *  remaining_parts can be identical with fr. In that case, fr is replaced by the remaining parts.
+   */
+  void fill (db::Cell *cell, const db::Region &fr, db::Region *remaining_parts = 0);
+
+  /**
+   *  @brief Gets the number of fill cell instances created by the last "fill" (array members counted individually)
+   */
+  size_t instances () const
+  {
+    return m_instances;
+  }
+
+  /**
+   *  @brief Gets the number of instance arrays created by the last "fill"
+   */
+  size_t arrays () const
+  {
+    return m_arrays;
+  }
+
+private:
+  std::vector<FillCell> m_fill_cells;
+  db::Point m_origin;
+  db::Vector m_fill_margin;
+  db::Vector m_tile_size;
+  int m_threads;
+  double m_density_target;
+  std::vector<db::Polygon> m_density_reference;
+  size_t m_instances, m_arrays;
+};
+
 }
 
+#endif
@@ -365,6 +365,20 @@ public:
    */
   void set_global_nets (const global_nets &gn);
 
+  /**
+   *  @brief Collects memory statistics
+   */
+  void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, bool no_self = false, void *parent = 0) const
+  {
+    if (! no_self) {
+      stat->add (typeid (*this), (void *) this, sizeof (*this), sizeof (*this), parent, purpose, cat);
+    }
+
+    db::mem_stat (stat, purpose, cat, m_shapes, true, (void *) this);
+    db::mem_stat (stat, purpose, cat, m_attrs, true, (void *) this);
+    db::mem_stat (stat, purpose, cat, m_global_nets, true, (void *) this);
+  }
+
 private:
   template <typename> friend class local_clusters;
   template <typename> friend class hnp_interaction_receiver;
@@ -392,6 +406,15 @@ private:
   size_t m_size;
 };
 
+/**
+ *  @brief Collects memory statistics
+ */
+template <class T>
+inline void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, const local_cluster<T> &x, bool no_self = false, void *parent = 0)
+{
+  x.mem_stat (stat, purpose, cat, no_self, parent);
+}
+
 /**
  *  @brief A box converter for the local_cluster class
  */
@@ -533,6 +556,18 @@ public:
     return id > m_clusters.size ();
   }
 
+  /**
+   *  @brief Collects memory statistics
+   */
+  void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, bool no_self = false, void *parent = 0) const
+  {
+    if (! no_self) {
+      stat->add (typeid (*this), (void *) this, sizeof (*this), sizeof (*this), parent, purpose, cat);
+    }
+
+    db::mem_stat (stat, purpose, cat, m_clusters, true, (void *) this);
+  }
+
 private:
   void ensure_sorted ();
 
@@ -955,6 +990,21 @@ public:
     m_connected_clusters.insert (id);
   }
 
+  /**
+   *  @brief Collects memory statistics
+   */
+  void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, bool no_self = false, void *parent = 0) const
+  {
+    if (! no_self) {
+      stat->add (typeid (*this), (void *) this, sizeof (*this), sizeof (*this), parent, purpose, cat);
+    }
+
+    local_clusters<T>::mem_stat (stat, purpose, cat, true, parent);
+    db::mem_stat (stat, purpose, cat, m_connections, true, (void *) this);
+    db::mem_stat (stat, purpose, cat, m_rev_connections, true, (void *) this);
+    db::mem_stat (stat, purpose, cat, m_connected_clusters, true, (void *) this);
+  }
+
 private:
   template<typename> friend class connected_clusters_iterator;
 
@@ -963,6 +1013,15 @@ private:
   std::set<id_type> m_connected_clusters;
 };
 
+/**
+ *  @brief Collects memory statistics
+ */
+template <class T>
+inline void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, const connected_clusters<T> &x, bool no_self = false, void *parent = 0)
+{
+  x.mem_stat (stat, purpose, cat, no_self, parent);
+}
+
 template <typename> class cell_clusters_box_converter;
 
 /**
@@ -1036,6 +1095,18 @@ public:
    */
   size_t propagate_cluster_inst (const db::Layout &layout, const Cell &cell, const ClusterInstance &ci, db::cell_index_type parent_ci, bool with_self);
 
+  /**
+   *  @brief Collects memory statistics
+   */
+  void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, bool no_self = false, void *parent = 0) const
+  {
+    if (! no_self) {
+      stat->add (typeid (*this), (void *) this, sizeof (*this), sizeof (*this), parent, purpose, cat);
+    }
+
+    db::mem_stat (stat, purpose, cat, m_per_cell_clusters, true, (void *) this);
+  }
+
 private:
   void build_local_cluster (const db::Layout &layout, const db::Cell &cell, const db::Connectivity &conn, const tl::equivalence_clusters<size_t> *attr_equivalence);
   void build_hier_connections (cell_clusters_box_converter<T> &cbc, const db::Layout &layout, const db::Cell &cell, const db::Connectivity &conn, const std::set<cell_index_type> *breakout_cells, instance_interaction_cache_type &instance_interaction_cache);
@@ -1046,6 +1117,15 @@ private:
   int m_base_verbosity;
 };
 
+/**
+ *  @brief Collects memory statistics
+ */
+template <class T>
+inline void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, const hier_clusters<T> &x, bool no_self = false, void *parent = 0)
+{
+  x.mem_stat (stat, purpose, cat, no_self, parent);
+}
+
 /**
  *  @brief A callback function for the recursive cluster shape and cluster iterator selecting cells/circuits
  *
@@ -1122,6 +1122,13 @@ void local_processor<TS, TI, TR>::run (local_operation<TS, TI, TR> *op, unsigned
   local_processor_contexts<TS, TI, TR> contexts;
   compute_contexts (contexts, op, subject_layer, intruder_layer);
   compute_results (contexts, op, output_layer);
+
+  //  the contexts are discarded now - report their memory usage if requested
+  if (db::MemStatisticsPeakRegistry::is_enabled ()) {
+    db::MemStatisticsSimple ms;
+    contexts.mem_stat (&ms, db::MemStatistics::ProcessorCaches, 0);
+    db::MemStatisticsPeakRegistry::report (db::MemStatistics::ProcessorCaches, ms.size ());
+  }
 }
 
 template <class TS, class TI, class TR>
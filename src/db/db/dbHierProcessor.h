@@ -173,12 +173,34 @@ public:
     return m_drops.end ();
   }
 
+  /**
+   *  @brief Collects memory statistics
+   */
+  void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, bool no_self = false, void *parent = 0) const
+  {
+    if (! no_self) {
+      stat->add (typeid (*this), (void *) this, sizeof (*this), sizeof (*this), parent, purpose, cat);
+    }
+
+    db::mem_stat (stat, purpose, cat, m_propagated, true, (void *) this);
+    db::mem_stat (stat, purpose, cat, m_drops, true, (void *) this);
+  }
+
 private:
   std::unordered_set<TR> m_propagated;
   std::vector<local_processor_cell_drop<TS, TI, TR> > m_drops;
   tl::Mutex m_lock;
 };
 
+/**
+ *  @brief Collects memory statistics
+ */
+template <class TS, class TI, class TR>
+inline void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, const local_processor_cell_context<TS, TI, TR> &x, bool no_self = false, void *parent = 0)
+{
+  x.mem_stat (stat, purpose, cat, no_self, parent);
+}
+
 template <class TS, class TI, class TR>
 class DB_PUBLIC local_processor_cell_contexts
 {
@@ -209,11 +231,32 @@ public:
     return m_contexts.end ();
   }
 
+  /**
+   *  @brief Collects memory statistics
+   */
+  void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, bool no_self = false, void *parent = 0) const
+  {
+    if (! no_self) {
+      stat->add (typeid (*this), (void *) this, sizeof (*this), sizeof (*this), parent, purpose, cat);
+    }
+
+    db::mem_stat (stat, purpose, cat, m_contexts, true, (void *) this);
+  }
+
 private:
   const db::Cell *mp_intruder_cell;
   std::unordered_map<context_key_type, db::local_processor_cell_context<TS, TI, TR> > m_contexts;
 };
 
+/**
+ *  @brief Collects memory statistics
+ */
+template <class TS, class TI, class TR>
+inline void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, const local_processor_cell_contexts<TS, TI, TR> &x, bool no_self = false, void *parent = 0)
+{
+  x.mem_stat (stat, purpose, cat, no_self, parent);
+}
+
 template <class TS, class TI, class TR>
 class DB_PUBLIC local_processor_contexts
 {
@@ -287,6 +330,18 @@ public:
     return m_lock;
   }
 
+  /**
+   *  @brief Collects memory statistics
+   */
+  void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, bool no_self = false, void *parent = 0) const
+  {
+    if (! no_self) {
+      stat->add (typeid (*this), (void *) this, sizeof (*this), sizeof (*this), parent, purpose, cat);
+    }
+
+    db::mem_stat (stat, purpose, cat, m_contexts_per_cell, true, (void *) this);
+  }
+
 private:
   contexts_per_cell_type m_contexts_per_cell;
   unsigned int m_subject_layer, m_intruder_layer;
@@ -114,6 +114,41 @@ public:
     }
   }
 
+  virtual size_t mem_used () const
+  {
+    db::MemStatisticsSimple ms;
+    db::mem_stat (&ms, db::MemStatistics::None, 0, m_insts, true);
+    return sizeof (*this) + ms.size ();
+  }
+
+  virtual void compact ()
+  {
+    m_insts.shrink_to_fit ();
+  }
+
+  static void queue_or_append (db::Manager *manager, db::Cell *cell, bool insert, const Inst &inst)
+  {
+    InstOp<Inst, ET> *old_op = dynamic_cast <InstOp<Inst, ET> *> (manager->last_queued (cell));
+    if (! old_op || old_op->m_insert != insert) {
+      manager->queue (cell, new InstOp<Inst, ET> (insert, inst));
+    } else {
+      old_op->m_insts.push_back (inst);
+    }
+  }
+
+  template <class Iter>
+  static void queue_or_append (db::Manager *manager, db::Cell *cell, bool insert, Iter from, Iter to, bool dummy)
+  {
+    InstOp<Inst, ET> *old_op = dynamic_cast <InstOp<Inst, ET> *> (manager->last_queued (cell));
+    if (! old_op || old_op->m_insert != insert) {
+      manager->queue (cell, new InstOp<Inst, ET> (insert, from, to, dummy));
+    } else {
+      for (Iter i = from; i != to; ++i) {
+        old_op->m_insts.push_back (**i);
+      }
+    }
+  }
+
 private:
   bool m_insert;
   std::vector<Inst> m_insts;
@@ -946,7 +981,7 @@ Instances::erase_positions (Tag tag, ET editable_tag, I first, I last)
   if (mp_cell) { 
     mp_cell->invalidate_insts ();  //  HINT: must come before the change is done!
     if (mp_cell->manager () && mp_cell->manager ()->transacting ()) {
-      mp_cell->manager ()->queue (mp_cell, new db::InstOp<typename Tag::object_type, ET> (false /*not insert*/, first, last, true /*dummy*/));
+      db::InstOp<typename Tag::object_type, ET>::queue_or_append (mp_cell->manager (), mp_cell, false /*not insert*/, first, last, true /*dummy*/);
     }
   }
 
@@ -963,9 +998,9 @@ Instances::insert (const InstArray &inst)
   if (mp_cell) {
     if (mp_cell->manager () && mp_cell->manager ()->transacting ()) {
       if (editable) {
-        mp_cell->manager ()->queue (mp_cell, new db::InstOp<InstArray, InstancesEditableTag> (true /*insert*/, inst));
+        db::InstOp<InstArray, InstancesEditableTag>::queue_or_append (mp_cell->manager (), mp_cell, true /*insert*/, inst);
       } else {
-        mp_cell->manager ()->queue (mp_cell, new db::InstOp<InstArray, InstancesNonEditableTag> (true /*insert*/, inst));
+        db::InstOp<InstArray, InstancesNonEditableTag>::queue_or_append (mp_cell->manager (), mp_cell, true /*insert*/, inst);
       }
     }
     mp_cell->invalidate_insts ();
@@ -1127,7 +1162,7 @@ Instances::erase_inst_by_iter (Tag tag, ET editable_tag, I iter)
   if (mp_cell) {
     mp_cell->invalidate_insts ();
     if (mp_cell->manager () && mp_cell->manager ()->transacting ()) {
-      mp_cell->manager ()->queue (mp_cell, new db::InstOp<typename Tag::object_type, ET> (false /*not insert*/, *iter));
+      db::InstOp<typename Tag::object_type, ET>::queue_or_append (mp_cell->manager (), mp_cell, false /*not insert*/, *iter);
     }
   }
 
@@ -1141,7 +1176,7 @@ Instances::erase_inst_by_tag (Tag tag, ET editable_tag, const typename Tag::obje
   if (mp_cell) {
     mp_cell->invalidate_insts ();
     if (mp_cell->manager () && mp_cell->manager ()->transacting ()) {
-      mp_cell->manager ()->queue (mp_cell, new db::InstOp<typename Tag::object_type, ET> (false /*not insert*/, obj));
+      db::InstOp<typename Tag::object_type, ET>::queue_or_append (mp_cell->manager (), mp_cell, false /*not insert*/, obj);
     }
   }
 
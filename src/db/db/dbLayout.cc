@@ -2073,6 +2073,21 @@ Layout::get_pcell_variant_cell (cell_index_type cell_index, const std::vector<tl
 
 }
 
+void
+Layout::refresh_pcell_variants (unsigned int threads)
+{
+  std::vector<PCellVariant *> variants;
+  for (iterator c = begin (); c != end (); ++c) {
+    PCellVariant *pcell_variant = dynamic_cast<PCellVariant *> (c.operator-> ());
+    if (pcell_variant) {
+      variants.push_back (pcell_variant);
+    }
+  }
+
+  tl::SelfTimer timer (tl::verbosity () >= layout_base_verbosity, tl::to_string (tr ("Producing PCell variants")));
+  PCellVariant::update_variants (variants, threads);
+}
+
 bool 
 Layout::get_context_info (cell_index_type cell_index, std::vector <std::string> &context_info) const
 {
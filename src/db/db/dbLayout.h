@@ -830,6 +830,16 @@ public:
    */
   cell_index_type get_pcell_variant_cell (cell_index_type cell_index, const std::vector<tl::Variant> &new_parameters);
 
+  /**
+   *  @brief Produces the layout of all PCell variants of this layout again
+   *
+   *  With "threads" > 0, the variants of PCells supporting parallel production
+   *  (see PCellDeclaration::can_produce_in_parallel) are produced in the given number
+   *  of worker threads.
+   *  Library proxies in other layouts referring to these variants are not updated.
+   */
+  void refresh_pcell_variants (unsigned int threads = 0);
+
   /**
    *  @brief Get the PCell header of the given PCell Id
    *
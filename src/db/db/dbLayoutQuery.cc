@@ -30,11 +30,13 @@
 #include "tlExpression.h"
 #include "gsiExpression.h"
 #include "gsiDecl.h"
+#include "tlThreadedWorkers.h"
 
 #include <limits>
 #include <memory>
 #include <deque>
 #include <iostream>
+#include <algorithm>
 
 namespace db
 {
@@ -333,6 +335,11 @@ public:
     }
   }
 
+  virtual bool is_enumerating () const
+  {
+    return true;
+  }
+
   virtual void dump () const
   {
     std::cout << "ShapeFilterState";
@@ -1093,6 +1100,11 @@ public:
     }
   }
 
+  virtual bool is_enumerating () const
+  {
+    return m_instance_mode != NoInstances || ! m_pattern.is_const ();
+  }
+
   virtual void dump () const
   {
     std::cout << "ChildCellFilterState";
@@ -1368,6 +1380,11 @@ public:
     }
   }
 
+  virtual bool is_enumerating () const
+  {
+    return ! m_pattern.is_const ();
+  }
+
   virtual void dump () const
   {
     std::cout << "CellFilterState";
@@ -1568,6 +1585,11 @@ public:
     FilterBracket::dump (l + 1);
   }
 
+  virtual bool can_run_parallel () const
+  {
+    return false;
+  }
+
 private:
   DeleteFilterPropertyIDs m_pids;
   bool m_transparent;
@@ -1671,6 +1693,11 @@ public:
     FilterBracket::dump (l + 1);
   }
 
+  virtual bool can_run_parallel () const
+  {
+    return false;
+  }
+
 private:
   std::string m_do_expression;
   bool m_transparent;
@@ -1896,6 +1923,12 @@ public:
     FilterBracket::dump (l + 1);
   }
 
+  virtual bool can_run_parallel () const
+  {
+    //  sorting needs to see all results
+    return m_sort_expression.empty () && FilterBracket::can_run_parallel ();
+  }
+
 private:
   SelectFilterPropertyIDs m_pids;
   std::vector<std::string> m_expressions;
@@ -2011,7 +2044,9 @@ private:
 //  LayoutQueryIterator implementation
 
 LayoutQueryIterator::LayoutQueryIterator (const LayoutQuery &q, db::Layout *layout, tl::Eval *parent_eval, tl::AbsoluteProgress *progress)
-  : mp_q (const_cast<db::LayoutQuery *> (&q)), mp_layout (layout), m_eval (parent_eval), m_layout_ctx (layout, true /*can modify*/), mp_progress (progress), m_initialized (false)
+  : mp_root_state (0), mp_q (const_cast<db::LayoutQuery *> (&q)), mp_layout (layout), m_eval (parent_eval), m_layout_ctx (layout, true /*can modify*/), mp_progress (progress), m_initialized (false), m_in_changes (true),
+    m_partition (0), m_partitions (1), m_partition_depth (std::numeric_limits<size_t>::max ()), m_units (0),
+    m_prefetch (false), m_threads (0), mp_parent_eval (parent_eval), m_row (0)
 {
   m_eval.set_ctx_handler (&m_layout_ctx);
   m_eval.set_var ("layout", tl::Variant::make_variant_ref (layout));
@@ -2025,7 +2060,9 @@ LayoutQueryIterator::LayoutQueryIterator (const LayoutQuery &q, db::Layout *layo
 }
 
 LayoutQueryIterator::LayoutQueryIterator (const LayoutQuery &q, const db::Layout *layout, tl::Eval *parent_eval, tl::AbsoluteProgress *progress)
-  : mp_q (const_cast<db::LayoutQuery *> (&q)), mp_layout (const_cast <db::Layout *> (layout)), m_eval (parent_eval), m_layout_ctx (layout), mp_progress (progress), m_initialized (false)
+  : mp_root_state (0), mp_q (const_cast<db::LayoutQuery *> (&q)), mp_layout (const_cast <db::Layout *> (layout)), m_eval (parent_eval), m_layout_ctx (layout), mp_progress (progress), m_initialized (false), m_in_changes (true),
+    m_partition (0), m_partitions (1), m_partition_depth (std::numeric_limits<size_t>::max ()), m_units (0),
+    m_prefetch (false), m_threads (0), mp_parent_eval (parent_eval), m_row (0)
 {
   //  TODO: check whether the query is a modifying one (with .. do, delete)
 
@@ -2036,12 +2073,43 @@ LayoutQueryIterator::LayoutQueryIterator (const LayoutQuery &q, const db::Layout
   }
 
   //  Avoid update() calls while iterating in modifying mode
+  mp_layout->update ();
   mp_layout->start_changes ();
 }
 
+LayoutQueryIterator::LayoutQueryIterator (const LayoutQuery &q, const db::Layout *layout, const std::vector<std::string> &properties, unsigned int threads, tl::Eval *parent_eval)
+  : mp_root_state (0), mp_q (const_cast<db::LayoutQuery *> (&q)), mp_layout (const_cast <db::Layout *> (layout)), m_eval (parent_eval), m_layout_ctx (layout), mp_progress (0), m_initialized (false), m_in_changes (false),
+    m_partition (0), m_partitions (1), m_partition_depth (std::numeric_limits<size_t>::max ()), m_units (0),
+    m_prefetch (true), m_threads (threads), mp_parent_eval (parent_eval), m_properties (properties), m_row (0)
+{
+  m_columns.resize (mp_q->properties (), -1);
+  for (size_t i = 0; i < properties.size (); ++i) {
+    if (mp_q->has_property (properties [i])) {
+      m_columns [mp_q->property_by_name (properties [i])] = int (i);
+    }
+  }
+}
+
+LayoutQueryIterator::LayoutQueryIterator (const LayoutQuery &q, const db::Layout *layout, tl::Eval *parent_eval, unsigned int partition, unsigned int partitions)
+  : mp_root_state (0), mp_q (const_cast<db::LayoutQuery *> (&q)), mp_layout (const_cast <db::Layout *> (layout)), m_eval (parent_eval), m_layout_ctx (layout), mp_progress (0), m_initialized (false), m_in_changes (false),
+    m_partition (partition), m_partitions (partitions), m_partition_depth (std::numeric_limits<size_t>::max ()), m_units (0),
+    m_prefetch (false), m_threads (0), mp_parent_eval (parent_eval), m_row (0)
+{
+  m_eval.set_ctx_handler (&m_layout_ctx);
+  m_eval.set_var ("layout", tl::Variant::make_variant_ref (layout));
+  for (unsigned int i = 0; i < mp_q->properties (); ++i) {
+    m_eval.define_function (mp_q->property_name (i), new FilterStateFunction (i, &m_state));
+  }
+
+  //  NOTE: start_changes is not called here as this iterator is used by LayoutQuery::collect
+  //  which takes care of the layout's state.
+}
+
 LayoutQueryIterator::~LayoutQueryIterator ()
 {
-  mp_layout->end_changes ();
+  if (m_in_changes) {
+    mp_layout->end_changes ();
+  }
   if (m_initialized) {
     cleanup ();
   }
@@ -2059,6 +2127,15 @@ LayoutQueryIterator::ensure_initialized ()
 void 
 LayoutQueryIterator::init ()
 {
+  if (m_prefetch) {
+    mp_q->collect (*mp_layout, m_properties, m_rows, m_threads, mp_parent_eval);
+    m_row = 0;
+    return;
+  }
+
+  m_units = 0;
+  m_partition_depth = std::numeric_limits<size_t>::max ();
+
   std::vector<FilterStateBase *> f;
   mp_root_state = mp_q->root ().create_state (f, mp_layout, m_eval, false);
   mp_root_state->init ();
@@ -2073,11 +2150,17 @@ LayoutQueryIterator::init ()
 void
 LayoutQueryIterator::cleanup ()
 {
-  std::set<FilterStateBase *> states;
-  collect (mp_root_state, states);
-  for (std::set<FilterStateBase *>::iterator s = states.begin (); s != states.end (); ++s) {
-    delete *s;
+  m_rows.clear ();
+  m_row = 0;
+
+  if (mp_root_state) {
+    std::set<FilterStateBase *> states;
+    collect (mp_root_state, states);
+    for (std::set<FilterStateBase *>::iterator s = states.begin (); s != states.end (); ++s) {
+      delete *s;
+    }
   }
+
   m_state.clear ();
   mp_root_state = 0;
 }
@@ -2088,8 +2171,10 @@ LayoutQueryIterator::reset ()
   if (m_initialized) {
 
     //  forces an update if required
-    mp_layout->end_changes ();
-    mp_layout->start_changes ();
+    if (m_in_changes) {
+      mp_layout->end_changes ();
+      mp_layout->start_changes ();
+    }
 
     cleanup ();
     init ();
@@ -2101,17 +2186,21 @@ bool
 LayoutQueryIterator::at_end () const
 {
   const_cast<LayoutQueryIterator *> (this)->ensure_initialized ();
-  return m_state.empty ();
+  if (m_prefetch) {
+    return m_row >= m_rows.size ();
+  } else {
+    return m_state.empty ();
+  }
 }
 
 bool
 LayoutQueryIterator::get (const std::string &name, tl::Variant &v)
 {
   ensure_initialized ();
-  if (m_state.empty () || !m_state.back () || !mp_q->has_property (name)) {
+  if (! mp_q->has_property (name)) {
     return false;
   } else {
-    return m_state.back ()->get_property (mp_q->property_by_name (name), v);
+    return get (mp_q->property_by_name (name), v);
   }
 }
 
@@ -2119,7 +2208,14 @@ bool
 LayoutQueryIterator::get (unsigned int id, tl::Variant &v)
 {
   ensure_initialized ();
-  if (m_state.empty () || !m_state.back ()) {
+  if (m_prefetch) {
+    if (m_row >= m_rows.size () || id >= (unsigned int) m_columns.size () || m_columns [id] < 0) {
+      return false;
+    } else {
+      v = m_rows [m_row].get_list () [m_columns [id]];
+      return true;
+    }
+  } else if (m_state.empty () || !m_state.back ()) {
     return false;
   } else {
     return m_state.back ()->get_property (id, v);
@@ -2130,7 +2226,9 @@ void
 LayoutQueryIterator::dump () const
 {
   const_cast<LayoutQueryIterator *> (this)->ensure_initialized ();
-  mp_root_state->dump ();
+  if (mp_root_state) {
+    mp_root_state->dump ();
+  }
   std::cout << std::endl;
 }
 
@@ -2151,6 +2249,11 @@ void
 LayoutQueryIterator::next (bool skip)
 {
   ensure_initialized ();
+  if (m_prefetch) {
+    ++m_row;
+    return;
+  }
+
   do {
     next_up (skip);
   } while (! next_down ());
@@ -2167,6 +2270,10 @@ LayoutQueryIterator::next_up (bool skip)
     if (m_state.back ()->at_end ()) {
       m_state.pop_back ();
     } else {
+      if (m_partitions > 1 && m_state.size () == m_partition_depth + 1) {
+        //  the partitioning state delivers a new item
+        ++m_units;
+      }
       break;
     }
   }
@@ -2179,6 +2286,11 @@ LayoutQueryIterator::next_down ()
 
     while (true) {
 
+      if (! in_partition ()) {
+        //  the current item of the partitioning state is handled by another partition
+        return false;
+      }
+
       if (mp_progress) {
         ++*mp_progress;
       }
@@ -2190,7 +2302,19 @@ LayoutQueryIterator::next_down ()
 
         new_state->reset (m_state.back ());
         if (! new_state->at_end ()) {
+
           m_state.push_back (new_state);
+
+          if (m_partitions > 1) {
+            //  the first enumerating state determines the partitioning
+            if (m_partition_depth == std::numeric_limits<size_t>::max () && new_state->is_enumerating ()) {
+              m_partition_depth = m_state.size () - 1;
+            }
+            if (m_state.size () == m_partition_depth + 1) {
+              ++m_units;
+            }
+          }
+
         } else { 
           return false;
         }
@@ -2201,7 +2325,227 @@ LayoutQueryIterator::next_down ()
 
   }
 
-  return true;
+  return owns_result ();
+}
+
+bool
+LayoutQueryIterator::in_partition () const
+{
+  if (m_partitions < 2 || m_partition_depth == std::numeric_limits<size_t>::max () || m_state.size () != m_partition_depth + 1) {
+    return true;
+  } else {
+    return (m_units - 1) % m_partitions == m_partition;
+  }
+}
+
+bool
+LayoutQueryIterator::owns_result () const
+{
+  //  results outside the items of the partitioning state are delivered by the first partition
+  return m_state.empty () || m_partitions < 2 || m_partition == 0 || (m_partition_depth != std::numeric_limits<size_t>::max () && m_state.size () > m_partition_depth);
+}
+
+void
+LayoutQueryIterator::unit_key (size_t &unit, bool &after) const
+{
+  unit = m_units;
+  after = (m_partition_depth == std::numeric_limits<size_t>::max () || m_state.size () <= m_partition_depth);
+}
+
+// --------------------------------------------------------------------------------
+//  LayoutQuery::collect implementation
+
+/**
+ *  @brief A result of a partial execution of a query
+ *
+ *  The key (unit, after) gives the position of the result in the single-threaded sequence.
+ */
+struct LayoutQueryResult
+{
+  LayoutQueryResult (size_t _unit, bool _after)
+    : unit (_unit), after (_after)
+  {
+    //  .. nothing yet ..
+  }
+
+  bool operator< (const LayoutQueryResult &other) const
+  {
+    if (unit != other.unit) {
+      return unit < other.unit;
+    }
+    return after < other.after;
+  }
+
+  size_t unit;
+  bool after;
+  tl::Variant data;
+};
+
+static bool
+less_result_ptr (const LayoutQueryResult *a, const LayoutQueryResult *b)
+{
+  return *a < *b;
+}
+
+class LayoutQueryWorker
+  : public tl::Worker
+{
+public:
+  LayoutQueryWorker ()
+    : tl::Worker ()
+  {
+    //  .. nothing yet ..
+  }
+
+  virtual void perform_task (tl::Task *task);
+
+  static void collect_partition (const LayoutQuery *query, const db::Layout *layout, tl::Eval *context, const std::vector<int> &ids, unsigned int partition, unsigned int partitions, std::vector<LayoutQueryResult> &results)
+  {
+    LayoutQueryIterator iq (*query, layout, context, partition, partitions);
+    while (! iq.at_end ()) {
+
+      size_t unit = 0;
+      bool after = false;
+      iq.unit_key (unit, after);
+
+      results.push_back (LayoutQueryResult (unit, after));
+
+      tl::Variant &row = results.back ().data;
+      std::vector<tl::Variant> vd;
+      row = tl::Variant (vd.begin (), vd.end ());
+
+      for (std::vector<int>::const_iterator i = ids.begin (); i != ids.end (); ++i) {
+
+        row.push (tl::Variant ());
+        tl::Variant &v = row.get_list ().back ();
+
+        if (*i >= 0) {
+          iq.get ((unsigned int) *i, v);
+          //  shapes and instances may be delivered as references to the state objects
+          if (v.is_user () && v.user_is_ref () && (v.is_user<db::Shape> () || v.is_user<db::Instance> ())) {
+            v = v.user_dup ();
+          }
+        }
+
+      }
+
+      ++iq;
+
+    }
+  }
+};
+
+class LayoutQueryTask
+  : public tl::Task
+{
+public:
+  LayoutQueryTask (const LayoutQuery *query, const db::Layout *layout, tl::Eval *context, const std::vector<int> *ids, unsigned int partition, unsigned int partitions, std::vector<LayoutQueryResult> *results)
+    : mp_query (query), mp_layout (layout), mp_context (context), mp_ids (ids), m_partition (partition), m_partitions (partitions), mp_results (results)
+  {
+    //  .. nothing yet ..
+  }
+
+  void perform ()
+  {
+    LayoutQueryWorker::collect_partition (mp_query, mp_layout, mp_context, *mp_ids, m_partition, m_partitions, *mp_results);
+  }
+
+private:
+  const LayoutQuery *mp_query;
+  const db::Layout *mp_layout;
+  tl::Eval *mp_context;
+  const std::vector<int> *mp_ids;
+  unsigned int m_partition, m_partitions;
+  std::vector<LayoutQueryResult> *mp_results;
+};
+
+void
+LayoutQueryWorker::perform_task (tl::Task *task)
+{
+  static_cast<LayoutQueryTask *> (task)->perform ();
+}
+
+void
+LayoutQuery::collect (const db::Layout &layout, const std::vector<std::string> &properties, std::vector<tl::Variant> &rows, unsigned int threads, tl::Eval *context) const
+{
+  std::vector<int> ids;
+  ids.reserve (properties.size ());
+  for (std::vector<std::string>::const_iterator p = properties.begin (); p != properties.end (); ++p) {
+    ids.push_back (has_property (*p) ? int (property_by_name (*p)) : -1);
+  }
+
+  unsigned int partitions = 1;
+  if (threads > 0 && can_run_parallel ()) {
+    partitions = threads;
+  } else {
+    threads = 0;
+  }
+
+  std::vector<std::vector<LayoutQueryResult> > results (partitions);
+
+  //  Bring the layout into a consistent state before the workers start reading it and
+  //  avoid update() calls while iterating
+  layout.update ();
+  db::Layout &ly = const_cast<db::Layout &> (layout);
+  ly.start_changes ();
+
+  try {
+
+    if (threads == 0) {
+
+      LayoutQueryWorker::collect_partition (this, &layout, context, ids, 0, 1, results.front ());
+
+    } else {
+
+      tl::Job<LayoutQueryWorker> job (threads);
+      for (unsigned int i = 0; i < partitions; ++i) {
+        job.schedule (new LayoutQueryTask (this, &layout, context, &ids, i, partitions, &results [i]));
+      }
+
+      try {
+        job.start ();
+        job.wait ();
+      } catch (...) {
+        job.terminate ();
+        throw;
+      }
+
+      if (job.has_error ()) {
+        throw tl::Exception (job.error_messages ().front ());
+      }
+
+    }
+
+  } catch (...) {
+    ly.end_changes ();
+    throw;
+  }
+
+  ly.end_changes ();
+
+  //  Merge the results: for a given key, all results come from one partition and are
+  //  in the right order already, hence a stable sort restores the single-threaded order.
+
+  std::vector<LayoutQueryResult *> sorted;
+  for (std::vector<std::vector<LayoutQueryResult> >::iterator r = results.begin (); r != results.end (); ++r) {
+    for (std::vector<LayoutQueryResult>::iterator i = r->begin (); i != r->end (); ++i) {
+      sorted.push_back (i.operator-> ());
+    }
+  }
+
+  std::stable_sort (sorted.begin (), sorted.end (), &less_result_ptr);
+
+  rows.reserve (rows.size () + sorted.size ());
+  for (std::vector<LayoutQueryResult *>::const_iterator s = sorted.begin (); s != sorted.end (); ++s) {
+    rows.push_back (tl::Variant ());
+    rows.back ().swap ((*s)->data);
+  }
+}
+
+bool
+LayoutQuery::can_run_parallel () const
+{
+  return mp_root->can_run_parallel ();
 }
 
 // --------------------------------------------------------------------------------
@@ -2958,6 +3302,17 @@ FilterBracket::dump (unsigned int l) const
   }
 }
 
+bool
+FilterBracket::can_run_parallel () const
+{
+  for (std::vector<FilterBase *>::const_iterator c = m_children.begin (); c != m_children.end (); ++c) {
+    if (! (*c)->can_run_parallel ()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void
 FilterBracket::optimize ()
 {
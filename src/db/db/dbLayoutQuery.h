@@ -107,6 +107,17 @@ public:
    */
   virtual void dump (unsigned int l) const;
 
+  /**
+   *  @brief Returns a value indicating whether the filter can be executed by multiple threads
+   *
+   *  Filters which modify the layout or which need to see all results (i.e. for sorting)
+   *  must return false here.
+   */
+  virtual bool can_run_parallel () const
+  {
+    return true;
+  }
+
   /**
    *  @brief Gets the follower filters (const version)
    */
@@ -246,6 +257,11 @@ public:
    */
   virtual void dump (unsigned int l) const;
 
+  /**
+   *  @brief Implementation of can_run_parallel
+   */
+  virtual bool can_run_parallel () const;
+
   /**
    *  @brief Optimize the bracket - reduce the complexity where possible
    */
@@ -362,6 +378,17 @@ public:
     return mp_previous && mp_previous->get_property (id, v);
   }
 
+  /**
+   *  @brief Returns a value indicating whether this state delivers multiple independent items
+   *
+   *  The items of the first enumerating state are used to partition the work if the
+   *  query is executed by multiple threads.
+   */
+  virtual bool is_enumerating () const
+  {
+    return false;
+  }
+
   /**
    *  @brief Gets the child state for the current state
    *
@@ -534,6 +561,27 @@ public:
    *  The context provides a way to define variables and functions.
    */
   void execute (db::Layout &layout, tl::Eval *context = 0);
+
+  /**
+   *  @brief Returns a value indicating whether the query can be executed by multiple threads
+   *
+   *  This is the case for read-only queries without sorting.
+   */
+  bool can_run_parallel () const;
+
+  /**
+   *  @brief Collects the given properties for all results of the query
+   *
+   *  For each result, one list of values is added to "rows". The values correspond to the
+   *  properties given by name. Properties not available for a result are nil.
+   *
+   *  If "threads" is larger than zero and the query can run in parallel, the query is
+   *  executed by this number of worker threads, each with its own expression evaluation
+   *  context derived from "context". The results are delivered in the same order as
+   *  the single-threaded iteration would deliver them. Expressions used inside the query
+   *  must not have side effects in this case.
+   */
+  void collect (const db::Layout &layout, const std::vector<std::string> &properties, std::vector<tl::Variant> &rows, unsigned int threads = 0, tl::Eval *context = 0) const;
   
   /**
    *  @brief A dump method (for debugging)
@@ -585,6 +633,20 @@ public:
    */
   LayoutQueryIterator (const LayoutQuery &q, const db::Layout *layout, tl::Eval *parent_eval = 0, tl::AbsoluteProgress *progress = 0);
 
+  /**
+   *  @brief Constructor for the prefetching mode
+   *
+   *  In this mode, the results are computed in advance using LayoutQuery::collect with the
+   *  given number of threads. Only the given properties are available through "get".
+   *  "next" does not support skipping in this mode.
+   *
+   *  @param q The query that this iterator walks over
+   *  @param layout The layout to which the query is applied
+   *  @param properties The names of the properties to collect
+   *  @param threads The number of worker threads
+   */
+  LayoutQueryIterator (const LayoutQuery &q, const db::Layout *layout, const std::vector<std::string> &properties, unsigned int threads, tl::Eval *parent_eval = 0);
+
   /**
    *  @brief Destructor
    */
@@ -674,11 +736,33 @@ private:
   db::LayoutContextHandler m_layout_ctx;
   tl::AbsoluteProgress *mp_progress;
   bool m_initialized;
+  bool m_in_changes;
+
+  //  partitioning for the multi-threaded mode
+  unsigned int m_partition, m_partitions;
+  size_t m_partition_depth;
+  size_t m_units;
+
+  //  prefetching mode
+  bool m_prefetch;
+  unsigned int m_threads;
+  tl::Eval *mp_parent_eval;
+  std::vector<std::string> m_properties;
+  std::vector<int> m_columns;
+  std::vector<tl::Variant> m_rows;
+  size_t m_row;
+
+  friend class LayoutQueryWorker;
+
+  LayoutQueryIterator (const LayoutQuery &q, const db::Layout *layout, tl::Eval *parent_eval, unsigned int partition, unsigned int partitions);
 
   void ensure_initialized ();
   void collect (FilterStateBase *state, std::set<FilterStateBase *> &states);
   void next_up (bool skip);
   bool next_down ();
+  bool in_partition () const;
+  bool owns_result () const;
+  void unit_key (size_t &unit, bool &after) const;
   void cleanup ();
   void init ();
 
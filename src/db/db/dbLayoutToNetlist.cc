@@ -1261,10 +1261,10 @@ db::Region LayoutToNetlist::antenna_check (const db::Region &gate, double gate_p
 }
 
 
-void LayoutToNetlist::save (const std::string &path, bool short_format)
+void LayoutToNetlist::save (const std::string &path, bool short_format, bool binary)
 {
   tl::OutputStream stream (path);
-  db::LayoutToNetlistStandardWriter writer (stream, short_format);
+  db::LayoutToNetlistStandardWriter writer (stream, short_format, binary);
   set_filename (path);
   writer.write (this);
 }
@@ -1286,8 +1286,12 @@ db::LayoutToNetlist *LayoutToNetlist::create_from_file (const std::string &path)
   std::string first_line;
   {
     tl::InputStream stream (path);
-    tl::TextInputStream text_stream (stream);
-    first_line = text_stream.get_line ();
+    if (db::l2n_binary_format::is_binary (stream)) {
+      first_line = db::l2n_binary_format::first_comment (stream);
+    } else {
+      tl::TextInputStream text_stream (stream);
+      first_line = text_stream.get_line ();
+    }
   }
 
   if (first_line.find (db::lvs_std_format::keys<false>::lvs_magic_string) == 0) {
@@ -1302,6 +1306,32 @@ db::LayoutToNetlist *LayoutToNetlist::create_from_file (const std::string &path)
   return db.release ();
 }
 
+void LayoutToNetlist::mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, bool no_self, void *parent) const
+{
+  if (! no_self) {
+    stat->add (typeid (*this), (void *) this, sizeof (*this), sizeof (*this), parent, purpose, cat);
+  }
+
+  db::mem_stat (stat, purpose, cat, m_description, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_name, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_original_file, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_filename, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_dlrefs, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_named_regions, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_name_of_layer, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_generator, true, (void *) this);
+
+  m_net_clusters.mem_stat (stat, MemStatistics::Clusters, cat, true, (void *) this);
+
+  if (mp_netlist.get ()) {
+    mp_netlist->mem_stat (stat, MemStatistics::NetlistInfo, cat, false, (void *) this);
+  }
+
+  if (mp_internal_dss.get ()) {
+    mp_internal_dss->mem_stat (stat, MemStatistics::DeepShapeStoreInfo, cat, false, (void *) this);
+  }
+}
+
 void LayoutToNetlist::set_generator (const std::string &g)
 {
   m_generator = g;
@@ -765,11 +765,12 @@ public:
    *  @brief Saves the database to the given path
    *
    *  Currently, the internal format will be used. If "short_format" is true, the short version
-   *  of the format is used.
+   *  of the format is used. If "binary" is true, the compact binary container is written.
+   *  The binary container is detected automatically by "load".
    *
    *  This is a convenience method. The low-level functionality is the LayoutToNetlistWriter.
    */
-  void save (const std::string &path, bool short_format);
+  void save (const std::string &path, bool short_format, bool binary = false);
 
   /**
    *  @brief Loads the database from the given path
@@ -788,6 +789,14 @@ public:
    */
   static db::LayoutToNetlist *create_from_file (const std::string &path);
 
+  /**
+   *  @brief Collects memory statistics
+   *
+   *  The net clusters are reported with the "Clusters" purpose and the netlist with the
+   *  "NetlistInfo" purpose. An internal deep shape store is included, an external one is not.
+   */
+  void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, bool no_self = false, void *parent = 0) const;
+
 private:
   //  no copying
   LayoutToNetlist (const db::LayoutToNetlist &other);
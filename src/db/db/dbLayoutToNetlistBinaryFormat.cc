@@ -0,0 +1,638 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2020 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#include "dbLayoutToNetlistBinaryFormat.h"
+#include "tlString.h"
+#include "tlInternational.h"
+
+#include <cstring>
+#include <cctype>
+
+namespace db
+{
+
+namespace l2n_binary_format
+{
+
+static const char magic [] = "KLNB\002";
+static const size_t magic_length = 5;
+
+enum token_codes
+{
+  code_open = 0x01,
+  code_close = 0x02,
+  code_int = 0x03,
+  code_word_def = 0x04,
+  code_word_ref = 0x05,
+  code_quoted_def = 0x06,
+  code_quoted_ref = 0x07,
+  code_comment = 0x08,
+  code_point = 0x09,
+  code_short_word_ref_open = 0x40,
+  code_short_word_ref = 0x80
+};
+
+/**
+ *  @brief Returns true if the given data starts with the magic bytes of a container of a known version
+ */
+static bool is_magic (const char *cp)
+{
+  //  version 1 is a subset of version 2
+  return memcmp (cp, magic, magic_length - 1) == 0 && (cp [magic_length - 1] == '\001' || cp [magic_length - 1] == '\002');
+}
+
+bool is_binary (tl::InputStream &stream)
+{
+  const char *cp = stream.get (magic_length);
+  if (! cp) {
+    return false;
+  }
+
+  bool res = is_magic (cp);
+  stream.unget (magic_length);
+  return res;
+}
+
+std::string first_comment (tl::InputStream &stream)
+{
+  if (! is_binary (stream)) {
+    return std::string ();
+  }
+
+  TokenDecoder decoder (stream);
+  return decoder.read_comment ();
+}
+
+// -------------------------------------------------------------------------------------------
+//  TokenEncoder implementation
+
+/**
+ *  @brief Returns true, if the word is an integer number which can be restored exactly from the binary representation
+ */
+static bool is_canonical_int (const std::string &w, int64_t &v)
+{
+  const char *cp = w.c_str ();
+
+  bool neg = false;
+  if (*cp == '-') {
+    neg = true;
+    ++cp;
+  }
+
+  //  no leading zeros, no "-0"
+  if (! *cp || (*cp == '0' && (cp [1] || neg))) {
+    return false;
+  }
+
+  uint64_t a = 0;
+  int n = 0;
+  for ( ; *cp; ++cp, ++n) {
+    if (! isdigit (*cp) || n == 18) {
+      return false;
+    }
+    a = a * 10 + uint64_t (*cp - '0');
+  }
+
+  v = neg ? -int64_t (a) : int64_t (a);
+  return true;
+}
+
+static bool is_word_char (char c)
+{
+  return c && ! isspace (c) && c != ',' && c != '(' && c != ')' && c != '\'' && c != '"';
+}
+
+TokenEncoder::TokenEncoder (tl::OutputStream &stream)
+  : mp_stream (&stream)
+{
+  put (magic, magic_length);
+}
+
+void
+TokenEncoder::write (const char *b, size_t n)
+{
+  const char *e = b + n;
+  while (b != e) {
+
+    const char *nl = (const char *) memchr (b, '\n', e - b);
+    if (! nl) {
+      m_line.append (b, e - b);
+      break;
+    }
+
+    m_line.append (b, nl - b);
+    encode_line ();
+    m_line.clear ();
+
+    b = nl + 1;
+
+  }
+}
+
+void
+TokenEncoder::finish ()
+{
+  encode_line ();
+  m_line.clear ();
+
+  mp_stream->flush ();
+}
+
+void
+TokenEncoder::put (const char *b, size_t n)
+{
+  mp_stream->put (b, n);
+}
+
+void
+TokenEncoder::put_code (int code)
+{
+  char c = char (code);
+  put (&c, 1);
+}
+
+void
+TokenEncoder::put_varint (uint64_t v)
+{
+  char b [10];
+  size_t n = 0;
+  while (v >= 0x80) {
+    b [n++] = char ((v & 0x7f) | 0x80);
+    v >>= 7;
+  }
+  b [n++] = char (v);
+  put (b, n);
+}
+
+void
+TokenEncoder::put_bytes (const std::string &s)
+{
+  put_varint (s.size ());
+  put (s.c_str (), s.size ());
+}
+
+void
+TokenEncoder::put_string (char def_code, char ref_code, const std::string &s)
+{
+  std::unordered_map<std::string, size_t>::const_iterator i = m_word_ids.find (s);
+  if (i != m_word_ids.end ()) {
+
+    if (ref_code == char (code_word_ref) && i->second < 0x80) {
+      put_code (code_short_word_ref | int (i->second));
+    } else {
+      put (&ref_code, 1);
+      put_varint (i->second);
+    }
+
+  } else {
+
+    size_t id = m_word_ids.size ();
+    m_word_ids.insert (std::make_pair (s, id));
+
+    put (&def_code, 1);
+    put_bytes (s);
+
+  }
+}
+
+void
+TokenEncoder::encode_line ()
+{
+  tl::Extractor ex (m_line.c_str ());
+
+  if (*ex.skip () == '#') {
+    put_code (code_comment);
+    put_bytes (std::string (ex.get ()));
+    return;
+  }
+
+  //  tokenize the line
+
+  std::vector<Token> tokens;
+
+  while (! ex.at_end ()) {
+
+    char c = *ex.skip ();
+
+    if (c == ',') {
+
+      ++ex;
+
+    } else if (c == '(') {
+
+      ++ex;
+      tokens.push_back (Token (OpenBracket));
+
+    } else if (c == ')') {
+
+      ++ex;
+      tokens.push_back (Token (CloseBracket));
+
+    } else if (c == '\'' || c == '"') {
+
+      std::string s;
+      ex.read_quoted (s);
+      tokens.push_back (Token (Quoted, 0, s));
+
+    } else {
+
+      const char *cp0 = ex.get ();
+      const char *cp = cp0;
+
+      if (c == '{' || c == '[') {
+        //  array or user type variant: use the variant parser to find the end of the literal
+        tl::Extractor vex (cp0);
+        tl::Variant v;
+        vex.read (v);
+        cp = vex.get ();
+      } else {
+        while (is_word_char (*cp)) {
+          ++cp;
+        }
+      }
+
+      std::string w (cp0, cp - cp0);
+      ex = tl::Extractor (cp);
+
+      int64_t v = 0;
+      if (is_canonical_int (w, v)) {
+        tokens.push_back (Token (Int, v));
+      } else {
+        tokens.push_back (Token (Word, 0, w));
+      }
+
+    }
+
+  }
+
+  //  encode the tokens
+
+  for (size_t i = 0; i < tokens.size (); ) {
+
+    const Token &t = tokens [i];
+
+    bool is_point = (i + 3 < tokens.size () && tokens [i].type == OpenBracket && tokens [i + 1].type == Int && tokens [i + 2].type == Int && tokens [i + 3].type == CloseBracket);
+
+    if (is_point) {
+
+      put_code (code_point);
+      put_varint ((uint64_t (tokens [i + 1].value) << 1) ^ uint64_t (tokens [i + 1].value >> 63));
+      put_varint ((uint64_t (tokens [i + 2].value) << 1) ^ uint64_t (tokens [i + 2].value >> 63));
+      i += 4;
+
+    } else if (t.type == OpenBracket) {
+
+      put_code (code_open);
+      ++i;
+
+    } else if (t.type == CloseBracket) {
+
+      put_code (code_close);
+      ++i;
+
+    } else if (t.type == Int) {
+
+      put_code (code_int);
+      put_varint ((uint64_t (t.value) << 1) ^ uint64_t (t.value >> 63));
+      ++i;
+
+    } else if (t.type == Quoted) {
+
+      put_string (char (code_quoted_def), char (code_quoted_ref), t.text);
+      ++i;
+
+    } else {
+
+      bool with_open = (i + 1 < tokens.size () && tokens [i + 1].type == OpenBracket);
+      bool next_is_point = (i + 4 < tokens.size () && tokens [i + 2].type == Int && tokens [i + 3].type == Int && tokens [i + 4].type == CloseBracket);
+
+      if (with_open && ! next_is_point) {
+
+        std::unordered_map<std::string, size_t>::const_iterator id = m_word_ids.find (t.text);
+        if (id != m_word_ids.end () && id->second < 0x40) {
+          put_code (code_short_word_ref_open | int (id->second));
+        } else {
+          put_string (char (code_word_def), char (code_word_ref), t.text);
+          put_code (code_open);
+        }
+
+        i += 2;
+
+      } else {
+
+        put_string (char (code_word_def), char (code_word_ref), t.text);
+        ++i;
+
+      }
+
+    }
+
+  }
+}
+
+// -------------------------------------------------------------------------------------------
+//  TokenDecoder implementation
+
+TokenDecoder::TokenDecoder (tl::InputStream &stream)
+  : mp_stream (&stream), m_position (0), m_type (None), m_int (0), m_string_id (0)
+{
+  const char *cp = mp_stream->get (magic_length);
+  if (! cp || ! is_magic (cp)) {
+    error (tl::to_string (tr ("Not a binary L2N or LVS database file")));
+  }
+  m_position += magic_length;
+}
+
+void
+TokenDecoder::error (const std::string &msg)
+{
+  throw tl::Exception (msg);
+}
+
+unsigned char
+TokenDecoder::get_byte ()
+{
+  const char *cp = mp_stream->get (1);
+  if (! cp) {
+    error (tl::to_string (tr ("Unexpected end of file")));
+  }
+  ++m_position;
+  return (unsigned char) *cp;
+}
+
+uint64_t
+TokenDecoder::get_varint ()
+{
+  uint64_t v = 0;
+  unsigned int s = 0;
+  while (true) {
+    unsigned char b = get_byte ();
+    if (s > 63) {
+      error (tl::to_string (tr ("Integer value overflow")));
+    }
+    v |= uint64_t (b & 0x7f) << s;
+    if ((b & 0x80) == 0) {
+      return v;
+    }
+    s += 7;
+  }
+}
+
+std::string
+TokenDecoder::get_bytes ()
+{
+  size_t n = size_t (get_varint ());
+  if (n == 0) {
+    return std::string ();
+  }
+
+  const char *cp = mp_stream->get (n);
+  if (! cp) {
+    error (tl::to_string (tr ("Unexpected end of file")));
+  }
+  m_position += n;
+  return std::string (cp, n);
+}
+
+size_t
+TokenDecoder::string_id (uint64_t id)
+{
+  if (id >= uint64_t (m_strings.size ())) {
+    error (tl::to_string (tr ("Invalid string reference")));
+  }
+  return size_t (id);
+}
+
+bool
+TokenDecoder::peek ()
+{
+  if (m_type != None) {
+    return true;
+  }
+
+  if (! m_pending.empty ()) {
+    m_type = m_pending.front ().type;
+    m_int = m_pending.front ().value;
+    m_string_id = m_pending.front ().string_id;
+    m_pending.pop_front ();
+    return true;
+  }
+
+  const char *cp = mp_stream->get (1);
+  if (! cp) {
+    return false;
+  }
+  ++m_position;
+
+  unsigned char c = (unsigned char) *cp;
+
+  if (c >= code_short_word_ref) {
+    m_type = Word;
+    m_string_id = string_id (c & 0x7f);
+  } else if (c >= code_short_word_ref_open) {
+    m_type = Word;
+    m_string_id = string_id (c & 0x3f);
+    m_pending.push_back (PendingToken (OpenBracket));
+  } else if (c == code_open) {
+    m_type = OpenBracket;
+  } else if (c == code_close) {
+    m_type = CloseBracket;
+  } else if (c == code_int) {
+    uint64_t v = get_varint ();
+    m_type = Int;
+    m_int = int64_t (v >> 1) ^ -int64_t (v & 1);
+  } else if (c == code_point) {
+    uint64_t x = get_varint ();
+    uint64_t y = get_varint ();
+    m_type = OpenBracket;
+    m_pending.push_back (PendingToken (Int, int64_t (x >> 1) ^ -int64_t (x & 1)));
+    m_pending.push_back (PendingToken (Int, int64_t (y >> 1) ^ -int64_t (y & 1)));
+    m_pending.push_back (PendingToken (CloseBracket));
+  } else if (c == code_word_def || c == code_quoted_def) {
+    m_type = (c == code_word_def ? Word : Quoted);
+    m_strings.push_back (get_bytes ());
+    m_string_id = m_strings.size () - 1;
+  } else if (c == code_word_ref || c == code_quoted_ref) {
+    m_type = (c == code_word_ref ? Word : Quoted);
+    m_string_id = string_id (get_varint ());
+  } else if (c == code_comment) {
+    m_type = Comment;
+    m_comment = get_bytes ();
+  } else {
+    error (tl::sprintf (tl::to_string (tr ("Invalid token code %d")), int (c)));
+  }
+
+  return true;
+}
+
+bool
+TokenDecoder::next ()
+{
+  while (peek ()) {
+    if (m_type != Comment) {
+      return true;
+    }
+    consume ();
+  }
+  return false;
+}
+
+std::string
+TokenDecoder::read_comment ()
+{
+  if (peek () && m_type == Comment) {
+    consume ();
+    return m_comment;
+  } else {
+    return std::string ();
+  }
+}
+
+bool
+TokenDecoder::at_end ()
+{
+  return ! next ();
+}
+
+bool
+TokenDecoder::test (const std::string &token)
+{
+  if (! next ()) {
+    return false;
+  }
+
+  bool match = false;
+
+  if (m_type == Word) {
+    match = (m_strings [m_string_id] == token);
+  } else if (m_type == OpenBracket) {
+    match = (token.size () == 1 && token [0] == '(');
+  } else if (m_type == CloseBracket) {
+    match = (token.size () == 1 && token [0] == ')');
+  } else if (m_type == Int) {
+    //  numerical keys are possible (e.g. "1" for "match" in LVSDB)
+    match = (! token.empty () && (isdigit (token [0]) || token [0] == '-') && tl::to_string (m_int) == token);
+  }
+
+  if (match) {
+    consume ();
+  }
+  return match;
+}
+
+void
+TokenDecoder::expect (const std::string &token)
+{
+  if (! test (token)) {
+    error (tl::sprintf (tl::to_string (tr ("Expected '%s'")), token));
+  }
+}
+
+void
+TokenDecoder::read_word_or_quoted (std::string &s)
+{
+  if (next () && (m_type == Word || m_type == Quoted)) {
+    s = m_strings [m_string_id];
+  } else if (next () && m_type == Int) {
+    s = tl::to_string (m_int);
+  } else {
+    error (tl::to_string (tr ("Expected a word or quoted string")));
+  }
+  consume ();
+}
+
+int64_t
+TokenDecoder::read_int ()
+{
+  int64_t i = 0;
+  if (next () && m_type == Int) {
+    i = m_int;
+  } else if (next () && m_type == Word) {
+    long long ll = 0;
+    tl::Extractor ex (m_strings [m_string_id].c_str ());
+    ex.read (ll);
+    ex.expect_end ();
+    i = int64_t (ll);
+  } else {
+    error (tl::to_string (tr ("Expected an integer value")));
+  }
+  consume ();
+  return i;
+}
+
+double
+TokenDecoder::read_double ()
+{
+  double d = 0.0;
+  if (next () && m_type == Int) {
+    d = double (m_int);
+  } else if (next () && m_type == Word) {
+    tl::Extractor ex (m_strings [m_string_id].c_str ());
+    ex.read (d);
+    ex.expect_end ();
+  } else {
+    error (tl::to_string (tr ("Expected a floating-point value")));
+  }
+  consume ();
+  return d;
+}
+
+void
+TokenDecoder::read_variant (tl::Variant &v)
+{
+  if (! next ()) {
+    error (tl::to_string (tr ("Unexpected end of file")));
+  }
+
+  if (m_type == Quoted) {
+
+    v = tl::Variant (m_strings [m_string_id]);
+    consume ();
+
+  } else if (m_type == Word || m_type == Int) {
+
+    std::string s = (m_type == Word ? m_strings [m_string_id] : tl::to_string (m_int));
+    consume ();
+
+    tl::Extractor ex (s.c_str ());
+    ex.read (v);
+
+  } else if (m_type == OpenBracket) {
+
+    //  a list
+    consume ();
+
+    v = tl::Variant::empty_list ();
+    while (! test (")")) {
+      tl::Variant e;
+      read_variant (e);
+      v.push (e);
+    }
+
+  } else {
+    error (tl::to_string (tr ("Expected a value")));
+  }
+}
+
+}
+
+}
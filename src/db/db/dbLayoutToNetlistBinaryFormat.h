@@ -0,0 +1,209 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2020 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef HDR_dbLayoutToNetlistBinaryFormat
+#define HDR_dbLayoutToNetlistBinaryFormat
+
+#include "dbCommon.h"
+#include "tlStream.h"
+#include "tlVariant.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <stdint.h>
+
+namespace db
+{
+
+/**
+ *  The binary container for the L2N and LVSDB formats
+ *
+ *  The binary container is a token-by-token encoding of the short text
+ *  format (see dbLayoutToNetlistFormatDefs.h and dbLayoutVsSchematicFormatDefs.h).
+ *  Hence the grammar is the same - just the representation of the tokens
+ *  is different:
+ *
+ *    <magic>                     - "KLNB" followed by the version byte (2)
+ *    0x01                        - "("
+ *    0x02                        - ")"
+ *    0x03 <zigzag-varint>        - integer number
+ *    0x04 <varint-len> <bytes>   - word (new string table entry)
+ *    0x05 <varint-index>         - word (string table reference)
+ *    0x06 <varint-len> <bytes>   - quoted string (new string table entry)
+ *    0x07 <varint-index>         - quoted string (string table reference)
+ *    0x08 <varint-len> <bytes>   - comment line (not put into the string table)
+ *    0x09 <zigzag-varint> x 2    - point: "(" followed by two integer numbers and ")"
+ *    0x40+i                      - word (string table reference with index i < 64) followed by "("
+ *    0x80+i                      - word (string table reference with index i < 128)
+ *
+ *  Keys are words and are entered into the string table at the first occurance, hence
+ *  they are usually represented by a single byte. Coordinates are already
+ *  given relative to the previous point by the text format, so they
+ *  are small numbers and the varint representation is compact.
+ *
+ *  Version 1 containers do not use the 0x09 and 0x40+i codes.
+ *
+ *  The container does not provide a per-circuit index for random access: the string
+ *  table is built while streaming, so a circuit's record cannot be decoded without the
+ *  records before it. Readers always decode the whole container and the geometry is
+ *  not loaded lazily.
+ */
+
+namespace l2n_binary_format
+{
+
+/**
+ *  @brief Returns a value indicating whether the stream contains a binary L2N or LVSDB container
+ *
+ *  The stream is not consumed by this function.
+ */
+DB_PUBLIC bool is_binary (tl::InputStream &stream);
+
+/**
+ *  @brief Reads the first comment line of a binary container (the magic string of the text format)
+ *
+ *  This function returns an empty string if the stream is not a binary container.
+ */
+DB_PUBLIC std::string first_comment (tl::InputStream &stream);
+
+/**
+ *  @brief The token encoder
+ *
+ *  The encoder is an output stream delegate which receives the short text format
+ *  and translates it into the binary representation on the fly.
+ *  After the text has been written, "finish" needs to be called.
+ */
+class DB_PUBLIC TokenEncoder
+  : public tl::OutputStreamBase
+{
+public:
+  TokenEncoder (tl::OutputStream &stream);
+
+  virtual void write (const char *b, size_t n);
+
+  /**
+   *  @brief Encodes the remaining text
+   */
+  void finish ();
+
+private:
+  enum token_type { OpenBracket, CloseBracket, Int, Word, Quoted };
+
+  struct Token
+  {
+    Token (token_type _type, int64_t _value = 0, const std::string &_text = std::string ())
+      : type (_type), value (_value), text (_text)
+    { }
+
+    token_type type;
+    int64_t value;
+    std::string text;
+  };
+
+  tl::OutputStream *mp_stream;
+  std::string m_line;
+  std::unordered_map<std::string, size_t> m_word_ids;
+
+  void encode_line ();
+  void put (const char *b, size_t n);
+  void put_code (int code);
+  void put_varint (uint64_t v);
+  void put_bytes (const std::string &s);
+  void put_string (char def_code, char ref_code, const std::string &s);
+};
+
+/**
+ *  @brief The token decoder
+ *
+ *  The decoder provides the primitives needed by the L2N and LVSDB readers.
+ */
+class DB_PUBLIC TokenDecoder
+{
+public:
+  TokenDecoder (tl::InputStream &stream);
+
+  bool at_end ();
+  bool test (const std::string &token);
+  void expect (const std::string &token);
+  void read_word_or_quoted (std::string &s);
+  int64_t read_int ();
+  double read_double ();
+  void read_variant (tl::Variant &v);
+
+  /**
+   *  @brief Reads a comment if the next token is one
+   *
+   *  Returns an empty string otherwise. Comments are skipped by all other read functions.
+   */
+  std::string read_comment ();
+
+  /**
+   *  @brief Gets the current byte position
+   */
+  size_t position () const
+  {
+    return m_position;
+  }
+
+private:
+  enum token_type { None = 0, OpenBracket, CloseBracket, Int, Word, Quoted, Comment };
+
+  struct PendingToken
+  {
+    PendingToken (token_type _type, int64_t _value = 0, size_t _string_id = 0)
+      : type (_type), value (_value), string_id (_string_id)
+    { }
+
+    token_type type;
+    int64_t value;
+    size_t string_id;
+  };
+
+  tl::InputStream *mp_stream;
+  size_t m_position;
+  token_type m_type;
+  int64_t m_int;
+  size_t m_string_id;
+  std::string m_comment;
+  std::vector<std::string> m_strings;
+  std::deque<PendingToken> m_pending;
+
+  bool peek ();
+  bool next ();
+  void consume ()
+  {
+    m_type = None;
+  }
+  unsigned char get_byte ();
+  uint64_t get_varint ();
+  std::string get_bytes ();
+  size_t string_id (uint64_t id);
+  void error (const std::string &msg);
+};
+
+}
+
+}
+
+#endif
\ No newline at end of file
@@ -63,16 +63,33 @@ LayoutToNetlistStandardReader::LayoutToNetlistStandardReader (tl::InputStream &s
   : m_stream (stream), m_path (stream.absolute_path ()), m_dbu (0.0),
     m_progress (tl::to_string (tr ("Reading L2N database")), 1000)
 {
-  m_progress.set_format (tl::to_string (tr ("%.0fk lines")));
-  m_progress.set_format_unit (1000.0);
-  m_progress.set_unit (100000.0);
+  if (l2n_binary_format::is_binary (stream)) {
 
-  skip ();
+    mp_binary.reset (new l2n_binary_format::TokenDecoder (stream));
+
+    m_progress.set_format (tl::to_string (tr ("%.0f MB")));
+    m_progress.set_format_unit (1024.0 * 1024.0);
+    m_progress.set_unit (1024.0 * 1024.0);
+
+  } else {
+
+    m_progress.set_format (tl::to_string (tr ("%.0fk lines")));
+    m_progress.set_format_unit (1000.0);
+    m_progress.set_unit (100000.0);
+
+    skip ();
+
+  }
 }
 
 bool
 LayoutToNetlistStandardReader::test (const std::string &token)
 {
+  if (mp_binary.get ()) {
+    m_progress.set (mp_binary->position ());
+    return mp_binary->test (token);
+  }
+
   skip ();
   return ! at_end () && m_ex.test (token.c_str ());
 }
@@ -80,18 +97,30 @@ LayoutToNetlistStandardReader::test (const std::string &token)
 void
 LayoutToNetlistStandardReader::expect (const std::string &token)
 {
-  m_ex.expect (token.c_str ());
+  if (mp_binary.get ()) {
+    mp_binary->expect (token);
+  } else {
+    m_ex.expect (token.c_str ());
+  }
 }
 
 void
 LayoutToNetlistStandardReader::read_word_or_quoted (std::string &s)
 {
-  m_ex.read_word_or_quoted (s);
+  if (mp_binary.get ()) {
+    mp_binary->read_word_or_quoted (s);
+  } else {
+    m_ex.read_word_or_quoted (s);
+  }
 }
 
 int
 LayoutToNetlistStandardReader::read_int ()
 {
+  if (mp_binary.get ()) {
+    return int (mp_binary->read_int ());
+  }
+
   int i = 0;
   m_ex.read (i);
   return i;
@@ -100,6 +129,10 @@ LayoutToNetlistStandardReader::read_int ()
 db::Coord
 LayoutToNetlistStandardReader::read_coord ()
 {
+  if (mp_binary.get ()) {
+    return db::Coord (mp_binary->read_int ());
+  }
+
   db::Coord i = 0;
   m_ex.read (i);
   return i;
@@ -108,14 +141,32 @@ LayoutToNetlistStandardReader::read_coord ()
 double
 LayoutToNetlistStandardReader::read_double ()
 {
+  if (mp_binary.get ()) {
+    return mp_binary->read_double ();
+  }
+
   double d = 0;
   m_ex.read (d);
   return d;
 }
 
+void
+LayoutToNetlistStandardReader::read_variant (tl::Variant &v)
+{
+  if (mp_binary.get ()) {
+    mp_binary->read_variant (v);
+  } else {
+    m_ex.read (v);
+  }
+}
+
 bool
 LayoutToNetlistStandardReader::at_end ()
 {
+  if (mp_binary.get ()) {
+    return mp_binary->at_end ();
+  }
+
   skip ();
   return (m_ex.at_end () && m_stream.at_end ());
 }
@@ -123,6 +174,10 @@ LayoutToNetlistStandardReader::at_end ()
 void
 LayoutToNetlistStandardReader::skip ()
 {
+  if (mp_binary.get ()) {
+    return;
+  }
+
   while (m_ex.at_end () || *m_ex.skip () == '#') {
     if (m_stream.at_end ()) {
       return;
@@ -133,6 +188,16 @@ LayoutToNetlistStandardReader::skip ()
   }
 }
 
+std::string
+LayoutToNetlistStandardReader::format_error (const std::string &msg)
+{
+  if (mp_binary.get ()) {
+    return tl::sprintf (tl::to_string (tr ("%s at position: %lu of %s")), msg, (unsigned long) mp_binary->position (), m_path);
+  } else {
+    return tl::sprintf (tl::to_string (tr ("%s in line: %d of %s")), msg, m_stream.line_number (), m_path);
+  }
+}
+
 void LayoutToNetlistStandardReader::do_read (db::LayoutToNetlist *l2n)
 {
   tl::SelfTimer timer (tl::verbosity () >= 21, tl::to_string (tr ("File read: ")) + m_path);
@@ -140,7 +205,7 @@ void LayoutToNetlistStandardReader::do_read (db::LayoutToNetlist *l2n)
   try {
     read_netlist (0, l2n);
   } catch (tl::Exception &ex) {
-    throw tl::Exception (tl::sprintf (tl::to_string (tr ("%s in line: %d of %s")), ex.msg (), m_stream.line_number (), m_path));
+    throw tl::Exception (format_error (ex.msg ()));
   }
 }
 
@@ -435,8 +500,8 @@ LayoutToNetlistStandardReader::read_property (db::NetlistObject *obj)
   Brace br (this);
 
   tl::Variant k, v;
-  m_ex.read (k);
-  m_ex.read (v);
+  read_variant (k);
+  read_variant (v);
 
   if (obj) {
     obj->set_property (k, v);
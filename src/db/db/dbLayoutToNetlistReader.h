@@ -27,6 +27,7 @@
 #include "dbPolygon.h"
 #include "dbCell.h"
 #include "dbLayoutToNetlist.h"
+#include "dbLayoutToNetlistBinaryFormat.h"
 #include "tlStream.h"
 #include "tlProgress.h"
 
@@ -130,8 +131,10 @@ protected:
   int read_int ();
   db::Coord read_coord ();
   double read_double ();
+  void read_variant (tl::Variant &v);
   bool at_end ();
   void skip ();
+  std::string format_error (const std::string &msg);
 
   void read_net (Netlist *netlist, db::LayoutToNetlist *l2n, db::Circuit *circuit, ObjectMap &map);
   void read_pin (Netlist *netlist, db::LayoutToNetlist *l2n, db::Circuit *circuit, ObjectMap &map);
@@ -154,6 +157,7 @@ private:
   tl::Extractor m_ex;
   db::Point m_ref;
   tl::AbsoluteProgress m_progress;
+  std::auto_ptr<l2n_binary_format::TokenDecoder> mp_binary;
 };
 
 }
@@ -23,6 +23,7 @@
 #include "dbLayoutToNetlistWriter.h"
 #include "dbLayoutToNetlist.h"
 #include "dbLayoutToNetlistFormatDefs.h"
+#include "dbLayoutToNetlistBinaryFormat.h"
 #include "dbPolygonTools.h"
 
 namespace db
@@ -728,8 +729,8 @@ template class std_writer_impl<l2n_std_format::keys<true> >;
 // -------------------------------------------------------------------------------------------
 //  LayoutToNetlistStandardWriter implementation
 
-LayoutToNetlistStandardWriter::LayoutToNetlistStandardWriter (tl::OutputStream &stream, bool short_version)
-  : mp_stream (&stream), m_short_version (short_version)
+LayoutToNetlistStandardWriter::LayoutToNetlistStandardWriter (tl::OutputStream &stream, bool short_version, bool binary)
+  : mp_stream (&stream), m_short_version (short_version), m_binary (binary)
 {
   //  .. nothing yet ..
 }
@@ -745,7 +746,18 @@ void LayoutToNetlistStandardWriter::do_write (const db::LayoutToNetlist *l2n)
 
   double dbu = l2n->internal_layout ()->dbu ();
 
-  if (m_short_version) {
+  if (m_binary) {
+
+    //  the binary container is produced by translating the short text format on the fly
+    l2n_binary_format::TokenEncoder encoder (*mp_stream);
+    {
+      tl::OutputStream text_stream (encoder);
+      l2n_std_format::std_writer_impl<l2n_std_format::keys<true> > writer (text_stream, dbu);
+      writer.write (l2n);
+    }
+    encoder.finish ();
+
+  } else if (m_short_version) {
     l2n_std_format::std_writer_impl<l2n_std_format::keys<true> > writer (*mp_stream, dbu);
     writer.write (l2n);
   } else {
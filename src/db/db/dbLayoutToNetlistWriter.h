@@ -113,7 +113,13 @@ class DB_PUBLIC LayoutToNetlistStandardWriter
   : public LayoutToNetlistWriterBase
 {
 public:
-  LayoutToNetlistStandardWriter (tl::OutputStream &stream, bool short_version);
+  /**
+   *  @brief Constructor
+   *
+   *  If "binary" is true, the binary container is written (see dbLayoutToNetlistBinaryFormat.h).
+   *  The binary container always uses the short keys.
+   */
+  LayoutToNetlistStandardWriter (tl::OutputStream &stream, bool short_version, bool binary = false);
 
 protected:
   void do_write (const db::LayoutToNetlist *l2n);
@@ -121,6 +127,7 @@ protected:
 private:
   tl::OutputStream *mp_stream;
   bool m_short_version;
+  bool m_binary;
 };
 
 }
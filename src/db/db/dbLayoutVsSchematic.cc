@@ -86,10 +86,10 @@ db::NetlistCrossReference *LayoutVsSchematic::make_cross_ref ()
 }
 
 
-void LayoutVsSchematic::save (const std::string &path, bool short_format)
+void LayoutVsSchematic::save (const std::string &path, bool short_format, bool binary)
 {
   tl::OutputStream stream (path);
-  db::LayoutVsSchematicStandardWriter writer (stream, short_format);
+  db::LayoutVsSchematicStandardWriter writer (stream, short_format, binary);
   set_filename (path);
   writer.write (this);
 }
@@ -148,11 +148,12 @@ public:
    *  @brief Saves the database to the given path
    *
    *  Currently, the internal format will be used. If "short_format" is true, the short version
-   *  of the format is used.
+   *  of the format is used. If "binary" is true, the compact binary container is written.
+   *  The binary container is detected automatically by "load".
    *
    *  This is a convenience method. The low-level functionality is the LayoutVsSchematicWriter.
    */
-  void save (const std::string &path, bool short_format);
+  void save (const std::string &path, bool short_format, bool binary = false);
 
   /**
    *  @brief Loads the database from the given path
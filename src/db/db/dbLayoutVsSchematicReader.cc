@@ -43,7 +43,7 @@ void LayoutVsSchematicStandardReader::do_read_lvs (db::LayoutVsSchematic *l2n)
   try {
     read_netlist (l2n);
   } catch (tl::Exception &ex) {
-    throw tl::Exception (tl::sprintf (tl::to_string (tr ("%s in line: %d of %s")), ex.msg (), stream ().line_number (), path ()));
+    throw tl::Exception (format_error (ex.msg ()));
   }
 }
 
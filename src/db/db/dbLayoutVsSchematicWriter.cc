@@ -24,6 +24,7 @@
 #include "dbLayoutVsSchematicWriter.h"
 #include "dbLayoutVsSchematic.h"
 #include "dbLayoutVsSchematicFormatDefs.h"
+#include "dbLayoutToNetlistBinaryFormat.h"
 
 namespace db
 {
@@ -212,8 +213,8 @@ void std_writer_impl<Keys>::write (const db::NetlistCrossReference *xref)
 // -------------------------------------------------------------------------------------------
 //  LayoutVsSchematicStandardWriter implementation
 
-LayoutVsSchematicStandardWriter::LayoutVsSchematicStandardWriter (tl::OutputStream &stream, bool short_version)
-  : mp_stream (&stream), m_short_version (short_version)
+LayoutVsSchematicStandardWriter::LayoutVsSchematicStandardWriter (tl::OutputStream &stream, bool short_version, bool binary)
+  : mp_stream (&stream), m_short_version (short_version), m_binary (binary)
 {
   //  .. nothing yet ..
 }
@@ -229,7 +230,18 @@ void LayoutVsSchematicStandardWriter::do_write_lvs (const db::LayoutVsSchematic
 
   double dbu = lvs->internal_layout ()->dbu ();
 
-  if (m_short_version) {
+  if (m_binary) {
+
+    //  the binary container is produced by translating the short text format on the fly
+    l2n_binary_format::TokenEncoder encoder (*mp_stream);
+    {
+      tl::OutputStream text_stream (encoder);
+      lvs_std_format::std_writer_impl<lvs_std_format::keys<true> > writer (text_stream, dbu);
+      writer.write (lvs);
+    }
+    encoder.finish ();
+
+  } else if (m_short_version) {
     lvs_std_format::std_writer_impl<lvs_std_format::keys<true> > writer (*mp_stream, dbu);
     writer.write (lvs);
   } else {
@@ -60,7 +60,13 @@ class DB_PUBLIC LayoutVsSchematicStandardWriter
   : public LayoutVsSchematicWriterBase
 {
 public:
-  LayoutVsSchematicStandardWriter (tl::OutputStream &stream, bool short_version);
+  /**
+   *  @brief Constructor
+   *
+   *  If "binary" is true, the binary container is written (see dbLayoutToNetlistBinaryFormat.h).
+   *  The binary container always uses the short keys.
+   */
+  LayoutVsSchematicStandardWriter (tl::OutputStream &stream, bool short_version, bool binary = false);
 
 protected:
   void do_write_lvs (const db::LayoutVsSchematic *lvs);
@@ -68,6 +74,7 @@ protected:
 private:
   tl::OutputStream *mp_stream;
   bool m_short_version;
+  bool m_binary;
 };
 
 }
@@ -66,6 +66,30 @@ public:
   {
     return m_done;
   }
+
+  /**
+   *  @brief Gets the approximate memory used by this operation in bytes
+   *
+   *  This value is used by the manager to limit the memory of the undo history
+   *  (see Manager::set_max_memory). Operations holding a considerable amount of data
+   *  should reimplement this method.
+   */
+  virtual size_t mem_used () const
+  {
+    return sizeof (Op);
+  }
+
+  /**
+   *  @brief Releases excess memory
+   *
+   *  This method is called when the transaction is committed. Operations which have
+   *  been extended after being queued (see Manager::last_queued) can release the
+   *  excess capacity of their containers here.
+   */
+  virtual void compact ()
+  {
+    //  .. nothing yet ..
+  }
 };
 
 /**
@@ -234,6 +258,33 @@ public:
    */
   void clear ();
 
+  /**
+   *  @brief Sets the memory budget for the undo history in bytes
+   *
+   *  If the operations of the committed transactions require more memory than
+   *  this value, the oldest transactions are discarded. The most recent transaction
+   *  which can be undone is always kept. If that is not sufficient, transactions
+   *  which can be redone are discarded too, starting with the last one.
+   *  A value of 0 (the default) disables the limit.
+   */
+  void set_max_memory (size_t bytes);
+
+  /**
+   *  @brief Gets the memory budget for the undo history in bytes
+   */
+  size_t max_memory () const
+  {
+    return m_max_memory;
+  }
+
+  /**
+   *  @brief Gets the approximate memory used by the committed transactions in bytes
+   */
+  size_t memory_used () const
+  {
+    return m_memory_used;
+  }
+
   /**
    *  @brief Query if we are within a transaction
    */
@@ -256,7 +307,18 @@ private:
 
   typedef std::pair<db::Manager::ident_t, db::Op *> operation_t;
   typedef std::list<operation_t> operations_t;
-  typedef std::pair<operations_t, std::string> transaction_t;
+
+  struct transaction_t
+  {
+    transaction_t (const std::string &d)
+      : description (d), memory (0)
+    { }
+
+    operations_t operations;
+    std::string description;
+    size_t memory;
+  };
+
   typedef std::list<transaction_t> transactions_t;
 
   transactions_t m_transactions;
@@ -264,8 +326,11 @@ private:
   bool m_opened;
   bool m_replay;
   bool m_enabled;
+  size_t m_max_memory;
+  size_t m_memory_used;
 
   void erase_transactions (transactions_t::iterator from, transactions_t::iterator to);
+  void limit_memory ();
 };
 
 /**
@@ -23,6 +23,9 @@
 
 #include "dbMemStatistics.h"
 #include "tlLog.h"
+#include "tlThreads.h"
+
+#include <algorithm>
 
 #ifdef __GNUG__
 #include <memory>
@@ -88,6 +91,83 @@ MemStatistics::MemStatistics ()
   //  .. nothing yet ..
 }
 
+const char *
+MemStatistics::purpose_name (purpose_t purpose)
+{
+  switch (purpose) {
+  case LayoutInfo:
+    return "layout_info";
+  case CellInfo:
+    return "cell_info";
+  case Instances:
+    return "instances";
+  case InstTrees:
+    return "instance_trees";
+  case ShapesInfo:
+    return "shapes_info";
+  case ShapesCache:
+    return "shapes_cache";
+  case ShapeTrees:
+    return "shape_trees";
+  case DeepShapeStoreInfo:
+    return "deep_shape_store";
+  case Clusters:
+    return "clusters";
+  case NetlistInfo:
+    return "netlist";
+  case ProcessorCaches:
+    return "processor_caches";
+  case ReportDatabase:
+    return "report_database";
+  default:
+    return "none";
+  }
+}
+
+// --------------------------------------------------------------------------------------
+
+static tl::Mutex s_peak_lock;
+static bool s_peaks_enabled = false;
+static std::map<MemStatistics::purpose_t, size_t> s_peaks;
+
+void
+MemStatisticsPeakRegistry::set_enabled (bool f)
+{
+  s_peaks_enabled = f;
+}
+
+bool
+MemStatisticsPeakRegistry::is_enabled ()
+{
+  return s_peaks_enabled;
+}
+
+void
+MemStatisticsPeakRegistry::report (MemStatistics::purpose_t purpose, size_t size)
+{
+  tl::MutexLocker locker (&s_peak_lock);
+  size_t &p = s_peaks [purpose];
+  p = std::max (p, size);
+}
+
+std::map<std::string, size_t>
+MemStatisticsPeakRegistry::peaks ()
+{
+  tl::MutexLocker locker (&s_peak_lock);
+  std::map<std::string, size_t> res;
+  for (std::map<MemStatistics::purpose_t, size_t>::const_iterator p = s_peaks.begin (); p != s_peaks.end (); ++p) {
+    res [MemStatistics::purpose_name (p->first)] = p->second;
+  }
+  return res;
+}
+
+void
+MemStatisticsPeakRegistry::reset ()
+{
+  tl::MutexLocker locker (&s_peak_lock);
+  s_peaks.clear ();
+}
+
 // --------------------------------------------------------------------------------------
 
 MemStatisticsCollector::MemStatisticsCollector (bool detailed)
@@ -108,6 +188,11 @@ MemStatisticsCollector::print ()
   p2s[ShapesInfo]  = "Shapes info    ";
   p2s[ShapesCache] = "Shapes cache   ";
   p2s[ShapeTrees]  = "Shape trees    ";
+  p2s[DeepShapeStoreInfo] = "Deep shapes    ";
+  p2s[Clusters]    = "Clusters       ";
+  p2s[NetlistInfo] = "Netlist        ";
+  p2s[ProcessorCaches] = "Proc. caches   ";
+  p2s[ReportDatabase] = "Report DB      ";
 
   if (m_detailed) {
 
@@ -133,6 +218,19 @@ MemStatisticsCollector::print ()
   tl::info << "  Total          : " << tot.first << " (used) " << tot.second << " (reqd)";
 }
 
+std::map<std::string, size_t>
+MemStatisticsCollector::size_per_purpose () const
+{
+  std::map<std::string, size_t> res;
+  size_t tot = 0;
+  for (std::map<purpose_t, std::pair<size_t, size_t> >::const_iterator t = m_per_purpose.begin (); t != m_per_purpose.end (); ++t) {
+    res [purpose_name (t->first)] += t->second.second;
+    tot += t->second.second;
+  }
+  res ["total"] = tot;
+  return res;
+}
+
 void
 MemStatisticsCollector::add (const std::type_info &ti, void * /*ptr*/, size_t size, size_t used, void * /*parent*/, purpose_t purpose, int cat)
 {
@@ -32,6 +32,8 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <unordered_set>
 #include <list>
 #include <typeinfo>
 #include "tlReuseVector.h"
@@ -64,9 +66,20 @@ public:
     InstTrees,
     ShapesInfo,
     ShapesCache,
-    ShapeTrees
+    ShapeTrees,
+    DeepShapeStoreInfo,
+    Clusters,
+    NetlistInfo,
+    ProcessorCaches,
+    ReportDatabase
   };
 
+  /**
+   *  @brief Gets a name for the given purpose
+   *  The name is a short identifier suitable for use as a key in reports.
+   */
+  static const char *purpose_name (purpose_t purpose);
+
   /**
    *  @brief Adds a memory block for a specific object
    *  The object has a purpose (general category), a detailed category (i.e.
@@ -94,6 +107,13 @@ public:
    */
   void print ();
 
+  /**
+   *  @brief Gets the memory allocated per master category
+   *  The keys are the purpose names (see MemStatistics::purpose_name). An
+   *  additional key "total" delivers the sum over all categories.
+   */
+  std::map<std::string, size_t> size_per_purpose () const;
+
   virtual void add (const std::type_info &ti, void *ptr, size_t size, size_t used, void *parent, purpose_t purpose, int cat);
 
 private:
@@ -103,6 +123,82 @@ private:
   std::map<purpose_t, std::pair<size_t, size_t> > m_per_purpose;
 };
 
+/**
+ *  @brief A memory statistics collector which just sums up the memory
+ */
+class DB_PUBLIC MemStatisticsSimple
+  : public MemStatistics
+{
+public:
+  MemStatisticsSimple ()
+    : m_size (0), m_used (0)
+  { }
+
+  /**
+   *  @brief Gets the total memory allocated
+   */
+  size_t size () const
+  {
+    return m_size;
+  }
+
+  /**
+   *  @brief Gets the total memory used
+   */
+  size_t used () const
+  {
+    return m_used;
+  }
+
+  virtual void add (const std::type_info & /*ti*/, void * /*ptr*/, size_t size, size_t used, void * /*parent*/, purpose_t /*purpose*/, int /*cat*/)
+  {
+    m_size += size;
+    m_used += used;
+  }
+
+private:
+  size_t m_size, m_used;
+};
+
+/**
+ *  @brief A registry for the memory usage of transient structures
+ *
+ *  Some structures - such as the context caches of the hierarchical processor - only
+ *  exist while an operation is executed. If the registry is enabled, these structures
+ *  report their memory usage here and the registry keeps the maximum per purpose until
+ *  it is reset. Collecting this information costs time, hence the registry is disabled
+ *  by default.
+ */
+class DB_PUBLIC MemStatisticsPeakRegistry
+{
+public:
+  /**
+   *  @brief Enables or disables the registry
+   */
+  static void set_enabled (bool f);
+
+  /**
+   *  @brief Gets a value indicating whether the registry is enabled
+   */
+  static bool is_enabled ();
+
+  /**
+   *  @brief Reports a memory size for the given purpose
+   */
+  static void report (MemStatistics::purpose_t purpose, size_t size);
+
+  /**
+   *  @brief Gets the peak memory sizes reported since the last reset
+   *  The keys are the purpose names (see MemStatistics::purpose_name).
+   */
+  static std::map<std::string, size_t> peaks ();
+
+  /**
+   *  @brief Resets the peak values
+   */
+  static void reset ();
+};
+
 //  Some standard templates to collect the information
 template <class X>
 void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, const X &x, bool no_self = false, void *parent = 0)
@@ -178,6 +274,19 @@ void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, c
   }
 }
 
+template <class X, class Y, class H>
+void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, const std::unordered_map<X, Y, H> &v, bool no_self = false, void *parent = 0)
+{
+  if (! no_self) {
+    stat->add (typeid (std::unordered_map<X, Y, H>), (void *) &v, sizeof (std::unordered_map<X, Y, H>), sizeof (std::unordered_map<X, Y, H>), parent, purpose, cat);
+  }
+  stat->add (typeid (void *[]), (void *) &v, sizeof (void *) * v.bucket_count (), sizeof (void *) * v.bucket_count (), (void *) &v, purpose, cat);
+  for (typename std::unordered_map<X, Y, H>::const_iterator i = v.begin (); i != v.end (); ++i) {
+    mem_stat (stat, purpose, cat, i->first, false, (void *) &v);
+    mem_stat (stat, purpose, cat, i->second, false, (void *) &v);
+  }
+}
+
 template <class X>
 void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, const std::set<X> &v, bool no_self = false, void *parent = 0)
 {
@@ -192,6 +301,18 @@ void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, c
   }
 }
 
+template <class X, class H>
+void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, const std::unordered_set<X, H> &v, bool no_self = false, void *parent = 0)
+{
+  if (! no_self) {
+    stat->add (typeid (std::unordered_set<X, H>), (void *) &v, sizeof (std::unordered_set<X, H>), sizeof (std::unordered_set<X, H>), parent, purpose, cat);
+  }
+  stat->add (typeid (void *[]), (void *) &v, sizeof (void *) * v.bucket_count (), sizeof (void *) * v.bucket_count (), (void *) &v, purpose, cat);
+  for (typename std::unordered_set<X, H>::const_iterator i = v.begin (); i != v.end (); ++i) {
+    mem_stat (stat, purpose, cat, *i, false, (void *) &v);
+  }
+}
+
 template <class X>
 void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, const std::list<X> &v, bool no_self = false, void *parent = 0)
 {
@@ -976,4 +976,73 @@ void Netlist::from_string (const std::string &s)
   ex.expect_end ();
 }
 
+
+void Netlist::mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, bool no_self, void *parent) const
+{
+  if (! no_self) {
+    stat->add (typeid (*this), (void *) this, sizeof (*this), sizeof (*this), parent, purpose, cat);
+  }
+
+  //  std::list nodes carry two link pointers in addition to the payload
+  const size_t list_node_overhead = 2 * sizeof (void *);
+
+  db::mem_stat (stat, purpose, cat, m_top_down_circuits, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_child_circuits, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_parent_circuits, true, (void *) this);
+
+  for (const_device_class_iterator dc = begin_device_classes (); dc != end_device_classes (); ++dc) {
+    stat->add (typeid (db::DeviceClass), (void *) dc.operator-> (), sizeof (db::DeviceClass), sizeof (db::DeviceClass), (void *) this, purpose, cat);
+    db::mem_stat (stat, purpose, cat, dc->name (), true, (void *) dc.operator-> ());
+    db::mem_stat (stat, purpose, cat, dc->terminal_definitions (), true, (void *) dc.operator-> ());
+    db::mem_stat (stat, purpose, cat, dc->parameter_definitions (), true, (void *) dc.operator-> ());
+  }
+
+  for (const_abstract_model_iterator da = begin_device_abstracts (); da != end_device_abstracts (); ++da) {
+    stat->add (typeid (db::DeviceAbstract), (void *) da.operator-> (), sizeof (db::DeviceAbstract), sizeof (db::DeviceAbstract), (void *) this, purpose, cat);
+    db::mem_stat (stat, purpose, cat, da->name (), true, (void *) da.operator-> ());
+  }
+
+  for (const_circuit_iterator c = begin_circuits (); c != end_circuits (); ++c) {
+
+    const db::Circuit *circuit = c.operator-> ();
+
+    stat->add (typeid (db::Circuit), (void *) circuit, sizeof (db::Circuit), sizeof (db::Circuit), (void *) this, purpose, cat);
+    db::mem_stat (stat, purpose, cat, circuit->name (), true, (void *) circuit);
+
+    for (db::Circuit::const_pin_iterator p = circuit->begin_pins (); p != circuit->end_pins (); ++p) {
+      stat->add (typeid (db::Pin), (void *) p.operator-> (), sizeof (db::Pin), sizeof (db::Pin), (void *) circuit, purpose, cat);
+      db::mem_stat (stat, purpose, cat, p->name (), true, (void *) p.operator-> ());
+    }
+
+    for (db::Circuit::const_net_iterator n = circuit->begin_nets (); n != circuit->end_nets (); ++n) {
+      stat->add (typeid (db::Net), (void *) n.operator-> (), sizeof (db::Net), sizeof (db::Net), (void *) circuit, purpose, cat);
+      db::mem_stat (stat, purpose, cat, n->name (), true, (void *) n.operator-> ());
+      stat->add (typeid (db::NetTerminalRef), 0, n->terminal_count () * (sizeof (db::NetTerminalRef) + list_node_overhead), n->terminal_count () * sizeof (db::NetTerminalRef), (void *) n.operator-> (), purpose, cat);
+      stat->add (typeid (db::NetPinRef), 0, n->pin_count () * (sizeof (db::NetPinRef) + list_node_overhead), n->pin_count () * sizeof (db::NetPinRef), (void *) n.operator-> (), purpose, cat);
+      stat->add (typeid (db::NetSubcircuitPinRef), 0, n->subcircuit_pin_count () * (sizeof (db::NetSubcircuitPinRef) + list_node_overhead), n->subcircuit_pin_count () * sizeof (db::NetSubcircuitPinRef), (void *) n.operator-> (), purpose, cat);
+    }
+
+    for (db::Circuit::const_device_iterator d = circuit->begin_devices (); d != circuit->end_devices (); ++d) {
+      stat->add (typeid (db::Device), (void *) d.operator-> (), sizeof (db::Device), sizeof (db::Device), (void *) circuit, purpose, cat);
+      db::mem_stat (stat, purpose, cat, d->name (), true, (void *) d.operator-> ());
+      if (d->device_class ()) {
+        size_t np = d->device_class ()->parameter_definitions ().size ();
+        size_t nt = d->device_class ()->terminal_definitions ().size ();
+        stat->add (typeid (double []), 0, np * sizeof (double), np * sizeof (double), (void *) d.operator-> (), purpose, cat);
+        stat->add (typeid (db::Net::terminal_iterator []), 0, nt * sizeof (db::Net::terminal_iterator), nt * sizeof (db::Net::terminal_iterator), (void *) d.operator-> (), purpose, cat);
+      }
+    }
+
+    for (db::Circuit::const_subcircuit_iterator sc = circuit->begin_subcircuits (); sc != circuit->end_subcircuits (); ++sc) {
+      stat->add (typeid (db::SubCircuit), (void *) sc.operator-> (), sizeof (db::SubCircuit), sizeof (db::SubCircuit), (void *) circuit, purpose, cat);
+      db::mem_stat (stat, purpose, cat, sc->name (), true, (void *) sc.operator-> ());
+      if (sc->circuit_ref ()) {
+        size_t np = sc->circuit_ref ()->pin_count ();
+        stat->add (typeid (db::Net::subcircuit_pin_iterator []), 0, np * sizeof (db::Net::subcircuit_pin_iterator), np * sizeof (db::Net::subcircuit_pin_iterator), (void *) sc.operator-> (), purpose, cat);
+      }
+    }
+
+  }
+}
+
 }
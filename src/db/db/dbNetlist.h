@@ -27,6 +27,7 @@
 #include "dbCircuit.h"
 #include "dbDeviceClass.h"
 #include "dbDeviceAbstract.h"
+#include "dbMemStatistics.h"
 
 #include "tlVector.h"
 
@@ -502,6 +503,14 @@ public:
    */
   void combine_devices ();
 
+  /**
+   *  @brief Collects memory statistics
+   *
+   *  The memory required by the netlist objects is estimated from the object
+   *  sizes and the numbers of connections, parameters and names.
+   */
+  void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, bool no_self = false, void *parent = 0) const;
+
 private:
   friend class Circuit;
   friend class DeviceAbstract;
@@ -535,6 +544,14 @@ private:
   const tl::vector<Circuit *> &parent_circuits (Circuit *circuit);
 };
 
+/**
+ *  @brief Collects memory statistics
+ */
+inline void mem_stat (MemStatistics *stat, MemStatistics::purpose_t purpose, int cat, const Netlist &x, bool no_self = false, void *parent = 0)
+{
+  x.mem_stat (stat, purpose, cat, no_self, parent);
+}
+
 /**
  *  @brief A helper class using RAII for safe locking/unlocking
  */
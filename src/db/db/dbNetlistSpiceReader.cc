@@ -31,6 +31,7 @@
 #include "tlUri.h"
 #include "tlTimer.h"
 #include "tlLog.h"
+#include "tlThreadedWorkers.h"
 
 #include <sstream>
 #include <cctype>
@@ -235,8 +236,45 @@ bool NetlistSpiceReaderDelegate::element (db::Circuit *circuit, const std::strin
 
 static const char *allowed_name_chars = "_.:,!+$/&\\#[]|<>";
 
+//  the number of cards per parser task
+static const size_t cards_per_task = 1000;
+
+/**
+ *  @brief A task for the card parser: tokenizes a range of cards
+ */
+class NetlistSpiceCardParserTask
+  : public tl::Task
+{
+public:
+  NetlistSpiceCardParserTask (NetlistSpiceCard *from, NetlistSpiceCard *to)
+    : mp_from (from), mp_to (to)
+  { }
+
+  NetlistSpiceCard *mp_from, *mp_to;
+};
+
+/**
+ *  @brief The worker for the card parser
+ */
+class NetlistSpiceCardParserWorker
+  : public tl::Worker
+{
+public:
+  NetlistSpiceCardParserWorker ()
+    : tl::Worker ()
+  { }
+
+  virtual void perform_task (tl::Task *task)
+  {
+    NetlistSpiceCardParserTask *parser_task = static_cast<NetlistSpiceCardParserTask *> (task);
+    for (NetlistSpiceCard *c = parser_task->mp_from; c != parser_task->mp_to; ++c) {
+      NetlistSpiceReader::parse_card (*c);
+    }
+  }
+};
+
 NetlistSpiceReader::NetlistSpiceReader (NetlistSpiceReaderDelegate *delegate)
-  : mp_netlist (0), mp_stream (0), mp_delegate (delegate)
+  : mp_netlist (0), mp_stream (0), mp_delegate (delegate), m_num_threads (0), m_next_card (0), mp_stream_source (0), mp_location_source (0), m_location_line (0)
 {
   static NetlistSpiceReaderDelegate std_delegate;
   if (! delegate) {
@@ -260,6 +298,10 @@ void NetlistSpiceReader::read (tl::InputStream &stream, db::Netlist &netlist)
   mp_nets_by_name.reset (0);
   m_global_nets.clear ();
   m_circuits_read.clear ();
+  m_cards.clear ();
+  m_next_card = 0;
+  update_stream_source ();
+  set_location_from_stream ();
 
   try {
 
@@ -269,6 +311,8 @@ void NetlistSpiceReader::read (tl::InputStream &stream, db::Netlist &netlist)
       read_card ();
     }
 
+    set_location_from_stream ();
+
     build_global_nets ();
 
     mp_delegate->finish (&netlist);
@@ -276,9 +320,7 @@ void NetlistSpiceReader::read (tl::InputStream &stream, db::Netlist &netlist)
 
   } catch (tl::Exception &ex) {
 
-    //  NOTE: because we do a peek to capture the "+" line continuation character, we're
-    //  one line ahead.
-    std::string fmt_msg = tl::sprintf ("%s in %s, line %d", ex.msg (), mp_stream->source (), mp_stream->line_number () - 1);
+    std::string fmt_msg = tl::sprintf ("%s in %s, line %d", ex.msg (), *mp_location_source, m_location_line);
     finish ();
     throw tl::Exception (fmt_msg);
 
@@ -342,6 +384,22 @@ void NetlistSpiceReader::finish ()
   mp_netlist = 0;
   mp_circuit = 0;
   mp_nets_by_name.reset (0);
+  m_cards.clear ();
+  m_next_card = 0;
+}
+
+void NetlistSpiceReader::update_stream_source ()
+{
+  //  the source name is interned once per stream, so the cards can simply refer to it
+  mp_stream_source = m_sources.insert (mp_stream->source ()).first.operator-> ();
+}
+
+void NetlistSpiceReader::set_location_from_stream ()
+{
+  //  NOTE: because we do a peek to capture the "+" line continuation character, we're
+  //  one line ahead.
+  mp_location_source = mp_stream_source;
+  m_location_line = int (mp_stream->line_number ()) - 1;
 }
 
 void NetlistSpiceReader::push_stream (const std::string &path)
@@ -362,6 +420,7 @@ void NetlistSpiceReader::push_stream (const std::string &path)
 
   m_streams.push_back (std::make_pair (istream, mp_stream.release ()));
   mp_stream.reset (new tl::TextInputStream (*istream));
+  update_stream_source ();
 }
 
 void NetlistSpiceReader::pop_stream ()
@@ -373,12 +432,14 @@ void NetlistSpiceReader::pop_stream ()
 
     m_streams.pop_back ();
 
+    update_stream_source ();
+
   }
 }
 
 bool NetlistSpiceReader::at_end ()
 {
-  return mp_stream->at_end () && m_streams.empty ();
+  return m_next_card == m_cards.size () && mp_stream->at_end () && m_streams.empty ();
 }
 
 std::string NetlistSpiceReader::get_line ()
@@ -441,76 +502,231 @@ bool NetlistSpiceReader::subcircuit_captured (const std::string &nc_name)
   }
 }
 
-bool NetlistSpiceReader::read_card ()
+void NetlistSpiceReader::fetch_cards ()
 {
-  std::string l = get_line ();
-  if (l.empty ()) {
-    return false;
+  m_cards.clear ();
+  m_next_card = 0;
+
+  //  in the single-threaded case, we fetch one card at a time
+  size_t n = m_num_threads > 0 ? cards_per_task * size_t (m_num_threads) * 4 : 1;
+  m_cards.reserve (n);
+
+  while (m_cards.size () < n) {
+
+    m_cards.push_back (NetlistSpiceCard ());
+    NetlistSpiceCard &card = m_cards.back ();
+
+    try {
+      card.line = get_line ();
+    } catch (tl::Exception &ex) {
+      //  deliver the error when the card is consumed
+      card.type = NetlistSpiceCard::Error;
+      card.has_error = true;
+      card.error = ex.msg ();
+    }
+
+    //  NOTE: the location is that of the stream (one line ahead, see set_location_from_stream).
+    //  It becomes the reader's location when the card is consumed.
+    card.source = mp_stream_source;
+    card.line_number = int (mp_stream->line_number ()) - 1;
+
+    if (card.type == NetlistSpiceCard::Error) {
+      break;
+    } else if (card.line.empty ()) {
+      m_cards.pop_back ();
+      break;
+    }
+
+  }
+
+  if (m_num_threads > 0 && m_cards.size () > cards_per_task) {
+
+    if (! mp_parser_job.get ()) {
+      mp_parser_job.reset (new tl::Job<NetlistSpiceCardParserWorker> (m_num_threads));
+    }
+
+    for (size_t i = 0; i < m_cards.size (); i += cards_per_task) {
+      NetlistSpiceCard *from = &m_cards [i];
+      mp_parser_job->schedule (new NetlistSpiceCardParserTask (from, from + std::min (cards_per_task, m_cards.size () - i)));
+    }
+
+    try {
+      mp_parser_job->start ();
+      mp_parser_job->wait ();
+    } catch (...) {
+      mp_parser_job->terminate ();
+      throw;
+    }
+
+    if (mp_parser_job->has_error ()) {
+      //  NOTE: regular errors are stored inside the cards, so this is an exceptional case
+      throw tl::Exception (mp_parser_job->error_messages ().front ());
+    }
+
+  } else {
+
+    for (std::vector<NetlistSpiceCard>::iterator c = m_cards.begin (); c != m_cards.end (); ++c) {
+      parse_card (*c);
+    }
+
+  }
+}
+
+bool NetlistSpiceReader::next_card (NetlistSpiceCard &card)
+{
+  if (m_next_card == m_cards.size ()) {
+    fetch_cards ();
+    if (m_cards.empty ()) {
+      return false;
+    }
   }
 
-  tl::Extractor ex (l.c_str ());
+  std::swap (card, m_cards [m_next_card++]);
+
+  mp_location_source = card.source;
+  m_location_line = card.line_number;
+
+  if (card.type == NetlistSpiceCard::Error) {
+    error (card.error);
+  }
+
+  return true;
+}
+
+void NetlistSpiceReader::parse_card (NetlistSpiceCard &card)
+{
+  if (card.type == NetlistSpiceCard::Error) {
+    return;
+  }
+
+  tl::Extractor ex (card.line.c_str ());
 
   ex.skip ();
   char next_char = toupper (*ex);
 
-  if (ex.test_without_case (".")) {
+  //  NOTE: the card type is determined first without raising an error - this way, cards can
+  //  be skipped even if they are not valid. Errors are raised when the card is consumed.
+
+  try {
 
-    //  control statement
-    if (ex.test_without_case ("model")) {
+    if (ex.test_without_case (".")) {
+
+      //  control statement
+      if (ex.test_without_case ("model")) {
 
-      //  ignore model statements
+        card.type = NetlistSpiceCard::Model;
 
-    } else if (ex.test_without_case ("global")) {
+      } else if (ex.test_without_case ("global")) {
 
-      while (! ex.at_end ()) {
-        std::string n = read_name (ex);
-        if (m_global_net_names.find (n) == m_global_net_names.end ()) {
-          m_global_nets.push_back (n);
-          m_global_net_names.insert (n);
+        card.type = NetlistSpiceCard::Global;
+
+        while (! ex.at_end ()) {
+          card.nets.push_back (read_name (ex));
         }
-      }
 
-    } else if (ex.test_without_case ("subckt")) {
+      } else if (ex.test_without_case ("subckt")) {
+
+        card.type = NetlistSpiceCard::Subckt;
+
+        card.name = read_name (ex);
+        read_pin_and_parameters (ex, card.nets, card.params);
+        ex.expect_end ();
+
+      } else if (ex.test_without_case ("ends")) {
+
+        card.type = NetlistSpiceCard::Ends;
+
+      } else if (ex.test_without_case ("end")) {
+
+        card.type = NetlistSpiceCard::End;
 
-      std::string nc = read_name (ex);
-      if (subcircuit_captured (nc)) {
-        skip_circuit (ex);
       } else {
-        read_circuit (ex, nc);
+
+        card.type = NetlistSpiceCard::Control;
+
+        ex.read_word (card.name);
+        card.name = tl::to_lower_case (card.name);
+
       }
 
-    } else if (ex.test_without_case ("ends")) {
+    } else if (isalpha (next_char)) {
 
-      return true;
+      card.type = NetlistSpiceCard::Element;
+      card.element.push_back (next_char);
 
-    } else if (ex.test_without_case ("end")) {
+      ++ex;
+
+      card.name = read_name (ex);
+      parse_element (ex, card);
 
-      //  ignore end statements
+      ex.expect_end ();
 
     } else {
+      card.type = NetlistSpiceCard::Ignored;
+    }
 
-      std::string s;
-      ex.read_word (s);
-      s = tl::to_lower_case (s);
-      warn (tl::to_string (tr ("Control statement ignored: ")) + s);
+  } catch (tl::Exception &ex) {
+    card.has_error = true;
+    card.error = ex.msg ();
+  }
 
-    }
+  //  release memory early
+  std::string ().swap (card.line);
+}
 
-  } else if (isalpha (next_char)) {
+bool NetlistSpiceReader::read_card ()
+{
+  NetlistSpiceCard card;
+  if (! next_card (card)) {
+    return false;
+  }
 
-    ++ex;
+  if (card.type == NetlistSpiceCard::Subckt && ! card.name.empty () && subcircuit_captured (card.name)) {
+    //  NOTE: errors in captured subcircuits are ignored
+    skip_circuit ();
+    return false;
+  }
 
-    std::string name = read_name (ex);
-    ensure_circuit ();
+  if (card.has_error) {
+    error (card.error);
+  }
+
+  if (card.type == NetlistSpiceCard::Model) {
 
-    std::string es;
-    es.push_back (next_char);
+    //  ignore model statements
 
-    if (! read_element (ex, es, name)) {
-      warn (tl::sprintf (tl::to_string (tr ("Element type '%c' ignored")), next_char));
+  } else if (card.type == NetlistSpiceCard::Global) {
+
+    for (std::vector<std::string>::const_iterator n = card.nets.begin (); n != card.nets.end (); ++n) {
+      if (m_global_net_names.find (*n) == m_global_net_names.end ()) {
+        m_global_nets.push_back (*n);
+        m_global_net_names.insert (*n);
+      }
     }
 
-    ex.expect_end ();
+  } else if (card.type == NetlistSpiceCard::Subckt) {
+
+    read_circuit (card);
+
+  } else if (card.type == NetlistSpiceCard::Ends) {
+
+    return true;
+
+  } else if (card.type == NetlistSpiceCard::End) {
+
+    //  ignore end statements
+
+  } else if (card.type == NetlistSpiceCard::Control) {
+
+    warn (tl::to_string (tr ("Control statement ignored: ")) + card.name);
+
+  } else if (card.type == NetlistSpiceCard::Element) {
+
+    ensure_circuit ();
+
+    if (! read_element (card)) {
+      warn (tl::sprintf (tl::to_string (tr ("Element type '%c' ignored")), card.element [0]));
+    }
 
   } else {
     warn (tl::to_string (tr ("Line ignored")));
@@ -526,7 +742,7 @@ void NetlistSpiceReader::error (const std::string &msg)
 
 void NetlistSpiceReader::warn (const std::string &msg)
 {
-  std::string fmt_msg = tl::sprintf ("%s in %s, line %d", msg, mp_stream->source (), mp_stream->line_number () - 1);
+  std::string fmt_msg = tl::sprintf ("%s in %s, line %d", msg, *mp_location_source, m_location_line);
   tl::warn << fmt_msg;
 }
 
@@ -631,10 +847,10 @@ void NetlistSpiceReader::ensure_circuit ()
 db::Net *NetlistSpiceReader::make_net (const std::string &name)
 {
   if (! mp_nets_by_name.get ()) {
-    mp_nets_by_name.reset (new std::map<std::string, db::Net *> ());
+    mp_nets_by_name.reset (new std::unordered_map<std::string, db::Net *> ());
   }
 
-  std::map<std::string, db::Net *>::const_iterator n2n = mp_nets_by_name->find (name);
+  std::unordered_map<std::string, db::Net *>::const_iterator n2n = mp_nets_by_name->find (name);
 
   db::Net *net = 0;
   if (n2n == mp_nets_by_name->end ()) {
@@ -697,6 +913,11 @@ std::string NetlistSpiceReader::read_name_with_case (tl::Extractor &ex)
   std::string n;
   ex.read_word_or_quoted (n, allowed_name_chars);
 
+  //  fast path: no escape sequences
+  if (n.find ('\\') == std::string::npos) {
+    return n;
+  }
+
   std::string nn;
   nn.reserve (n.size ());
   const char *cp = n.c_str ();
@@ -746,14 +967,15 @@ std::string NetlistSpiceReader::read_name (tl::Extractor &ex)
 #endif
 }
 
-bool NetlistSpiceReader::read_element (tl::Extractor &ex, const std::string &element, const std::string &name)
+void NetlistSpiceReader::parse_element (tl::Extractor &ex, NetlistSpiceCard &card)
 {
   //  generic parse
-  std::vector<std::string> nn;
-  std::map<std::string, double> pv;
+  const std::string &element = card.element;
+  std::vector<std::string> &nn = card.nets;
+  std::map<std::string, double> &pv = card.params;
 
-  std::string model;
-  double value = 0.0;
+  std::string &model = card.model;
+  double &value = card.value;
 
   //  interpret the parameters according to the code
   if (element == "X") {
@@ -841,8 +1063,16 @@ bool NetlistSpiceReader::read_element (tl::Extractor &ex, const std::string &ele
 
   }
 
+}
+
+bool NetlistSpiceReader::read_element (const NetlistSpiceCard &card)
+{
+  const std::string &element = card.element;
+  const std::string &model = card.model;
+  const std::map<std::string, double> &pv = card.params;
+
   std::vector<db::Net *> nets;
-  for (std::vector<std::string>::const_iterator i = nn.begin (); i != nn.end (); ++i) {
+  for (std::vector<std::string>::const_iterator i = card.nets.begin (); i != card.nets.end (); ++i) {
     nets.push_back (make_net (*i));
   }
 
@@ -850,10 +1080,10 @@ bool NetlistSpiceReader::read_element (tl::Extractor &ex, const std::string &ele
     if (! pv.empty ()) {
       warn (tl::to_string (tr ("Circuit parameters are not allowed currently")));
     }
-    read_subcircuit (name, model, nets);
+    read_subcircuit (card.name, model, nets);
     return true;
   } else {
-    return mp_delegate->element (mp_circuit, element, name, model, value, nets, pv);
+    return mp_delegate->element (mp_circuit, element, card.name, model, card.value, nets, pv);
   }
 }
 
@@ -887,33 +1117,31 @@ void NetlistSpiceReader::read_subcircuit (const std::string &sc_name, const std:
   }
 }
 
-void NetlistSpiceReader::skip_circuit (tl::Extractor & /*ex*/)
+void NetlistSpiceReader::skip_circuit ()
 {
-  while (! at_end ()) {
+  NetlistSpiceCard card;
 
-    std::string l = get_line ();
-    tl::Extractor ex (l.c_str ());
-    if (ex.test_without_case (".")) {
+  while (! at_end ()) {
 
-      //  control statement
-      if (ex.test_without_case ("subckt")) {
-        skip_circuit (ex);
-      } else if (ex.test_without_case ("ends")) {
-        break;
-      }
+    if (! next_card (card)) {
+      break;
+    }
 
+    if (card.type == NetlistSpiceCard::Subckt) {
+      skip_circuit ();
+    } else if (card.type == NetlistSpiceCard::Ends) {
+      break;
     }
 
   }
 }
 
-void NetlistSpiceReader::read_circuit (tl::Extractor &ex, const std::string &nc)
+void NetlistSpiceReader::read_circuit (const NetlistSpiceCard &card)
 {
-  std::vector<std::string> nn;
-  std::map<std::string, double> pv;
-  read_pin_and_parameters (ex, nn, pv);
+  const std::string &nc = card.name;
+  const std::vector<std::string> &nn = card.nets;
 
-  if (! pv.empty ()) {
+  if (! card.params.empty ()) {
     warn (tl::to_string (tr ("Circuit parameters are not allowed currently")));
   }
 
@@ -940,7 +1168,7 @@ void NetlistSpiceReader::read_circuit (tl::Extractor &ex, const std::string &nc)
   }
   m_circuits_read.insert (cc);
 
-  std::auto_ptr<std::map<std::string, db::Net *> > n2n (mp_nets_by_name.release ());
+  std::auto_ptr<std::unordered_map<std::string, db::Net *> > n2n (mp_nets_by_name.release ());
   mp_nets_by_name.reset (0);
 
   std::swap (cc, mp_circuit);
@@ -964,8 +1192,6 @@ void NetlistSpiceReader::read_circuit (tl::Extractor &ex, const std::string &nc)
 
   mp_nets_by_name.reset (n2n.release ());
   std::swap (cc, mp_circuit);
-
-  ex.expect_end ();
 }
 
 }
@@ -31,6 +31,12 @@
 #include <set>
 #include <map>
 #include <memory>
+#include <unordered_map>
+
+namespace tl
+{
+  class JobBase;
+}
 
 namespace db
 {
@@ -41,6 +47,33 @@ class Circuit;
 class DeviceClass;
 class Device;
 
+/**
+ *  @brief Represents a logical line of a SPICE file
+ *
+ *  This is an internal structure used by NetlistSpiceReader. The line is
+ *  tokenized in "parse_card" which does not depend on the reader's state. This way,
+ *  cards can be tokenized in parallel.
+ */
+struct NetlistSpiceCard
+{
+  enum card_type { Ignored = 0, Element, Model, Global, Subckt, Ends, End, Control, Error };
+
+  NetlistSpiceCard ()
+    : type (Ignored), source (0), line_number (0), value (0.0), has_error (false)
+  { }
+
+  card_type type;
+  std::string line;
+  const std::string *source;
+  int line_number;
+  std::string element, name, model;
+  double value;
+  std::vector<std::string> nets;
+  std::map<std::string, double> params;
+  bool has_error;
+  std::string error;
+};
+
 /**
  *  @brief A specialized exception class to handle netlist reader delegate errors
  */
@@ -111,6 +144,15 @@ public:
 
 /**
  *  @brief A SPICE format reader for netlists
+ *
+ *  The reader works in two stages: first, logical lines ("cards") are collected
+ *  from the input (resolving continuation lines and includes). Then the cards are
+ *  tokenized and translated into circuits, nets, devices and subcircuits.
+ *
+ *  If a number of threads is given, the cards are read in batches and the tokenization
+ *  is done in parallel. Building the netlist and calling the delegate still happens
+ *  sequentially and in the original order, so the netlist is identical to
+ *  the single-threaded one.
  */
 class DB_PUBLIC NetlistSpiceReader
   : public NetlistReader
@@ -121,6 +163,24 @@ public:
 
   virtual void read (tl::InputStream &stream, db::Netlist &netlist);
 
+  /**
+   *  @brief Sets the number of threads to use for tokenizing the cards
+   *
+   *  0 (the default) means tokenizing happens in the reader thread.
+   */
+  void set_num_threads (int n)
+  {
+    m_num_threads = n;
+  }
+
+  /**
+   *  @brief Gets the number of threads to use for tokenizing the cards
+   */
+  int num_threads () const
+  {
+    return m_num_threads;
+  }
+
 private:
   db::Netlist *mp_netlist;
   db::Circuit *mp_circuit;
@@ -128,32 +188,47 @@ private:
   std::auto_ptr<tl::TextInputStream> mp_stream;
   tl::weak_ptr<NetlistSpiceReaderDelegate> mp_delegate;
   std::vector<std::pair<tl::InputStream *, tl::TextInputStream *> > m_streams;
-  std::auto_ptr<std::map<std::string, db::Net *> > mp_nets_by_name;
+  std::auto_ptr<std::unordered_map<std::string, db::Net *> > mp_nets_by_name;
   std::string m_stored_line;
   std::map<std::string, bool> m_captured;
   std::vector<std::string> m_global_nets;
   std::set<std::string> m_global_net_names;
   std::set<const db::Circuit *> m_circuits_read;
+  int m_num_threads;
+  std::auto_ptr<tl::JobBase> mp_parser_job;
+  std::vector<NetlistSpiceCard> m_cards;
+  size_t m_next_card;
+  std::set<std::string> m_sources;
+  const std::string *mp_stream_source;
+  const std::string *mp_location_source;
+  int m_location_line;
 
   void push_stream (const std::string &path);
   void pop_stream ();
   bool at_end ();
-  void read_pin_and_parameters (tl::Extractor &ex, std::vector<std::string> &nn, std::map<std::string, double> &pv);
-  bool read_element (tl::Extractor &ex, const std::string &element, const std::string &name);
+  static void read_pin_and_parameters (tl::Extractor &ex, std::vector<std::string> &nn, std::map<std::string, double> &pv);
+  static void parse_card (NetlistSpiceCard &card);
+  friend class NetlistSpiceCardParserWorker;
+  static void parse_element (tl::Extractor &ex, NetlistSpiceCard &card);
+  bool read_element (const NetlistSpiceCard &card);
   void read_subcircuit (const std::string &sc_name, const std::string &nc_name, const std::vector<db::Net *> &nets);
-  void read_circuit (tl::Extractor &ex, const std::string &name);
-  void skip_circuit (tl::Extractor &ex);
+  void read_circuit (const NetlistSpiceCard &card);
+  void skip_circuit ();
   bool read_card ();
-  double read_value (tl::Extractor &ex);
-  std::string read_name_with_case (tl::Extractor &ex);
-  std::string read_name (tl::Extractor &ex);
-  double read_atomic_value (tl::Extractor &ex);
-  double read_dot_expr (tl::Extractor &ex);
-  double read_bar_expr (tl::Extractor &ex);
+  bool next_card (NetlistSpiceCard &card);
+  void fetch_cards ();
+  static double read_value (tl::Extractor &ex);
+  static std::string read_name_with_case (tl::Extractor &ex);
+  static std::string read_name (tl::Extractor &ex);
+  static double read_atomic_value (tl::Extractor &ex);
+  static double read_dot_expr (tl::Extractor &ex);
+  static double read_bar_expr (tl::Extractor &ex);
   std::string get_line ();
   void unget_line (const std::string &l);
-  void error (const std::string &msg);
+  static void error (const std::string &msg);
   void warn (const std::string &msg);
+  void set_location_from_stream ();
+  void update_stream_source ();
   void finish ();
   db::Net *make_net (const std::string &name);
   void ensure_circuit ();
@@ -0,0 +1,984 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2020 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+#include "dbPCellCache.h"
+#include "dbLayout.h"
+#include "dbCell.h"
+#include "dbLibrary.h"
+#include "dbLibraryManager.h"
+#include "tlStream.h"
+#include "tlFileUtils.h"
+#include "tlEnv.h"
+#include "tlString.h"
+#include "tlLog.h"
+#include "tlInternational.h"
+
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <stdint.h>
+
+namespace db
+{
+
+// ---------------------------------------------------------------------------------
+//  The binary representation of a cache entry
+//
+//  The entry starts with the magic bytes "KLPC" and the format version byte (2).
+//  Numbers are stored as varints (7 bits per byte, LSB first), signed numbers
+//  in zigzag encoding. Strings are stored as the length followed by the bytes.
+//  The layout of the file is:
+//
+//    <key> <cache-version> <display-name>
+//    <#layers> { <layer-slot> <#shapes> { <shape> } }
+//
+//  The layer slot is the index in the layer_ids vector. A shape is a type byte
+//  followed by the properties and the geometry. Points of polygons and paths are
+//  stored relative to the previous point. Properties are stored as the number of
+//  name/value pairs followed by the parsable string representations.
+
+static const char *magic = "KLPC";
+static const unsigned char format_version = 2;
+
+enum pcell_cache_shape_type
+{
+  ShapeBox = 1,
+  ShapePolygon = 2,
+  ShapeSimplePolygon = 3,
+  ShapePath = 4,
+  ShapeText = 5,
+  ShapeEdge = 6,
+  ShapeEdgePair = 7
+};
+
+namespace
+{
+
+/**
+ *  @brief Thrown if the cell contains objects which cannot be cached
+ */
+struct NotCacheable { };
+
+class EntryWriter
+{
+public:
+  EntryWriter (const db::Layout &layout)
+    : mp_layout (&layout)
+  { }
+
+  std::string &data () { return m_data; }
+
+  void put_byte (unsigned char b)
+  {
+    m_data += char (b);
+  }
+
+  void put_uint (uint64_t v)
+  {
+    while (v >= 0x80) {
+      put_byte ((unsigned char) (v & 0x7f) | 0x80);
+      v >>= 7;
+    }
+    put_byte ((unsigned char) v);
+  }
+
+  void put_int (int64_t v)
+  {
+    put_uint (v < 0 ? ((uint64_t (-(v + 1)) << 1) | 1) : (uint64_t (v) << 1));
+  }
+
+  void put_string (const std::string &s)
+  {
+    put_uint (s.size ());
+    m_data += s;
+  }
+
+  void put_point (const db::Point &p, db::Point &last)
+  {
+    put_int (int64_t (p.x ()) - last.x ());
+    put_int (int64_t (p.y ()) - last.y ());
+    last = p;
+  }
+
+  void put_edge (const db::Edge &e)
+  {
+    db::Point last;
+    put_point (e.p1 (), last);
+    put_point (e.p2 (), last);
+  }
+
+  template <class Iter>
+  void put_points (Iter from, Iter to, size_t n)
+  {
+    put_uint (n);
+    db::Point last;
+    for (Iter p = from; p != to; ++p) {
+      put_point (*p, last);
+    }
+  }
+
+  void put_trans (const db::Trans &t)
+  {
+    put_uint (t.rot ());
+    put_int (t.disp ().x ());
+    put_int (t.disp ().y ());
+  }
+
+  void put_properties (db::properties_id_type prop_id)
+  {
+    if (prop_id == 0) {
+      put_uint (0);
+      return;
+    }
+
+    const db::PropertiesRepository &rep = mp_layout->properties_repository ();
+    const db::PropertiesRepository::properties_set &props = rep.properties (prop_id);
+    put_uint (props.size ());
+    for (db::PropertiesRepository::properties_set::const_iterator p = props.begin (); p != props.end (); ++p) {
+      put_string (rep.prop_name (p->first).to_parsable_string ());
+      put_string (p->second.to_parsable_string ());
+    }
+  }
+
+  void put_shape (const db::Shape &shape)
+  {
+    if (shape.is_box ()) {
+
+      put_byte (ShapeBox);
+      put_properties (shape.prop_id ());
+      db::Box b = shape.box ();
+      put_edge (db::Edge (b.p1 (), b.p2 ()));
+
+    } else if (shape.is_simple_polygon ()) {
+
+      put_byte (ShapeSimplePolygon);
+      put_properties (shape.prop_id ());
+      db::SimplePolygon poly;
+      shape.simple_polygon (poly);
+      put_points (poly.hull ().begin (), poly.hull ().end (), poly.hull ().size ());
+
+    } else if (shape.is_polygon ()) {
+
+      put_byte (ShapePolygon);
+      put_properties (shape.prop_id ());
+      db::Polygon poly;
+      shape.polygon (poly);
+      put_uint (poly.holes ());
+      for (unsigned int c = 0; c <= poly.holes (); ++c) {
+        const db::Polygon::contour_type &ctr = poly.contour (c);
+        put_points (ctr.begin (), ctr.end (), ctr.size ());
+      }
+
+    } else if (shape.is_path ()) {
+
+      put_byte (ShapePath);
+      put_properties (shape.prop_id ());
+      db::Path path;
+      shape.path (path);
+      put_int (path.width ());
+      put_int (path.bgn_ext ());
+      put_int (path.end_ext ());
+      put_byte (path.round () ? 1 : 0);
+      put_points (path.begin (), path.end (), path.points ());
+
+    } else if (shape.is_text ()) {
+
+      put_byte (ShapeText);
+      put_properties (shape.prop_id ());
+      db::Text text;
+      shape.text (text);
+      put_string (text.string ());
+      put_trans (text.trans ());
+      put_int (text.size ());
+      put_int (int (text.font ()));
+      put_int (int (text.halign ()));
+      put_int (int (text.valign ()));
+
+    } else if (shape.is_edge ()) {
+
+      put_byte (ShapeEdge);
+      put_properties (shape.prop_id ());
+      put_edge (shape.edge ());
+
+    } else if (shape.is_edge_pair ()) {
+
+      put_byte (ShapeEdgePair);
+      put_properties (shape.prop_id ());
+      put_edge (shape.edge_pair ().first ());
+      put_edge (shape.edge_pair ().second ());
+
+    } else {
+      throw NotCacheable ();
+    }
+  }
+
+private:
+  const db::Layout *mp_layout;
+  std::string m_data;
+};
+
+class EntryReader
+{
+public:
+  EntryReader (const std::string &data, db::Layout &layout)
+    : mp_layout (&layout), mp_cp (data.c_str ()), mp_end (data.c_str () + data.size ())
+  { }
+
+  bool at_end () const
+  {
+    return mp_cp == mp_end;
+  }
+
+  unsigned char get_byte ()
+  {
+    if (mp_cp == mp_end) {
+      throw tl::Exception (tl::to_string (tr ("Unexpected end of PCell cache entry")));
+    }
+    return (unsigned char) *mp_cp++;
+  }
+
+  uint64_t get_uint ()
+  {
+    uint64_t v = 0;
+    unsigned int shift = 0;
+    unsigned char b;
+    do {
+      if (shift > 63) {
+        throw tl::Exception (tl::to_string (tr ("Invalid number in PCell cache entry")));
+      }
+      b = get_byte ();
+      v |= uint64_t (b & 0x7f) << shift;
+      shift += 7;
+    } while ((b & 0x80) != 0);
+    return v;
+  }
+
+  int64_t get_int ()
+  {
+    uint64_t v = get_uint ();
+    return (v & 1) != 0 ? -int64_t (v >> 1) - 1 : int64_t (v >> 1);
+  }
+
+  db::Coord get_coord ()
+  {
+    return db::Coord (get_int ());
+  }
+
+  std::string get_string ()
+  {
+    size_t n = size_t (get_uint ());
+    const char *cp = get_bytes (n);
+    return std::string (cp, n);
+  }
+
+  tl::Variant get_variant ()
+  {
+    std::string s = get_string ();
+    tl::Variant v;
+    tl::Extractor ex (s.c_str ());
+    ex.read (v);
+    return v;
+  }
+
+  db::Point get_point (db::Point &last)
+  {
+    db::Coord dx = get_coord ();
+    db::Coord dy = get_coord ();
+    last = last + db::Vector (dx, dy);
+    return last;
+  }
+
+  db::Edge get_edge ()
+  {
+    db::Point last;
+    db::Point p1 = get_point (last);
+    db::Point p2 = get_point (last);
+    return db::Edge (p1, p2);
+  }
+
+  void get_points (std::vector<db::Point> &pts)
+  {
+    size_t n = size_t (get_uint ());
+    if (n > size_t (mp_end - mp_cp)) {
+      throw tl::Exception (tl::to_string (tr ("Invalid point count in PCell cache entry")));
+    }
+    pts.clear ();
+    pts.reserve (n);
+    db::Point last;
+    for (size_t i = 0; i < n; ++i) {
+      pts.push_back (get_point (last));
+    }
+  }
+
+  db::Trans get_trans ()
+  {
+    int rot = int (get_uint ());
+    db::Coord x = get_coord ();
+    db::Coord y = get_coord ();
+    return db::Trans (rot, db::Vector (x, y));
+  }
+
+  db::properties_id_type get_properties ()
+  {
+    size_t n = size_t (get_uint ());
+    if (n == 0) {
+      return 0;
+    }
+
+    db::PropertiesRepository &rep = mp_layout->properties_repository ();
+    db::PropertiesRepository::properties_set props;
+    for (size_t i = 0; i < n; ++i) {
+      tl::Variant name = get_variant ();
+      props.insert (std::make_pair (rep.prop_name_id (name), get_variant ()));
+    }
+    return rep.properties_id (props);
+  }
+
+  template <class Sh>
+  void insert (db::Shapes &shapes, const Sh &sh, db::properties_id_type prop_id)
+  {
+    if (prop_id != 0) {
+      shapes.insert (db::object_with_properties<Sh> (sh, prop_id));
+    } else {
+      shapes.insert (sh);
+    }
+  }
+
+  void get_shape (db::Shapes &shapes)
+  {
+    unsigned char type = get_byte ();
+    db::properties_id_type prop_id = get_properties ();
+
+    if (type == ShapeBox) {
+
+      db::Edge e = get_edge ();
+      insert (shapes, db::Box (e.p1 (), e.p2 ()), prop_id);
+
+    } else if (type == ShapeSimplePolygon) {
+
+      get_points (m_pts);
+      db::SimplePolygon poly;
+      poly.assign_hull (m_pts.begin (), m_pts.end (), false);
+      insert (shapes, poly, prop_id);
+
+    } else if (type == ShapePolygon) {
+
+      size_t holes = size_t (get_uint ());
+      db::Polygon poly;
+      get_points (m_pts);
+      poly.assign_hull (m_pts.begin (), m_pts.end (), false);
+      for (size_t h = 0; h < holes; ++h) {
+        get_points (m_pts);
+        poly.insert_hole (m_pts.begin (), m_pts.end (), false);
+      }
+      insert (shapes, poly, prop_id);
+
+    } else if (type == ShapePath) {
+
+      db::Coord w = get_coord ();
+      db::Coord bx = get_coord ();
+      db::Coord ex = get_coord ();
+      bool round = get_byte () != 0;
+      get_points (m_pts);
+      insert (shapes, db::Path (m_pts.begin (), m_pts.end (), w, bx, ex, round), prop_id);
+
+    } else if (type == ShapeText) {
+
+      std::string s = get_string ();
+      db::Trans t = get_trans ();
+      db::Coord size = get_coord ();
+      db::Font font = db::Font (get_int ());
+      db::HAlign halign = db::HAlign (get_int ());
+      db::VAlign valign = db::VAlign (get_int ());
+      insert (shapes, db::Text (s, t, size, font, halign, valign), prop_id);
+
+    } else if (type == ShapeEdge) {
+
+      insert (shapes, get_edge (), prop_id);
+
+    } else if (type == ShapeEdgePair) {
+
+      db::Edge first = get_edge ();
+      db::Edge second = get_edge ();
+      insert (shapes, db::EdgePair (first, second), prop_id);
+
+    } else {
+      throw tl::Exception (tl::to_string (tr ("Invalid shape type in PCell cache entry")));
+    }
+  }
+
+private:
+  db::Layout *mp_layout;
+  const char *mp_cp, *mp_end;
+  std::vector<db::Point> m_pts;
+
+  const char *get_bytes (size_t n)
+  {
+    if (n > size_t (mp_end - mp_cp)) {
+      throw tl::Exception (tl::to_string (tr ("Unexpected end of PCell cache entry")));
+    }
+    const char *cp = mp_cp;
+    mp_cp += n;
+    return cp;
+  }
+};
+
+/**
+ *  @brief Describes a file in the cache directory for the size limitation
+ *
+ *  Entries are ordered by the time of the last use, the least recently used
+ *  entry first. Entries used in the current session within the same second
+ *  are ordered by the sequence of use.
+ */
+struct CacheFile
+{
+  CacheFile (const std::string &p, size_t s, long long t, size_t u)
+    : path (p), size (s), mtime (t), last_use (u)
+  { }
+
+  bool operator< (const CacheFile &other) const
+  {
+    if (mtime != other.mtime) {
+      return mtime < other.mtime;
+    }
+    return last_use < other.last_use;
+  }
+
+  std::string path;
+  size_t size;
+  long long mtime;
+  size_t last_use;
+};
+
+
+}
+
+// ---------------------------------------------------------------------------------
+//  PCellCache implementation
+
+PCellCache::PCellCache ()
+  : m_hits (0), m_misses (0), m_max_size (size_t (1024) * 1024 * 1024), m_size (0), m_size_valid (false), m_use_count (0)
+{
+  std::string max_size = tl::get_env ("KLAYOUT_PCELL_CACHE_SIZE");
+  if (! max_size.empty ()) {
+    try {
+      double mb = 0.0;
+      tl::from_string (max_size, mb);
+      m_max_size = size_t (std::max (0.0, mb) * 1024 * 1024);
+    } catch (tl::Exception &ex) {
+      tl::warn << tl::to_string (tr ("Invalid value of KLAYOUT_PCELL_CACHE_SIZE: ")) << ex.msg ();
+    }
+  }
+
+  set_path (tl::get_env ("KLAYOUT_PCELL_CACHE"));
+}
+
+PCellCache &
+PCellCache::instance ()
+{
+  static PCellCache s_instance;
+  return s_instance;
+}
+
+void
+PCellCache::set_path (const std::string &path)
+{
+  if (! path.empty () && ! tl::is_dir (path) && ! tl::mkpath (path)) {
+    tl::warn << tl::to_string (tr ("Unable to create PCell cache directory: ")) << path;
+    m_path.clear ();
+  } else {
+    m_path = path;
+  }
+
+  m_hits = m_misses = 0;
+  m_size_valid = false;
+  m_last_use.clear ();
+}
+
+void
+PCellCache::set_max_size (size_t bytes)
+{
+  m_max_size = bytes;
+  limit_size ();
+}
+
+size_t
+PCellCache::size ()
+{
+  if (! is_enabled ()) {
+    return 0;
+  }
+
+  if (! m_size_valid) {
+    m_size = 0;
+    std::vector<std::string> entries = tl::dir_entries (m_path, true, false);
+    for (std::vector<std::string>::const_iterator e = entries.begin (); e != entries.end (); ++e) {
+      if (tl::extension_last (*e) == "pcc") {
+        m_size += tl::file_size (tl::combine_path (m_path, *e));
+      }
+    }
+    m_size_valid = true;
+  }
+
+  return m_size;
+}
+
+void
+PCellCache::used (const std::string &path)
+{
+  //  the modification time marks the last use across sessions
+  tl::touch_file (path);
+  m_last_use [path] = ++m_use_count;
+}
+
+void
+PCellCache::limit_size ()
+{
+  if (! is_enabled () || m_max_size == 0 || size () <= m_max_size) {
+    return;
+  }
+
+  std::vector<CacheFile> files;
+
+  m_size = 0;
+  std::vector<std::string> entries = tl::dir_entries (m_path, true, false);
+  for (std::vector<std::string>::const_iterator e = entries.begin (); e != entries.end (); ++e) {
+    if (tl::extension_last (*e) == "pcc") {
+      std::string path = tl::combine_path (m_path, *e);
+      std::map<std::string, size_t>::const_iterator u = m_last_use.find (path);
+      files.push_back (CacheFile (path, tl::file_size (path), tl::file_last_modified (path), u != m_last_use.end () ? u->second : 0));
+      m_size += files.back ().size;
+    }
+  }
+
+  std::sort (files.begin (), files.end ());
+
+  //  remove the least recently used entries until there is some room for new entries
+  size_t target = m_max_size / 4 * 3;
+  for (std::vector<CacheFile>::const_iterator f = files.begin (); f != files.end () && m_size > target; ++f) {
+    if (tl::rm_file (f->path)) {
+      m_size -= std::min (m_size, f->size);
+      m_last_use.erase (f->path);
+    }
+  }
+}
+
+void
+PCellCache::clear ()
+{
+  if (! is_enabled ()) {
+    return;
+  }
+
+  std::vector<std::string> entries = tl::dir_entries (m_path, true, false);
+  for (std::vector<std::string>::const_iterator e = entries.begin (); e != entries.end (); ++e) {
+    if (tl::extension_last (*e) == "pcc") {
+      tl::rm_file (tl::combine_path (m_path, *e));
+    }
+  }
+
+  m_size = 0;
+  m_size_valid = true;
+  m_last_use.clear ();
+}
+
+static void
+put_key_double (std::string &key, double d)
+{
+  //  doubles are encoded by their bits: the string representation is rounded and
+  //  would let close parameter values share an entry
+  uint64_t bits = 0;
+  memcpy (&bits, &d, sizeof (double));
+  char b [24];
+  snprintf (b, sizeof (b), "#%016llx", (unsigned long long) bits);
+  key += b;
+}
+
+template <class Iter>
+static void
+put_key_points (std::string &key, Iter from, Iter to)
+{
+  key += "{";
+  for (Iter p = from; p != to; ++p) {
+    put_key_double (key, (*p).x ());
+    put_key_double (key, (*p).y ());
+  }
+  key += "}";
+}
+
+static void
+put_key_polygon (std::string &key, const db::DPolygon &poly)
+{
+  for (unsigned int c = 0; c < poly.holes () + 1; ++c) {
+    put_key_points (key, poly.contour (c).begin (), poly.contour (c).end ());
+  }
+}
+
+/**
+ *  @brief Appends an exact representation of the parameter to the key
+ *
+ *  Returns false, if there is no exact representation. Such parameters are not cached.
+ */
+static bool
+put_key_value (std::string &key, const tl::Variant &v)
+{
+  if (v.is_double ()) {
+
+    put_key_double (key, v.to_double ());
+
+  } else if (v.is_list ()) {
+
+    key += "(";
+    for (tl::Variant::const_iterator i = v.begin (); i != v.end (); ++i) {
+      if (i != v.begin ()) {
+        key += ",";
+      }
+      if (! put_key_value (key, *i)) {
+        return false;
+      }
+    }
+    key += ")";
+
+  } else if (v.is_array ()) {
+
+    key += "{";
+    for (tl::Variant::const_array_iterator i = v.begin_array (); i != v.end_array (); ++i) {
+      if (i != v.begin_array ()) {
+        key += ",";
+      }
+      if (! put_key_value (key, i->first)) {
+        return false;
+      }
+      key += "=>";
+      if (! put_key_value (key, i->second)) {
+        return false;
+      }
+    }
+    key += "}";
+
+  } else if (v.is_user<db::DPoint> ()) {
+
+    const db::DPoint &p = v.to_user<db::DPoint> ();
+    key += "P";
+    put_key_points (key, &p, &p + 1);
+
+  } else if (v.is_user<db::DBox> ()) {
+
+    const db::DBox &b = v.to_user<db::DBox> ();
+    db::DPoint pts [] = { b.p1 (), b.p2 () };
+    key += "B";
+    put_key_points (key, pts + 0, pts + 2);
+
+  } else if (v.is_user<db::DEdge> ()) {
+
+    const db::DEdge &e = v.to_user<db::DEdge> ();
+    db::DPoint pts [] = { e.p1 (), e.p2 () };
+    key += "E";
+    put_key_points (key, pts + 0, pts + 2);
+
+  } else if (v.is_user<db::DPolygon> ()) {
+
+    key += "Q";
+    put_key_polygon (key, v.to_user<db::DPolygon> ());
+
+  } else if (v.is_user<db::DPath> ()) {
+
+    const db::DPath &path = v.to_user<db::DPath> ();
+    key += path.round () ? "R" : "W";
+    put_key_double (key, path.width ());
+    put_key_double (key, path.bgn_ext ());
+    put_key_double (key, path.end_ext ());
+    put_key_points (key, path.begin (), path.end ());
+
+  } else if (v.is_user ()) {
+
+    //  integer geometries and layers have an exact string representation
+    if (! v.is_user<db::LayerProperties> () && ! v.is_user<db::Point> () && ! v.is_user<db::Box> () &&
+        ! v.is_user<db::Edge> () && ! v.is_user<db::Polygon> () && ! v.is_user<db::Path> ()) {
+      return false;
+    }
+    key += v.to_parsable_string ();
+
+  } else {
+    key += v.to_parsable_string ();
+  }
+
+  return true;
+}
+
+std::string
+PCellCache::entry_key (const db::Layout &layout, const db::PCellDeclaration &declaration, const pcell_parameters_type &parameters) const
+{
+  std::string key;
+
+  //  The owner of a PCell is the library: PCells registered in a layout are not cached, as a
+  //  layout has no identity across sessions and scripted declarations are indistinguishable by
+  //  their implementation class.
+  for (db::LibraryManager::iterator l = db::LibraryManager::instance ().begin (); l != db::LibraryManager::instance ().end (); ++l) {
+    const db::Library *lib = db::LibraryManager::instance ().lib (l->second);
+    if (lib && &lib->layout () == &layout) {
+      key += "lib:";
+      key += lib->get_name ();
+      break;
+    }
+  }
+
+  if (key.empty ()) {
+    return key;
+  }
+
+  key += ".";
+  key += declaration.name ();
+  key += "@";
+  put_key_double (key, layout.dbu ());
+  key += "(";
+  for (pcell_parameters_type::const_iterator p = parameters.begin (); p != parameters.end (); ++p) {
+    if (p != parameters.begin ()) {
+      key += ",";
+    }
+    if (! put_key_value (key, *p)) {
+      return std::string ();
+    }
+  }
+  key += ")";
+
+  return key;
+}
+
+std::string
+PCellCache::entry_path (const std::string &key) const
+{
+  //  FNV-1a hash of the key - collisions are detected by comparing the key stored in the entry
+  uint64_t h = 14695981039346656037ull;
+  for (std::string::const_iterator c = key.begin (); c != key.end (); ++c) {
+    h ^= (unsigned char) *c;
+    h *= 1099511628211ull;
+  }
+
+  char name [32];
+  snprintf (name, sizeof (name), "%016llx.pcc", (unsigned long long) h);
+  return tl::combine_path (m_path, name);
+}
+
+bool
+PCellCache::fetch (const db::Layout &layout, const db::PCellDeclaration &declaration, const pcell_parameters_type &parameters, const std::vector<unsigned int> &layer_ids, db::Cell &cell, std::string &display_name)
+{
+  if (! is_enabled ()) {
+    return false;
+  }
+
+  std::string version = declaration.cache_version ();
+  if (version.empty ()) {
+    return false;
+  }
+
+  std::string key = entry_key (layout, declaration, parameters);
+  if (key.empty ()) {
+    return false;
+  }
+
+  std::string path = entry_path (key);
+  if (! tl::file_exists (path)) {
+    ++m_misses;
+    return false;
+  }
+
+  try {
+
+    std::string data;
+    {
+      tl::InputStream stream (path);
+      data = stream.read_all ();
+    }
+
+    if (data.size () < 5 || data.compare (0, 4, magic) != 0 || (unsigned char) data [4] != format_version) {
+      throw tl::Exception (tl::to_string (tr ("Not a PCell cache entry")));
+    }
+    data.erase (0, 5);
+
+    EntryReader reader (data, *cell.layout ());
+
+    if (reader.get_string () != key) {
+      //  hash collision: the entry belongs to another variant
+      ++m_misses;
+      return false;
+    }
+
+    if (reader.get_string () != version) {
+      //  stale entry: the PCell implementation has changed
+      tl::rm_file (path);
+      m_size_valid = false;
+      ++m_misses;
+      return false;
+    }
+
+    std::string dn = reader.get_string ();
+
+    size_t nlayers = size_t (reader.get_uint ());
+    for (size_t i = 0; i < nlayers; ++i) {
+      size_t slot = size_t (reader.get_uint ());
+      if (slot >= layer_ids.size ()) {
+        throw tl::Exception (tl::to_string (tr ("Invalid layer in PCell cache entry")));
+      }
+      db::Shapes &shapes = cell.shapes (layer_ids [slot]);
+      size_t nshapes = size_t (reader.get_uint ());
+      for (size_t j = 0; j < nshapes; ++j) {
+        reader.get_shape (shapes);
+      }
+    }
+
+    if (! reader.at_end ()) {
+      throw tl::Exception (tl::to_string (tr ("Extra bytes at the end of PCell cache entry")));
+    }
+
+    display_name = dn;
+    used (path);
+    ++m_hits;
+    return true;
+
+  } catch (tl::Exception &ex) {
+
+    tl::warn << tl::to_string (tr ("Ignoring PCell cache entry ")) << path << ": " << ex.msg ();
+    cell.clear_shapes ();
+
+    tl::rm_file (path);
+    m_size_valid = false;
+    ++m_misses;
+    return false;
+
+  }
+}
+
+void
+PCellCache::store (const db::Layout &layout, const db::PCellDeclaration &declaration, const pcell_parameters_type &parameters, const std::vector<unsigned int> &layer_ids, const db::Cell &cell, const std::string &display_name)
+{
+  if (! is_enabled ()) {
+    return;
+  }
+
+  std::string version = declaration.cache_version ();
+  if (version.empty ()) {
+    return;
+  }
+
+  std::string key = entry_key (layout, declaration, parameters);
+  if (key.empty ()) {
+    return;
+  }
+
+  //  instances cannot be restored in a new session as the target cells may not exist
+  if (cell.cell_instances () != 0) {
+    return;
+  }
+
+  EntryWriter writer (layout);
+
+  try {
+
+    writer.data () += magic;
+    writer.put_byte (format_version);
+    writer.put_string (key);
+    writer.put_string (version);
+    writer.put_string (display_name);
+
+    //  shapes on layers other than the PCell layers cannot be restored
+    std::vector<int> slots (layout.layers (), -1);
+    for (std::vector<unsigned int>::const_iterator l = layer_ids.begin (); l != layer_ids.end (); ++l) {
+      if (*l < slots.size () && slots [*l] < 0) {
+        slots [*l] = int (l - layer_ids.begin ());
+      }
+    }
+
+    size_t nlayers = 0;
+    for (unsigned int l = 0; l < layout.layers (); ++l) {
+      if (! cell.shapes (l).empty ()) {
+        if (slots [l] < 0) {
+          throw NotCacheable ();
+        }
+        ++nlayers;
+      }
+    }
+
+    writer.put_uint (nlayers);
+    for (unsigned int l = 0; l < layout.layers (); ++l) {
+
+      const db::Shapes &shapes = cell.shapes (l);
+      if (shapes.empty ()) {
+        continue;
+      }
+
+      //  arrays are delivered member by member, hence count the shapes as we see them
+      size_t nshapes = 0;
+      for (db::ShapeIterator s = shapes.begin (db::ShapeIterator::All); ! s.at_end (); ++s) {
+        ++nshapes;
+      }
+
+      writer.put_uint (slots [l]);
+      writer.put_uint (nshapes);
+      for (db::ShapeIterator s = shapes.begin (db::ShapeIterator::All); ! s.at_end (); ++s) {
+        writer.put_shape (*s);
+      }
+
+    }
+
+  } catch (NotCacheable) {
+    return;
+  }
+
+  std::string path = entry_path (key);
+  std::string tmp_path = path + ".tmp";
+  size_t old_size = tl::file_size (path);
+
+  try {
+
+    {
+      tl::OutputStream os (tmp_path, tl::OutputStream::OM_Plain);
+      os.put (writer.data ().c_str (), writer.data ().size ());
+    }
+
+    //  replace the entry in one step so concurrent sessions do not see partial entries
+    if (rename (tmp_path.c_str (), path.c_str ()) != 0) {
+      //  on some platforms, rename does not replace existing files
+      tl::rm_file (path);
+      if (rename (tmp_path.c_str (), path.c_str ()) != 0) {
+        tl::rm_file (tmp_path);
+        m_size_valid = false;
+        return;
+      }
+    }
+
+    if (m_size_valid) {
+      m_size -= std::min (m_size, old_size);
+      m_size += writer.data ().size ();
+    }
+
+    used (path);
+    limit_size ();
+
+  } catch (tl::Exception &ex) {
+    tl::warn << tl::to_string (tr ("Unable to write PCell cache entry ")) << path << ": " << ex.msg ();
+  }
+}
+
+}
+
@@ -0,0 +1,181 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2020 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+#ifndef HDR_dbPCellCache
+#define HDR_dbPCellCache
+
+#include "dbCommon.h"
+#include "dbTypes.h"
+#include "dbPCellDeclaration.h"
+
+#include <string>
+#include <vector>
+#include <map>
+
+namespace db
+{
+
+class Layout;
+class Cell;
+
+/**
+ *  @brief A persistent cache for the layout produced by PCells
+ *
+ *  The cache keeps the shapes produced for a PCell variant in a directory, one file
+ *  per variant. The file name is derived from the library, the PCell name, the database
+ *  unit and the parameters. The parameters are encoded exactly, i.e. doubles by their
+ *  bits. The file stores the declaration's cache version (see PCellDeclaration::cache_version).
+ *  An entry with a different version is considered stale and removed when it is encountered.
+ *
+ *  Only library PCells delivering a non-empty cache version are cached: PCells registered
+ *  in a layout have no owner which can be identified in another session. Variants with
+ *  instances are not cached, because the instantiated cells cannot be restored in another
+ *  session. Variants with parameters of types not having an exact representation are not
+ *  cached either.
+ *
+ *  The cache is disabled if the path is empty. The initial path is taken from
+ *  the KLAYOUT_PCELL_CACHE environment variable.
+ *
+ *  The size of the cache directory is limited (see set_max_size). When an entry is
+ *  stored and the limit is exceeded, the least recently used entries are removed.
+ *
+ *  The cache is not thread-safe and must be used from the main thread only.
+ */
+class DB_PUBLIC PCellCache
+{
+public:
+  /**
+   *  @brief Constructor
+   */
+  PCellCache ();
+
+  /**
+   *  @brief Gets the singleton instance
+   */
+  static PCellCache &instance ();
+
+  /**
+   *  @brief Sets the path of the cache directory
+   *
+   *  The directory is created if required. An empty path disables the cache.
+   */
+  void set_path (const std::string &path);
+
+  /**
+   *  @brief Gets the path of the cache directory
+   */
+  const std::string &path () const
+  {
+    return m_path;
+  }
+
+  /**
+   *  @brief Gets a value indicating whether the cache is enabled
+   */
+  bool is_enabled () const
+  {
+    return ! m_path.empty ();
+  }
+
+  /**
+   *  @brief Sets the maximum size of the cache directory in bytes
+   *
+   *  If storing an entry makes the directory exceed this size, the least recently
+   *  used entries are removed until the size is below three quarters of the limit.
+   *  A value of 0 disables the limit. The initial value is taken from the
+   *  KLAYOUT_PCELL_CACHE_SIZE environment variable (in megabytes). The default is 1 GB.
+   */
+  void set_max_size (size_t bytes);
+
+  /**
+   *  @brief Gets the maximum size of the cache directory in bytes
+   */
+  size_t max_size () const
+  {
+    return m_max_size;
+  }
+
+  /**
+   *  @brief Gets the size of the entries in the cache directory in bytes
+   */
+  size_t size ();
+
+  /**
+   *  @brief Restores the layout of a PCell variant from the cache
+   *
+   *  "layout" is the layout the variant lives in, "layer_ids" are the layers as
+   *  they would be passed to PCellDeclaration::produce. On success, the shapes and
+   *  instances are inserted into "cell", "display_name" receives the display name
+   *  and true is returned. If no valid entry exists, the cell is not modified and
+   *  false is returned.
+   */
+  bool fetch (const db::Layout &layout, const db::PCellDeclaration &declaration, const pcell_parameters_type &parameters, const std::vector<unsigned int> &layer_ids, db::Cell &cell, std::string &display_name);
+
+  /**
+   *  @brief Stores the layout of a PCell variant in the cache
+   *
+   *  The arguments are the same as for "fetch". If the cell contains objects which
+   *  cannot be cached, nothing is stored.
+   */
+  void store (const db::Layout &layout, const db::PCellDeclaration &declaration, const pcell_parameters_type &parameters, const std::vector<unsigned int> &layer_ids, const db::Cell &cell, const std::string &display_name);
+
+  /**
+   *  @brief Removes all entries from the cache directory
+   */
+  void clear ();
+
+  /**
+   *  @brief Gets the number of successful fetches since the cache was enabled
+   */
+  size_t hits () const
+  {
+    return m_hits;
+  }
+
+  /**
+   *  @brief Gets the number of unsuccessful fetches since the cache was enabled
+   */
+  size_t misses () const
+  {
+    return m_misses;
+  }
+
+private:
+  std::string m_path;
+  size_t m_hits, m_misses;
+  size_t m_max_size;
+  size_t m_size;
+  bool m_size_valid;
+  size_t m_use_count;
+  std::map<std::string, size_t> m_last_use;
+
+  std::string entry_key (const db::Layout &layout, const db::PCellDeclaration &declaration, const pcell_parameters_type &parameters) const;
+  std::string entry_path (const std::string &key) const;
+  void used (const std::string &path);
+  void limit_size ();
+};
+
+}
+
+#endif
+
@@ -384,6 +384,53 @@ public:
     // .. nothing yet ..
   }
 
+  /**
+   *  @brief Returns true, if the layout of several variants can be produced in parallel
+   *
+   *  If this method returns true, "produce" may be called from worker threads for different
+   *  variants at the same time (see Layout::refresh_pcell_variants). In this case, the cell
+   *  given to "produce" belongs to a temporary layout with the same database unit and layers.
+   *  An implementation returning true must only create shapes and must not use global
+   *  state which is not thread-safe. If the production creates cells or instances, the
+   *  variant is produced again in the original layout.
+   *
+   *  The default implementation returns false.
+   */
+  virtual bool can_produce_in_parallel () const
+  {
+    return false;
+  }
+
+  /**
+   *  @brief Prepares the parallel production of variants
+   *
+   *  This method is called once in the main thread before variants of this PCell are
+   *  produced in parallel. An implementation can initialize shared resources here which
+   *  "produce" is then able to use concurrently (e.g. fonts loaded on demand).
+   *
+   *  The default implementation does nothing.
+   */
+  virtual void prepare_parallel_production () const
+  {
+    //  .. nothing yet ..
+  }
+
+  /**
+   *  @brief Gets the version string for the persistent PCell cache
+   *
+   *  If this method returns a non-empty string, the layout produced for a variant
+   *  may be stored in the persistent PCell cache (see db::PCellCache) and is taken
+   *  from there instead of calling "produce" again. The version string must change
+   *  whenever the implementation changes - e.g. it can be a hash of the library source.
+   *  Cache entries with a different version are discarded.
+   *
+   *  The default implementation returns an empty string which disables caching.
+   */
+  virtual std::string cache_version () const
+  {
+    return std::string ();
+  }
+
   /**
    *  @brief Get the display name for a PCell with the given parameters
    *
@@ -23,8 +23,15 @@
 
 #include "dbPCellVariant.h"
 #include "dbPCellHeader.h"
+#include "dbLayoutUtils.h"
+#include "dbPCellCache.h"
 
 #include "tlLog.h"
+#include "tlThreadedWorkers.h"
+
+#include <memory>
+#include <algorithm>
+#include <set>
 
 namespace db
 {
@@ -156,85 +163,369 @@ PCellVariant::update (ImportLayerMapping *layer_mapping)
     std::vector<unsigned int> layer_ids;
     try {
       layer_ids = header->get_layer_indices (*layout (), m_parameters, layer_mapping);
-      header->declaration ()->produce (*layout (), layer_ids, m_parameters, *this);
-      m_display_name = header->declaration ()->get_display_name (m_parameters);
+      db::PCellCache &cache = db::PCellCache::instance ();
+      if (! cache.fetch (*layout (), *header->declaration (), m_parameters, layer_ids, *this, m_display_name)) {
+        header->declaration ()->produce (*layout (), layer_ids, m_parameters, *this);
+        m_display_name = header->declaration ()->get_display_name (m_parameters);
+        cache.store (*layout (), *header->declaration (), m_parameters, layer_ids, *this, m_display_name);
+      }
     } catch (tl::Exception &ex) {
-      tl::error << ex.msg ();
-      if (! layer_ids.empty ()) {
-        //  put error messages into layout as text objects
-        shapes (layer_ids [0]).insert (db::Text (ex.msg (), db::Trans ()));
+      produce_error (layer_ids, ex.msg ());
+    }
+
+    produce_guiding_shapes (pn, dn);
+
+  }
+}
+
+void
+PCellVariant::produce_error (const std::vector<unsigned int> &layer_ids, const std::string &msg)
+{
+  tl::error << msg;
+  if (! layer_ids.empty ()) {
+    //  put error messages into layout as text objects
+    shapes (layer_ids [0]).insert (db::Text (msg, db::Trans ()));
+  }
+}
+
+void
+PCellVariant::produce_guiding_shapes (db::property_names_id_type pn, db::property_names_id_type dn)
+{
+  PCellHeader *header = pcell_header ();
+  if (! header || ! header->declaration ()) {
+    return;
+  }
+
+  //  produce the shape parameters on the guiding shape layer so they can be edited
+  size_t i = 0;
+  const std::vector<db::PCellParameterDeclaration> &pcp = header->declaration ()->parameter_declarations ();
+  for (std::vector<db::PCellParameterDeclaration>::const_iterator p = pcp.begin (); p != pcp.end (); ++p, ++i) {
+
+    if (i < m_parameters.size () && p->get_type () == db::PCellParameterDeclaration::t_shape && ! p->is_hidden ()) {
+
+      //  use property with name "name" to indicate the parameter name
+      db::PropertiesRepository::properties_set props;
+      props.insert (std::make_pair (pn, tl::Variant (p->get_name ())));
+
+      if (! p->get_description ().empty ()) {
+        props.insert (std::make_pair (dn, tl::Variant (p->get_description ())));
       }
+
+      if (m_parameters[i].is_user<db::DBox> ()) {
+
+        shapes (layout ()->guiding_shape_layer ()).insert (db::BoxWithProperties(db::Box (m_parameters[i].to_user<db::DBox> () * (1.0 / layout ()->dbu ())), layout ()->properties_repository ().properties_id (props)));
+
+      } else if (m_parameters[i].is_user<db::Box> ()) {
+
+        shapes (layout ()->guiding_shape_layer ()).insert (db::BoxWithProperties(m_parameters[i].to_user<db::Box> (), layout ()->properties_repository ().properties_id (props)));
+
+      } else if (m_parameters[i].is_user<db::DEdge> ()) {
+
+        shapes (layout ()->guiding_shape_layer ()).insert (db::EdgeWithProperties(db::Edge (m_parameters[i].to_user<db::DEdge> () * (1.0 / layout ()->dbu ())), layout ()->properties_repository ().properties_id (props)));
+
+      } else if (m_parameters[i].is_user<db::Edge> ()) {
+
+        shapes (layout ()->guiding_shape_layer ()).insert (db::EdgeWithProperties(m_parameters[i].to_user<db::Edge> (), layout ()->properties_repository ().properties_id (props)));
+
+      } else if (m_parameters[i].is_user<db::DPoint> ()) {
+
+        db::DPoint p = m_parameters[i].to_user<db::DPoint> ();
+        shapes (layout ()->guiding_shape_layer ()).insert (db::BoxWithProperties(db::Box (db::DBox (p, p) * (1.0 / layout ()->dbu ())), layout ()->properties_repository ().properties_id (props)));
+
+      } else if (m_parameters[i].is_user<db::Point> ()) {
+
+        db::Point p = m_parameters[i].to_user<db::Point> ();
+        shapes (layout ()->guiding_shape_layer ()).insert (db::BoxWithProperties(db::Box (p, p), layout ()->properties_repository ().properties_id (props)));
+
+      } else if (m_parameters[i].is_user<db::DPolygon> ()) {
+
+        db::complex_trans<db::DCoord, db::Coord> dbu_trans (1.0 / layout ()->dbu ());
+        db::Polygon poly = m_parameters[i].to_user<db::DPolygon> ().transformed (dbu_trans, false);
+        //  Hint: we don't compress the polygon since we don't want to loose information
+        shapes (layout ()->guiding_shape_layer ()).insert (db::PolygonWithProperties(poly, layout ()->properties_repository ().properties_id (props)));
+
+      } else if (m_parameters[i].is_user<db::Polygon> ()) {
+
+        db::Polygon poly = m_parameters[i].to_user<db::Polygon> ();
+        //  Hint: we don't compress the polygon since we don't want to loose information
+        shapes (layout ()->guiding_shape_layer ()).insert (db::PolygonWithProperties(poly, layout ()->properties_repository ().properties_id (props)));
+
+      } else if (m_parameters[i].is_user<db::DPath> ()) {
+
+        db::complex_trans<db::DCoord, db::Coord> dbu_trans (1.0 / layout ()->dbu ());
+        shapes (layout ()->guiding_shape_layer ()).insert (db::PathWithProperties(dbu_trans * m_parameters[i].to_user<db::DPath> (), layout ()->properties_repository ().properties_id (props)));
+
+      } else if (m_parameters[i].is_user<db::Path> ()) {
+
+        shapes (layout ()->guiding_shape_layer ()).insert (db::PathWithProperties(m_parameters[i].to_user<db::Path> (), layout ()->properties_repository ().properties_id (props)));
+
+      }
+
     }
 
-    //  produce the shape parameters on the guiding shape layer so they can be edited
-    size_t i = 0;
-    const std::vector<db::PCellParameterDeclaration> &pcp = header->declaration ()->parameter_declarations ();
-    for (std::vector<db::PCellParameterDeclaration>::const_iterator p = pcp.begin (); p != pcp.end (); ++p, ++i) {
+  }
+}
+
+
+// ---------------------------------------------------------------------------------
+//  Parallel production of PCell variants
+
+namespace
+{
+
+/**
+ *  @brief Holds the input and the result of the production of one variant
+ */
+struct PCellProductionItem
+{
+  PCellProductionItem ()
+    : variant (0), declaration (0), layout (0), cell_index (0), failed (false), cached (false), needs_update (false)
+  { }
+
+  PCellVariant *variant;
+  const PCellDeclaration *declaration;
+  std::vector<unsigned int> layer_ids;
+  db::Layout *layout;
+  db::cell_index_type cell_index;
+  bool failed;
+  bool cached;
+  bool needs_update;
+  std::string error;
+};
+
+/**
+ *  @brief Holds the temporary layouts the variants are produced into
+ */
+struct PCellProductionLayouts
+{
+  ~PCellProductionLayouts ()
+  {
+    for (std::vector<db::Layout *>::const_iterator l = layouts.begin (); l != layouts.end (); ++l) {
+      delete *l;
+    }
+  }
+
+  std::vector<db::Layout *> layouts;
+};
+
+/**
+ *  @brief A task producing a range of variants into one temporary layout
+ *
+ *  Creating a layout per variant is expensive compared to the production of simple
+ *  PCells, hence the variants are produced in batches.
+ */
+class PCellProductionTask
+  : public tl::Task
+{
+public:
+  PCellProductionTask (PCellProductionItem *from, PCellProductionItem *to, db::Layout *layout, const db::Layout *target)
+    : mp_from (from), mp_to (to), mp_layout (layout), mp_target (target)
+  { }
+
+  PCellProductionItem *from () const { return mp_from; }
+  PCellProductionItem *to () const { return mp_to; }
+  db::Layout *layout () const { return mp_layout; }
+  const db::Layout *target () const { return mp_target; }
+
+private:
+  PCellProductionItem *mp_from, *mp_to;
+  db::Layout *mp_layout;
+  const db::Layout *mp_target;
+};
+
+class PCellProductionWorker
+  : public tl::Worker
+{
+public:
+  PCellProductionWorker ()
+    : tl::Worker ()
+  { }
+
+  virtual void perform_task (tl::Task *task)
+  {
+    PCellProductionTask *pt = dynamic_cast<PCellProductionTask *> (task);
+    tl_assert (pt != 0);
 
-      if (i < m_parameters.size () && p->get_type () == db::PCellParameterDeclaration::t_shape && ! p->is_hidden ()) {
+    db::Layout *layout = pt->layout ();
+    const db::Layout *target = pt->target ();
 
-        //  use property with name "name" to indicate the parameter name
-        db::PropertiesRepository::properties_set props;
-        props.insert (std::make_pair (pn, tl::Variant (p->get_name ())));
+    for (PCellProductionItem *item = pt->from (); item != pt->to (); ++item) {
 
-        if (! p->get_description ().empty ()) {
-          props.insert (std::make_pair (dn, tl::Variant (p->get_description ())));
+      if (! item->declaration || item->failed) {
+        continue;
+      }
+
+      try {
+
+        //  produce into the temporary layout with the same database unit and layers
+        for (std::vector<unsigned int>::const_iterator l = item->layer_ids.begin (); l != item->layer_ids.end (); ++l) {
+          if (! layout->is_valid_layer (*l)) {
+            layout->insert_layer (*l, target->get_properties (*l));
+          }
         }
 
-        if (m_parameters[i].is_user<db::DBox> ()) {
+        size_t cells_before = layout->cells ();
 
-          shapes (layout ()->guiding_shape_layer ()).insert (db::BoxWithProperties(db::Box (m_parameters[i].to_user<db::DBox> () * (1.0 / layout ()->dbu ())), layout ()->properties_repository ().properties_id (props)));
+        item->layout = layout;
+        item->cell_index = layout->add_cell (target->cell_name (item->variant->cell_index ()));
+        item->declaration->produce (*layout, item->layer_ids, item->variant->parameters (), layout->cell (item->cell_index));
 
-        } else if (m_parameters[i].is_user<db::Box> ()) {
+        //  the production has created cells or instances: these need to be created in the original layout
+        item->needs_update = (layout->cells () != cells_before + 1 || layout->cell (item->cell_index).cell_instances () != 0);
 
-          shapes (layout ()->guiding_shape_layer ()).insert (db::BoxWithProperties(m_parameters[i].to_user<db::Box> (), layout ()->properties_repository ().properties_id (props)));
+      } catch (tl::Exception &ex) {
+        item->failed = true;
+        item->error = ex.msg ();
+      } catch (std::exception &ex) {
+        item->failed = true;
+        item->error = ex.what ();
+      }
+
+    }
+  }
+};
 
-        } else if (m_parameters[i].is_user<db::DEdge> ()) {
+}
 
-          shapes (layout ()->guiding_shape_layer ()).insert (db::EdgeWithProperties(db::Edge (m_parameters[i].to_user<db::DEdge> () * (1.0 / layout ()->dbu ())), layout ()->properties_repository ().properties_id (props)));
+void
+PCellVariant::update_variants (const std::vector<PCellVariant *> &variants, unsigned int threads)
+{
+  if (threads == 0) {
+    for (std::vector<PCellVariant *>::const_iterator v = variants.begin (); v != variants.end (); ++v) {
+      (*v)->update ();
+    }
+    return;
+  }
 
-        } else if (m_parameters[i].is_user<db::Edge> ()) {
+  //  Serial phase: clear the variants and resolve the layers (this may create layers in the target layout)
 
-          shapes (layout ()->guiding_shape_layer ()).insert (db::EdgeWithProperties(m_parameters[i].to_user<db::Edge> (), layout ()->properties_repository ().properties_id (props)));
+  std::vector<PCellProductionItem> items (variants.size ());
+  std::set<const db::PCellDeclaration *> prepared;
 
-        } else if (m_parameters[i].is_user<db::DPoint> ()) {
+  for (size_t i = 0; i < variants.size (); ++i) {
 
-          db::DPoint p = m_parameters[i].to_user<db::DPoint> ();
-          shapes (layout ()->guiding_shape_layer ()).insert (db::BoxWithProperties(db::Box (db::DBox (p, p) * (1.0 / layout ()->dbu ())), layout ()->properties_repository ().properties_id (props)));
+    PCellVariant *variant = variants [i];
+    PCellProductionItem &item = items [i];
+    item.variant = variant;
 
-        } else if (m_parameters[i].is_user<db::Point> ()) {
+    tl_assert (variant->layout () != 0);
 
-          db::Point p = m_parameters[i].to_user<db::Point> ();
-          shapes (layout ()->guiding_shape_layer ()).insert (db::BoxWithProperties(db::Box (p, p), layout ()->properties_repository ().properties_id (props)));
+    PCellHeader *header = variant->pcell_header ();
+    if (! header || ! header->declaration () || ! header->declaration ()->can_produce_in_parallel ()) {
+      continue;
+    }
 
-        } else if (m_parameters[i].is_user<db::DPolygon> ()) {
+    variant->clear_shapes ();
+    variant->clear_insts ();
 
-          db::complex_trans<db::DCoord, db::Coord> dbu_trans (1.0 / layout ()->dbu ());
-          db::Polygon poly = m_parameters[i].to_user<db::DPolygon> ().transformed (dbu_trans, false);
-          //  Hint: we don't compress the polygon since we don't want to loose information
-          shapes (layout ()->guiding_shape_layer ()).insert (db::PolygonWithProperties(poly, layout ()->properties_repository ().properties_id (props)));
+    try {
+      item.layer_ids = header->get_layer_indices (*variant->layout (), variant->m_parameters);
+      if (db::PCellCache::instance ().fetch (*variant->layout (), *header->declaration (), variant->m_parameters, item.layer_ids, *variant, variant->m_display_name)) {
+        item.cached = true;
+      } else {
+        item.declaration = header->declaration ();
+        if (prepared.insert (item.declaration).second) {
+          item.declaration->prepare_parallel_production ();
+        }
+      }
+    } catch (tl::Exception &ex) {
+      item.failed = true;
+      item.error = ex.msg ();
+    }
 
-        } else if (m_parameters[i].is_user<db::Polygon> ()) {
+  }
 
-          db::Polygon poly = m_parameters[i].to_user<db::Polygon> ();
-          //  Hint: we don't compress the polygon since we don't want to loose information
-          shapes (layout ()->guiding_shape_layer ()).insert (db::PolygonWithProperties(poly, layout ()->properties_repository ().properties_id (props)));
+  //  Parallel phase: produce the layout of the variants into temporary layouts. The variants
+  //  are produced in a few batches per thread, each with its own temporary layout.
 
-        } else if (m_parameters[i].is_user<db::DPath> ()) {
+  PCellProductionLayouts temp_layouts;
+  tl::Job<PCellProductionWorker> job (threads);
 
-          db::complex_trans<db::DCoord, db::Coord> dbu_trans (1.0 / layout ()->dbu ());
-          shapes (layout ()->guiding_shape_layer ()).insert (db::PathWithProperties(dbu_trans * m_parameters[i].to_user<db::DPath> (), layout ()->properties_repository ().properties_id (props)));
+  size_t batch_size = std::max (size_t (1), items.size () / (size_t (threads) * 4));
+  for (size_t from = 0; from < items.size (); from += batch_size) {
 
-        } else if (m_parameters[i].is_user<db::Path> ()) {
+    size_t to = std::min (items.size (), from + batch_size);
 
-          shapes (layout ()->guiding_shape_layer ()).insert (db::PathWithProperties(m_parameters[i].to_user<db::Path> (), layout ()->properties_repository ().properties_id (props)));
+    bool any = false;
+    for (size_t i = from; i < to && ! any; ++i) {
+      any = (items [i].declaration && ! items [i].failed);
+    }
 
+    if (any) {
+      const db::Layout *target = items [from].variant->layout ();
+      db::Layout *layout = new db::Layout (target->is_editable ());
+      temp_layouts.layouts.push_back (layout);
+      layout->dbu (target->dbu ());
+      job.schedule (new PCellProductionTask (&items [from], &items [0] + to, layout, target));
+    }
+
+  }
+
+  try {
+    job.start ();
+    job.wait ();
+  } catch (...) {
+    job.terminate ();
+    throw;
+  }
+
+  if (job.has_error ()) {
+    throw tl::Exception (job.error_messages ().front ());
+  }
+
+  //  Serial phase: transfer the results in the original order
+
+  for (std::vector<PCellProductionItem>::iterator i = items.begin (); i != items.end (); ++i) {
+
+    PCellVariant *variant = i->variant;
+
+    if (! i->declaration && ! i->failed && ! i->cached) {
+      //  not eligible for parallel production
+      variant->update ();
+      continue;
+    }
+
+    db::Layout *layout = variant->layout ();
+    db::property_names_id_type pn = layout->properties_repository ().prop_name_id (tl::Variant ("name"));
+    db::property_names_id_type dn = layout->properties_repository ().prop_name_id (tl::Variant ("description"));
+
+    if (i->cached) {
+      variant->produce_guiding_shapes (pn, dn);
+      continue;
+    }
+
+    if (! i->failed && i->needs_update) {
+      //  the production has created cells or instances: these need to be created in the original layout
+      variant->update ();
+      continue;
+    }
+
+    if (i->failed) {
+
+      variant->produce_error (i->layer_ids, i->error);
+
+    } else {
+
+      const db::Cell &produced = i->layout->cell (i->cell_index);
+      db::PropertyMapper pm (*layout, *i->layout);
+
+      for (std::vector<unsigned int>::const_iterator l = i->layer_ids.begin (); l != i->layer_ids.end (); ++l) {
+        if (i->layout->is_valid_layer (*l) && ! produced.shapes (*l).empty ()) {
+          variant->shapes (*l).insert (produced.shapes (*l), pm);
         }
+      }
 
+      try {
+        variant->m_display_name = i->declaration->get_display_name (variant->m_parameters);
+        db::PCellCache::instance ().store (*layout, *i->declaration, variant->m_parameters, i->layer_ids, *variant, variant->m_display_name);
+      } catch (tl::Exception &ex) {
+        variant->produce_error (i->layer_ids, ex.msg ());
       }
 
     }
 
+    variant->produce_guiding_shapes (pn, dn);
+
   }
 }
 
@@ -120,6 +120,16 @@ public:
    */
   virtual void update (ImportLayerMapping *layer_mapping = 0);
 
+  /**
+   *  @brief Updates the layout of several variants
+   *
+   *  With "threads" > 0, the layout of the variants whose declaration supports parallel
+   *  production (see PCellDeclaration::can_produce_in_parallel) is produced in the
+   *  given number of worker threads. All other variants are updated in the calling thread.
+   *  The result is the same as calling "update" on each variant.
+   */
+  static void update_variants (const std::vector<PCellVariant *> &variants, unsigned int threads);
+
   /**
    *  @brief Tell, if this cell is a proxy cell
    *
@@ -153,6 +163,9 @@ private:
   mutable std::string m_display_name;
   size_t m_pcell_id;
   bool m_registered;
+
+  void produce_error (const std::vector<unsigned int> &layer_ids, const std::string &msg);
+  void produce_guiding_shapes (db::property_names_id_type pn, db::property_names_id_type dn);
 };
   
 }
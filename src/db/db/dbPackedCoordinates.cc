@@ -0,0 +1,201 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2020 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+#include "dbPackedCoordinates.h"
+#include "tlException.h"
+#include "tlInternational.h"
+
+#include <cstring>
+
+namespace db
+{
+
+static inline void
+put_number (std::vector<char> &v, int64_t n, bool wide)
+{
+  if (wide) {
+    const char *cp = (const char *) &n;
+    v.insert (v.end (), cp, cp + sizeof (int64_t));
+  } else {
+    int32_t n32 = int32_t (n);
+    const char *cp = (const char *) &n32;
+    v.insert (v.end (), cp, cp + sizeof (int32_t));
+  }
+}
+
+static inline int64_t
+get_number (const char *p, size_t i, bool wide)
+{
+  if (wide) {
+    int64_t n;
+    memcpy (&n, p + i * sizeof (int64_t), sizeof (int64_t));
+    return n;
+  } else {
+    int32_t n;
+    memcpy (&n, p + i * sizeof (int32_t), sizeof (int32_t));
+    return n;
+  }
+}
+
+static size_t
+number_count (const std::vector<char> &v, bool wide, const char *what)
+{
+  size_t w = wide ? sizeof (int64_t) : sizeof (int32_t);
+  if (v.size () % w != 0) {
+    throw tl::Exception (tl::to_string (tr ("Packed %s array size is not a multiple of %d bytes")), what, int (w));
+  }
+  return v.size () / w;
+}
+
+// ------------------------------------------------------------------------------------
+//  PackedPolygonWriter implementation
+
+PackedPolygonWriter::PackedPolygonWriter (bool wide)
+  : m_wide (wide), m_npoints (0), m_ncontours (0)
+{
+  put (m_contours, 0);
+  put (m_polygons, 0);
+}
+
+void
+PackedPolygonWriter::put (std::vector<char> &v, int64_t n)
+{
+  put_number (v, n, m_wide);
+}
+
+void
+PackedPolygonWriter::add (const db::Polygon &poly)
+{
+  for (unsigned int c = 0; c <= poly.holes (); ++c) {
+
+    const db::Polygon::contour_type &ctr = poly.contour (c);
+    for (size_t i = 0; i < ctr.size (); ++i) {
+      db::Point p = ctr [i];
+      put (m_points, p.x ());
+      put (m_points, p.y ());
+    }
+
+    m_npoints += ctr.size ();
+    put (m_contours, int64_t (m_npoints));
+
+  }
+
+  m_ncontours += poly.holes () + 1;
+  put (m_polygons, int64_t (m_ncontours));
+}
+
+// ------------------------------------------------------------------------------------
+//  PackedPolygonReader implementation
+
+PackedPolygonReader::PackedPolygonReader (const std::vector<char> &points, const std::vector<char> &contours, const std::vector<char> &polygons, bool wide)
+  : m_wide (wide), mp_points (points.empty () ? 0 : &points.front ()), mp_contours (contours.empty () ? 0 : &contours.front ()), mp_polygons (polygons.empty () ? 0 : &polygons.front ())
+{
+  size_t n = number_count (points, wide, "points");
+  if (n % 2 != 0) {
+    throw tl::Exception (tl::to_string (tr ("Packed points array does not have an even number of coordinates")));
+  }
+  m_npoints = n / 2;
+
+  n = number_count (contours, wide, "contours");
+  m_ncontours = n > 0 ? n - 1 : 0;
+
+  n = number_count (polygons, wide, "polygons");
+  m_npolygons = n > 0 ? n - 1 : 0;
+}
+
+int64_t
+PackedPolygonReader::at (const char *p, size_t i) const
+{
+  return get_number (p, i, m_wide);
+}
+
+void
+PackedPolygonReader::contour (size_t c, std::vector<db::Point> &pts) const
+{
+  if (c >= m_ncontours) {
+    throw tl::Exception (tl::to_string (tr ("Contour index %ld is out of range in packed polygons")), long (c));
+  }
+
+  int64_t from = at (mp_contours, c), to = at (mp_contours, c + 1);
+  if (from < 0 || to < from || size_t (to) > m_npoints) {
+    throw tl::Exception (tl::to_string (tr ("Invalid point offsets for contour %ld in packed polygons")), long (c));
+  }
+
+  pts.clear ();
+  pts.reserve (size_t (to - from));
+  for (int64_t i = from; i < to; ++i) {
+    pts.push_back (db::Point (db::Coord (at (mp_points, size_t (i) * 2)), db::Coord (at (mp_points, size_t (i) * 2 + 1))));
+  }
+}
+
+void
+PackedPolygonReader::get (size_t n, db::Polygon &poly) const
+{
+  tl_assert (n < m_npolygons);
+
+  int64_t from = at (mp_polygons, n), to = at (mp_polygons, n + 1);
+  if (from < 0 || to <= from || size_t (to) > m_ncontours) {
+    throw tl::Exception (tl::to_string (tr ("Invalid contour offsets for polygon %ld in packed polygons")), long (n));
+  }
+
+  poly.clear ();
+
+  contour (size_t (from), m_pts);
+  poly.assign_hull (m_pts.begin (), m_pts.end ());
+
+  for (int64_t c = from + 1; c < to; ++c) {
+    contour (size_t (c), m_pts);
+    poly.insert_hole (m_pts.begin (), m_pts.end ());
+  }
+}
+
+// ------------------------------------------------------------------------------------
+//  Packed edges
+
+void
+pack_edge (const db::Edge &edge, std::vector<char> &data, bool wide)
+{
+  put_number (data, edge.p1 ().x (), wide);
+  put_number (data, edge.p1 ().y (), wide);
+  put_number (data, edge.p2 ().x (), wide);
+  put_number (data, edge.p2 ().y (), wide);
+}
+
+void
+unpack_edges (const std::vector<char> &data, bool wide, std::vector<db::Edge> &edges)
+{
+  size_t n = number_count (data, wide, "edges");
+  if (n % 4 != 0) {
+    throw tl::Exception (tl::to_string (tr ("Packed edges array does not have four coordinates per edge")));
+  }
+
+  const char *p = data.empty () ? 0 : &data.front ();
+
+  edges.reserve (edges.size () + n / 4);
+  for (size_t i = 0; i < n; i += 4) {
+    edges.push_back (db::Edge (db::Point (db::Coord (get_number (p, i, wide)), db::Coord (get_number (p, i + 1, wide))),
+                               db::Point (db::Coord (get_number (p, i + 2, wide)), db::Coord (get_number (p, i + 3, wide)))));
+  }
+}
+
+}
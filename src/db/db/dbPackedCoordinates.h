@@ -0,0 +1,152 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2020 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#ifndef HDR_dbPackedCoordinates
+#define HDR_dbPackedCoordinates
+
+#include "dbCommon.h"
+#include "dbPolygon.h"
+#include "dbEdge.h"
+
+#include <vector>
+
+namespace db
+{
+
+/**
+ *  The packed coordinate representation
+ *
+ *  Packed coordinates are flat arrays of integer numbers in native byte order.
+ *  Depending on the "wide" flag, the numbers are 32 bit or 64 bit integers.
+ *  The packed representation is intended for bulk transfer of geometries to
+ *  and from scripts (e.g. into NumPy arrays) without creating one object per
+ *  shape.
+ *
+ *  Polygons are represented by three arrays:
+ *
+ *    points    - x and y of all contour points (hulls and holes of all polygons)
+ *    contours  - n+1 offsets into the point list (in units of points) for n contours
+ *    polygons  - m+1 offsets into the contour list for m polygons. The first contour
+ *                of each polygon is the hull, the following ones are the holes.
+ *
+ *  Edges are represented by one array with x1, y1, x2, y2 for each edge.
+ */
+
+/**
+ *  @brief Collects polygons into the packed representation
+ */
+class DB_PUBLIC PackedPolygonWriter
+{
+public:
+  /**
+   *  @brief Constructor
+   *  @param wide If true, 64 bit integers are produced, otherwise 32 bit ones
+   */
+  PackedPolygonWriter (bool wide);
+
+  /**
+   *  @brief Adds a polygon
+   */
+  void add (const db::Polygon &poly);
+
+  /**
+   *  @brief Gets the packed points
+   */
+  std::vector<char> &points ()
+  {
+    return m_points;
+  }
+
+  /**
+   *  @brief Gets the packed contour offsets
+   */
+  std::vector<char> &contours ()
+  {
+    return m_contours;
+  }
+
+  /**
+   *  @brief Gets the packed polygon offsets
+   */
+  std::vector<char> &polygons ()
+  {
+    return m_polygons;
+  }
+
+private:
+  bool m_wide;
+  size_t m_npoints, m_ncontours;
+  std::vector<char> m_points, m_contours, m_polygons;
+
+  void put (std::vector<char> &v, int64_t n);
+};
+
+/**
+ *  @brief Provides polygons from the packed representation
+ *
+ *  The arrays given to the constructor must stay valid while the reader is used.
+ *  Inconsistent arrays will make the constructor or "get" throw an exception.
+ */
+class DB_PUBLIC PackedPolygonReader
+{
+public:
+  /**
+   *  @brief Constructor
+   */
+  PackedPolygonReader (const std::vector<char> &points, const std::vector<char> &contours, const std::vector<char> &polygons, bool wide);
+
+  /**
+   *  @brief Gets the number of polygons
+   */
+  size_t size () const
+  {
+    return m_npolygons;
+  }
+
+  /**
+   *  @brief Gets the polygon with the given index
+   */
+  void get (size_t n, db::Polygon &poly) const;
+
+private:
+  bool m_wide;
+  const char *mp_points, *mp_contours, *mp_polygons;
+  size_t m_npoints, m_ncontours, m_npolygons;
+  mutable std::vector<db::Point> m_pts;
+
+  int64_t at (const char *p, size_t i) const;
+  void contour (size_t c, std::vector<db::Point> &pts) const;
+};
+
+/**
+ *  @brief Appends edges to the packed representation (x1, y1, x2, y2 per edge)
+ */
+DB_PUBLIC void pack_edge (const db::Edge &edge, std::vector<char> &data, bool wide);
+
+/**
+ *  @brief Gets the edges from the packed representation
+ */
+DB_PUBLIC void unpack_edges (const std::vector<char> &data, bool wide, std::vector<db::Edge> &edges);
+
+}
+
+#endif
@@ -27,15 +27,110 @@
 #include "tlString.h"
 #include "tlAssert.h"
 
+#include <limits>
+
 namespace db
 {
 
+// ----------------------------------------------------------------------------------
+//  Hash functions for the properties sets
+
+static const properties_id_type empty_slot = std::numeric_limits<properties_id_type>::max ();
+
+static inline size_t
+hcombine (size_t h1, size_t h2)
+{
+  return (h1 << 4) ^ (h1 >> 4) ^ h2;
+}
+
+/**
+ *  @brief A hash function for tl::Variant which is compatible with tl::Variant's operator==
+ *
+ *  Numerical values of different types may compare equal, hence they are hashed
+ *  through their double representation.
+ */
+static size_t
+variant_hash (const tl::Variant &v)
+{
+  switch (v.type_code ()) {
+  case tl::Variant::t_nil:
+    return 0;
+  case tl::Variant::t_bool:
+    return v.to_bool () ? 1 : 2;
+  case tl::Variant::t_char:
+  case tl::Variant::t_schar:
+  case tl::Variant::t_uchar:
+  case tl::Variant::t_short:
+  case tl::Variant::t_ushort:
+  case tl::Variant::t_int:
+  case tl::Variant::t_uint:
+  case tl::Variant::t_long:
+  case tl::Variant::t_ulong:
+  case tl::Variant::t_longlong:
+  case tl::Variant::t_ulonglong:
+#if defined(HAVE_64BIT_COORD)
+  case tl::Variant::t_int128:
+#endif
+  case tl::Variant::t_float:
+  case tl::Variant::t_double:
+    {
+      double d = v.to_double ();
+      //  NOTE: 0.0 and -0.0 are equal
+      return d == 0.0 ? 3 : std::hash<double> () (d);
+    }
+  case tl::Variant::t_id:
+    return std::hash<size_t> () (v.to_id ());
+  case tl::Variant::t_list:
+    {
+      size_t h = 4;
+      for (tl::Variant::const_iterator i = v.begin (); i != v.end (); ++i) {
+        h = hcombine (h, variant_hash (*i));
+      }
+      return h;
+    }
+  case tl::Variant::t_array:
+    {
+      size_t h = 5;
+      for (tl::Variant::const_array_iterator i = v.begin_array (); i != v.end_array (); ++i) {
+        h = hcombine (h, variant_hash (i->first));
+        h = hcombine (h, variant_hash (i->second));
+      }
+      return h;
+    }
+  case tl::Variant::t_user:
+  case tl::Variant::t_user_ref:
+    //  user objects are compared by value through their class - no generic hash is available
+    return std::hash<const void *> () ((const void *) v.user_cls ());
+  default:
+    return std::hash<std::string> () (std::string (v.to_string ()));
+  }
+}
+
+static size_t
+properties_set_hash (const PropertiesRepository::properties_set &props)
+{
+  size_t h = props.size ();
+  for (PropertiesRepository::properties_set::const_iterator p = props.begin (); p != props.end (); ++p) {
+    h = hcombine (h, std::hash<property_names_id_type> () (p->first));
+    h = hcombine (h, variant_hash (p->second));
+  }
+  return h;
+}
+
+size_t
+PropertiesRepository::name_value_hash::operator() (const name_value_pair &nv) const
+{
+  return hcombine (std::hash<property_names_id_type> () (nv.first), variant_hash (nv.second));
+}
+
 // ----------------------------------------------------------------------------------
 //  PropertiesRepository implementation
 
 PropertiesRepository::PropertiesRepository (db::LayoutStateModel *state_model)
-  : mp_state_model (state_model)
+  : m_index_valid (true), mp_state_model (state_model)
 {
+  rehash_table (16);
+
   //  install empty property set
   properties_set empty_set;
   properties_id_type id = properties_id (empty_set);
@@ -49,12 +144,115 @@ PropertiesRepository::operator= (const PropertiesRepository &d)
     m_propnames_by_id            = d.m_propnames_by_id;
     m_propname_ids_by_name       = d.m_propname_ids_by_name;
     m_properties_by_id           = d.m_properties_by_id;
-    m_properties_ids_by_set      = d.m_properties_ids_by_set;
+    m_properties_hashes          = d.m_properties_hashes;
+    m_properties_table           = d.m_properties_table;
     m_properties_component_table = d.m_properties_component_table;
+    m_index_valid                = d.m_index_valid;
   }
   return *this;
 }
 
+void
+PropertiesRepository::rehash_table (size_t size) const
+{
+  m_properties_table.clear ();
+  m_properties_table.resize (size, empty_slot);
+
+  for (properties_id_type id = 0; id < m_properties_hashes.size (); ++id) {
+    insert_into_table (id);
+  }
+}
+
+void
+PropertiesRepository::insert_into_table (properties_id_type id) const
+{
+  size_t mask = m_properties_table.size () - 1;
+  size_t i = m_properties_hashes [id] & mask;
+  while (m_properties_table [i] != empty_slot) {
+    i = (i + 1) & mask;
+  }
+  m_properties_table [i] = id;
+}
+
+void
+PropertiesRepository::erase_from_table (properties_id_type id) const
+{
+  size_t mask = m_properties_table.size () - 1;
+
+  size_t i = m_properties_hashes [id] & mask;
+  while (m_properties_table [i] != id) {
+    tl_assert (m_properties_table [i] != empty_slot);
+    i = (i + 1) & mask;
+  }
+
+  //  backward shift deletion: move entries up which would not be found otherwise
+  size_t j = i;
+  while (true) {
+
+    j = (j + 1) & mask;
+    if (m_properties_table [j] == empty_slot) {
+      break;
+    }
+
+    size_t k = m_properties_hashes [m_properties_table [j]] & mask;
+    bool stays = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+    if (! stays) {
+      m_properties_table [i] = m_properties_table [j];
+      i = j;
+    }
+
+  }
+
+  m_properties_table [i] = empty_slot;
+}
+
+properties_id_type
+PropertiesRepository::find_in_table (const properties_set &props, size_t h) const
+{
+  size_t mask = m_properties_table.size () - 1;
+  for (size_t i = h & mask; m_properties_table [i] != empty_slot; i = (i + 1) & mask) {
+    properties_id_type id = m_properties_table [i];
+    if (m_properties_hashes [id] == h && m_properties_by_id [id].second == props) {
+      return id;
+    }
+  }
+  return empty_slot;
+}
+
+void
+PropertiesRepository::add_components (properties_id_type id) const
+{
+  const properties_set &props = m_properties_by_id [id].second;
+  for (properties_set::const_iterator nv = props.begin (); nv != props.end (); ++nv) {
+    m_properties_component_table [*nv].push_back (id);
+  }
+}
+
+void
+PropertiesRepository::validate_index () const
+{
+  if (m_index_valid) {
+    return;
+  }
+
+  //  the properties sets may have been modified through the non-const iterators:
+  //  recompute the hash values and the lookup tables
+  m_properties_hashes.clear ();
+  m_properties_hashes.reserve (m_properties_by_id.size ());
+  for (iterator p = m_properties_by_id.begin (); p != m_properties_by_id.end (); ++p) {
+    m_properties_hashes.push_back (properties_set_hash (p->second));
+  }
+
+  rehash_table (m_properties_table.size ());
+
+  m_properties_component_table.clear ();
+  for (properties_id_type id = 0; id < m_properties_by_id.size (); ++id) {
+    add_components (id);
+  }
+
+  m_index_valid = true;
+}
+
 std::pair<bool, property_names_id_type>
 PropertiesRepository::get_id_of_name (const tl::Variant &name) const
 {
@@ -72,7 +270,7 @@ PropertiesRepository::prop_name_id (const tl::Variant &name)
   std::map <tl::Variant, property_names_id_type>::const_iterator pi = m_propname_ids_by_name.find (name);
   if (pi == m_propname_ids_by_name.end ()) {
     property_names_id_type id = m_propnames_by_id.size ();
-    m_propnames_by_id.insert (std::make_pair (id, name));
+    m_propnames_by_id.push_back (name);
     m_propname_ids_by_name.insert (std::make_pair (name, id));
     return id;
   } else {
@@ -83,50 +281,49 @@ PropertiesRepository::prop_name_id (const tl::Variant &name)
 void 
 PropertiesRepository::change_properties (property_names_id_type id, const properties_set &new_props)
 {
-  const properties_set &old_props = properties (id);
-
-  std::map <properties_set, properties_id_type>::const_iterator pi = m_properties_ids_by_set.find (old_props);
-  if (pi != m_properties_ids_by_set.end ()) {
-
-    //  erase the id from the component table
-    for (properties_set::const_iterator nv = old_props.begin (); nv != old_props.end (); ++nv) {
-      if (m_properties_component_table.find (*nv) != m_properties_component_table.end ()) {
-        properties_id_vector &v = m_properties_component_table [*nv];
-        for (size_t i = 0; i < v.size (); ) {
-          if (v[i] == id) {
-            v.erase (v.begin () + i);
-          } else {
-            ++i;
-          }
+  if (! is_valid_properties_id (id)) {
+    return;
+  }
+
+  validate_index ();
+
+  //  erase the id from the component table
+  const properties_set &old_props = m_properties_by_id [id].second;
+  for (properties_set::const_iterator nv = old_props.begin (); nv != old_props.end (); ++nv) {
+    std::unordered_map <name_value_pair, properties_id_vector, name_value_hash>::iterator c = m_properties_component_table.find (*nv);
+    if (c != m_properties_component_table.end ()) {
+      properties_id_vector &v = c->second;
+      for (size_t i = 0; i < v.size (); ) {
+        if (v[i] == id) {
+          v.erase (v.begin () + i);
+        } else {
+          ++i;
         }
       }
     }
+  }
 
-    //  and insert again
-    m_properties_ids_by_set.erase (old_props);
-    m_properties_ids_by_set.insert (std::make_pair (new_props, id));
-
-    m_properties_by_id [id] = new_props;
+  //  and insert again
+  erase_from_table (id);
 
-    for (properties_set::const_iterator nv = new_props.begin (); nv != new_props.end (); ++nv) {
-      m_properties_component_table.insert (std::make_pair (*nv, properties_id_vector ())).first->second.push_back (id);
-    }
+  m_properties_by_id [id].second = new_props;
+  m_properties_hashes [id] = properties_set_hash (new_props);
 
-    //  signal the change of the properties ID's. This way for example, the layer views
-    //  can recompute the property selectors
-    if (mp_state_model) {
-      mp_state_model->prop_ids_changed ();
-    }
+  insert_into_table (id);
+  add_components (id);
 
+  //  signal the change of the properties ID's. This way for example, the layer views
+  //  can recompute the property selectors
+  if (mp_state_model) {
+    mp_state_model->prop_ids_changed ();
   }
 }
 
 void 
 PropertiesRepository::change_name (property_names_id_type id, const tl::Variant &new_name)
 {
-  std::map <property_names_id_type, tl::Variant>::iterator pi = m_propnames_by_id.find (id);
-  tl_assert (pi != m_propnames_by_id.end ());
-  pi->second = new_name;
+  tl_assert (id < m_propnames_by_id.size ());
+  m_propnames_by_id [id] = new_name;
 
   m_propname_ids_by_name.insert (std::make_pair (new_name, id));
 }
@@ -134,41 +331,49 @@ PropertiesRepository::change_name (property_names_id_type id, const tl::Variant
 const tl::Variant &
 PropertiesRepository::prop_name (property_names_id_type id) const
 {
-  return m_propnames_by_id.find (id)->second;
+  tl_assert (id < m_propnames_by_id.size ());
+  return m_propnames_by_id [id];
 }
 
 properties_id_type 
 PropertiesRepository::properties_id (const properties_set &props)
 {
-  std::map <properties_set, properties_id_type>::const_iterator pi = m_properties_ids_by_set.find (props);
-  if (pi == m_properties_ids_by_set.end ()) {
+  validate_index ();
 
-    properties_id_type id = m_properties_ids_by_set.size ();
-    m_properties_ids_by_set.insert (std::make_pair (props, id));
-    m_properties_by_id.insert (std::make_pair (id, props));
-    for (properties_set::const_iterator nv = props.begin (); nv != props.end (); ++nv) {
-      m_properties_component_table.insert (std::make_pair (*nv, properties_id_vector ())).first->second.push_back (id);
+  size_t h = properties_set_hash (props);
+
+  properties_id_type id = find_in_table (props, h);
+  if (id == empty_slot) {
+
+    id = m_properties_by_id.size ();
+    m_properties_by_id.push_back (std::make_pair (id, props));
+    m_properties_hashes.push_back (h);
+
+    //  keep the load factor of the table below 1/2
+    if (m_properties_by_id.size () * 2 > m_properties_table.size ()) {
+      rehash_table (m_properties_table.size () * 2);
+    } else {
+      insert_into_table (id);
     }
 
+    add_components (id);
+
     //  signal the change of the properties ID's. This way for example, the layer views
     //  can recompute the property selectors
     if (mp_state_model) {
       mp_state_model->prop_ids_changed ();
     }
 
-    return id;
-
-  } else {
-    return pi->second;
   }
+
+  return id;
 }
 
 const PropertiesRepository::properties_set &
 PropertiesRepository::properties (properties_id_type id) const
 {
-  iterator p = m_properties_by_id.find (id);
-  if (p != m_properties_by_id.end ()) {
-    return p->second;
+  if (id < m_properties_by_id.size ()) {
+    return m_properties_by_id [id].second;
   } else {
     static PropertiesRepository::properties_set empty_set;
     return empty_set;
@@ -178,13 +383,15 @@ PropertiesRepository::properties (properties_id_type id) const
 bool
 PropertiesRepository::is_valid_properties_id (properties_id_type id) const
 {
-  return m_properties_by_id.find (id) != m_properties_by_id.end ();
+  return id < m_properties_by_id.size ();
 }
 
 const PropertiesRepository::properties_id_vector &
 PropertiesRepository::properties_ids_by_name_value (const name_value_pair &nv) const
 {
-  std::map <name_value_pair, properties_id_vector>::const_iterator idv = m_properties_component_table.find (nv);
+  validate_index ();
+
+  std::unordered_map <name_value_pair, properties_id_vector, name_value_hash>::const_iterator idv = m_properties_component_table.find (nv);
   if (idv == m_properties_component_table.end ()) {
     static properties_id_vector empty;
     return empty;
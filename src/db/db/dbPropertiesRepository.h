@@ -33,6 +33,7 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <unordered_map>
 
 namespace db
 {
@@ -46,15 +47,19 @@ class LayoutStateModel;
  *  an unique Id which can be stored with a object_with_properties element.
  *  For performance reasons property names (which are strings) are not
  *  stored as such but as integers.
+ *
+ *  Property sets are stored once in a vector indexed by the Id. The lookup
+ *  of the Id for a given set is done through a hash table with open addressing
+ *  which holds the Id's only. The hash values of the sets are precomputed.
  */
 
 class DB_PUBLIC PropertiesRepository
 {
 public:
   typedef std::multimap <property_names_id_type, tl::Variant> properties_set;
-  typedef std::map <properties_id_type, properties_set> properties_map;
-  typedef std::map <properties_id_type, properties_set>::const_iterator iterator;
-  typedef std::map <properties_id_type, properties_set>::iterator non_const_iterator;
+  typedef std::vector <std::pair <properties_id_type, properties_set> > properties_map;
+  typedef properties_map::const_iterator iterator;
+  typedef properties_map::iterator non_const_iterator;
   typedef std::pair <property_names_id_type, tl::Variant> name_value_pair;
   typedef std::vector <properties_id_type> properties_id_vector;
 
@@ -140,9 +145,13 @@ public:
 
   /**
    *  @brief Iterate over Id/Properties sets (non-const)
+   *
+   *  As the properties sets may be modified through this iterator, the
+   *  lookup tables are rebuilt on the next access.
    */
   non_const_iterator begin_non_const () 
   {
+    m_index_valid = false;
     return m_properties_by_id.begin ();
   }
 
@@ -151,6 +160,7 @@ public:
    */
   non_const_iterator end_non_const () 
   {
+    m_index_valid = false;
     return m_properties_by_id.end ();
   }
 
@@ -219,21 +229,36 @@ public:
     db::mem_stat (stat, purpose, cat, m_propnames_by_id, true, parent);
     db::mem_stat (stat, purpose, cat, m_propname_ids_by_name, true, parent);
     db::mem_stat (stat, purpose, cat, m_properties_by_id, true, parent);
-    db::mem_stat (stat, purpose, cat, m_properties_ids_by_set, true, parent);
+    db::mem_stat (stat, purpose, cat, m_properties_hashes, true, parent);
+    db::mem_stat (stat, purpose, cat, m_properties_table, true, parent);
     db::mem_stat (stat, purpose, cat, m_properties_component_table, true, parent);
   }
 
 private:
-  std::map <property_names_id_type, tl::Variant> m_propnames_by_id;
+  struct name_value_hash
+  {
+    size_t operator() (const name_value_pair &nv) const;
+  };
+
+  std::vector <tl::Variant> m_propnames_by_id;
   std::map <tl::Variant, property_names_id_type> m_propname_ids_by_name;
 
-  std::map <properties_id_type, properties_set> m_properties_by_id;
-  std::map <properties_set, properties_id_type> m_properties_ids_by_set;
-  std::map <name_value_pair, properties_id_vector> m_properties_component_table;
+  properties_map m_properties_by_id;
+  mutable std::vector <size_t> m_properties_hashes;
+  mutable std::vector <properties_id_type> m_properties_table;
+  mutable std::unordered_map <name_value_pair, properties_id_vector, name_value_hash> m_properties_component_table;
+  mutable bool m_index_valid;
 
   db::LayoutStateModel *mp_state_model;
 
   PropertiesRepository (const PropertiesRepository &d);
+
+  void validate_index () const;
+  void rehash_table (size_t size) const;
+  void insert_into_table (properties_id_type id) const;
+  void erase_from_table (properties_id_type id) const;
+  properties_id_type find_in_table (const properties_set &props, size_t h) const;
+  void add_components (properties_id_type id) const;
 };
 
 /**
@@ -37,9 +37,18 @@ Edge2EdgeCheckBase::Edge2EdgeCheckBase (const EdgeRelationFilter &check, bool di
   m_distance = check.distance ();
 }
 
+/**
+ *  @brief The number of candidate edge pairs collected before they are checked
+ */
+static const size_t check_batch_size = 1024;
+
 bool
 Edge2EdgeCheckBase::prepare_next_pass ()
 {
+  if (m_pass == 0) {
+    flush_batch ();
+  }
+
   ++m_pass;
 
   if (m_pass == 1) {
@@ -95,16 +104,20 @@ Edge2EdgeCheckBase::add (const db::Edge *o1, size_t p1, const db::Edge *o2, size
       int l1 = int (p1 & size_t (1));
       int l2 = int (p2 & size_t (1));
 
-      db::EdgePair ep;
-      if (mp_check->check (l1 <= l2 ? *o1 : *o2, l1 <= l2 ? *o2 : *o1, &ep)) {
-
-        //  found a violation: store inside the local buffer for now. In the second
-        //  pass we will eliminate those which are shielded completely.
-        size_t n = m_ep.size ();
-        m_ep.push_back (ep);
-        m_e2ep.insert (std::make_pair (std::make_pair (*o1, p1), n));
-        m_e2ep.insert (std::make_pair (std::make_pair (*o2, p2), n));
+      //  collect the candidates and check them in batches: this allows doing a fast
+      //  rejection test on many pairs at once
+      if (l1 <= l2) {
+        m_batch_a.push_back (*o1);
+        m_batch_b.push_back (*o2);
+        m_batch_p.push_back (std::make_pair (p1, p2));
+      } else {
+        m_batch_a.push_back (*o2);
+        m_batch_b.push_back (*o1);
+        m_batch_p.push_back (std::make_pair (p2, p1));
+      }
 
+      if (m_batch_a.size () >= check_batch_size) {
+        flush_batch ();
       }
 
     }
@@ -160,6 +173,38 @@ Edge2EdgeCheckBase::add (const db::Edge *o1, size_t p1, const db::Edge *o2, size
 
 }
 
+void
+Edge2EdgeCheckBase::flush_batch ()
+{
+  size_t n = m_batch_a.size ();
+  if (n == 0) {
+    return;
+  }
+
+  m_batch_candidates.resize (n);
+  mp_check->prefilter (&m_batch_a.front (), &m_batch_b.front (), n, &m_batch_candidates.front ());
+
+  for (size_t i = 0; i < n; ++i) {
+
+    db::EdgePair ep;
+    if (m_batch_candidates [i] && mp_check->check (m_batch_a [i], m_batch_b [i], &ep)) {
+
+      //  found a violation: store inside the local buffer for now. In the second
+      //  pass we will eliminate those which are shielded completely.
+      size_t nep = m_ep.size ();
+      m_ep.push_back (ep);
+      m_e2ep.insert (std::make_pair (std::make_pair (m_batch_a [i], m_batch_p [i].first), nep));
+      m_e2ep.insert (std::make_pair (std::make_pair (m_batch_b [i], m_batch_p [i].second), nep));
+
+    }
+
+  }
+
+  m_batch_a.clear ();
+  m_batch_b.clear ();
+  m_batch_p.clear ();
+}
+
 /**
  *  @brief Gets a value indicating whether the check requires different layers
  */
@@ -289,6 +334,23 @@ Poly2PolyCheckBase::enter (const db::Polygon &o1, size_t p1, const db::Polygon &
 // -------------------------------------------------------------------------------------
 //  RegionToEdgeInteractionFilterBase implementation
 
+static bool
+polygon_interacts_with_edge (const db::Polygon &p, const db::Edge &e)
+{
+  //  A polygon and an edge interact if the edge is either inside completely
+  //  of at least one edge of the polygon intersects with the edge
+  if (p.box ().contains (e.p1 ()) && db::inside_poly (p.begin_edge (), e.p1 ()) >= 0) {
+    return true;
+  } else {
+    for (db::Polygon::polygon_edge_iterator pe = p.begin_edge (); ! pe.at_end (); ++pe) {
+      if ((*pe).intersect (e)) {
+        return true;
+      }
+    }
+    return false;
+  }
+}
+
 template <class OutputType>
 region_to_edge_interaction_filter_base<OutputType>::region_to_edge_interaction_filter_base (bool inverse)
   : m_inverse (inverse)
@@ -312,20 +374,7 @@ region_to_edge_interaction_filter_base<OutputType>::add (const db::Polygon *p, s
 
   if ((m_seen.find (o) == m_seen.end ()) != m_inverse) {
 
-    //  A polygon and an edge interact if the edge is either inside completely
-    //  of at least one edge of the polygon intersects with the edge
-    bool interacts = false;
-    if (p->box ().contains (e->p1 ()) && db::inside_poly (p->begin_edge (), e->p1 ()) >= 0) {
-      interacts = true;
-    } else {
-      for (db::Polygon::polygon_edge_iterator pe = p->begin_edge (); ! pe.at_end () && ! interacts; ++pe) {
-        if ((*pe).intersect (*e)) {
-          interacts = true;
-        }
-      }
-    }
-
-    if (interacts) {
+    if (polygon_interacts_with_edge (*p, *e)) {
       if (m_inverse) {
         m_seen.erase (o);
       } else {
@@ -350,6 +399,40 @@ region_to_edge_interaction_filter_base<OutputType>::fill_output ()
 template class region_to_edge_interaction_filter_base<db::Polygon>;
 template class region_to_edge_interaction_filter_base<db::Edge>;
 
+// -------------------------------------------------------------------------------------
+//  RegionToEdgeInteractionCollector implementation
+
+region_to_edge_interaction_collector::region_to_edge_interaction_collector ()
+{
+  //  .. nothing yet ..
+}
+
+void
+region_to_edge_interaction_collector::add (const db::Polygon *p, size_t, const db::Edge *e, size_t)
+{
+  if (m_interacting.find (p) == m_interacting.end () && polygon_interacts_with_edge (*p, *e)) {
+    m_interacting.insert (p);
+  }
+}
+
+region_to_edge_interaction_collector
+region_to_edge_interaction_collector::make_slab_receiver () const
+{
+  return region_to_edge_interaction_collector ();
+}
+
+void
+region_to_edge_interaction_collector::merge (const region_to_edge_interaction_collector &other)
+{
+  m_interacting.insert (other.m_interacting.begin (), other.m_interacting.end ());
+}
+
+bool
+region_to_edge_interaction_collector::interacts (const db::Polygon *p) const
+{
+  return m_interacting.find (p) != m_interacting.end ();
+}
+
 // -------------------------------------------------------------------------------------
 //  RegionToTextInteractionFilterBase implementation
 
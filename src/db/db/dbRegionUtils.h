@@ -417,6 +417,11 @@ private:
   std::multimap<std::pair<db::Edge, size_t>, size_t> m_e2ep;
   std::vector<bool> m_ep_discarded;
   unsigned int m_pass;
+  std::vector<db::Edge> m_batch_a, m_batch_b;
+  std::vector<std::pair<size_t, size_t> > m_batch_p;
+  std::vector<char> m_batch_candidates;
+
+  void flush_batch ();
 };
 
 /**
@@ -524,6 +529,34 @@ private:
   OutputContainer *mp_output;
 };
 
+/**
+ *  @brief A receiver collecting the polygons which interact with edges
+ *
+ *  This receiver is intended for the multi-threaded version of box_scanner2::process
+ *  which takes thread-local receivers: each slab collects the interacting polygons in
+ *  its own collector and these are merged into the main collector afterwards.
+ */
+class DB_PUBLIC region_to_edge_interaction_collector
+  : public db::box_scanner_receiver2<db::Polygon, size_t, db::Edge, size_t>
+{
+public:
+  typedef region_to_edge_interaction_collector slab_receiver_type;
+
+  region_to_edge_interaction_collector ();
+
+  void add (const db::Polygon *p, size_t, const db::Edge *e, size_t);
+  slab_receiver_type make_slab_receiver () const;
+  void merge (const slab_receiver_type &other);
+
+  /**
+   *  @brief Returns true, if the given polygon interacts with any edge
+   */
+  bool interacts (const db::Polygon *p) const;
+
+private:
+  std::set<const db::Polygon *> m_interacting;
+};
+
 /**
  *  @brief A helper class for the region to text interaction functionality
  */
@@ -951,6 +951,22 @@ void Shapes::update ()
   set_dirty (false);
 }
 
+void Shapes::update_except (unsigned int skip)
+{
+  bool skipped = false;
+  for (tl::vector<LayerBase *>::const_iterator l = m_layers.begin (); l != m_layers.end (); ++l) {
+    if (((*l)->type_mask () & skip) != 0) {
+      skipped = true;
+    } else {
+      (*l)->sort ();
+      (*l)->update_bbox ();
+    }
+  }
+  if (! skipped) {
+    set_dirty (false);
+  }
+}
+
 bool Shapes::is_bbox_dirty () const
 {
   if (is_dirty ()) {
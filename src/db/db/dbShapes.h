@@ -740,9 +740,9 @@ public:
           (*l)->deref_into (this, pm_delegate);
         }
       } else {
-        //  translate and transform into this
+        //  translate into this
         for (tl::vector<LayerBase *>::const_iterator l = d.m_layers.begin (); l != d.m_layers.end (); ++l) {
-          (*l)->transform_into (this, shape_repository (), array_repository (), pm_delegate);
+          (*l)->translate_into (this, shape_repository (), array_repository (), pm_delegate);
         }
       }
 
@@ -1135,6 +1135,15 @@ public:
    */
   void update ();
 
+  /**
+   *  @brief updates the bbox and sorts if necessary, except for the given shape types
+   *
+   *  Layers holding shapes of the types given by "skip" (a combination of ShapeIterator flags)
+   *  are not touched. If there are such layers, the container stays dirty, so a later
+   *  "update" will handle them.
+   */
+  void update_except (unsigned int skip);
+
   /**
    *  @brief updates the bbox 
    *
@@ -1652,6 +1661,18 @@ public:
     }
   }
 
+  virtual size_t mem_used () const
+  {
+    db::MemStatisticsSimple ms;
+    db::mem_stat (&ms, db::MemStatistics::None, 0, m_shapes, true);
+    return sizeof (*this) + ms.size ();
+  }
+
+  virtual void compact ()
+  {
+    m_shapes.shrink_to_fit ();
+  }
+
   static void queue_or_append (db::Manager *manager, db::Shapes *shapes, bool insert, const Sh &sh)
   {
     db::layer_op<Sh, StableTag> *old_op = dynamic_cast <db::layer_op<Sh, StableTag> *> (manager->last_queued (shapes));
@@ -84,6 +84,16 @@ static void set_properties_enabled (db::LoadLayoutOptions *options, bool l)
   options->get_options<db::CommonReaderOptions> ().enable_properties = l;
 }
 
+static unsigned int get_pipeline_threads (const db::LoadLayoutOptions *options)
+{
+  return options->get_options<db::CommonReaderOptions> ().pipeline_threads;
+}
+
+static void set_pipeline_threads (db::LoadLayoutOptions *options, unsigned int n)
+{
+  options->get_options<db::CommonReaderOptions> ().pipeline_threads = n;
+}
+
 //  extend lay::LoadLayoutOptions with the Common options
 static
 gsi::ClassExt<db::LoadLayoutOptions> common_reader_options (
@@ -156,6 +166,21 @@ gsi::ClassExt<db::LoadLayoutOptions> common_reader_options (
     "@param enabled True, if properties should be read."
     "\n"
     "Starting with version 0.25 this option only applies to GDS2 and OASIS format. Other formats provide their own configuration."
+  ) +
+  gsi::method_ext ("pipeline_threads", &get_pipeline_threads,
+    "@brief Gets the number of threads used for preparing cells while reading\n"
+    "See \\pipeline_threads= for a description of this attribute.\n"
+    "\n"
+    "This option only applies to GDS2 and OASIS format. It has been introduced in version 0.27."
+  ) +
+  gsi::method_ext ("pipeline_threads=", &set_pipeline_threads, gsi::arg ("n"),
+    "@brief Sets the number of threads used for preparing cells while reading\n"
+    "If this value is larger than zero, cells are handed over to worker threads as soon as their definition "
+    "has been read. The workers sort the shapes and compute the shape bounding boxes while the reader continues. "
+    "This overlaps parsing with the layout update which otherwise happens after the file has been read. "
+    "The default value is zero, which disables this feature.\n"
+    "\n"
+    "This option only applies to GDS2 and OASIS format. It has been introduced in version 0.27."
   ),
   ""
 );
@@ -22,11 +22,39 @@
 
 #include "gsiDecl.h"
 #include "dbDeepShapeStore.h"
+#include "dbMemStatistics.h"
 #include "tlGlobPattern.h"
 
 namespace gsi
 {
 
+static std::map<std::string, size_t> dss_mem_statistics (const db::DeepShapeStore *dss)
+{
+  db::MemStatisticsCollector ms (false);
+  dss->mem_stat (&ms, db::MemStatistics::DeepShapeStoreInfo, 0);
+  return ms.size_per_purpose ();
+}
+
+static void set_track_peak_memory (bool f)
+{
+  db::MemStatisticsPeakRegistry::set_enabled (f);
+}
+
+static bool track_peak_memory ()
+{
+  return db::MemStatisticsPeakRegistry::is_enabled ();
+}
+
+static std::map<std::string, size_t> peak_mem_statistics ()
+{
+  return db::MemStatisticsPeakRegistry::peaks ();
+}
+
+static void reset_peak_mem_statistics ()
+{
+  db::MemStatisticsPeakRegistry::reset ();
+}
+
 static void set_or_add_breakout_cells (db::DeepShapeStore *dss, const std::string &pattern, bool add, unsigned int layout_index = std::numeric_limits<unsigned int>::max ())
 {
   //  set or add for all
@@ -228,6 +256,39 @@ Class<db::DeepShapeStore> decl_dbDeepShapeStore ("db", "DeepShapeStore",
     "This will restore the state pushed by \\push_state.\n"
     "\n"
     "This method has been added in version 0.26.1\n"
+  ) +
+  gsi::method_ext ("mem_statistics", &dss_mem_statistics,
+    "@brief Gets the memory used by the store, broken down by category\n"
+    "The result is a hash of category names to allocated bytes. The \"total\" key gives the sum. "
+    "Categories are \"deep_shape_store\" for the store's own bookkeeping and \"layout_info\", "
+    "\"cell_info\", \"instances\", \"shapes_info\" and so on for the working layouts.\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
+  ) +
+  gsi::method ("track_peak_memory=", &set_track_peak_memory, gsi::arg ("flag"),
+    "@brief Enables or disables peak memory tracking for transient data\n"
+    "Transient data such as the hierarchical processor's context caches only exists while an operation "
+    "executes. When tracking is enabled, these components report their size and the maximum is kept. "
+    "Use \\peak_mem_statistics to read the peaks and \\reset_peak_mem_statistics to reset them.\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
+  ) +
+  gsi::method ("track_peak_memory?", &track_peak_memory,
+    "@brief Gets a value indicating whether peak memory tracking is enabled\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
+  ) +
+  gsi::method ("peak_mem_statistics", &peak_mem_statistics,
+    "@brief Gets the peak memory used by transient data, broken down by category\n"
+    "The result is a hash of category names (e.g. \"processor_caches\") to the peak number of bytes "
+    "seen since the last reset. See \\track_peak_memory= for details.\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
+  ) +
+  gsi::method ("reset_peak_mem_statistics", &reset_peak_mem_statistics,
+    "@brief Resets the peak memory statistics\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
   ),
   "@brief An opaque layout heap for the deep region processor\n"
   "\n"
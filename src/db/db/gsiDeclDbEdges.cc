@@ -30,6 +30,7 @@
 #include "dbRegion.h"
 #include "dbOriginalLayerRegion.h"
 #include "dbLayoutUtils.h"
+#include "dbPackedCoordinates.h"
 
 namespace gsi
 {
@@ -369,6 +370,24 @@ static void insert_e (db::Edges *e, const db::Edges &a)
   }
 }
 
+static std::vector<char> to_packed (const db::Edges *e, bool wide)
+{
+  std::vector<char> data;
+  for (db::Edges::const_iterator p = e->begin (); ! p.at_end (); ++p) {
+    db::pack_edge (*p, data, wide);
+  }
+  return data;
+}
+
+static void insert_packed (db::Edges *e, const std::vector<char> &data, bool wide)
+{
+  std::vector<db::Edge> edges;
+  db::unpack_edges (data, wide, edges);
+  for (std::vector<db::Edge>::const_iterator i = edges.begin (); i != edges.end (); ++i) {
+    e->insert (*i);
+  }
+}
+
 template <class Trans>
 static void insert_st (db::Edges *e, const db::Shapes &a, const Trans &t)
 {
@@ -703,6 +722,28 @@ Class<db::Edges> dec_Edges (decl_dbShapeCollection, "db", "Edges",
   method_ext ("insert", &insert_a2, gsi::arg ("edges"),
     "@brief Inserts all edges from the array into this edge collection\n"
   ) +
+  method_ext ("to_packed", &to_packed, gsi::arg ("wide", false),
+    "@brief Exports the edges as a packed coordinate array\n"
+    "@param wide If true, 64 bit integers are produced, otherwise 32 bit integers\n"
+    "@return A byte string with x1, y1, x2 and y2 for each edge\n"
+    "\n"
+    "This method is intended for bulk transfer of edges without creating one object per edge. "
+    "The numbers are stored in native byte order. In Python the result is a \"bytes\" object which "
+    "can be wrapped by a NumPy array with \"numpy.frombuffer\". In Ruby it is a binary string which "
+    "can be decoded with \"unpack\". The edges are delivered in the order of \\each.\n"
+    "\n"
+    "This method has been introduced in version 0.27."
+  ) +
+  method_ext ("insert_packed", &insert_packed, gsi::arg ("data"), gsi::arg ("wide", false),
+    "@brief Inserts edges from a packed coordinate array\n"
+    "@param data A byte string with x1, y1, x2 and y2 for each edge\n"
+    "@param wide If true, the array holds 64 bit integers, otherwise 32 bit integers\n"
+    "\n"
+    "This method is the reverse of \\to_packed. In Python, the data can be any object "
+    "supporting the buffer protocol, such as a contiguous NumPy array of the matching integer type.\n"
+    "\n"
+    "This method has been introduced in version 0.27."
+  ) +
   method ("merge", (db::Edges &(db::Edges::*) ()) &db::Edges::merge,
     "@brief Merge the edges\n"
     "\n"
@@ -0,0 +1,146 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2020 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+#include "gsiDecl.h"
+#include "dbFillTool.h"
+#include "dbRegion.h"
+#include "dbCell.h"
+
+namespace gsi
+{
+
+static void fill1 (db::FillEngine *engine, db::Cell *cell, const db::Region &fr)
+{
+  engine->fill (cell, fr);
+}
+
+static void fill2 (db::FillEngine *engine, db::Cell *cell, const db::Region &fr, db::Region *remaining_parts)
+{
+  engine->fill (cell, fr, remaining_parts);
+}
+
+Class<db::FillEngine> decl_dbFillEngine ("db", "FillEngine",
+  gsi::method ("add_fill_cell", &db::FillEngine::add_fill_cell, gsi::arg ("fill_cell_index"), gsi::arg ("fc_box"), gsi::arg ("priority", 0),
+    "@brief Adds a fill cell\n"
+    "@param fill_cell_index The index of the fill cell\n"
+    "@param fc_box The fill cell's footprint\n"
+    "@param priority The priority of the fill cell\n"
+    "\n"
+    "Fill cells with a higher priority are placed first. Fill cells with the same priority are placed in the order they "
+    "have been added. The footprint is the area covered by one instance of the fill cell. Instances of the same fill cell are "
+    "arranged with their footprints forming a seamless array.\n"
+  ) +
+  gsi::method ("clear_fill_cells", &db::FillEngine::clear_fill_cells,
+    "@brief Removes all fill cells\n"
+  ) +
+  gsi::method ("origin=", &db::FillEngine::set_origin, gsi::arg ("origin"),
+    "@brief Sets the origin of the fill raster\n"
+    "All fill cells are placed on a raster anchored at this point."
+  ) +
+  gsi::method ("origin", &db::FillEngine::origin,
+    "@brief Gets the origin of the fill raster\n"
+  ) +
+  gsi::method ("fill_margin=", &db::FillEngine::set_fill_margin, gsi::arg ("margin"),
+    "@brief Sets the fill margin\n"
+    "The fill margin is the minimum distance in x and y direction between fill cells of different kind. "
+    "It is also the margin applied to the filled area before it is subtracted from the fill region when computing the remaining parts."
+  ) +
+  gsi::method ("fill_margin", &db::FillEngine::fill_margin,
+    "@brief Gets the fill margin\n"
+  ) +
+  gsi::method ("tile_size=", &db::FillEngine::set_tile_size, gsi::arg ("size"),
+    "@brief Sets the tile size\n"
+    "The fill region is cut into tiles of this size which are filled in parallel. The tiles also serve as density windows. "
+    "Tiles start at the lower-left corner of the fill region's bounding box. A zero size means a single tile. "
+    "Tiles are made at least as large as the largest fill cell footprint."
+  ) +
+  gsi::method ("tile_size", &db::FillEngine::tile_size,
+    "@brief Gets the tile size\n"
+  ) +
+  gsi::method ("threads=", &db::FillEngine::set_threads, gsi::arg ("n"),
+    "@brief Sets the number of threads to use\n"
+    "With a value of 0, the tiles are filled without using threads."
+  ) +
+  gsi::method ("threads", &db::FillEngine::threads,
+    "@brief Gets the number of threads to use\n"
+  ) +
+  gsi::method ("density_target=", &db::FillEngine::set_density_target, gsi::arg ("density"),
+    "@brief Sets the density target per tile\n"
+    "If the density target is less than 1, the fill cells are thinned out evenly so that the footprint area of the fill cells "
+    "inside a tile plus the area of the density reference shapes (see \\density_reference=) does not exceed the given fraction of the tile area."
+  ) +
+  gsi::method ("density_target", &db::FillEngine::density_target,
+    "@brief Gets the density target per tile\n"
+  ) +
+  gsi::method ("density_reference=", &db::FillEngine::set_density_reference, gsi::arg ("region"),
+    "@brief Sets the shapes which count against the density target\n"
+    "Typically these are the existing shapes of the layer which is filled."
+  ) +
+  gsi::method ("clear_density_reference", &db::FillEngine::clear_density_reference,
+    "@brief Clears the density reference shapes\n"
+  ) +
+  gsi::method_ext ("fill", &fill1, gsi::arg ("cell"), gsi::arg ("region"),
+    "@brief Fills the given region\n"
+    "@param cell The cell in which to place the fill cell instances\n"
+    "@param region The region to fill\n"
+  ) +
+  gsi::method_ext ("fill", &fill2, gsi::arg ("cell"), gsi::arg ("region"), gsi::arg ("remaining_parts"),
+    "@brief Fills the given region and delivers the parts which are not filled\n"
+    "@param cell The cell in which to place the fill cell instances\n"
+    "@param region The region to fill\n"
+    "@param remaining_parts Receives the parts of the region not covered by fill cells (including the fill margin)\n"
+    "\n"
+    "'remaining_parts' can be identical with 'region'. In that case, the region is replaced by the remaining parts."
+  ) +
+  gsi::method ("instances", &db::FillEngine::instances,
+    "@brief Gets the number of fill cell instances created by the last \\fill\n"
+    "Each member of an instance array is counted individually."
+  ) +
+  gsi::method ("arrays", &db::FillEngine::arrays,
+    "@brief Gets the number of instance arrays created by the last \\fill\n"
+  ),
+  "@brief A tiled, multi-threaded fill engine\n"
+  "\n"
+  "The fill engine fills a region with instances of one or more fill cells. Compared to \\Cell#fill_region, the engine "
+  "cuts the region into tiles which are filled in parallel, places the fill cells in compact regular arrays and supports "
+  "multiple fill cells with priorities as well as a density target per tile.\n"
+  "\n"
+  "The fill cell with the highest priority is placed on a global raster first. Fill cells with a lower priority fill the space left over, "
+  "keeping the fill margin to the fill cells placed before and to the tile borders.\n"
+  "\n"
+  "@code\n"
+  "engine = RBA::FillEngine::new\n"
+  "engine.add_fill_cell(big_fill.cell_index, RBA::Box::new(0, 0, 2000, 2000), 1)\n"
+  "engine.add_fill_cell(small_fill.cell_index, RBA::Box::new(0, 0, 500, 500), 0)\n"
+  "engine.fill_margin = RBA::Vector::new(200, 200)\n"
+  "engine.tile_size = RBA::Vector::new(100000, 100000)\n"
+  "engine.density_target = 0.6\n"
+  "engine.density_reference = existing\n"
+  "engine.threads = 4\n"
+  "engine.fill(top, fill_region)\n"
+  "@/code\n"
+  "\n"
+  "This class has been introduced in version 0.27.\n"
+);
+
+}
@@ -37,6 +37,7 @@
 #include "dbEdgePairs.h"
 #include "dbTexts.h"
 #include "dbLayoutUtils.h"
+#include "dbBoxTree.h"
 #include "tlStream.h"
 
 namespace gsi
@@ -1815,6 +1816,14 @@ Class<db::Layout> decl_Layout ("db", "Layout",
     "\n"
     "This method has been added in version 0.23.\n"
   ) +
+  gsi::method ("refresh_pcell_variants", &db::Layout::refresh_pcell_variants, gsi::arg ("threads", (unsigned int) 0),
+    "@brief Produces the layout of all PCell variants of this layout again\n"
+    "@param threads The number of worker threads to use (0 for producing the variants in the calling thread)\n"
+    "With a thread count larger than 0, PCells implemented in C++ which support parallel production "
+    "are produced concurrently. Scripted PCells are always produced in the calling thread.\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
+  ) +
   gsi::method ("add_lib_cell", &db::Layout::get_lib_proxy, gsi::arg ("library"), gsi::arg ("lib_cell_index"),
     "@brief Imports a cell from the library\n"
     "@param library The reference to the library from which to import the cell\n"
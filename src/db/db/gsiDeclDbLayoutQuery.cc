@@ -105,6 +105,13 @@ static LayoutQueryIteratorWrapper iterate (const db::LayoutQuery *q, const db::L
   return LayoutQueryIteratorWrapper (*q, layout, eval);
 }
 
+static std::vector<tl::Variant> collect (const db::LayoutQuery *q, const db::Layout *layout, const std::vector<std::string> &properties, unsigned int threads, tl::Eval *eval)
+{
+  std::vector<tl::Variant> rows;
+  q->collect (*layout, properties, rows, threads, eval);
+  return rows;
+}
+
 static tl::Variant iter_get (db::LayoutQueryIterator *iter, const std::string &name)
 {
   tl::Variant v;
@@ -205,6 +212,30 @@ Class<db::LayoutQuery> decl_LayoutQuery ("db", "LayoutQuery",
     "\n"
     "The context argument allows supplying an expression execution context. This context can be used for "
     "example to supply variables for the execution. It has been added in version 0.26.\n"
+  ) +
+  gsi::method_ext ("collect", &collect, gsi::arg ("layout"), gsi::arg ("properties"), gsi::arg ("threads", (unsigned int) 0), gsi::arg ("context", (tl::Eval *) 0, "nil"),
+    "@brief Executes the query and delivers all results at once.\n"
+    "@param layout The layout the query is applied to\n"
+    "@param properties The names of the properties to collect (see \\property_names)\n"
+    "@param threads The number of worker threads to use (0 for single-threaded execution)\n"
+    "@param context An optional expression execution context\n"
+    "@return An array with one array of property values per result\n"
+    "\n"
+    "Properties not available for a specific result are delivered as nil. "
+    "With a thread count larger than 0, read-only queries are executed by multiple threads. The work is distributed "
+    "over the cells, instances or shapes delivered by the first part of the query which enumerates multiple items. "
+    "The results are still delivered in the same order as \\each would deliver them. "
+    "Queries which modify the layout or which use \"sorted by\" are always executed in a single thread. "
+    "The expressions of the query must not have side effects when multiple threads are used.\n"
+    "\n"
+    "@code\n"
+    "q = RBA::LayoutQuery::new(\"select cell.name, cell.bbox from *\")\n"
+    "q.collect(ly, [ \"data\" ], 4).each do |row|\n"
+    "  puts \"cell name: #{row[0][0]}, bounding box: #{row[0][1]}\"\n"
+    "end\n"
+    "@/code\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
   ),
   "@brief A layout query\n"
   "Layout queries are the backbone of the \"Search & replace\" feature. Layout queries allow retrieval of "
@@ -135,6 +135,13 @@ static db::Region antenna_check (db::LayoutToNetlist *l2n, const db::Region &pol
   return antenna_check2 (l2n, poly, 0, metal, 0, ratio, diodes);
 }
 
+static std::map<std::string, size_t> l2n_mem_statistics (const db::LayoutToNetlist *l2n)
+{
+  db::MemStatisticsCollector ms (false);
+  l2n->mem_stat (&ms, db::MemStatistics::NetlistInfo, 0);
+  return ms.size_per_purpose ();
+}
+
 Class<db::LayoutToNetlist> decl_dbLayoutToNetlist ("db", "LayoutToNetlist",
   gsi::constructor ("new", &make_l2n, gsi::arg ("iter"),
     "@brief Creates a new extractor connected to an original layout\n"
@@ -561,9 +568,13 @@ Class<db::LayoutToNetlist> decl_dbLayoutToNetlist ("db", "LayoutToNetlist",
     "This variant accepts a database-unit location. The location is given in the\n"
     "coordinate space of the initial cell.\n"
   ) +
-  gsi::method ("write|write_l2n", &db::LayoutToNetlist::save, gsi::arg ("path"), gsi::arg ("short_format", false),
+  gsi::method ("write|write_l2n", &db::LayoutToNetlist::save, gsi::arg ("path"), gsi::arg ("short_format", false), gsi::arg ("binary", false),
     "@brief Writes the extracted netlist to a file.\n"
     "This method employs the native format of KLayout.\n"
+    "\n"
+    "If 'binary' is true, a compact binary representation of the short format is written. "
+    "Binary files are recognized automatically when reading. "
+    "The 'binary' argument has been introduced in version 0.27.\n"
   ) +
   gsi::method ("read|read_l2n", &db::LayoutToNetlist::load, gsi::arg ("path"),
     "@brief Reads the extracted netlist from the file.\n"
@@ -626,6 +637,15 @@ Class<db::LayoutToNetlist> decl_dbLayoutToNetlist ("db", "LayoutToNetlist",
    "of the material. Essentially the side walls of the material are taking into account for the surface area as well.\n"
    "\n"
    "This variant has been introduced in version 0.26.6.\n"
+  ) +
+  gsi::method_ext ("mem_statistics", &l2n_mem_statistics,
+    "@brief Gets the memory used by the netlist extractor, broken down by category\n"
+    "The result is a hash of category names to bytes. The \"total\" key gives the sum. "
+    "\"clusters\" is the memory used by the hierarchical net clusters, \"netlist\" the memory used by the "
+    "netlist and \"deep_shape_store\", \"layout_info\", \"shapes_info\" etc. the memory used by the "
+    "internal deep shape store. An external deep shape store (see \\dss) is not included.\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
   ),
   "@brief A generic framework for extracting netlists from layouts\n"
   "\n"
@@ -55,9 +55,9 @@ static db::LayoutVsSchematic *make_lvs_flat (const std::string &topcell_name, do
   return new db::LayoutVsSchematic (topcell_name, dbu);
 }
 
-static void save_l2n (db::LayoutVsSchematic *lvs, const std::string &path, bool short_format)
+static void save_l2n (db::LayoutVsSchematic *lvs, const std::string &path, bool short_format, bool binary)
 {
-  lvs->db::LayoutToNetlist::save (path, short_format);
+  lvs->db::LayoutToNetlist::save (path, short_format, binary);
 }
 
 static void load_l2n (db::LayoutVsSchematic *lvs, const std::string &path)
@@ -110,17 +110,25 @@ Class<db::LayoutVsSchematic> decl_dbLayoutVsSchematic (decl_dbLayoutToNetlist, "
     "\n"
     "See \\NetlistCrossReference for more details.\n"
   ) +
-  gsi::method_ext ("write_l2n", &save_l2n, gsi::arg ("path"), gsi::arg ("short_format", false),
+  gsi::method_ext ("write_l2n", &save_l2n, gsi::arg ("path"), gsi::arg ("short_format", false), gsi::arg ("binary", false),
     "@brief Writes the \\LayoutToNetlist part of the object to a file.\n"
     "This method employs the native format of KLayout.\n"
+    "\n"
+    "If 'binary' is true, a compact binary representation of the short format is written. "
+    "Binary files are recognized automatically when reading. "
+    "The 'binary' argument has been introduced in version 0.27.\n"
   ) +
   gsi::method_ext ("read_l2n", &load_l2n, gsi::arg ("path"),
     "@brief Reads the \\LayoutToNetlist part of the object from a file.\n"
     "This method employs the native format of KLayout.\n"
   ) +
-  gsi::method ("write", &db::LayoutVsSchematic::save, gsi::arg ("path"), gsi::arg ("short_format", false),
+  gsi::method ("write", &db::LayoutVsSchematic::save, gsi::arg ("path"), gsi::arg ("short_format", false), gsi::arg ("binary", false),
     "@brief Writes the LVS object to a file.\n"
     "This method employs the native format of KLayout.\n"
+    "\n"
+    "If 'binary' is true, a compact binary representation of the short format is written. "
+    "Binary files are recognized automatically when reading. "
+    "The 'binary' argument has been introduced in version 0.27.\n"
   ) +
   gsi::method ("read", &db::LayoutVsSchematic::load, gsi::arg ("path"),
     "@brief Reads the LVS object from the file.\n"
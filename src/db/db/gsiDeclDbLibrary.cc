@@ -28,6 +28,7 @@
 #include "dbPCellDeclaration.h"
 #include "dbLibrary.h"
 #include "dbLibraryManager.h"
+#include "dbPCellCache.h"
 
 namespace gsi
 {
@@ -68,6 +69,31 @@ static void delete_lib (db::Library *lib)
   db::LibraryManager::instance ().delete_lib (lib);
 }
 
+static void set_pcell_cache_path (const std::string &path)
+{
+  db::PCellCache::instance ().set_path (path);
+}
+
+static std::string pcell_cache_path ()
+{
+  return db::PCellCache::instance ().path ();
+}
+
+static void set_pcell_cache_max_size (size_t bytes)
+{
+  db::PCellCache::instance ().set_max_size (bytes);
+}
+
+static size_t pcell_cache_max_size ()
+{
+  return db::PCellCache::instance ().max_size ();
+}
+
+static void clear_pcell_cache ()
+{
+  db::PCellCache::instance ().clear ();
+}
+
 Class<db::Library> decl_Library ("db", "Library",
   gsi::constructor ("new", &new_lib,
     "@brief Creates a new, empty library"
@@ -97,6 +123,44 @@ Class<db::Library> decl_Library ("db", "Library",
     "\n"
     "This method has been introduced in version 0.25.\n"
   ) +
+  gsi::method ("pcell_cache_path=", &set_pcell_cache_path, gsi::arg ("path"),
+    "@brief Sets the directory of the persistent PCell cache\n"
+    "\n"
+    "The persistent PCell cache keeps the layout produced by PCells across sessions. "
+    "Only library PCells which provide a cache version (see \\PCellDeclaration#cache_version) are cached. "
+    "Variants instantiating other cells are not cached. "
+    "An empty path disables the cache. The initial path is taken from the KLAYOUT_PCELL_CACHE "
+    "environment variable.\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
+  ) +
+  gsi::method ("pcell_cache_path", &pcell_cache_path,
+    "@brief Gets the directory of the persistent PCell cache\n"
+    "See \\pcell_cache_path= for details.\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
+  ) +
+  gsi::method ("pcell_cache_max_size=", &set_pcell_cache_max_size, gsi::arg ("bytes"),
+    "@brief Sets the maximum size of the persistent PCell cache directory in bytes\n"
+    "\n"
+    "When storing an entry makes the cache exceed this size, the least recently used entries are removed "
+    "until the size is below three quarters of the limit. A value of 0 disables the limit. "
+    "The initial value is taken from the KLAYOUT_PCELL_CACHE_SIZE environment variable (in megabytes). "
+    "The default is 1 GB.\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
+  ) +
+  gsi::method ("pcell_cache_max_size", &pcell_cache_max_size,
+    "@brief Gets the maximum size of the persistent PCell cache directory in bytes\n"
+    "See \\pcell_cache_max_size= for details.\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
+  ) +
+  gsi::method ("clear_pcell_cache", &clear_pcell_cache,
+    "@brief Removes all entries from the persistent PCell cache\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
+  ) +
   gsi::method ("name", &db::Library::get_name, 
     "@brief Returns the libraries' name\n"
     "The name is set when the library is registered and cannot be changed\n"
@@ -173,6 +237,7 @@ Class<db::PCellDeclaration> decl_PCellDeclaration_Native ("db", "PCellDeclaratio
   gsi::method ("parameters_from_shape", &db::PCellDeclaration::parameters_from_shape) +
   gsi::method ("transformation_from_shape", &db::PCellDeclaration::transformation_from_shape) +
   gsi::method ("display_text", &db::PCellDeclaration::get_display_name) +
+  gsi::method ("cache_version", &db::PCellDeclaration::cache_version) +
   gsi::method ("id", &db::PCellDeclaration::id,
     "@brief Gets the integer ID of the PCell declaration\n"
     "This ID is used to identify the PCell in the context of a Layout object for example"
@@ -313,6 +378,20 @@ public:
     }
   }
 
+  std::string cache_version_fb () const
+  {
+    return db::PCellDeclaration::cache_version ();
+  }
+
+  virtual std::string cache_version () const
+  {
+    if (cb_cache_version.can_issue ()) {
+      return cb_cache_version.issue<db::PCellDeclaration, std::string> (&db::PCellDeclaration::cache_version);
+    } else {
+      return db::PCellDeclaration::cache_version ();
+    }
+  }
+
   gsi::Callback cb_get_layer_declarations;
   gsi::Callback cb_get_parameter_declarations;
   gsi::Callback cb_produce;
@@ -321,6 +400,7 @@ public:
   gsi::Callback cb_transformation_from_shape;
   gsi::Callback cb_coerce_parameters;
   gsi::Callback cb_get_display_name;
+  gsi::Callback cb_cache_version;
 };
 
 Class<PCellDeclarationImpl> decl_PCellDeclaration (decl_PCellDeclaration_Native, "db", "PCellDeclaration",
@@ -331,6 +411,7 @@ Class<PCellDeclarationImpl> decl_PCellDeclaration (decl_PCellDeclaration_Native,
   gsi::method ("parameters_from_shape", &PCellDeclarationImpl::parameters_from_shape_fb, "@hide") +
   gsi::method ("transformation_from_shape", &PCellDeclarationImpl::transformation_from_shape_fb, "@hide") +
   gsi::method ("display_text", &PCellDeclarationImpl::get_display_name_fb, "@hide") +
+  gsi::method ("cache_version", &PCellDeclarationImpl::cache_version_fb, "@hide") +
   gsi::callback ("get_layers", &PCellDeclarationImpl::get_layer_declarations_impl, &PCellDeclarationImpl::cb_get_layer_declarations, gsi::arg ("parameters"),
     "@brief Returns a list of layer declarations\n"
     "Reimplement this method to return a list of layers this PCell wants to create.\n"
@@ -403,6 +484,16 @@ Class<PCellDeclarationImpl> decl_PCellDeclaration (decl_PCellDeclaration_Native,
     "@brief Returns the display text for this PCell given a certain parameter set\n"
     "Reimplement this method to create a distinct display text for a PCell variant with \n"
     "the given parameter set. If this method is not implemented, a default text is created. \n"
+  ) +
+  gsi::callback ("cache_version", &PCellDeclarationImpl::cache_version, &PCellDeclarationImpl::cb_cache_version,
+    "@brief Returns the version string for the persistent PCell cache\n"
+    "Reimplement this method to enable caching of the layout produced by this PCell across "
+    "sessions (see \\Library#pcell_cache_path=). The version string must change whenever the "
+    "production code changes - for example it can be a hash of the library's source file. "
+    "Cached layouts with a different version are discarded. The default implementation returns "
+    "an empty string which disables caching.\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
   ),
   "@brief A PCell declaration providing the parameters and code to produce the PCell\n"
   "\n"
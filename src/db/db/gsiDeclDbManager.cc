@@ -116,6 +116,26 @@ Class<db::Manager> decl_Manager ("db", "Manager",
   ) +
   gsi::method_ext ("transaction_for_redo", &transaction_for_redo,
     "@brief Return the description of the next transaction for 'redo'\n"
+  ) +
+  gsi::method ("max_memory=", &db::Manager::set_max_memory, gsi::arg ("bytes"),
+    "@brief Sets the memory budget for the undo history\n"
+    "\n"
+    "If the operations of the transactions held for undo require more memory than "
+    "the given number of bytes, the oldest transactions are discarded. The most recent "
+    "transaction is always kept. A value of 0 (the default) means unlimited.\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
+  ) +
+  gsi::method ("max_memory", &db::Manager::max_memory,
+    "@brief Gets the memory budget for the undo history\n"
+    "See \\max_memory= for details.\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
+  ) +
+  gsi::method ("memory_used", &db::Manager::memory_used,
+    "@brief Gets the approximate memory in bytes used by the transactions held for undo and redo\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
   ),
   "@brief A transaction manager class\n"
   "\n"
@@ -1447,6 +1447,13 @@ circuits_by_name (db::Netlist *netlist, const std::string &name_pattern)
   return res;
 }
 
+static std::map<std::string, size_t> netlist_mem_statistics (const db::Netlist *netlist)
+{
+  db::MemStatisticsCollector ms (false);
+  netlist->mem_stat (&ms, db::MemStatistics::NetlistInfo, 0);
+  return ms.size_per_purpose ();
+}
+
 Class<db::Netlist> decl_dbNetlist ("db", "Netlist",
   gsi::method_ext ("add", &gsi::add_circuit, gsi::arg ("circuit"),
     "@brief Adds the circuit to the netlist\n"
@@ -1562,6 +1569,13 @@ Class<db::Netlist> decl_dbNetlist ("db", "Netlist",
     "For example, serial or parallel resistors can be combined into "
     "a single resistor.\n"
   ) +
+  gsi::method_ext ("mem_statistics", &netlist_mem_statistics,
+    "@brief Gets the memory used by the netlist, broken down by category\n"
+    "The result is a hash of category names to bytes. The \"total\" key gives the sum. "
+    "The netlist figures are estimates based on the number of objects and their attributes.\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
+  ) +
   gsi::method ("make_top_level_pins", &db::Netlist::make_top_level_pins,
     "@brief Creates pins for top-level circuits.\n"
     "This method will turn all named nets of top-level circuits (such that are not "
@@ -2052,6 +2066,20 @@ Class<db::NetlistSpiceReader> db_NetlistSpiceReader (db_NetlistReader, "db", "Ne
   ) +
   gsi::constructor ("new", &new_spice_reader2, gsi::arg ("delegate"),
     "@brief Creates a new reader with a delegate.\n"
+  ) +
+  gsi::method ("num_threads=", &db::NetlistSpiceReader::set_num_threads, gsi::arg ("n"),
+    "@brief Sets the number of threads to use for tokenizing the input\n"
+    "If this value is larger than 0, the input is read in batches of lines which are "
+    "tokenized in parallel. The netlist is still built in the original order, so the "
+    "result is identical to the single-threaded one. This is useful for large netlists.\n"
+    "\n"
+    "This attribute has been introduced in version 0.27."
+  ) +
+  gsi::method ("num_threads", &db::NetlistSpiceReader::num_threads,
+    "@brief Gets the number of threads to use for tokenizing the input\n"
+    "See \\num_threads= for details.\n"
+    "\n"
+    "This attribute has been introduced in version 0.27."
   ),
   "@brief Implements a netlist Reader for the SPICE format.\n"
   "Use the SPICE reader like this:\n"
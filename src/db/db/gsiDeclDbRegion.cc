@@ -32,6 +32,7 @@
 #include "dbDeepShapeStore.h"
 #include "dbRegion.h"
 #include "dbRegionProcessors.h"
+#include "dbPackedCoordinates.h"
 #include "tlGlobPattern.h"
 
 #include <memory>
@@ -215,6 +216,31 @@ static void insert_si2 (db::Region *r, db::RecursiveShapeIterator si, db::ICplxT
   }
 }
 
+static std::vector<std::vector<char> > to_packed (const db::Region *r, bool wide)
+{
+  db::PackedPolygonWriter writer (wide);
+  for (db::Region::const_iterator p = r->begin (); ! p.at_end (); ++p) {
+    writer.add (*p);
+  }
+
+  std::vector<std::vector<char> > res;
+  res.resize (3);
+  res [0].swap (writer.points ());
+  res [1].swap (writer.contours ());
+  res [2].swap (writer.polygons ());
+  return res;
+}
+
+static void insert_packed (db::Region *r, const std::vector<char> &points, const std::vector<char> &contours, const std::vector<char> &polygons, bool wide)
+{
+  db::PackedPolygonReader reader (points, contours, polygons, wide);
+  db::Polygon poly;
+  for (size_t i = 0; i < reader.size (); ++i) {
+    reader.get (i, poly);
+    r->insert (poly);
+  }
+}
+
 static db::Region minkowsky_sum_pe (const db::Region *r, const db::Edge &e)
 {
   return r->processed (db::minkowsky_sum_computation<db::Edge> (e));
@@ -1070,6 +1096,38 @@ Class<db::Region> decl_Region (decl_dbShapeCollection, "db", "Region",
     "\n"
     "This method has been introduced in version 0.25."
   ) +
+  method_ext ("to_packed", &to_packed, gsi::arg ("wide", false),
+    "@brief Exports the polygons as packed coordinate arrays\n"
+    "@param wide If true, 64 bit integers are produced, otherwise 32 bit integers\n"
+    "@return An array with three byte strings: the points, the contour offsets and the polygon offsets\n"
+    "\n"
+    "This method is intended for bulk transfer of geometry without creating one object per polygon. "
+    "The byte strings hold integer numbers in native byte order. In Python they are delivered as \"bytes\" "
+    "objects which can be wrapped by NumPy arrays with \"numpy.frombuffer\". In Ruby they are binary strings "
+    "which can be decoded with \"unpack\" (\"l*\" for 32 bit, \"q*\" for 64 bit).\n"
+    "\n"
+    "The points array holds x and y of all contour points. The contour offsets array holds the index "
+    "of the first point of each contour plus one final entry with the total number of points. The polygon "
+    "offsets array holds the index of the first contour of each polygon plus one final entry with the total "
+    "number of contours. The first contour of a polygon is the hull, the following ones are the holes.\n"
+    "\n"
+    "The polygons are delivered in the order of \\each, i.e. without merged semantics.\n"
+    "\n"
+    "This method has been introduced in version 0.27."
+  ) +
+  method_ext ("insert_packed", &insert_packed, gsi::arg ("points"), gsi::arg ("contours"), gsi::arg ("polygons"), gsi::arg ("wide", false),
+    "@brief Inserts polygons from packed coordinate arrays\n"
+    "@param points The x and y coordinates of the contour points\n"
+    "@param contours The point offsets of the contours\n"
+    "@param polygons The contour offsets of the polygons\n"
+    "@param wide If true, the arrays hold 64 bit integers, otherwise 32 bit integers\n"
+    "\n"
+    "This method is the reverse of \\to_packed. In Python, the arrays can be \"bytes\" or \"bytearray\" "
+    "objects or any object supporting the buffer protocol, such as contiguous NumPy arrays of the "
+    "matching integer type.\n"
+    "\n"
+    "This method has been introduced in version 0.27."
+  ) +
   method_ext ("extents", &extents0,
     "@brief Returns a region with the bounding boxes of the polygons\n"
     "This method will return a region consisting of the bounding boxes of the polygons.\n"
@@ -30,6 +30,7 @@
 #include "dbRegion.h"
 #include "dbEdgePairs.h"
 #include "dbEdges.h"
+#include "dbPackedCoordinates.h"
 
 namespace gsi
 {
@@ -296,6 +297,33 @@ static void insert_region (db::Shapes *sh, const db::Region &r)
   }
 }
 
+static std::vector<std::vector<char> > polygons_to_packed (const db::Shapes *sh, unsigned int flags, bool wide)
+{
+  db::PackedPolygonWriter writer (wide);
+  db::Polygon poly;
+  for (db::Shapes::shape_iterator s = sh->begin (flags & (db::ShapeIterator::Polygons | db::ShapeIterator::Boxes | db::ShapeIterator::Paths)); ! s.at_end (); ++s) {
+    s->polygon (poly);
+    writer.add (poly);
+  }
+
+  std::vector<std::vector<char> > res;
+  res.resize (3);
+  res [0].swap (writer.points ());
+  res [1].swap (writer.contours ());
+  res [2].swap (writer.polygons ());
+  return res;
+}
+
+static void insert_packed_polygons (db::Shapes *sh, const std::vector<char> &points, const std::vector<char> &contours, const std::vector<char> &polygons, bool wide)
+{
+  db::PackedPolygonReader reader (points, contours, polygons, wide);
+  db::Polygon poly;
+  for (size_t i = 0; i < reader.size (); ++i) {
+    reader.get (i, poly);
+    sh->insert (poly);
+  }
+}
+
 static void insert_region_with_trans (db::Shapes *sh, const db::Region &r, const db::ICplxTrans &trans)
 {
   //  NOTE: if the source (r) is from the same layout than the shapes live in, we better
@@ -551,6 +579,25 @@ Class<db::Shapes> decl_Shapes ("db", "Shapes",
     "\n"
     "This method has been introduced in version 0.23.\n"
   ) +
+  gsi::method_ext ("polygons_to_packed", &polygons_to_packed, gsi::arg ("flags", db::ShapeIterator::All, "All"), gsi::arg ("wide", false),
+    "@brief Exports the polygon-like shapes as packed coordinate arrays\n"
+    "@param flags An \"or\"-ed combination of the S... constants selecting the shapes\n"
+    "@param wide If true, 64 bit integers are produced, otherwise 32 bit integers\n"
+    "@return An array with three byte strings: the points, the contour offsets and the polygon offsets\n"
+    "\n"
+    "Polygons, boxes and paths are converted to polygons. Other shapes are ignored. "
+    "See \\Region#to_packed for a description of the packed format.\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
+  ) +
+  gsi::method_ext ("insert_packed_polygons", &insert_packed_polygons, gsi::arg ("points"), gsi::arg ("contours"), gsi::arg ("polygons"), gsi::arg ("wide", false),
+    "@brief Inserts polygons from packed coordinate arrays\n"
+    "\n"
+    "This method is the reverse of \\polygons_to_packed. "
+    "See \\Region#insert_packed for a description of the arguments.\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
+  ) +
   gsi::method_ext ("insert", &insert_region_with_trans, gsi::arg ("region"), gsi::arg ("trans"),
     "@brief Inserts the polygons from the region into this shape container with a transformation\n"
     "@param region The region to insert\n"
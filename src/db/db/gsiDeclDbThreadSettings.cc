@@ -0,0 +1,117 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2020 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+#include "gsiDecl.h"
+
+#include "dbBoxTree.h"
+#include "dbBoxScanner.h"
+#include "tlThreads.h"
+
+namespace gsi
+{
+
+/**
+ *  @brief A pseudo class that wraps the global thread settings of the database
+ */
+class ThreadSettings
+{
+public:
+  static int cores ()
+  {
+    return tl::available_cores ();
+  }
+
+  static int box_tree_sort_threads ()
+  {
+    return db::box_tree_sort_threads ();
+  }
+
+  static void set_box_tree_sort_threads (int threads)
+  {
+    db::set_box_tree_sort_threads (threads);
+  }
+
+  static unsigned int box_scanner_threads ()
+  {
+    return db::box_scanner_threads ();
+  }
+
+  static void set_box_scanner_threads (unsigned int threads)
+  {
+    db::set_box_scanner_threads (threads);
+  }
+};
+
+}
+
+namespace tl {
+  template <> struct type_traits<gsi::ThreadSettings> : public type_traits<void> {
+    typedef tl::false_tag has_copy_constructor;
+    typedef tl::false_tag has_default_constructor;
+  };
+}
+
+namespace gsi
+{
+
+Class<ThreadSettings> decl_ThreadSettings ("db", "ThreadSettings",
+  gsi::method ("cores", &ThreadSettings::cores,
+    "@brief Gets the number of processor cores available\n"
+    "This is the number of threads which can run concurrently.\n"
+  ) +
+  gsi::method ("box_tree_sort_threads=", &ThreadSettings::set_box_tree_sort_threads, gsi::arg ("threads"),
+    "@brief Sets the number of threads used for building the shape and instance lookup trees\n"
+    "With a thread count larger than 0, the lookup trees of big cells are built with the given number "
+    "of worker threads when a layout is updated, e.g. after reading a file. Small trees are always built "
+    "in the calling thread. The resulting trees are identical to the ones built in the calling thread.\n"
+    "\n"
+    "The initial value is taken from the KLAYOUT_BOX_TREE_SORT_THREADS environment variable. "
+    "If this variable is not set, the number of available cores is used (0 on a single-core machine).\n"
+  ) +
+  gsi::method ("box_tree_sort_threads", &ThreadSettings::box_tree_sort_threads,
+    "@brief Gets the number of threads used for building the shape and instance lookup trees\n"
+    "See \\box_tree_sort_threads= for details.\n"
+  ) +
+  gsi::method ("box_scanner_threads=", &ThreadSettings::set_box_scanner_threads, gsi::arg ("threads"),
+    "@brief Sets the number of threads used by the flat region operations for the interaction scan\n"
+    "With a thread count larger than 0, the flat \\Region#interacting and \\Region#not_interacting operations "
+    "with \\Edges on big inputs split the scan into horizontal slabs which are processed by the given number of "
+    "worker threads. Other interaction and check operations are not multi-threaded yet. "
+    "Small inputs are always processed in the calling thread. The results do not depend on the thread count.\n"
+    "\n"
+    "The initial value is taken from the KLAYOUT_BOX_SCANNER_THREADS environment variable. "
+    "If this variable is not set, the value is 0 (single-threaded).\n"
+  ) +
+  gsi::method ("box_scanner_threads", &ThreadSettings::box_scanner_threads,
+    "@brief Gets the number of threads used by the flat region operations for the interaction scan\n"
+    "See \\box_scanner_threads= for details.\n"
+  ),
+  "@brief Global settings for the multi-threaded operations of the layout database\n"
+  "\n"
+  "These settings apply to the whole application. Operations which take a thread count "
+  "argument (e.g. \\DeepShapeStore#threads= or \\TilingProcessor#threads=) are not affected.\n"
+  "\n"
+  "This class has been introduced in version 0.27.\n"
+);
+
+}
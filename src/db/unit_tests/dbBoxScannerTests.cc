@@ -381,6 +381,177 @@ TEST(2)
   run_test2(_this, 10000, 2, 10000);
 }
 
+struct BoxScannerTestRecorderFinishCount
+{
+  void finish (const db::Box *, size_t p) { ++finished [p]; }
+  void finish1 (const db::Box *, size_t p) { ++finished [p]; }
+  void finish2 (const db::SimplePolygon *, int p) { ++finished2 [p]; }
+
+  void initialize () { }
+  void finalize (bool) { }
+
+  std::map<size_t, int> finished;
+  std::map<int, int> finished2;
+};
+
+struct BoxScannerTestSlabRecorder
+{
+  bool stop () const { return false; }
+
+  void add (const db::Box * /*b1*/, size_t p1, const db::Box * /*b2*/, size_t p2)
+  {
+    interactions.push_back (std::make_pair (std::min (p1, p2), std::max (p1, p2)));
+  }
+
+  std::vector<std::pair<size_t, size_t> > interactions;
+};
+
+void run_test3 (tl::TestBase *_this, size_t n, db::Coord spread, size_t nslabs, unsigned int nthreads, bool touch = true)
+{
+  std::vector<db::Box> bb;
+  for (size_t i = 0; i < n; ++i) {
+    db::Coord x = rand () % spread;
+    db::Coord y = rand () % spread;
+    db::Coord h = 1 + rand () % 300;
+    bb.push_back (db::Box (x, y, x + 100, y + h));
+  }
+
+  db::box_scanner<db::Box, size_t> bs;
+  for (std::vector<db::Box>::const_iterator b = bb.begin (); b != bb.end (); ++b) {
+    bs.insert (&*b, b - bb.begin ());
+  }
+
+  std::vector<BoxScannerTestSlabRecorder> slab_recs (nslabs);
+  std::vector<BoxScannerTestSlabRecorder *> slab_rec_ptrs;
+  for (size_t i = 0; i < nslabs; ++i) {
+    slab_rec_ptrs.push_back (&slab_recs [i]);
+  }
+
+  BoxScannerTestRecorderFinishCount fr;
+  bs.set_scanner_threshold (10);
+  EXPECT_EQ (bs.process (fr, slab_rec_ptrs, nthreads, touch ? 1 : 0, db::box_convert<db::Box> ()), true);
+
+  //  each interaction must be reported exactly once
+  std::vector<std::pair<size_t, size_t> > mt_interactions;
+  for (size_t i = 0; i < nslabs; ++i) {
+    mt_interactions.insert (mt_interactions.end (), slab_recs [i].interactions.begin (), slab_recs [i].interactions.end ());
+  }
+  std::sort (mt_interactions.begin (), mt_interactions.end ());
+
+  std::vector<std::pair<size_t, size_t> > interactions;
+  for (size_t i = 0; i < bb.size (); ++i) {
+    for (size_t j = i + 1; j < bb.size (); ++j) {
+      if ((touch && bb[i].touches (bb[j])) || (!touch && bb[i].overlaps (bb[j]))) {
+        interactions.push_back (std::make_pair (i, j));
+      }
+    }
+  }
+
+  EXPECT_EQ (interactions == mt_interactions, true);
+
+  //  finish is called once per object
+  EXPECT_EQ (fr.finished.size (), n);
+  bool finished_once = true;
+  for (std::map<size_t, int>::const_iterator f = fr.finished.begin (); f != fr.finished.end (); ++f) {
+    if (f->second != 1) {
+      finished_once = false;
+    }
+  }
+  EXPECT_EQ (finished_once, true);
+}
+
+TEST(3)
+{
+  run_test3 (_this, 10, 1000, 4, 0);
+  run_test3 (_this, 1000, 1000, 1, 0);
+  run_test3 (_this, 1000, 1000, 4, 0);
+  run_test3 (_this, 1000, 1000, 4, 1);
+  run_test3 (_this, 1000, 1000, 7, 4);
+  run_test3 (_this, 1000, 1000, 16, 4, false);
+  run_test3 (_this, 1000, 10, 8, 4);
+  run_test3 (_this, 10000, 10000, 16, 4);
+}
+
+struct BoxScannerTestMergingRecorder
+{
+  typedef BoxScannerTestMergingRecorder slab_receiver_type;
+
+  BoxScannerTestMergingRecorder () : merged (0), finished_before_merge (0) { }
+
+  bool stop () const { return false; }
+  void initialize () { }
+  void finalize (bool) { }
+
+  void finish (const db::Box *, size_t) { if (merged == 0) ++finished_before_merge; }
+  void finish1 (const db::Box *, size_t) { if (merged == 0) ++finished_before_merge; }
+  void finish2 (const db::SimplePolygon *, int) { if (merged == 0) ++finished_before_merge; }
+
+  void add (const db::Box * /*b1*/, size_t p1, const db::Box * /*b2*/, size_t p2)
+  {
+    interactions.push_back (std::make_pair (std::min (p1, p2), size_t (std::max (p1, p2))));
+  }
+
+  void add (const db::Box * /*b1*/, size_t p1, const db::SimplePolygon * /*b2*/, int p2)
+  {
+    interactions.push_back (std::make_pair (p1, size_t (p2)));
+  }
+
+  slab_receiver_type make_slab_receiver () const
+  {
+    return BoxScannerTestMergingRecorder ();
+  }
+
+  void merge (const BoxScannerTestMergingRecorder &other)
+  {
+    interactions.insert (interactions.end (), other.interactions.begin (), other.interactions.end ());
+    ++merged;
+  }
+
+  std::vector<std::pair<size_t, size_t> > interactions;
+  size_t merged, finished_before_merge;
+};
+
+void run_test3a (tl::TestBase *_this, size_t n, db::Coord spread, size_t nslabs, unsigned int nthreads)
+{
+  std::vector<db::Box> bb;
+  for (size_t i = 0; i < n; ++i) {
+    db::Coord x = rand () % spread;
+    db::Coord y = rand () % spread;
+    bb.push_back (db::Box (x, y, x + 100, y + 1 + rand () % 300));
+  }
+
+  db::box_scanner<db::Box, size_t> bs_serial, bs;
+  for (std::vector<db::Box>::const_iterator b = bb.begin (); b != bb.end (); ++b) {
+    bs_serial.insert (&*b, b - bb.begin ());
+    bs.insert (&*b, b - bb.begin ());
+  }
+
+  BoxScannerTestMergingRecorder serial;
+  EXPECT_EQ (bs_serial.process (serial, 1, db::box_convert<db::Box> ()), true);
+  std::sort (serial.interactions.begin (), serial.interactions.end ());
+
+  BoxScannerTestMergingRecorder rec;
+  bs.set_scanner_threshold (10);
+  EXPECT_EQ (bs.process (rec, nthreads, nslabs, 1, db::box_convert<db::Box> ()), true);
+
+  //  the slab receivers are merged before "finish" is called
+  EXPECT_EQ (rec.merged, nslabs);
+  EXPECT_EQ (rec.finished_before_merge, size_t (0));
+
+  std::sort (rec.interactions.begin (), rec.interactions.end ());
+  EXPECT_EQ (rec.interactions.size (), serial.interactions.size ());
+  EXPECT_EQ (rec.interactions == serial.interactions, true);
+}
+
+TEST(3a)
+{
+  run_test3a (_this, 10, 1000, 4, 0);
+  run_test3a (_this, 1000, 1000, 1, 0);
+  run_test3a (_this, 1000, 1000, 4, 1);
+  run_test3a (_this, 1000, 1000, 7, 4);
+  run_test3a (_this, 10000, 10000, 16, 4);
+}
+
 
 struct TestCluster
   : public db::cluster<db::Box, size_t>
@@ -1160,3 +1331,134 @@ TEST(two_2i)
 {
   run_test2_two(_this, 10000, 2, 10000);
 }
+
+struct BoxScannerTestSlabRecorderTwo
+{
+  bool stop () const { return false; }
+
+  void add (const db::Box * /*b1*/, size_t p1, const db::SimplePolygon * /*b2*/, int p2)
+  {
+    interactions.push_back (std::make_pair (p1, p2));
+  }
+
+  std::vector<std::pair<size_t, int> > interactions;
+};
+
+void run_test3_two (tl::TestBase *_this, size_t n, db::Coord spread, size_t nslabs, unsigned int nthreads, bool touch = true)
+{
+  std::vector<db::Box> bb;
+  for (size_t i = 0; i < n; ++i) {
+    db::Coord x = rand () % spread;
+    db::Coord y = rand () % spread;
+    bb.push_back (db::Box (x, y, x + 100, y + 1 + rand () % 300));
+  }
+
+  std::vector<db::SimplePolygon> bb2;
+  for (size_t i = 0; i < n; ++i) {
+    db::Coord x = rand () % spread;
+    db::Coord y = rand () % spread;
+    bb2.push_back (db::SimplePolygon (db::Box (x, y, x + 100, y + 100)));
+  }
+
+  db::box_scanner2<db::Box, size_t, db::SimplePolygon, int> bs;
+  for (std::vector<db::Box>::const_iterator b = bb.begin (); b != bb.end (); ++b) {
+    bs.insert1 (&*b, b - bb.begin ());
+  }
+  for (std::vector<db::SimplePolygon>::const_iterator b2 = bb2.begin (); b2 != bb2.end (); ++b2) {
+    bs.insert2 (&*b2, int (b2 - bb2.begin ()));
+  }
+
+  std::vector<BoxScannerTestSlabRecorderTwo> slab_recs (nslabs);
+  std::vector<BoxScannerTestSlabRecorderTwo *> slab_rec_ptrs;
+  for (size_t i = 0; i < nslabs; ++i) {
+    slab_rec_ptrs.push_back (&slab_recs [i]);
+  }
+
+  BoxScannerTestRecorderFinishCount fr;
+  bs.set_scanner_threshold (10);
+  EXPECT_EQ (bs.process (fr, slab_rec_ptrs, nthreads, touch ? 1 : 0, db::box_convert<db::Box> (), db::box_convert<db::SimplePolygon> ()), true);
+
+  //  each interaction must be reported exactly once
+  std::vector<std::pair<size_t, int> > mt_interactions;
+  for (size_t i = 0; i < nslabs; ++i) {
+    mt_interactions.insert (mt_interactions.end (), slab_recs [i].interactions.begin (), slab_recs [i].interactions.end ());
+  }
+  std::sort (mt_interactions.begin (), mt_interactions.end ());
+
+  std::vector<std::pair<size_t, int> > interactions;
+  for (size_t i = 0; i < bb.size (); ++i) {
+    for (size_t j = 0; j < bb2.size (); ++j) {
+      if ((touch && bb[i].touches (bb2[j].box ())) || (!touch && bb[i].overlaps (bb2[j].box ()))) {
+        interactions.push_back (std::make_pair (i, int (j)));
+      }
+    }
+  }
+
+  EXPECT_EQ (interactions == mt_interactions, true);
+
+  EXPECT_EQ (fr.finished.size (), n);
+  EXPECT_EQ (fr.finished2.size (), n);
+}
+
+TEST(two_3)
+{
+  run_test3_two (_this, 10, 1000, 4, 0);
+  run_test3_two (_this, 1000, 1000, 1, 0);
+  run_test3_two (_this, 1000, 1000, 4, 1);
+  run_test3_two (_this, 1000, 1000, 7, 4);
+  run_test3_two (_this, 1000, 1000, 16, 4, false);
+  run_test3_two (_this, 1000, 10, 8, 4);
+  run_test3_two (_this, 10000, 10000, 16, 4);
+}
+
+void run_test3a_two (tl::TestBase *_this, size_t n, db::Coord spread, size_t nslabs, unsigned int nthreads)
+{
+  std::vector<db::Box> bb;
+  for (size_t i = 0; i < n; ++i) {
+    db::Coord x = rand () % spread;
+    db::Coord y = rand () % spread;
+    bb.push_back (db::Box (x, y, x + 100, y + 1 + rand () % 300));
+  }
+
+  std::vector<db::SimplePolygon> bb2;
+  for (size_t i = 0; i < n; ++i) {
+    db::Coord x = rand () % spread;
+    db::Coord y = rand () % spread;
+    bb2.push_back (db::SimplePolygon (db::Box (x, y, x + 100, y + 100)));
+  }
+
+  db::box_scanner2<db::Box, size_t, db::SimplePolygon, int> bs_serial, bs;
+  for (std::vector<db::Box>::const_iterator b = bb.begin (); b != bb.end (); ++b) {
+    bs_serial.insert1 (&*b, b - bb.begin ());
+    bs.insert1 (&*b, b - bb.begin ());
+  }
+  for (std::vector<db::SimplePolygon>::const_iterator b2 = bb2.begin (); b2 != bb2.end (); ++b2) {
+    bs_serial.insert2 (&*b2, int (b2 - bb2.begin ()));
+    bs.insert2 (&*b2, int (b2 - bb2.begin ()));
+  }
+
+  BoxScannerTestMergingRecorder serial;
+  EXPECT_EQ (bs_serial.process (serial, 1, db::box_convert<db::Box> (), db::box_convert<db::SimplePolygon> ()), true);
+  std::sort (serial.interactions.begin (), serial.interactions.end ());
+
+  BoxScannerTestMergingRecorder rec;
+  bs.set_scanner_threshold (10);
+  EXPECT_EQ (bs.process (rec, nthreads, nslabs, 1, db::box_convert<db::Box> (), db::box_convert<db::SimplePolygon> ()), true);
+
+  //  the slab receivers are merged before "finish1" and "finish2" are called
+  EXPECT_EQ (rec.merged, nslabs);
+  EXPECT_EQ (rec.finished_before_merge, size_t (0));
+
+  std::sort (rec.interactions.begin (), rec.interactions.end ());
+  EXPECT_EQ (rec.interactions.size (), serial.interactions.size ());
+  EXPECT_EQ (rec.interactions == serial.interactions, true);
+}
+
+TEST(two_3a)
+{
+  run_test3a_two (_this, 10, 1000, 4, 0);
+  run_test3a_two (_this, 1000, 1000, 1, 0);
+  run_test3a_two (_this, 1000, 1000, 4, 1);
+  run_test3a_two (_this, 1000, 1000, 7, 4);
+  run_test3a_two (_this, 10000, 10000, 16, 4);
+}
@@ -1032,3 +1032,114 @@ TEST(6U)
 }
 
 
+
+template <class Tree>
+static bool same_nodes (const db::box_tree_node<Tree> *a, const db::box_tree_node<Tree> *b)
+{
+  if (! a || ! b) {
+    return a == b;
+  }
+  if (a->center () != b->center () || a->quad () != b->quad ()) {
+    return false;
+  }
+  for (int q = -1; q < 4; ++q) {
+    if (a->lenq (q) != b->lenq (q)) {
+      return false;
+    }
+  }
+  for (int q = 0; q < 4; ++q) {
+    if (! same_nodes (a->child (q), b->child (q))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <class Tree, class BoxConv>
+static void test_parallel_sort (tl::TestBase *_this, BoxConv conv)
+{
+  Tree t1, t2;
+
+  int n = 300000;
+  for (int i = 0; i < n; ++i) {
+    db::Box bx;
+    if (rvalue () % 3000 != 0) {
+      bx = rbox ();
+    }
+    t1.insert (bx);
+    t2.insert (bx);
+  }
+
+  int saved_threads = db::box_tree_sort_threads ();
+
+  db::set_box_tree_sort_threads (0);
+  t1.sort (conv);
+
+  db::set_box_tree_sort_threads (4);
+  try {
+    t2.sort (conv);
+  } catch (...) {
+    db::set_box_tree_sort_threads (saved_threads);
+    throw;
+  }
+  db::set_box_tree_sort_threads (saved_threads);
+
+  EXPECT_EQ (t1.root () != 0, true);
+  EXPECT_EQ (same_nodes (t1.root (), t2.root ()), true);
+
+  db::Box world = db::Box::world ();
+  typename Tree::touching_iterator i1 = t1.begin_touching (world, conv);
+  typename Tree::touching_iterator i2 = t2.begin_touching (world, conv);
+  size_t nn = 0;
+  while (! i1.at_end () && ! i2.at_end () && *i1 == *i2) {
+    ++i1;
+    ++i2;
+    ++nn;
+  }
+  EXPECT_EQ (i1.at_end (), true);
+  EXPECT_EQ (i2.at_end (), true);
+  EXPECT_EQ (nn > 0, true);
+
+  db::Box sbox (-1000, -1000, 500, 2000);
+  std::vector<db::Box> r1, r2;
+  for (typename Tree::touching_iterator i = t1.begin_touching (sbox, conv); ! i.at_end (); ++i) {
+    r1.push_back (*i);
+  }
+  for (typename Tree::touching_iterator i = t2.begin_touching (sbox, conv); ! i.at_end (); ++i) {
+    r2.push_back (*i);
+  }
+  EXPECT_EQ (r1.size () > 0, true);
+  EXPECT_EQ (r1 == r2, true);
+}
+
+//  parallel sort delivers the same tree as the single-threaded one
+TEST(7)
+{
+  test_parallel_sort<TestTreeL> (_this, Box2Box ());
+  test_parallel_sort<TestTreeCmplxL> (_this, Box2BoxCmplx ());
+}
+
+TEST(7U)
+{
+  test_parallel_sort<UnstableTestTreeL> (_this, Box2Box ());
+  test_parallel_sort<UnstableTestTreeCmplxL> (_this, Box2BoxCmplx ());
+
+  UnstableTestTreeL t1, t2;
+  for (int i = 0; i < 200000; ++i) {
+    db::Box bx = rbox ();
+    t1.insert (bx);
+    t2.insert (bx);
+  }
+
+  int saved_threads = db::box_tree_sort_threads ();
+
+  Box2Box conv;
+  db::set_box_tree_sort_threads (0);
+  t1.sort (conv);
+  db::set_box_tree_sort_threads (3);
+  t2.sort (conv);
+  db::set_box_tree_sort_threads (saved_threads);
+
+  //  the unstable tree reorders the objects themselves
+  EXPECT_EQ (std::equal (t1.begin (), t1.end (), t2.begin ()), true);
+}
@@ -24,6 +24,7 @@
 #include "dbCellVariants.h"
 #include "dbTestSupport.h"
 #include "dbReader.h"
+#include "dbRegion.h"
 #include "tlUnitTest.h"
 #include "tlStream.h"
 
@@ -370,6 +371,40 @@ TEST(9_ComplexGridVariants)
   EXPECT_EQ (var2str (vb.variants (d.cell_index ())), "");
 }
 
+TEST(10_ManyCellsMT)
+{
+  //  enough cells per level to make the collector use the threads
+
+  db::Layout ly;
+  db::Cell &top = ly.cell (ly.add_cell ("TOP"));
+  db::Cell &leaf = ly.cell (ly.add_cell ("LEAF"));
+
+  std::vector<db::cell_index_type> mid;
+  for (int i = 0; i < 2500; ++i) {
+    db::Cell &m = ly.cell (ly.add_cell (("M" + tl::to_string (i)).c_str ()));
+    mid.push_back (m.cell_index ());
+    top.insert (db::CellInstArray (db::CellInst (m.cell_index ()), db::Trans (i % 4, false, db::Vector (i * 10, 0))));
+    if (i % 3 == 0) {
+      top.insert (db::CellInstArray (db::CellInst (m.cell_index ()), db::Trans (0, true, db::Vector (i * 10, 100))));
+    }
+    m.insert (db::CellInstArray (db::CellInst (leaf.cell_index ()), db::Trans (i % 2, false, db::Vector ())));
+  }
+
+  db::cell_variants_collector<db::OrientationReducer> vb_st;
+  vb_st.collect (ly, top);
+
+  db::cell_variants_collector<db::OrientationReducer> vb_mt;
+  vb_mt.collect (ly, top, 4);
+
+  for (std::vector<db::cell_index_type>::const_iterator m = mid.begin (); m != mid.end (); ++m) {
+    EXPECT_EQ (var2str (vb_mt.variants (*m)), var2str (vb_st.variants (*m)));
+  }
+  EXPECT_EQ (var2str (vb_mt.variants (leaf.cell_index ())), var2str (vb_st.variants (leaf.cell_index ())));
+
+  EXPECT_EQ (var2str (vb_mt.variants (mid [3])), "r270 *1 0,0[1];m0 *1 0,0[1]");
+  EXPECT_EQ (var2str (vb_mt.variants (leaf.cell_index ())), "m135 *1 0,0[417];r180 *1 0,0[1250];m0 *1 0,0[417];r0 *1 0,0[1250]");
+}
+
 TEST(100_OrientationVariantsWithLayout)
 {
   db::Layout ly;
@@ -24,6 +24,7 @@
 #include "dbDeepShapeStore.h"
 #include "dbRegion.h"
 #include "dbDeepRegion.h"
+#include "dbMemStatistics.h"
 #include "tlUnitTest.h"
 #include "tlStream.h"
 
@@ -265,3 +266,57 @@ TEST(5_State)
   EXPECT_EQ (store.breakout_cells (0)->find (5) != store.breakout_cells (0)->end (), true);
   EXPECT_EQ (store.breakout_cells (0)->find (3) != store.breakout_cells (0)->end (), true);
 }
+
+TEST(6_MemStatistics)
+{
+  db::Layout layout;
+  unsigned int l1 = layout.insert_layer ();
+  unsigned int l2 = layout.insert_layer ();
+  db::cell_index_type c1 = layout.add_cell ("C1");
+  db::cell_index_type c2 = layout.add_cell ("C2");
+
+  for (int i = 0; i < 10; ++i) {
+    layout.cell (c2).shapes (l1).insert (db::Box (i * 100, 0, i * 100 + 50, 1000));
+    layout.cell (c2).shapes (l2).insert (db::Box (0, i * 100, 1000, i * 100 + 50));
+  }
+  for (int i = 0; i < 10; ++i) {
+    layout.cell (c1).insert (db::CellInstArray (db::CellInst (c2), db::Trans (db::Vector (i * 2000, 0))));
+  }
+
+  db::DeepShapeStore store;
+
+  db::MemStatisticsCollector ms0 (false);
+  store.mem_stat (&ms0, db::MemStatistics::DeepShapeStoreInfo, 0);
+  std::map<std::string, size_t> s0 = ms0.size_per_purpose ();
+  EXPECT_EQ (s0 ["total"] > 0, true);
+  EXPECT_EQ (s0 ["shapes_info"], size_t (0));
+
+  db::Region r1 (db::RecursiveShapeIterator (layout, layout.cell (c1), l1), store);
+  db::Region r2 (db::RecursiveShapeIterator (layout, layout.cell (c1), l2), store);
+
+  db::MemStatisticsPeakRegistry::set_enabled (true);
+  db::MemStatisticsPeakRegistry::reset ();
+
+  db::Region r = r1 & r2;
+  EXPECT_EQ (r.size (), size_t (1000));
+
+  std::map<std::string, size_t> peaks = db::MemStatisticsPeakRegistry::peaks ();
+  db::MemStatisticsPeakRegistry::set_enabled (false);
+  EXPECT_EQ (peaks ["processor_caches"] > 0, true);
+
+  db::MemStatisticsCollector ms1 (false);
+  store.mem_stat (&ms1, db::MemStatistics::DeepShapeStoreInfo, 0);
+  std::map<std::string, size_t> s1 = ms1.size_per_purpose ();
+  EXPECT_EQ (s1 ["total"] > s0 ["total"], true);
+  EXPECT_EQ (s1 ["shapes_info"] > 0, true);
+  EXPECT_EQ (s1 ["deep_shape_store"] > 0, true);
+
+  //  the sum of the categories is the total
+  size_t sum = 0;
+  for (std::map<std::string, size_t>::const_iterator i = s1.begin (); i != s1.end (); ++i) {
+    if (i->first != "total") {
+      sum += i->second;
+    }
+  }
+  EXPECT_EQ (sum, s1 ["total"]);
+}
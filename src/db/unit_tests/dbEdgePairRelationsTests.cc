@@ -402,3 +402,75 @@ TEST(8_KissingCornerProblem)
   res = f.check (db::Edge (db::Point (0, 100), db::Point (0, 0)), db::Edge (db::Point (0, -100), db::Point (0, -1)), &output);
   EXPECT_EQ (res, false);
 }
+
+static db::Edge random_edge (db::Coord offset, db::Coord spread)
+{
+  db::Coord x1 = offset + rand () % spread, y1 = offset + rand () % spread;
+  db::Coord x2 = offset + rand () % spread, y2 = offset + rand () % spread;
+
+  //  generate Manhattan edges preferably
+  int mode = rand () % 4;
+  if (mode == 0) {
+    x2 = x1;
+  } else if (mode == 1) {
+    y2 = y1;
+  }
+
+  return db::Edge (db::Point (x1, y1), db::Point (x2, y2));
+}
+
+TEST(9_PrefilterIsConservative)
+{
+  //  the batch prefilter must not reject any pair for which "check" returns true
+
+  const size_t n = 1000;
+
+  std::vector<db::Edge> a, b;
+  std::vector<char> candidates (n);
+
+  size_t checked = 0, rejected = 0, failed = 0;
+
+  db::edge_relation_type relations[] = { db::WidthRelation, db::SpaceRelation, db::OverlapRelation, db::InsideRelation };
+  db::metrics_type metrics[] = { db::Euclidian, db::Square, db::Projection };
+  double angles[] = { 90.0, 45.0, 135.0 };
+  db::Coord offsets[] = { -50, 100000000 };
+
+  for (unsigned int r = 0; r < sizeof (relations) / sizeof (relations [0]); ++r) {
+    for (unsigned int m = 0; m < sizeof (metrics) / sizeof (metrics [0]); ++m) {
+      for (unsigned int an = 0; an < sizeof (angles) / sizeof (angles [0]); ++an) {
+        for (unsigned int o = 0; o < sizeof (offsets) / sizeof (offsets [0]); ++o) {
+          for (int iz = 0; iz < 2; ++iz) {
+
+            db::EdgeRelationFilter f (relations [r], 1 + rand () % 40, metrics [m], angles [an]);
+            f.set_include_zero (iz != 0);
+
+            a.clear ();
+            b.clear ();
+            for (size_t i = 0; i < n; ++i) {
+              a.push_back (random_edge (offsets [o], 100));
+              b.push_back (random_edge (offsets [o], 100));
+            }
+
+            f.prefilter (&a.front (), &b.front (), n, &candidates.front ());
+
+            for (size_t i = 0; i < n; ++i) {
+              ++checked;
+              if (! candidates [i]) {
+                ++rejected;
+                if (f.check (a [i], b [i])) {
+                  ++failed;
+                  tl::warn << "Prefilter rejected a valid pair: " << a [i].to_string () << ", " << b [i].to_string () << " (relation " << int (relations [r]) << ", metrics " << int (metrics [m]) << ", d=" << f.distance () << ")";
+                }
+              }
+            }
+
+          }
+        }
+      }
+    }
+  }
+
+  EXPECT_EQ (failed, size_t (0));
+  //  the prefilter should reject a substantial part of the random pairs
+  EXPECT_EQ (rejected * 4 > checked, true);
+}
@@ -2483,3 +2483,159 @@ TEST(135b)
   EXPECT_EQ (run_test135b (_this, db::Trans (db::Trans::m90)), "(-78,25;-33,34;-36,33;-37,33)");
   EXPECT_EQ (run_test135b (_this, db::Trans (db::Trans::m135)), "(-26,-78;-35,-33;-33,-36;-33,-37)");
 }
+
+//  The Manhattan scanline implementation is used if all edges are horizontal or vertical.
+//  A far-away non-Manhattan triangle forces the general implementation, so both can be compared.
+
+static db::Polygon far_triangle ()
+{
+  db::Point pts[] = { db::Point (100000, 100000), db::Point (100000, 101000), db::Point (101000, 100000) };
+  db::Polygon p;
+  p.assign_hull (&pts[0], &pts[sizeof(pts) / sizeof(pts[0])]);
+  return p;
+}
+
+template <class Obj>
+static std::string near_objects (const std::vector<Obj> &objects)
+{
+  std::vector<Obj> near;
+  for (typename std::vector<Obj>::const_iterator o = objects.begin (); o != objects.end (); ++o) {
+    if (db::box_convert<Obj> () (*o).right () < 50000) {
+      near.push_back (*o);
+    }
+  }
+  std::sort (near.begin (), near.end ());
+
+  std::string s;
+  for (typename std::vector<Obj>::const_iterator o = near.begin (); o != near.end (); ++o) {
+    if (! s.empty ()) {
+      s += ";";
+    }
+    s += o->to_string ();
+  }
+  return s;
+}
+
+static void run_test_manhattan_vs_general (tl::TestBase *_this, const std::vector<db::Polygon> &a, const std::vector<db::Polygon> &b)
+{
+  std::vector<db::Polygon> ag (a);
+  ag.push_back (far_triangle ());
+
+  db::EdgeProcessor ep;
+
+  int modes[] = { db::BooleanOp::And, db::BooleanOp::Or, db::BooleanOp::Xor, db::BooleanOp::ANotB, db::BooleanOp::BNotA };
+
+  for (unsigned int m = 0; m < sizeof (modes) / sizeof (modes[0]); ++m) {
+
+    for (int f = 0; f < 4; ++f) {
+
+      bool resolve_holes = (f & 1) != 0;
+      bool min_coherence = (f & 2) != 0;
+
+      std::vector<db::Polygon> out_m, out_g;
+      ep.boolean (a, b, out_m, modes [m], resolve_holes, min_coherence);
+      ep.boolean (ag, b, out_g, modes [m], resolve_holes, min_coherence);
+      EXPECT_EQ (near_objects (out_g), near_objects (out_m));
+
+    }
+
+    std::vector<db::Edge> eout_m, eout_g;
+    ep.boolean (a, b, eout_m, modes [m]);
+    ep.boolean (ag, b, eout_g, modes [m]);
+    EXPECT_EQ (near_objects (eout_g), near_objects (eout_m));
+
+  }
+
+  //  merge
+  std::vector<db::Polygon> ab (a);
+  ab.insert (ab.end (), b.begin (), b.end ());
+  std::vector<db::Polygon> abg (ab);
+  abg.push_back (far_triangle ());
+
+  for (unsigned int min_wc = 0; min_wc < 2; ++min_wc) {
+    for (int f = 0; f < 4; ++f) {
+      std::vector<db::Polygon> out_m, out_g;
+      ep.merge (ab, out_m, min_wc, (f & 1) != 0, (f & 2) != 0);
+      ep.merge (abg, out_g, min_wc, (f & 1) != 0, (f & 2) != 0);
+      EXPECT_EQ (near_objects (out_g), near_objects (out_m));
+    }
+  }
+
+  //  edges vs. polygons (selects edges)
+  for (int f = 0; f < 4; ++f) {
+
+    bool outside = (f & 1) != 0;
+    bool include_touching = (f & 2) != 0;
+
+    std::vector<db::Edge> out_m, out_g;
+
+    for (int g = 0; g < 2; ++g) {
+
+      ep.clear ();
+      for (std::vector<db::Polygon>::const_iterator p = a.begin (); p != a.end (); ++p) {
+        ep.insert (*p, 0);
+      }
+      if (g) {
+        ep.insert (far_triangle (), 0);
+      }
+      for (std::vector<db::Polygon>::const_iterator p = b.begin (); p != b.end (); ++p) {
+        for (db::Polygon::polygon_edge_iterator e = p->begin_edge (); ! e.at_end (); ++e) {
+          ep.insert (*e, 1);
+        }
+      }
+
+      db::EdgeContainer ec (g ? out_g : out_m);
+      db::EdgePolygonOp op (outside, include_touching);
+      ep.process (ec, op);
+
+    }
+
+    EXPECT_EQ (near_objects (out_g), near_objects (out_m));
+
+  }
+}
+
+TEST(200_ManhattanVsGeneral)
+{
+  std::vector<db::Polygon> a, b;
+
+  //  coincident
+  a.push_back (db::Polygon (db::Box (0, 0, 100, 100)));
+  b.push_back (db::Polygon (db::Box (0, 0, 100, 100)));
+
+  //  touching along an edge and at a corner
+  a.push_back (db::Polygon (db::Box (200, 0, 300, 100)));
+  b.push_back (db::Polygon (db::Box (300, 0, 400, 100)));
+  b.push_back (db::Polygon (db::Box (300, 100, 400, 200)));
+
+  //  collinear overlap of edges
+  a.push_back (db::Polygon (db::Box (500, 0, 600, 100)));
+  b.push_back (db::Polygon (db::Box (550, 100, 650, 200)));
+  b.push_back (db::Polygon (db::Box (600, 20, 700, 80)));
+
+  //  overlap and a hole
+  db::Polygon frame (db::Box (800, 0, 1100, 300));
+  db::Point hole[] = { db::Point (900, 100), db::Point (900, 200), db::Point (1000, 200), db::Point (1000, 100) };
+  frame.insert_hole (&hole[0], &hole[sizeof(hole) / sizeof(hole[0])]);
+  a.push_back (frame);
+  b.push_back (db::Polygon (db::Box (950, 150, 1200, 250)));
+
+  //  self-overlapping input in one layer
+  a.push_back (db::Polygon (db::Box (1300, 0, 1400, 100)));
+  a.push_back (db::Polygon (db::Box (1350, 50, 1450, 150)));
+  a.push_back (db::Polygon (db::Box (1300, 0, 1400, 100)));
+
+  run_test_manhattan_vs_general (_this, a, b);
+
+  //  the same with different orientations, which changes the scanline order
+  for (int t = 1; t < 8; ++t) {
+    std::vector<db::Polygon> at, bt;
+    for (std::vector<db::Polygon>::const_iterator p = a.begin (); p != a.end (); ++p) {
+      at.push_back (p->transformed (db::Trans (t)));
+    }
+    for (std::vector<db::Polygon>::const_iterator p = b.begin (); p != b.end (); ++p) {
+      bt.push_back (p->transformed (db::Trans (t)));
+    }
+    run_test_manhattan_vs_general (_this, at, bt);
+  }
+}
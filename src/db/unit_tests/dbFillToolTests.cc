@@ -0,0 +1,144 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2020 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+
+#include "dbFillTool.h"
+#include "dbLayout.h"
+#include "dbRegion.h"
+#include "tlUnitTest.h"
+
+#include <set>
+
+static std::string fill_instances (const db::Layout &ly, const db::Cell &cell)
+{
+  std::set<std::string> insts;
+  for (db::Cell::const_iterator i = cell.begin (); ! i.at_end (); ++i) {
+    for (db::CellInstArray::iterator a = i->cell_inst ().begin (); ! a.at_end (); ++a) {
+      insts.insert (std::string (ly.cell_name (i->cell_index ())) + "@" + (*a).disp ().to_string ());
+    }
+  }
+
+  std::string res;
+  for (std::set<std::string>::const_iterator s = insts.begin (); s != insts.end (); ++s) {
+    if (! res.empty ()) {
+      res += ";";
+    }
+    res += *s;
+  }
+  return res;
+}
+
+TEST(1_SingleCell)
+{
+  db::Layout ly;
+  db::cell_index_type top = ly.add_cell ("TOP");
+  db::cell_index_type fc = ly.add_cell ("FC");
+
+  db::Region fr;
+  fr.insert (db::Box (0, 0, 10000, 10000));
+  fr.insert (db::Box (2500, 2500, 3000, 7500));
+
+  db::FillEngine engine;
+  engine.add_fill_cell (fc, db::Box (-500, -500, 500, 500));
+
+  engine.fill (&ly.cell (top), fr);
+  EXPECT_EQ (engine.instances (), size_t (100));
+  EXPECT_EQ (engine.arrays (), size_t (1));
+
+  std::string ref = fill_instances (ly, ly.cell (top));
+  EXPECT_EQ (ly.cell (top).cell_instances (), size_t (1));
+
+  //  tiled and multi-threaded fill delivers the same instances
+  db::cell_index_type top2 = ly.add_cell ("TOP2");
+  engine.set_tile_size (db::Vector (3000, 2500));
+  engine.set_threads (2);
+
+  engine.fill (&ly.cell (top2), fr);
+  EXPECT_EQ (engine.instances (), size_t (100));
+  EXPECT_EQ (engine.arrays () > size_t (1), true);
+  EXPECT_EQ (fill_instances (ly, ly.cell (top2)), ref);
+}
+
+TEST(2_Priority)
+{
+  db::Layout ly;
+  db::cell_index_type top = ly.add_cell ("TOP");
+  db::cell_index_type big = ly.add_cell ("BIG");
+  db::cell_index_type small = ly.add_cell ("SMALL");
+
+  db::Region fr;
+  fr.insert (db::Box (0, 0, 10000, 5500));
+
+  db::FillEngine engine;
+  engine.add_fill_cell (small, db::Box (0, 0, 200, 200), 0);
+  engine.add_fill_cell (big, db::Box (0, 0, 1000, 1000), 1);
+  engine.set_fill_margin (db::Vector (100, 100));
+
+  db::Region rem;
+  engine.fill (&ly.cell (top), fr, &rem);
+
+  //  50 big ones and a row of small ones above with the margin kept to the big ones and the tile border
+  EXPECT_EQ (engine.instances (), size_t (98));
+  EXPECT_EQ (engine.arrays (), size_t (2));
+
+  std::string insts = fill_instances (ly, ly.cell (top));
+  EXPECT_EQ (insts.find ("BIG@0,4000") != std::string::npos, true);
+  EXPECT_EQ (insts.find ("SMALL@200,5200") != std::string::npos, true);
+  EXPECT_EQ (insts.find ("SMALL@9600,5200") != std::string::npos, true);
+  EXPECT_EQ (insts.find ("SMALL@0,5200") != std::string::npos, false);
+
+  //  the remaining parts are the strips left and right of the small ones
+  EXPECT_EQ (rem.area (), db::Region::area_type (2 * 100 * 400));
+}
+
+TEST(3_Density)
+{
+  db::Layout ly;
+  db::cell_index_type top = ly.add_cell ("TOP");
+  db::cell_index_type fc = ly.add_cell ("FC");
+
+  db::Region fr;
+  fr.insert (db::Box (0, 0, 20000, 10000));
+
+  db::FillEngine engine;
+  engine.add_fill_cell (fc, db::Box (0, 0, 1000, 1000));
+  engine.set_tile_size (db::Vector (10000, 10000));
+  engine.set_density_target (0.5);
+
+  engine.fill (&ly.cell (top), fr);
+  EXPECT_EQ (engine.instances (), size_t (100));
+
+  //  existing shapes in the first window count against the target
+  db::Region existing;
+  existing.insert (db::Box (0, 0, 2000, 10000));
+  engine.set_density_reference (existing);
+
+  db::cell_index_type top2 = ly.add_cell ("TOP2");
+  engine.fill (&ly.cell (top2), fr);
+  EXPECT_EQ (engine.instances (), size_t (80));
+
+  //  the selection is spread over the window
+  std::string insts = fill_instances (ly, ly.cell (top2));
+  EXPECT_EQ (insts.find ("FC@0,0") != std::string::npos, true);
+  EXPECT_EQ (insts.find ("FC@10000,0") != std::string::npos, true);
+}
@@ -1488,3 +1488,140 @@ TEST(63)
 
   EXPECT_EQ (g.under_construction (), false);
 }
+
+static std::string q2s_rows (const db::Layout &g, const std::string &query, const std::vector<std::string> &props)
+{
+  db::LayoutQuery q (query);
+  db::LayoutQueryIterator iq (q, &g);
+  std::string res;
+  while (! iq.at_end ()) {
+    if (!res.empty ()) {
+      res += ";";
+    }
+    for (std::vector<std::string>::const_iterator p = props.begin (); p != props.end (); ++p) {
+      if (p != props.begin ()) {
+        res += "|";
+      }
+      tl::Variant v;
+      iq.get (*p, v);
+      res += v.to_string ();
+    }
+    ++iq;
+  }
+  return res;
+}
+
+static std::string q2s_prefetched (const db::Layout &g, const std::string &query, const std::vector<std::string> &props, unsigned int threads)
+{
+  db::LayoutQuery q (query);
+  db::LayoutQueryIterator iq (q, &g, props, threads);
+  std::string res;
+  while (! iq.at_end ()) {
+    if (!res.empty ()) {
+      res += ";";
+    }
+    for (std::vector<std::string>::const_iterator p = props.begin (); p != props.end (); ++p) {
+      if (p != props.begin ()) {
+        res += "|";
+      }
+      tl::Variant v;
+      iq.get (*p, v);
+      res += v.to_string ();
+    }
+    ++iq;
+  }
+  return res;
+}
+
+static std::string q2s_collect (const db::Layout &g, const std::string &query, const std::vector<std::string> &props, unsigned int threads)
+{
+  db::LayoutQuery q (query);
+  std::vector<tl::Variant> rows;
+  q.collect (g, props, rows, threads);
+  std::string res;
+  for (std::vector<tl::Variant>::const_iterator r = rows.begin (); r != rows.end (); ++r) {
+    if (!res.empty ()) {
+      res += ";";
+    }
+    for (tl::Variant::const_iterator v = r->begin (); v != r->end (); ++v) {
+      if (v != r->begin ()) {
+        res += "|";
+      }
+      res += v->to_string ();
+    }
+  }
+  return res;
+}
+
+//  Parallel execution
+TEST(64)
+{
+  db::Layout g;
+  g.insert_layer (0);
+  g.insert_layer (1);
+
+  db::Cell &top = g.cell (g.add_cell ("TOP"));
+
+  std::vector<db::cell_index_type> cells;
+  for (int i = 0; i < 40; ++i) {
+    db::Cell &c = g.cell (g.add_cell (("A" + tl::to_string (i)).c_str ()));
+    for (int j = 0; j <= i % 7; ++j) {
+      c.shapes (j % 2).insert (db::Box (0, 0, j + 1, i + 1));
+    }
+    if (! cells.empty ()) {
+      c.insert (db::CellInstArray (db::CellInst (cells.back ()), db::Trans (db::Vector (i, 0))));
+    }
+    top.insert (db::CellInstArray (db::CellInst (c.cell_index ()), db::Trans (db::Vector (0, i * 100))));
+    cells.push_back (c.cell_index ());
+  }
+
+  const db::Layout &cg = g;
+
+  const char *queries[] = {
+    "select cell_name+'#'+cell_index from *",
+    "*",
+    "TOP.*",
+    "instances of TOP.*",
+    "instances of ...*",
+    "boxes of * where shape.area > 10",
+    "shapes of instances of TOP..*",
+    "select cell_name from ..* sorted by cell_name",
+    "select cell_name from TOP"
+  };
+
+  std::vector<std::string> props;
+  props.push_back ("data");
+  props.push_back ("cell_name");
+  props.push_back ("parent_cell_name");
+  props.push_back ("trans");
+  props.push_back ("shape");
+  props.push_back ("does_not_exist");
+
+  for (size_t i = 0; i < sizeof (queries) / sizeof (queries [0]); ++i) {
+
+    std::string au = q2s_rows (cg, queries [i], props);
+    EXPECT_EQ (au.empty (), false);
+
+    EXPECT_EQ (q2s_collect (cg, queries [i], props, 0), au);
+    EXPECT_EQ (q2s_collect (cg, queries [i], props, 1), au);
+    EXPECT_EQ (q2s_collect (cg, queries [i], props, 3), au);
+    EXPECT_EQ (q2s_collect (cg, queries [i], props, 8), au);
+    EXPECT_EQ (q2s_prefetched (cg, queries [i], props, 4), au);
+
+  }
+
+  EXPECT_EQ (db::LayoutQuery ("select cell_name from *").can_run_parallel (), true);
+  EXPECT_EQ (db::LayoutQuery ("select cell_name from * sorted by cell_name").can_run_parallel (), false);
+  EXPECT_EQ (db::LayoutQuery ("delete cell *x").can_run_parallel (), false);
+  EXPECT_EQ (db::LayoutQuery ("with polygons from * do shape.box = shape.bbox").can_run_parallel (), false);
+
+  //  errors are reported from the worker threads
+  try {
+    q2s_collect (cg, "select cell.unknown_method from *", props, 4);
+    EXPECT_EQ (true, false);
+  } catch (tl::Exception &) {
+    //  .. expected ..
+  }
+
+  EXPECT_EQ (g.under_construction (), false);
+}
@@ -23,9 +23,11 @@
 #include "dbLayoutToNetlist.h"
 #include "dbLayoutToNetlistReader.h"
 #include "dbLayoutToNetlistWriter.h"
+#include "dbLayoutVsSchematic.h"
 #include "dbStream.h"
 #include "dbCommonReader.h"
 #include "dbNetlistDeviceExtractorClasses.h"
+#include "dbLayoutToNetlistBinaryFormat.h"
 #include "dbTestSupport.h"
 
 #include "tlUnitTest.h"
@@ -481,3 +483,59 @@ TEST(4_ReaderCombinedDevices)
   }
 }
 
+
+TEST(5_ReaderBinary)
+{
+  db::LayoutToNetlist l2n;
+
+  std::string in_path = tl::combine_path (tl::combine_path (tl::combine_path (tl::testsrc (), "testdata"), "algo"), "l2n_reader_in_p.txt");
+  tl::InputStream is_in (in_path);
+
+  db::LayoutToNetlistStandardReader reader (is_in);
+  reader.read (&l2n);
+
+  std::string bin_path = tmp_file ("tmp.l2n");
+  l2n.save (bin_path, false, true);
+
+  {
+    tl::InputStream is (bin_path);
+    EXPECT_EQ (db::l2n_binary_format::is_binary (is), true);
+    EXPECT_EQ (db::l2n_binary_format::first_comment (is), "#%l2n-klayout");
+  }
+
+  //  the binary representation is much more compact than the text one
+  std::string bin_data = tl::InputStream (bin_path).read_all ();
+  EXPECT_EQ (bin_data.size () * 2 < tl::InputStream (in_path).read_all ().size (), true);
+
+  std::auto_ptr<db::LayoutToNetlist> l2n2 (db::LayoutToNetlist::create_from_file (bin_path));
+  EXPECT_EQ (dynamic_cast<db::LayoutVsSchematic *> (l2n2.get ()) == 0, true);
+
+  //  verify against the input
+
+  std::string path = tmp_file ("tmp.txt");
+  l2n2->save (path, true);
+
+  compare_text_files (path, in_path);
+}
+
+TEST(6_ReaderBinaryLVS)
+{
+  db::LayoutVsSchematic lvs;
+
+  std::string in_path = tl::combine_path (tl::combine_path (tl::combine_path (tl::testsrc (), "testdata"), "algo"), "lvsdb_read_test.lvsdb");
+  lvs.load (in_path);
+
+  std::string path_au = tmp_file ("tmp_au.txt");
+  lvs.save (path_au, true);
+
+  std::string bin_path = tmp_file ("tmp.lvsdb");
+  lvs.save (bin_path, false, true);
+
+  std::auto_ptr<db::LayoutToNetlist> lvs2 (db::LayoutToNetlist::create_from_file (bin_path));
+  EXPECT_EQ (dynamic_cast<db::LayoutVsSchematic *> (lvs2.get ()) != 0, true);
+
+  std::string path = tmp_file ("tmp.txt");
+  dynamic_cast<db::LayoutVsSchematic *> (lvs2.get ())->save (path, true);
+
+  compare_text_files (path, path_au);
+}
@@ -487,3 +487,73 @@ TEST(13_NoGlobalNetsIfNotUsed)
   );
 }
 
+
+static std::string read_netlist_with_threads (const std::string &path, int threads)
+{
+  db::Netlist nl;
+
+  db::NetlistSpiceReader reader;
+  reader.set_num_threads (threads);
+
+  try {
+    tl::InputStream is (path);
+    reader.read (is, nl);
+  } catch (tl::Exception &ex) {
+    return ex.msg ();
+  }
+
+  return nl.to_string ();
+}
+
+TEST(14_MultiThreadedReaderGivesSameNetlist)
+{
+  for (int i = 1; i <= 13; ++i) {
+    std::string path = tl::combine_path (tl::combine_path (tl::combine_path (tl::testsrc (), "testdata"), "algo"), "nreader" + tl::to_string (i) + ".cir");
+    EXPECT_EQ (read_netlist_with_threads (path, 4), read_netlist_with_threads (path, 0));
+  }
+
+  //  a bigger netlist which needs several batches
+
+  std::string path = tmp_file ("tmp_nreader14.cir");
+
+  {
+    tl::OutputStream os (path);
+    os << "* generated\n";
+    os << ".global VDD VSS\n";
+    for (int c = 0; c < 200; ++c) {
+      os << "X" << c << " A" << c << " B" << c << " CELL" << (c + 1) % 200 << "\n";
+    }
+    for (int c = 0; c < 200; ++c) {
+      os << ".subckt CELL" << c << " A B\n";
+      for (int d = 0; d < 20; ++d) {
+        os << "M" << d << " A n" << d << " B VSS NMOS L=0.25u\n+ W=" << (d + 1) << "u\n";
+        os << "R" << d << " n" << d << " \\x41" << d << " " << d + 1 << "k\n";
+        os << "* comment\n";
+        os << "C" << d << " n" << d << " VDD 1.5f\n";
+      }
+      os << ".ends\n";
+    }
+  }
+
+  std::string nl_string = read_netlist_with_threads (path, 0);
+  EXPECT_EQ (nl_string.size () > 100000, true);
+  EXPECT_EQ (read_netlist_with_threads (path, 1), nl_string);
+  EXPECT_EQ (read_netlist_with_threads (path, 4), nl_string);
+
+  //  errors are reported at the same location
+
+  {
+    tl::OutputStream os (path);
+    for (int d = 0; d < 5000; ++d) {
+      os << "R" << d << " n" << d << " n" << d + 1 << " " << d + 1 << "k\n";
+    }
+    os << "M1 A B C D\n";
+    for (int d = 0; d < 5000; ++d) {
+      os << "R" << d << " n" << d << " n" << d + 1 << " " << d + 1 << "k\n";
+    }
+  }
+
+  nl_string = read_netlist_with_threads (path, 0);
+  EXPECT_EQ (tl::replaced (nl_string, path, "?"), "'M' element must have four nodes in ?, line 5001");
+  EXPECT_EQ (read_netlist_with_threads (path, 4), nl_string);
+}
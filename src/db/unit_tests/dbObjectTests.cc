@@ -22,6 +22,7 @@
 
 
 #include "dbObject.h"
+#include "dbLayout.h"
 #include "tlUnitTest.h"
 
 namespace {
@@ -313,3 +314,177 @@ TEST(4)
   EXPECT_EQ (BO::inst_count (), 0);
 }
 
+
+TEST(5)
+{
+  db::Manager *man = new db::Manager (true);
+  {
+    A a (man);
+
+    size_t mem_per_transaction = 0;
+    for (int i = 1; i <= 10; ++i) {
+      man->transaction ("add " + tl::to_string (i));
+      a.add (i);
+      a.add (i);
+      man->commit ();
+      if (i == 1) {
+        mem_per_transaction = man->memory_used ();
+      }
+    }
+
+    EXPECT_EQ (mem_per_transaction > 2 * sizeof (db::Op), true);
+    EXPECT_EQ (man->memory_used (), 10 * mem_per_transaction);
+    EXPECT_EQ (a.x, 110);
+    EXPECT_EQ (AO::inst_count (), 20);
+
+    //  the budget discards the oldest transactions
+    man->set_max_memory (3 * mem_per_transaction);
+    EXPECT_EQ (man->memory_used (), 3 * mem_per_transaction);
+    EXPECT_EQ (AO::inst_count (), 6);
+
+    man->undo ();
+    man->undo ();
+    EXPECT_EQ (a.x, 110 - 20 - 18);
+    EXPECT_EQ (man->available_undo ().second, "add 8");
+    man->undo ();
+    EXPECT_EQ (a.x, 110 - 20 - 18 - 16);
+    EXPECT_EQ (man->available_undo ().first, false);
+
+    man->redo ();
+    man->redo ();
+    man->redo ();
+    EXPECT_EQ (a.x, 110);
+
+    //  new transactions push out the old ones
+    man->transaction ("add 11");
+    a.add (11);
+    a.add (11);
+    man->commit ();
+    EXPECT_EQ (man->memory_used (), 3 * mem_per_transaction);
+    EXPECT_EQ (AO::inst_count (), 6);
+
+    //  the most recent transaction is always kept
+    man->set_max_memory (1);
+    EXPECT_EQ (man->memory_used (), mem_per_transaction);
+    EXPECT_EQ (man->available_undo ().second, "add 11");
+    man->undo ();
+    EXPECT_EQ (a.x, 110);
+    EXPECT_EQ (man->available_undo ().first, false);
+
+    //  redo transactions are erased by a new transaction
+    man->transaction ("add 12");
+    a.add (12);
+    man->commit ();
+    EXPECT_EQ (man->available_redo ().first, false);
+    EXPECT_EQ (AO::inst_count (), 1);
+    EXPECT_EQ (man->memory_used () < mem_per_transaction, true);
+
+    man->clear ();
+    EXPECT_EQ (man->memory_used (), size_t (0));
+  }
+
+  delete man;
+  EXPECT_EQ (AO::inst_count (), 0);
+}
+
+//  Memory limit with transactions which can be redone
+TEST(5a)
+{
+  db::Manager *man = new db::Manager (true);
+  {
+    A a (man);
+
+    size_t mem_per_transaction = 0;
+    for (int i = 1; i <= 10; ++i) {
+      man->transaction ("add " + tl::to_string (i));
+      a.add (i);
+      a.add (i);
+      man->commit ();
+      if (i == 1) {
+        mem_per_transaction = man->memory_used ();
+      }
+    }
+
+    for (int i = 0; i < 5; ++i) {
+      man->undo ();
+    }
+    EXPECT_EQ (a.x, 30);
+    EXPECT_EQ (man->memory_used (), 10 * mem_per_transaction);
+
+    //  the undo history is discarded down to the most recent transaction,
+    //  then the last transactions which can be redone
+    man->set_max_memory (3 * mem_per_transaction);
+    EXPECT_EQ (man->memory_used (), 3 * mem_per_transaction);
+    EXPECT_EQ (AO::inst_count (), 6);
+
+    EXPECT_EQ (man->available_undo ().second, "add 5");
+    EXPECT_EQ (man->available_redo ().second, "add 6");
+    man->redo ();
+    man->redo ();
+    EXPECT_EQ (a.x, 30 + 12 + 14);
+    EXPECT_EQ (man->available_redo ().first, false);
+
+    man->undo ();
+    man->undo ();
+    man->undo ();
+    EXPECT_EQ (a.x, 30 - 10);
+    EXPECT_EQ (man->available_undo ().first, false);
+
+    //  all transactions which can be redone may be discarded
+    man->set_max_memory (1);
+    EXPECT_EQ (man->memory_used (), size_t (0));
+    EXPECT_EQ (man->available_redo ().first, false);
+    EXPECT_EQ (AO::inst_count (), 0);
+
+    man->transaction ("add 11");
+    a.add (11);
+    man->commit ();
+    EXPECT_EQ (man->available_undo ().second, "add 11");
+    man->undo ();
+    EXPECT_EQ (a.x, 20);
+  }
+
+  delete man;
+  EXPECT_EQ (AO::inst_count (), 0);
+}
+
+//  Coalescing of instance operations
+TEST(6)
+{
+  db::Manager man (true);
+  db::Layout ly (&man);
+
+  db::cell_index_type top = ly.add_cell ("TOP");
+  db::cell_index_type a = ly.add_cell ("A");
+
+  man.transaction ("insert");
+  for (int i = 0; i < 1000; ++i) {
+    ly.cell (top).insert (db::CellInstArray (db::CellInst (a), db::Trans (db::Vector (i * 10, 0))));
+  }
+  man.commit ();
+
+  EXPECT_EQ (ly.cell (top).cell_instances (), size_t (1000));
+
+  //  a single op holds the instances, so the memory is roughly one instance array per instance
+  EXPECT_EQ (man.memory_used () < 1000 * (sizeof (db::CellInstArray) + 32), true);
+
+  man.undo ();
+  EXPECT_EQ (ly.cell (top).cell_instances (), size_t (0));
+  man.redo ();
+  EXPECT_EQ (ly.cell (top).cell_instances (), size_t (1000));
+
+  man.transaction ("delete");
+  while (! ly.cell (top).begin ().at_end ()) {
+    ly.cell (top).erase (*ly.cell (top).begin ());
+  }
+  man.commit ();
+
+  EXPECT_EQ (ly.cell (top).cell_instances (), size_t (0));
+  man.undo ();
+  EXPECT_EQ (ly.cell (top).cell_instances (), size_t (1000));
+  man.undo ();
+  EXPECT_EQ (ly.cell (top).cell_instances (), size_t (0));
+  man.redo ();
+  man.redo ();
+  EXPECT_EQ (ly.cell (top).cell_instances (), size_t (0));
+}
@@ -25,6 +25,9 @@
 #include "dbPCellHeader.h"
 #include "dbPCellDeclaration.h"
 #include "dbPCellVariant.h"
+#include "dbPCellCache.h"
+#include "dbLibrary.h"
+#include "dbLibraryManager.h"
 #include "dbWriter.h"
 #include "dbReader.h"
 #include "dbLayoutDiff.h"
@@ -32,6 +35,8 @@
 #include "tlStream.h"
 #include "tlUnitTest.h"
 
+#include <cmath>
+
 class PD 
   : public db::PCellDeclaration
 {
@@ -252,3 +257,402 @@ TEST(1)
   }
 }
 
+
+//  A PCell which can be produced in parallel (shapes only)
+class PDP
+  : public db::PCellDeclaration
+{
+  virtual std::vector<db::PCellLayerDeclaration> get_layer_declarations (const db::pcell_parameters_type &) const
+  {
+    std::vector<db::PCellLayerDeclaration> layers;
+
+    layers.push_back(db::PCellLayerDeclaration ());
+    layers.back ().layer = 1;
+    layers.back ().datatype = 0;
+
+    layers.push_back(db::PCellLayerDeclaration ());
+    layers.back ().layer = 2;
+    layers.back ().datatype = 0;
+
+    return layers;
+  }
+
+  virtual std::vector<db::PCellParameterDeclaration> get_parameter_declarations () const
+  {
+    std::vector<db::PCellParameterDeclaration> parameters;
+
+    parameters.push_back (db::PCellParameterDeclaration ("r"));
+    parameters.back ().set_type (db::PCellParameterDeclaration::t_double);
+    parameters.push_back (db::PCellParameterDeclaration ("n"));
+    parameters.back ().set_type (db::PCellParameterDeclaration::t_int);
+
+    return parameters;
+  }
+
+  virtual bool can_produce_in_parallel () const
+  {
+    return true;
+  }
+
+  virtual std::string get_display_name (const db::pcell_parameters_type &parameters) const
+  {
+    return "PDP(r=" + std::string (parameters[0].to_string ()) + ",n=" + std::string (parameters[1].to_string ()) + ")";
+  }
+
+  virtual void produce (const db::Layout &layout, const std::vector<unsigned int> &layer_ids, const db::pcell_parameters_type &parameters, db::Cell &cell) const
+  {
+    double r = parameters[0].to_double () / layout.dbu ();
+    int n = parameters[1].to_int ();
+    if (n < 3) {
+      throw tl::Exception ("n must be 3 or larger");
+    }
+
+    std::vector<db::Point> pts;
+    for (int i = 0; i < n; ++i) {
+      double a = M_PI * 2.0 * i / n;
+      pts.push_back (db::Point (db::coord_traits<db::Coord>::rounded (r * cos (a)), db::coord_traits<db::Coord>::rounded (r * sin (a))));
+    }
+
+    db::Polygon poly;
+    poly.assign_hull (pts.begin (), pts.end ());
+    cell.shapes (layer_ids[0]).insert (poly);
+    cell.shapes (layer_ids[1]).insert (db::Text (parameters[1].to_string (), db::Trans ()));
+  }
+};
+
+static void make_pdp_layout (db::Layout &layout)
+{
+  db::Cell &top = layout.cell (layout.add_cell ("TOP"));
+  db::pcell_id_type pd = layout.register_pcell ("PDP", new PDP ());
+  db::pcell_id_type pd_serial = layout.register_pcell ("PD", new PD ());
+
+  db::Cell &cell_a = layout.cell (layout.add_cell ("A"));
+  cell_a.shapes (layout.insert_layer (db::LayerProperties (16, 0))).insert (db::Box (0, 0, 200, 1000));
+
+  std::vector<tl::Variant> parameters;
+  parameters.push_back (tl::Variant ());
+  parameters.push_back (tl::Variant ());
+
+  for (int i = 0; i < 200; ++i) {
+
+    parameters[0] = 0.1 + 0.01 * i;
+    //  every 50th variant fails to produce
+    parameters[1] = (i % 50) == 49 ? 0 : 3 + i % 17;
+
+    db::cell_index_type ci = layout.get_pcell_variant (pd, parameters);
+    top.insert (db::CellInstArray (db::CellInst (ci), db::Trans (db::Vector (i * 1000, 0))));
+
+    if ((i % 20) == 0) {
+
+      //  a non-parallel PCell inbetween
+      std::vector<tl::Variant> p;
+      p.push_back (0.5 + 0.01 * i);
+      p.push_back (1.0);
+      p.push_back (long (0));
+
+      ci = layout.get_pcell_variant (pd_serial, p);
+      top.insert (db::CellInstArray (db::CellInst (ci), db::Trans (db::Vector (i * 1000, 5000))));
+
+    }
+
+  }
+}
+
+TEST(2)
+{
+  db::Layout layout_au;
+  make_pdp_layout (layout_au);
+
+  for (unsigned int threads = 0; threads < 4; threads += 3) {
+
+    db::Layout layout;
+    make_pdp_layout (layout);
+
+    //  wipe the variants so we can tell they are produced again
+    for (db::Layout::iterator c = layout.begin (); c != layout.end (); ++c) {
+      if (dynamic_cast<db::PCellVariant *> (c.operator-> ()) != 0) {
+        c->clear_shapes ();
+        c->clear_insts ();
+      }
+    }
+
+    layout.refresh_pcell_variants (threads);
+
+    EXPECT_EQ (db::compare_layouts (layout, layout_au, db::layout_diff::f_verbose, 0), true);
+
+    std::pair<bool, db::cell_index_type> cp = layout.cell_by_name ("PDP");
+    EXPECT_EQ (cp.first, true);
+    EXPECT_EQ (layout.display_name (cp.second), "PDP(r=0.1,n=3)");
+
+  }
+}
+
+//  A PCell which can be cached persistently
+class PDC
+  : public db::PCellDeclaration
+{
+public:
+  PDC (const std::string &version, bool with_instances = false)
+    : produced (0), m_version (version), m_with_instances (with_instances)
+  { }
+
+  virtual std::vector<db::PCellLayerDeclaration> get_layer_declarations (const db::pcell_parameters_type &) const
+  {
+    std::vector<db::PCellLayerDeclaration> layers;
+
+    layers.push_back(db::PCellLayerDeclaration ());
+    layers.back ().layer = 1;
+    layers.back ().datatype = 0;
+
+    layers.push_back(db::PCellLayerDeclaration ());
+    layers.back ().layer = 2;
+    layers.back ().datatype = 0;
+
+    return layers;
+  }
+
+  virtual std::vector<db::PCellParameterDeclaration> get_parameter_declarations () const
+  {
+    std::vector<db::PCellParameterDeclaration> parameters;
+
+    parameters.push_back (db::PCellParameterDeclaration ("w"));
+    parameters.back ().set_type (db::PCellParameterDeclaration::t_double);
+
+    return parameters;
+  }
+
+  virtual std::string cache_version () const
+  {
+    return m_version;
+  }
+
+  virtual std::string get_display_name (const db::pcell_parameters_type &parameters) const
+  {
+    return "PDC(w=" + std::string (parameters[0].to_string ()) + ")";
+  }
+
+  virtual void produce (const db::Layout &layout, const std::vector<unsigned int> &layer_ids, const db::pcell_parameters_type &parameters, db::Cell &cell) const
+  {
+    ++produced;
+
+    db::Coord w = db::coord_traits<db::Coord>::rounded (parameters[0].to_double () / layout.dbu ());
+
+    db::PropertiesRepository::properties_set ps;
+    ps.insert (std::make_pair (cell.layout ()->properties_repository ().prop_name_id (tl::Variant ("net")), tl::Variant (w)));
+    db::properties_id_type pid = cell.layout ()->properties_repository ().properties_id (ps);
+
+    cell.shapes (layer_ids[0]).insert (db::BoxWithProperties (db::Box (0, 0, w, 2 * w), pid));
+
+    db::Point pts[] = { db::Point (0, 0), db::Point (0, w), db::Point (w, w), db::Point (2 * w, -w) };
+    cell.shapes (layer_ids[0]).insert (db::Polygon (db::Box (-w, -w, 0, 0)));
+    cell.shapes (layer_ids[0]).insert (db::SimplePolygon (db::Box (-w, 0, 0, w)));
+    cell.shapes (layer_ids[1]).insert (db::Path (pts + 0, pts + 4, 10, 5, -5, false));
+    cell.shapes (layer_ids[1]).insert (db::Text ("T", db::Trans (3, true, db::Vector (w, -w)), 100, db::NoFont, db::HAlignCenter, db::VAlignTop));
+    cell.shapes (layer_ids[1]).insert (db::Edge (pts[1], pts[3]));
+
+    if (m_with_instances) {
+      const db::Cell &cell_a = layout.cell (layout.cell_by_name ("A").second);
+      cell.insert (db::CellInstArray (db::CellInst (cell_a.cell_index ()), db::Trans (1, db::Vector (w, 0))));
+    }
+  }
+
+  mutable int produced;
+
+private:
+  std::string m_version;
+  bool m_with_instances;
+};
+
+static void make_pdc_layout (db::Layout &layout, PDC *pdc, int n = 10, double dw = 0.0)
+{
+  layout.dbu (0.001);
+
+  db::Cell &top = layout.cell (layout.add_cell ("TOP"));
+  db::pcell_id_type pd = layout.register_pcell ("PDC", pdc);
+
+  db::Cell &cell_a = layout.cell (layout.add_cell ("A"));
+  cell_a.shapes (layout.insert_layer (db::LayerProperties (16, 0))).insert (db::Box (0, 0, 200, 1000));
+
+  std::vector<tl::Variant> parameters;
+  parameters.push_back (tl::Variant ());
+
+  for (int i = 0; i < n; ++i) {
+    parameters[0] = 0.5 + 0.1 * i + dw;
+    db::cell_index_type ci = layout.get_pcell_variant (pd, parameters);
+    top.insert (db::CellInstArray (db::CellInst (ci), db::Trans (db::Vector (i * 5000, 0))));
+  }
+}
+
+//  Only library PCells are cached: this library emulates one session of a library
+class PDCLibrary
+  : public db::Library
+{
+public:
+  PDCLibrary (const std::string &name, PDC *pdc, int n = 10, double dw = 0.0)
+  {
+    set_name (name);
+    db::LibraryManager::instance ().register_lib (this);
+    make_pdc_layout (layout (), pdc, n, dw);
+  }
+
+  void unregister ()
+  {
+    db::LibraryManager::instance ().delete_lib (this);
+  }
+};
+
+TEST(3)
+{
+  db::PCellCache &cache = db::PCellCache::instance ();
+  std::string saved_path = cache.path ();
+
+  cache.set_path (tmp_file ("pcell_cache"));
+  cache.clear ();
+
+  //  without caching
+  db::Layout layout_au;
+  {
+    cache.set_path (std::string ());
+    PDC *pdc = new PDC ("1");
+    make_pdc_layout (layout_au, pdc);
+    EXPECT_EQ (pdc->produced, 10);
+  }
+
+  cache.set_path (tmp_file ("pcell_cache"));
+
+  //  first session: populates the cache
+  {
+    PDC *pdc = new PDC ("1");
+    PDCLibrary *lib = new PDCLibrary ("PCC", pdc);
+    EXPECT_EQ (pdc->produced, 10);
+    EXPECT_EQ (cache.hits (), size_t (0));
+    EXPECT_EQ (db::compare_layouts (lib->layout (), layout_au, db::layout_diff::f_verbose, 0), true);
+    lib->unregister ();
+  }
+
+  //  second session: takes the layout from the cache
+  {
+    PDC *pdc = new PDC ("1");
+    PDCLibrary *lib = new PDCLibrary ("PCC", pdc);
+    EXPECT_EQ (pdc->produced, 0);
+    EXPECT_EQ (cache.hits (), size_t (10));
+    EXPECT_EQ (db::compare_layouts (lib->layout (), layout_au, db::layout_diff::f_verbose, 0), true);
+    EXPECT_EQ (lib->layout ().display_name (lib->layout ().cell_by_name ("PDC").second), "PDC(w=0.5)");
+    lib->unregister ();
+  }
+
+  //  a new version invalidates the cache entries
+  {
+    PDC *pdc = new PDC ("2");
+    PDCLibrary *lib = new PDCLibrary ("PCC", pdc);
+    EXPECT_EQ (pdc->produced, 10);
+    EXPECT_EQ (db::compare_layouts (lib->layout (), layout_au, db::layout_diff::f_verbose, 0), true);
+    lib->unregister ();
+  }
+
+  //  variants with instances are not cached as the instantiated cells cannot be restored
+  cache.clear ();
+  for (int i = 0; i < 2; ++i) {
+    PDC *pdc = new PDC ("1", true);
+    PDCLibrary *lib = new PDCLibrary ("PCC", pdc);
+    EXPECT_EQ (pdc->produced, 10);
+    lib->unregister ();
+  }
+  EXPECT_EQ (cache.size (), size_t (0));
+
+  cache.clear ();
+  cache.set_path (saved_path);
+}
+
+//  PCell cache: owner identity, exact keys and size limit
+TEST(4)
+{
+  db::PCellCache &cache = db::PCellCache::instance ();
+  std::string saved_path = cache.path ();
+  size_t saved_max_size = cache.max_size ();
+
+  cache.set_path (tmp_file ("pcell_cache"));
+  cache.set_max_size (0);
+  cache.clear ();
+  EXPECT_EQ (cache.size (), size_t (0));
+
+  //  PCells registered in a layout are not cached
+  for (int i = 0; i < 2; ++i) {
+    db::Layout layout;
+    PDC *pdc = new PDC ("1");
+    make_pdc_layout (layout, pdc);
+    EXPECT_EQ (pdc->produced, 10);
+  }
+  EXPECT_EQ (cache.size (), size_t (0));
+
+  {
+    PDC *pdc = new PDC ("1");
+    PDCLibrary *lib = new PDCLibrary ("PCC", pdc);
+    EXPECT_EQ (pdc->produced, 10);
+    lib->unregister ();
+  }
+
+  size_t size = cache.size ();
+  EXPECT_EQ (size > 0, true);
+
+  //  a PCell with the same name, but from a different library does not use these entries
+  {
+    PDC *pdc = new PDC ("1");
+    PDCLibrary *lib = new PDCLibrary ("PCC2", pdc);
+    EXPECT_EQ (pdc->produced, 10);
+    EXPECT_EQ (cache.hits (), size_t (0));
+    lib->unregister ();
+  }
+
+  EXPECT_EQ (cache.size () > size, true);
+
+  //  parameters differing beyond the precision of the string representation do not share entries
+  {
+    PDC *pdc = new PDC ("1");
+    PDCLibrary *lib = new PDCLibrary ("PCC", pdc, 10, 1e-13);
+    EXPECT_EQ (pdc->produced, 10);
+    EXPECT_EQ (cache.hits (), size_t (0));
+    lib->unregister ();
+  }
+
+  //  the size limit removes the least recently used entries
+  cache.clear ();
+
+  {
+    PDC *pdc = new PDC ("1");
+    PDCLibrary *lib = new PDCLibrary ("PCC", pdc);
+    EXPECT_EQ (pdc->produced, 10);
+    lib->unregister ();
+  }
+
+  //  uses the first three variants again
+  {
+    PDC *pdc = new PDC ("1");
+    PDCLibrary *lib = new PDCLibrary ("PCC", pdc, 3);
+    EXPECT_EQ (pdc->produced, 0);
+    lib->unregister ();
+  }
+
+  size = cache.size ();
+  cache.set_max_size (size / 2);
+  EXPECT_EQ (cache.size () <= size / 2 / 4 * 3, true);
+  EXPECT_EQ (cache.size () > 0, true);
+
+  {
+    PDC *pdc = new PDC ("1");
+    PDCLibrary *lib = new PDCLibrary ("PCC", pdc, 3);
+    EXPECT_EQ (pdc->produced, 0);
+    lib->unregister ();
+  }
+
+  {
+    PDC *pdc = new PDC ("1");
+    PDCLibrary *lib = new PDCLibrary ("PCC", pdc);
+    EXPECT_EQ (pdc->produced >= 7, true);
+    lib->unregister ();
+  }
+
+  cache.clear ();
+  cache.set_max_size (saved_max_size);
+  cache.set_path (saved_path);
+}
@@ -0,0 +1,110 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2020 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+#include "dbPackedCoordinates.h"
+#include "tlUnitTest.h"
+
+#include <vector>
+
+static void run_polygon_test (tl::TestBase *_this, bool wide)
+{
+  std::vector<db::Polygon> polygons;
+
+  polygons.push_back (db::Polygon (db::Box (0, 0, 100, 200)));
+
+  db::Polygon with_hole (db::Box (-1000, -1000, 1000, 1000));
+  db::Point hole[] = { db::Point (-100, -100), db::Point (-100, 100), db::Point (100, 100), db::Point (100, -100) };
+  with_hole.insert_hole (hole + 0, hole + sizeof (hole) / sizeof (hole[0]));
+  polygons.push_back (with_hole);
+
+  db::Point tri[] = { db::Point (0, 0), db::Point (0, 1000000000), db::Point (-1000000000, 0) };
+  db::Polygon triangle;
+  triangle.assign_hull (tri + 0, tri + sizeof (tri) / sizeof (tri[0]));
+  polygons.push_back (triangle);
+
+  db::PackedPolygonWriter writer (wide);
+  for (std::vector<db::Polygon>::const_iterator p = polygons.begin (); p != polygons.end (); ++p) {
+    writer.add (*p);
+  }
+
+  size_t w = wide ? 8 : 4;
+  EXPECT_EQ (writer.points ().size (), size_t (2 * (4 + 4 + 4 + 3)) * w);
+  EXPECT_EQ (writer.contours ().size (), size_t (4 + 1) * w);
+  EXPECT_EQ (writer.polygons ().size (), size_t (3 + 1) * w);
+
+  db::PackedPolygonReader reader (writer.points (), writer.contours (), writer.polygons (), wide);
+  EXPECT_EQ (reader.size (), size_t (3));
+
+  db::Polygon poly;
+  for (size_t i = 0; i < reader.size (); ++i) {
+    reader.get (i, poly);
+    EXPECT_EQ (poly.to_string (), polygons [i].to_string ());
+  }
+}
+
+TEST(1_Polygons)
+{
+  run_polygon_test (_this, false);
+  run_polygon_test (_this, true);
+}
+
+TEST(2_Edges)
+{
+  std::vector<char> data;
+  db::pack_edge (db::Edge (0, 0, 100, 200), data, false);
+  db::pack_edge (db::Edge (-10, 20, -30, 40), data, false);
+  EXPECT_EQ (data.size (), size_t (8 * 4));
+
+  std::vector<db::Edge> edges;
+  db::unpack_edges (data, false, edges);
+  EXPECT_EQ (edges.size (), size_t (2));
+  EXPECT_EQ (edges [0].to_string (), "(0,0;100,200)");
+  EXPECT_EQ (edges [1].to_string (), "(-10,20;-30,40)");
+
+  data.pop_back ();
+  try {
+    db::unpack_edges (data, false, edges);
+    EXPECT_EQ (true, false);
+  } catch (tl::Exception &) {
+    //  expected: truncated array
+  }
+}
+
+TEST(3_Invalid)
+{
+  db::PackedPolygonWriter writer (false);
+  writer.add (db::Polygon (db::Box (0, 0, 100, 200)));
+
+  //  contour offsets pointing beyond the points array
+  std::vector<char> points = writer.points ();
+  points.resize (points.size () - 8);
+
+  db::PackedPolygonReader reader (points, writer.contours (), writer.polygons (), false);
+  db::Polygon poly;
+  try {
+    reader.get (0, poly);
+    EXPECT_EQ (true, false);
+  } catch (tl::Exception &) {
+    //  expected
+  }
+}
@@ -259,3 +259,93 @@ TEST(6)
   EXPECT_EQ (pid2, size_t (2));
 }
 
+
+TEST(7)
+{
+  db::PropertiesRepository rep;
+
+  db::property_names_id_type net = rep.prop_name_id (tl::Variant ("NET"));
+  db::property_names_id_type w = rep.prop_name_id (tl::Variant (17));
+
+  //  many sets: ids are assigned in sequence and found again after the table grew
+  for (int i = 0; i < 10000; ++i) {
+    db::PropertiesRepository::properties_set set;
+    set.insert (std::make_pair (net, tl::Variant ("N" + tl::to_string (i))));
+    set.insert (std::make_pair (w, tl::Variant (i % 7)));
+    EXPECT_EQ (rep.properties_id (set), db::properties_id_type (i + 1));
+  }
+
+  bool all_found = true;
+  for (int i = 9999; i >= 0; --i) {
+    db::PropertiesRepository::properties_set set;
+    set.insert (std::make_pair (net, tl::Variant ("N" + tl::to_string (i))));
+    //  numerical values compare equal across types, so the hash must be compatible
+    set.insert (std::make_pair (w, tl::Variant (double (i % 7))));
+    if (rep.properties_id (set) != db::properties_id_type (i + 1)) {
+      all_found = false;
+    }
+  }
+  EXPECT_EQ (all_found, true);
+  EXPECT_EQ (rep.end_id (), db::properties_id_type (10001));
+  EXPECT_EQ (rep.is_valid_properties_id (10000), true);
+  EXPECT_EQ (rep.is_valid_properties_id (10001), false);
+  EXPECT_EQ (rep.properties (10001).empty (), true);
+
+  EXPECT_EQ (rep.properties_ids_by_name_value (std::make_pair (net, tl::Variant ("N42"))).size (), size_t (1));
+  EXPECT_EQ (rep.properties_ids_by_name_value (std::make_pair (w, tl::Variant (3l))).size (), size_t (1429));
+
+  //  change a set: the old set is no longer found, the new one is
+  db::PropertiesRepository::properties_set set_new;
+  set_new.insert (std::make_pair (net, tl::Variant ("NEW")));
+  rep.change_properties (43, set_new);
+
+  EXPECT_EQ (rep.properties_ids_by_name_value (std::make_pair (net, tl::Variant ("N42"))).size (), size_t (0));
+  EXPECT_EQ (rep.properties_ids_by_name_value (std::make_pair (net, tl::Variant ("NEW"))).size (), size_t (1));
+  EXPECT_EQ (rep.properties_id (set_new), db::properties_id_type (43));
+
+  db::PropertiesRepository::properties_set set_old;
+  set_old.insert (std::make_pair (net, tl::Variant ("N42")));
+  set_old.insert (std::make_pair (w, tl::Variant (0)));
+  EXPECT_EQ (rep.properties_id (set_old), db::properties_id_type (10001));
+
+  //  neighbors of the changed entry are still found
+  all_found = true;
+  for (int i = 0; i < 10000; ++i) {
+    if (i == 42) {
+      continue;
+    }
+    db::PropertiesRepository::properties_set set;
+    set.insert (std::make_pair (net, tl::Variant ("N" + tl::to_string (i))));
+    set.insert (std::make_pair (w, tl::Variant (i % 7)));
+    if (rep.properties_id (set) != db::properties_id_type (i + 1)) {
+      all_found = false;
+    }
+  }
+  EXPECT_EQ (all_found, true);
+
+  //  modification through the non-const iterator
+  for (db::PropertiesRepository::non_const_iterator p = rep.begin_non_const (); p != rep.end_non_const (); ++p) {
+    if (p->first == 1) {
+      p->second.clear ();
+      p->second.insert (std::make_pair (net, tl::Variant ("MODIFIED")));
+    }
+  }
+
+  EXPECT_EQ (rep.properties_ids_by_name_value (std::make_pair (net, tl::Variant ("N0"))).size (), size_t (0));
+  EXPECT_EQ (rep.properties_ids_by_name_value (std::make_pair (net, tl::Variant ("MODIFIED"))).size (), size_t (1));
+
+  db::PropertiesRepository::properties_set set_mod;
+  set_mod.insert (std::make_pair (net, tl::Variant ("MODIFIED")));
+  EXPECT_EQ (rep.properties_id (set_mod), db::properties_id_type (1));
+
+  //  copy and translate
+  db::PropertiesRepository rep2;
+  rep2.prop_name_id (tl::Variant ("X"));
+  EXPECT_EQ (rep2.translate (rep, 43), db::properties_id_type (1));
+  EXPECT_EQ (rep2.prop_name (rep2.properties (1).begin ()->first).to_string (), std::string ("NET"));
+
+  rep2 = rep;
+  EXPECT_EQ (rep2.properties_id (set_new), db::properties_id_type (43));
+  EXPECT_EQ (rep2.properties_id (set_mod), db::properties_id_type (1));
+  EXPECT_EQ (rep2.end_id (), db::properties_id_type (10002));
+}
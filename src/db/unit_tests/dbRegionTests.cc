@@ -1573,6 +1573,44 @@ TEST(34d)
   EXPECT_EQ (r.pull_interacting (db::Texts (db::Text ("abc", db::Trans (db::Vector (-190, -190))))).to_string (), "");
 }
 
+TEST(35_MultiThreadedEdgeInteraction)
+{
+  //  big enough for the multi-threaded box scanner
+  db::Region r;
+  for (int i = 0; i < 120; ++i) {
+    for (int j = 0; j < 100; ++j) {
+      r.insert (db::Box (i * 100, j * 100, i * 100 + 80, j * 100 + 80));
+    }
+  }
+
+  db::Edges e;
+  for (int i = 0; i < 200; ++i) {
+    db::Coord x = (i * 7919) % 12000;
+    db::Coord y = (i * 104729) % 10000;
+    e.insert (db::Edge (x, y, x + 250, y + (i % 5) * 90));
+  }
+
+  unsigned int threads = db::box_scanner_threads ();
+
+  db::set_box_scanner_threads (0);
+  db::Region serial = r.selected_interacting (e);
+  db::Region serial_inv = r.selected_not_interacting (e);
+
+  db::set_box_scanner_threads (4);
+  db::Region mt = r.selected_interacting (e);
+  db::Region mt_inv = r.selected_not_interacting (e);
+
+  db::set_box_scanner_threads (threads);
+
+  EXPECT_EQ (serial.size () > 0, true);
+  EXPECT_EQ (serial.size () + serial_inv.size (), size_t (12000));
+
+  EXPECT_EQ (mt.size (), serial.size ());
+  EXPECT_EQ ((mt ^ serial).empty (), true);
+  EXPECT_EQ (mt_inv.size (), serial_inv.size ());
+  EXPECT_EQ ((mt_inv ^ serial_inv).empty (), true);
+}
+
 TEST(100_Processors)
 {
   db::Region r;
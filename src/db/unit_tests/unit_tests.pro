@@ -49,6 +49,7 @@ SOURCES = \
     dbPolygonTests.cc \
     dbPointTests.cc \
     dbPCellsTests.cc \
+    dbPackedCoordinatesTests.cc \
     dbPathTests.cc \
     dbObjectTests.cc \
     dbMatrixTests.cc \
@@ -58,6 +59,7 @@ SOURCES = \
     dbLayoutTests.cc \
     dbLayerMappingTests.cc \
     dbLayerTests.cc \
+    dbFillToolTests.cc \
     dbExpressionTests.cc \
     dbEdgesToContoursTests.cc \
     dbEdgesTests.cc \
@@ -48,6 +48,9 @@ module DRC
       @deep = false
       @netter = nil
       @netter_data = nil
+      @profile = false
+      @profile_file = nil
+      @profile_steps = []
 
       @verbose = false
 
@@ -389,6 +392,39 @@ module DRC
       end
     end
     
+    # %DRC%
+    # @name profile
+    # @brief Enables or disables profiling
+    # @synopsis profile
+    # @synopsis profile(filename)
+    # @synopsis profile(false)
+    # In profiling mode, every operation records the source line it was
+    # called from, the elapsed wall and CPU time, the number of input and
+    # output shapes, the process memory before and after the operation and
+    # the growth of the process' peak memory. In addition, the memory used by
+    # the deep shape store, the netlist extractor and the report database
+    # is recorded by category. The peak memory of transient data such as the
+    # caches of the hierarchical processor is recorded as well. Device and
+    # netlist extraction and the netlist compare are recorded as operations too.
+    #
+    # When the script has finished, a table listing the source lines sorted
+    # by wall time is printed to the log. The full profile with the individual
+    # operations and the per-line summary is written in JSON format
+    # to the given file or to the log if no file name is given.
+    # Collecting the statistics takes some time after each operation,
+    # so profiling is intended for analysis runs only.
+    
+    def profile(arg = true)
+      if arg.is_a?(String)
+        @profile_file = arg
+        @profile = true
+      else
+        @profile_file = nil
+        @profile = arg ? true : false
+      end
+      RBA::DeepShapeStore::track_peak_memory = @profile
+    end
+    
     # %DRC%
     # @name log_file
     # @brief Specify the log file where to send to log to
@@ -1398,7 +1434,7 @@ CODE
     
     def src_line
       cc = caller.find do |c|
-        c !~ /drc.lym:/ && c !~ /_drc_\w+\.rb:/ && c !~ /\(eval\)/
+        c !~ /drc.lym:/ && c !~ /lvs.lym:/ && c !~ /_drc_\w+\.rb:/ && c !~ /_lvs_\w+\.rb:/ && c !~ /\(eval\)/
       end
       if cc =~ /(.*)\s*:\s*(\d+)\s*:\s*in.*$/
         return File::basename($1) + ":" + $2
@@ -1407,7 +1443,7 @@ CODE
       end
     end
     
-    def run_timed(desc, obj)
+    def run_timed(desc, obj, inputs = [])
 
       info(desc)
 
@@ -1416,6 +1452,20 @@ CODE
         obj.enable_progress(desc)
       end
       
+      # the profiler's bookkeeping (source line, input counts, memory probes) is done
+      # before the timer starts, so it does not count into the step's time
+      if @profile
+        GC.start # collect garbage first, so "memory_before" does not include it
+        profile = {
+          "step" => desc,
+          "source" => src_line,
+          "input_count" => _profile_count([ obj ] + inputs),
+          "memory_before" => RBA::Timer::memory_size,
+          "peak_memory_before" => RBA::Timer::peak_memory_size
+        }
+        RBA::DeepShapeStore::reset_peak_mem_statistics
+      end
+
       t = RBA::Timer::new
       t.start
       GC.start # force a garbage collection before the operation to free unused memory
@@ -1424,6 +1474,8 @@ CODE
 
       info("Elapsed: #{'%.3f'%(t.sys+t.user)}s")
 
+      @profile && _profile_step(profile, t, res)
+
       # disable progress
       if obj.is_a?(RBA::Region) || obj.is_a?(RBA::Edges) || obj.is_a?(RBA::EdgePairs)
         obj.disable_progress
@@ -1433,8 +1485,109 @@ CODE
 
     end
     
+    def _profile_count(objs)
+      n = nil
+      objs.each do |o|
+        if o.is_a?(Array)
+          c = _profile_count(o)
+        elsif o.is_a?(Hash)
+          c = _profile_count(o.values)
+        elsif o.is_a?(DRCLayer)
+          c = _profile_count([ o.data ])
+        elsif o.is_a?(RBA::Region) || o.is_a?(RBA::Edges) || o.is_a?(RBA::EdgePairs) || o.is_a?(RBA::Texts)
+          c = o.count
+        else
+          c = nil
+        end
+        c && n = (n || 0) + c
+      end
+      n
+    end
+
+    def _profile_step(profile, timer, res)
+
+      mem = {}
+      @dss && mem["deep_shape_store"] = @dss.mem_statistics
+      l2n = @netter && @netter._l2n_data
+      l2n && mem["netlist_extractor"] = l2n.mem_statistics
+      @output_rdb && mem["report_database"] = @output_rdb.mem_statistics
+      peaks = RBA::DeepShapeStore::peak_mem_statistics
+      peaks.empty? || mem["peak"] = peaks
+
+      profile["wall"] = timer.wall
+      profile["cpu"] = timer.user + timer.sys
+      profile["output_count"] = _profile_count([ res ])
+      profile["memory_after"] = RBA::Timer::memory_size
+      profile["memory_delta"] = profile["memory_after"] - profile["memory_before"]
+      profile["peak_memory_delta"] = RBA::Timer::peak_memory_size - profile["peak_memory_before"]
+      profile["memory"] = mem
+
+      @profile_steps << profile
+
+    end
+
+    def _profile_lines
+
+      per_line = {}
+      @profile_steps.each do |step|
+        line = (per_line[step["source"]] ||= { 
+          "source" => step["source"], "calls" => 0, "wall" => 0.0, "cpu" => 0.0, 
+          "input_count" => 0, "output_count" => 0, "memory_delta" => 0, "peak_memory_delta" => 0
+        })
+        line["calls"] += 1
+        [ "wall", "cpu", "input_count", "output_count", "memory_delta", "peak_memory_delta" ].each do |k|
+          line[k] += (step[k] || 0)
+        end
+      end
+
+      per_line.values.sort { |a,b| b["wall"] <=> a["wall"] }
+
+    end
+
+    def _to_json(obj, indent = "")
+      ni = indent + "  "
+      if obj.is_a?(Hash)
+        obj.empty? && (return "{}")
+        "{\n" + obj.collect { |k,v| ni + _to_json(k.to_s) + ": " + _to_json(v, ni) }.join(",\n") + "\n" + indent + "}"
+      elsif obj.is_a?(Array)
+        obj.empty? && (return "[]")
+        "[\n" + obj.collect { |v| ni + _to_json(v, ni) }.join(",\n") + "\n" + indent + "]"
+      elsif obj.is_a?(String)
+        "\"" + obj.gsub(/[\\"\x00-\x1f]/) { |c| c == "\\" || c == "\"" ? "\\" + c : "\\u%04x" % c.ord } + "\""
+      elsif obj.is_a?(Float)
+        "%.6g" % obj
+      elsif obj == nil
+        "null"
+      else
+        obj.to_s
+      end
+    end
+
+    def _write_profile
+
+      lines = _profile_lines
+
+      log("Profile (sorted by wall time):")
+      log("%10s %10s %6s %12s %12s %10s %10s  %s" % [ "Wall [s]", "CPU [s]", "Calls", "Input", "Output", "Mem [M]", "Peak [M]", "Source" ])
+      lines.each do |l|
+        log("%10.3f %10.3f %6d %12d %12d %10.1f %10.1f  %s" % [ l["wall"], l["cpu"], l["calls"], l["input_count"], l["output_count"], 
+                                                                 l["memory_delta"] / (1024.0 * 1024.0), l["peak_memory_delta"] / (1024.0 * 1024.0), l["source"] ])
+      end
+
+      json = _to_json({ "lines" => lines, "steps" => @profile_steps }) + "\n"
+
+      if @profile_file
+        profile_file = _make_path(@profile_file)
+        info("Writing profile: #{profile_file} ..")
+        File.open(profile_file, "w") { |f| f.write(json) }
+      else
+        log(json)
+      end
+
+    end
+    
     def _cmd(obj, method, *args)
-      run_timed("\"#{method}\" in: #{src_line}", obj) do
+      run_timed("\"#{method}\" in: #{src_line}", obj, args) do
         obj.send(method, *args)
       end
     end
@@ -1464,8 +1617,9 @@ CODE
         end
         av = args.size.times.collect { |i| "a#{i}" }.join(", ")
         tp.queue("_output(res, self.#{method}(#{av}))")
-        run_timed("\"#{method}\" in: #{src_line}", obj) do
+        run_timed("\"#{method}\" in: #{src_line}", obj, args) do
           tp.execute("Tiled \"#{method}\" in: #{src_line}")
+          res
         end
         
       else
@@ -1475,7 +1629,7 @@ CODE
         end
 
         res = nil
-        run_timed("\"#{method}\" in: #{src_line}", obj) do
+        run_timed("\"#{method}\" in: #{src_line}", obj, args) do
           res = obj.send(method, *args)
         end
 
@@ -1534,13 +1688,13 @@ CODE
     end
     
     def _rcmd(obj, method, *args)
-      run_timed("\"#{method}\" in: #{src_line}", obj) do
+      run_timed("\"#{method}\" in: #{src_line}", obj, args) do
         RBA::Region::new(obj.send(method, *args))
       end
     end
     
     def _vcmd(obj, method, *args)
-      run_timed("\"#{method}\" in: #{src_line}", obj) do
+      run_timed("\"#{method}\" in: #{src_line}", obj, args) do
         obj.send(method, *args)
       end
     end
@@ -1653,6 +1807,11 @@ CODE
 
         end
 
+        # write the profile if requested
+        if final && @profile
+          _write_profile
+        end
+
         # give derived classes a change to perform their actions
         _before_cleanup
       
@@ -1690,6 +1849,13 @@ CODE
         @netter = nil
         @netter_data = nil
         
+        if final && @profile
+          @profile = false
+          @profile_file = nil
+          @profile_steps = []
+          RBA::DeepShapeStore::track_peak_memory = false
+        end
+
         if final && @log_file
           @log_file.close
           @log_file = nil
@@ -25,6 +25,8 @@
 #include "dbTestSupport.h"
 #include "dbNetlist.h"
 #include "dbNetlistSpiceReader.h"
+#include "dbRegion.h"
+#include "dbRecursiveShapeIterator.h"
 #include "lymMacro.h"
 #include "tlFileUtils.h"
 
@@ -755,3 +757,93 @@ TEST(16_issue570)
 
   db::compare_layouts (_this, layout, au, db::NoNormalization);
 }
+
+//  Gets the "lines" entry of the profile for the given source line
+static std::string profile_line (const std::string &json, const std::string &source)
+{
+  //  the "lines" section comes before the "steps" section, so the first match is the line entry
+  size_t p = json.find ("\"source\": \"" + source + "\"");
+  if (p == std::string::npos) {
+    return std::string ();
+  }
+  return std::string (json, p, json.find ("}", p) - p);
+}
+
+//  Gets a value from a profile entry
+static std::string profile_value (const std::string &entry, const std::string &key)
+{
+  std::string k = "\"" + key + "\": ";
+  size_t p = entry.find (k);
+  if (p == std::string::npos) {
+    return std::string ();
+  }
+  p += k.size ();
+  return std::string (entry, p, entry.find_first_of (",\n", p) - p);
+}
+
+//  Profile mode
+TEST(17_Profile)
+{
+  std::string rs = tl::testsrc ();
+  rs += "/testdata/drc/drcSimpleTests_17.drc";
+
+  std::string input = tl::testsrc ();
+  input += "/testdata/drc/drcSimpleTests_16.gds";
+
+  std::string output = this->tmp_file ("tmp.gds");
+  std::string profile = this->tmp_file ("profile.json");
+
+  {
+    //  Set some variables
+    lym::Macro config;
+    config.set_text (tl::sprintf (
+        "$drc_test_source = '%s'\n"
+        "$drc_test_target = '%s'\n"
+        "$drc_test_profile = '%s'\n"
+      , input, output, profile)
+    );
+    config.set_interpreter (lym::Macro::Ruby);
+    EXPECT_EQ (config.run (), 0);
+  }
+
+  lym::Macro drc;
+  drc.load_from (rs);
+  EXPECT_EQ (drc.run (), 0);
+
+  db::Layout layout;
+
+  {
+    tl::InputStream stream (input);
+    db::Reader reader (stream);
+    reader.read (layout);
+  }
+
+  db::Cell &top = layout.cell (*layout.begin_top_down ());
+  size_t n2 = db::Region (db::RecursiveShapeIterator (layout, top, layout.get_layer (db::LayerProperties (2, 0)))).size ();
+  size_t n3 = db::Region (db::RecursiveShapeIterator (layout, top, layout.get_layer (db::LayerProperties (3, 0)))).size ();
+
+  std::string json;
+
+  {
+    tl::InputStream stream (profile);
+    tl::TextInputStream text (stream);
+    json = text.read_all ();
+  }
+
+  EXPECT_EQ (json.find ("\"lines\": [") != std::string::npos, true);
+  EXPECT_EQ (json.find ("\"steps\": [") != std::string::npos, true);
+
+  //  the join is attributed to deck line 8
+  std::string join = profile_line (json, "drcSimpleTests_17.drc:8");
+  EXPECT_EQ (profile_value (join, "calls"), "1");
+  EXPECT_EQ (profile_value (join, "input_count"), tl::to_string (n2 + n3));
+  EXPECT_EQ (profile_value (join, "output_count"), tl::to_string (n2 + n3));
+
+  //  both "sized" calls from deck line 9 are accumulated into one line entry
+  std::string sized = profile_line (json, "drcSimpleTests_17.drc:9");
+  EXPECT_EQ (profile_value (sized, "calls"), "2");
+  EXPECT_EQ (profile_value (sized, "input_count"), tl::to_string (2 * n2));
+
+  //  the individual steps are listed as well
+  EXPECT_EQ (json.find ("\"step\": \"\\\"sized\\\" in: drcSimpleTests_17.drc:9\"") != std::string::npos, true);
+}
@@ -171,6 +171,19 @@ Class<tl::Timer> decl_Timer ("tl", "Timer",
   ) +
   gsi::method ("stop", &tl::Timer::stop, 
     "@brief Stops the timer\n"
+  ) +
+  gsi::method ("memory_size", &tl::Timer::memory_size,
+    "@brief Gets the current virtual memory size of the process in bytes\n"
+    "Returns 0 if this information is not available on the platform.\n"
+    "\n"
+    "This method has been introduced in version 0.27."
+  ) +
+  gsi::method ("peak_memory_size", &tl::Timer::peak_memory_size,
+    "@brief Gets the peak resident memory size of the process in bytes\n"
+    "This value is the high-water mark of the resident memory and never decreases. "
+    "Returns 0 if this information is not available on the platform.\n"
+    "\n"
+    "This method has been introduced in version 0.27."
   ),
   "@brief A timer (stop watch)\n"
   "\n"
@@ -676,6 +676,17 @@ public:
    */
   virtual void set (const char *c_str, size_t s, tl::Heap &heap) = 0;
 
+  /**
+   *  @brief Returns true, if the string is a byte array rather than a UTF8 string
+   *
+   *  Byte arrays are delivered as "bytes" objects in Python. This allows passing
+   *  binary data such as packed coordinate arrays.
+   */
+  virtual bool is_binary () const
+  {
+    return false;
+  }
+
   /**
    *  @brief copy_to implementation
    */
@@ -986,6 +997,83 @@ private:
   std::string m_s;
 };
 
+/**
+ *  @brief Specialization for std::vector<char>
+ *
+ *  std::vector<char> is bound to a byte array string.
+ */
+template <>
+class GSI_PUBLIC StringAdaptorImpl<std::vector<char> >
+  : public StringAdaptor
+{
+public:
+  StringAdaptorImpl (std::vector<char> *s)
+    : mp_s (s), m_is_const (false)
+  {
+    //  .. nothing yet ..
+  }
+
+  StringAdaptorImpl (const std::vector<char> *s)
+    : mp_s (const_cast<std::vector<char> *> (s)), m_is_const (true)
+  {
+    //  .. nothing yet ..
+  }
+
+  StringAdaptorImpl (const std::vector<char> &s)
+    : m_is_const (false), m_s (s)
+  {
+    mp_s = &m_s;
+  }
+
+  StringAdaptorImpl ()
+    : m_is_const (false)
+  {
+    mp_s = &m_s;
+  }
+
+  virtual ~StringAdaptorImpl ()
+  {
+    //  .. nothing yet ..
+  }
+
+  virtual size_t size () const
+  {
+    return mp_s->size ();
+  }
+
+  virtual const char *c_str () const
+  {
+    return mp_s->empty () ? "" : &mp_s->front ();
+  }
+
+  virtual void set (const char *c_str, size_t s, tl::Heap &)
+  {
+    if (! m_is_const) {
+      mp_s->assign (c_str, c_str + s);
+    }
+  }
+
+  virtual bool is_binary () const
+  {
+    return true;
+  }
+
+  virtual void copy_to (AdaptorBase *target, tl::Heap &heap) const
+  {
+    StringAdaptorImpl<std::vector<char> > *s = dynamic_cast<StringAdaptorImpl<std::vector<char> > *>(target);
+    if (s) {
+      *s->mp_s = *mp_s;
+    } else {
+      StringAdaptor::copy_to (target, heap);
+    }
+  }
+
+private:
+  std::vector<char> *mp_s;
+  bool m_is_const;
+  std::vector<char> m_s;
+};
+
 /**
  *  @brief Specialization for const unsigned char *
  */
@@ -352,6 +352,7 @@ struct type_traits<void>
   static BasicType code () { return T_void; }
   static const ClassBase *cls_decl () { return 0; }
   static bool is_iter () { return false; }
+  static bool is_binary () { return false; }
   static size_t serial_size () { return 0; }
 };
 
@@ -404,6 +405,20 @@ struct generic_type_traits
   static BasicType code () { return TC; }
   static const ClassBase *cls_decl () { return 0; }
   static bool is_iter () { return false; }
+  static bool is_binary () { return false; }
+};
+
+/**
+ *  @brief Type traits for byte array strings (std::vector<char>)
+ *
+ *  These are strings, but script bindings may accept raw binary data
+ *  (e.g. objects supporting the Python buffer protocol) for them.
+ */
+template <class T>
+struct binary_string_type_traits
+  : generic_type_traits<T, StringAdaptor, T_string>
+{
+  static bool is_binary () { return true; }
 };
 
 template <> struct type_traits<bool>                        : generic_type_traits<bool_tag, bool, T_bool> { };
@@ -424,6 +439,7 @@ template <> struct type_traits<__int128>                    : generic_type_trait
 template <> struct type_traits<double>                      : generic_type_traits<double_tag, double, T_double> { };
 template <> struct type_traits<float>                       : generic_type_traits<float_tag, float, T_float> { };
 template <> struct type_traits<std::string>                 : generic_type_traits<string_tag, StringAdaptor, T_string> { };
+template <> struct type_traits<std::vector<char> >          : binary_string_type_traits<string_tag> { };
 #if defined(HAVE_QT)
 template <> struct type_traits<QString>                     : generic_type_traits<string_tag, StringAdaptor, T_string> { };
 template <> struct type_traits<QStringRef>                  : generic_type_traits<string_tag, StringAdaptor, T_string> { };
@@ -456,6 +472,7 @@ template <> struct type_traits<const __int128 &>            : generic_type_trait
 template <> struct type_traits<const double &>              : generic_type_traits<double_cref_tag, double, T_double> { };
 template <> struct type_traits<const float &>               : generic_type_traits<float_cref_tag, float, T_float> { };
 template <> struct type_traits<const std::string &>         : generic_type_traits<string_cref_tag, StringAdaptor, T_string> { };
+template <> struct type_traits<const std::vector<char> &>  : binary_string_type_traits<string_cref_tag> { };
 #if defined(HAVE_QT)
 template <> struct type_traits<const QString &>             : generic_type_traits<string_cref_tag, StringAdaptor, T_string> { };
 template <> struct type_traits<const QStringRef &>          : generic_type_traits<string_cref_tag, StringAdaptor, T_string> { };
@@ -485,6 +502,7 @@ template <> struct type_traits<__int128 &>                  : generic_type_trait
 template <> struct type_traits<double &>                    : generic_type_traits<double_ref_tag, double, T_double> { };
 template <> struct type_traits<float &>                     : generic_type_traits<float_ref_tag, float, T_float> { };
 template <> struct type_traits<std::string &>               : generic_type_traits<string_ref_tag, StringAdaptor, T_string> { };
+template <> struct type_traits<std::vector<char> &>        : binary_string_type_traits<string_ref_tag> { };
 #if defined(HAVE_QT)
 template <> struct type_traits<QString &>                   : generic_type_traits<string_ref_tag, StringAdaptor, T_string> { };
 template <> struct type_traits<QStringRef &>                : generic_type_traits<string_ref_tag, StringAdaptor, T_string> { };
@@ -515,6 +533,7 @@ template <> struct type_traits<const __int128 *>            : generic_type_trait
 template <> struct type_traits<const double *>              : generic_type_traits<double_cptr_tag, double, T_double> { };
 template <> struct type_traits<const float *>               : generic_type_traits<float_cptr_tag, float, T_float> { };
 template <> struct type_traits<const std::string *>         : generic_type_traits<string_cptr_tag, StringAdaptor, T_string> { };
+template <> struct type_traits<const std::vector<char> *>  : binary_string_type_traits<string_cptr_tag> { };
 #if defined(HAVE_QT)
 template <> struct type_traits<const QString *>             : generic_type_traits<string_cptr_tag, StringAdaptor, T_string> { };
 template <> struct type_traits<const QStringRef *>          : generic_type_traits<string_cptr_tag, StringAdaptor, T_string> { };
@@ -545,6 +564,7 @@ template <> struct type_traits<__int128 *>                  : generic_type_trait
 template <> struct type_traits<double *>                    : generic_type_traits<double_ptr_tag, double, T_double> { };
 template <> struct type_traits<float *>                     : generic_type_traits<float_ptr_tag, float, T_float> { };
 template <> struct type_traits<std::string *>               : generic_type_traits<string_ptr_tag, StringAdaptor, T_string> { };
+template <> struct type_traits<std::vector<char> *>        : binary_string_type_traits<string_ptr_tag> { };
 #if defined(HAVE_QT)
 template <> struct type_traits<QString *>                   : generic_type_traits<string_ptr_tag, StringAdaptor, T_string> { };
 template <> struct type_traits<QStringRef *>                : generic_type_traits<string_ptr_tag, StringAdaptor, T_string> { };
@@ -1558,6 +1578,7 @@ public:
 
     m_type        = type_traits<X>::code ();
     m_is_iter     = type_traits<X>::is_iter ();
+    m_is_binary   = type_traits<X>::is_binary ();
     mp_cls        = type_traits<X>::cls_decl ();
 
     m_pass_obj    = compute_pass_obj<arg_default_return_value_preference, X>::value ();
@@ -1602,6 +1623,7 @@ public:
 
     m_type        = type_traits<X>::code ();
     m_is_iter     = type_traits<X>::is_iter ();
+    m_is_binary   = type_traits<X>::is_binary ();
     mp_cls        = type_traits<X>::cls_decl ();
 
     m_pass_obj    = compute_pass_obj<Transfer, X>::value ();
@@ -1810,6 +1832,22 @@ public:
     m_is_iter = b;
   }
 
+  /**
+   *  @brief Returns a value indicating whether the type is a byte array string (std::vector<char>)
+   */
+  bool is_binary () const
+  {
+    return m_is_binary;
+  }
+
+  /**
+   *  @brief Sets a value indicating whether the type is a byte array string
+   */
+  void set_is_binary (bool b) 
+  {
+    m_is_binary = b;
+  }
+
   /**
    *  @brief Returns the size (in bytes) on the call stack
    */
@@ -1859,6 +1897,7 @@ private:
   bool m_is_cref : 1;
   bool m_is_cptr : 1;
   bool m_is_iter : 1;
+  bool m_is_binary : 1;
   bool m_owns_spec : 1;
   bool m_pass_obj : 1;
   bool m_prefer_copy : 1;
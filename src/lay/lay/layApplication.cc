@@ -63,6 +63,7 @@
 #include "tlHttpStream.h"
 #include "tlArch.h"
 #include "tlFileUtils.h"
+#include "tlTrace.h"
 
 #include <QIcon>
 #include <QDir>
@@ -448,6 +449,10 @@ ApplicationBase::parse_cmd (int &argc, char **argv)
 
       m_write_config_file = false;
 
+    } else if (a == "-tr" && (i + 1) < argc) {
+
+      tl::Tracer::start (args [++i]);
+
     } else if (a == "-z") {
 
       m_no_gui = true;
@@ -906,6 +911,9 @@ ApplicationBase::start_recording ()
 void
 ApplicationBase::shutdown ()
 {
+  //  writes the trace if enabled with -tr or KLAYOUT_TRACE
+  tl::Tracer::stop ();
+
   if (mp_ruby_interpreter) {
     delete mp_ruby_interpreter;
     mp_ruby_interpreter = 0;
@@ -966,6 +974,7 @@ ApplicationBase::usage ()
   r += tl::to_string (QObject::tr ("  -s                  Load files into same view")) + "\n";
   r += tl::to_string (QObject::tr ("  -t                  Don't update the configuration file on exit")) + "\n";
   r += tl::to_string (QObject::tr ("  -nt                 Update the configuration file on exit (default, overrides previous -t option)")) + "\n";
+  r += tl::to_string (QObject::tr ("  -tr <file name>     Record a Chrome trace of timers, progress and worker tasks into the given file")) + "\n";
   r += tl::to_string (QObject::tr ("  -u <file name>      Restore session from given file")) + "\n";
   r += tl::to_string (QObject::tr ("  -v                  Print program version and exit")) + "\n";
   r += tl::to_string (QObject::tr ("  -wd <name>=<value>  Define a variable within expressions")) + "\n";
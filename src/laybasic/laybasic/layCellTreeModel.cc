@@ -28,6 +28,7 @@
 #include "dbPCellVariant.h"
 #include "dbLibraryProxy.h"
 #include "dbLibrary.h"
+#include "tlThreadedWorkers.h"
 
 #include <QTreeView>
 #include <QPalette>
@@ -44,13 +45,15 @@ namespace lay {
 
 struct cmp_cell_tree_items_f 
 {
-  cmp_cell_tree_items_f (CellTreeModel::Sorting s)
-    : m_sorting (s)
+  cmp_cell_tree_items_f (CellTreeModel::Sorting s, const std::vector<size_t> *cell_ranks = 0)
+    : m_sorting (s), mp_cell_ranks (cell_ranks)
   { }
 
   bool operator() (const CellTreeItem *a, const CellTreeItem *b)
   {
-    if (m_sorting == CellTreeModel::ByArea) {
+    if (mp_cell_ranks && ! a->is_pcell () && ! b->is_pcell () && a->cell_or_pcell_index () < mp_cell_ranks->size () && b->cell_or_pcell_index () < mp_cell_ranks->size ()) {
+      return (*mp_cell_ranks) [a->cell_or_pcell_index ()] < (*mp_cell_ranks) [b->cell_or_pcell_index ()];
+    } else if (m_sorting == CellTreeModel::ByArea) {
       if (a->by_area_equal_than (b)) {
         return a->by_name_less_than (b);
       } else {
@@ -69,6 +72,101 @@ struct cmp_cell_tree_items_f
 
 private:
   CellTreeModel::Sorting m_sorting;
+  const std::vector<size_t> *mp_cell_ranks;
+};
+
+// --------------------------------------------------------------------
+//  A compare functor for cell indexes using the cell's name and area
+
+struct cmp_cell_indexes_f
+{
+  cmp_cell_indexes_f (const db::Layout *layout, CellTreeModel::Sorting s, const std::vector<std::string> *names = 0, const std::vector<size_t> *cell_ranks = 0)
+    : mp_layout (layout), m_sorting (s), mp_names (names), mp_cell_ranks (cell_ranks)
+  { }
+
+  bool operator() (db::cell_index_type a, db::cell_index_type b) const
+  {
+    if (mp_cell_ranks) {
+      //  cells created after the ranks have been computed are put at the end
+      bool ra = a < mp_cell_ranks->size (), rb = b < mp_cell_ranks->size ();
+      if (ra && rb) {
+        return (*mp_cell_ranks) [a] < (*mp_cell_ranks) [b];
+      } else if (ra != rb) {
+        return ra;
+      }
+    }
+
+    if (m_sorting != CellTreeModel::ByName) {
+      db::Box::area_type aa = mp_layout->cell (a).bbox ().area ();
+      db::Box::area_type ab = mp_layout->cell (b).bbox ().area ();
+      if (aa != ab) {
+        return (m_sorting == CellTreeModel::ByArea) == (aa < ab);
+      }
+    }
+
+    if (mp_names) {
+      int c = (*mp_names) [a].compare ((*mp_names) [b]);
+      if (c != 0) {
+        return c < 0;
+      }
+    } else {
+      std::string na = mp_layout->cell (a).get_display_name ();
+      std::string nb = mp_layout->cell (b).get_display_name ();
+      if (na != nb) {
+        return na < nb;
+      }
+    }
+
+    return a < b;
+  }
+
+private:
+  const db::Layout *mp_layout;
+  CellTreeModel::Sorting m_sorting;
+  const std::vector<std::string> *mp_names;
+  const std::vector<size_t> *mp_cell_ranks;
+};
+
+// --------------------------------------------------------------------
+//  A compare functor for the top level keys (PCell flag, cell or PCell index)
+
+struct cmp_toplevel_keys_f
+{
+  cmp_toplevel_keys_f (const db::Layout *layout, CellTreeModel::Sorting s, const std::vector<std::string> *names, const std::vector<size_t> *cell_ranks)
+    : mp_layout (layout), m_sorting (s), mp_names (names), mp_cell_ranks (cell_ranks)
+  { }
+
+  bool operator() (const std::pair<bool, size_t> &a, const std::pair<bool, size_t> &b) const
+  {
+    if (! a.first && ! b.first) {
+      return (*mp_cell_ranks) [a.second] < (*mp_cell_ranks) [b.second];
+    } else if (a.first != b.first && m_sorting != CellTreeModel::ByName) {
+      //  PCells come first when sorting by area
+      return a.first;
+    } else {
+      int c = name (a).compare (name (b));
+      if (c != 0) {
+        return c < 0;
+      } else {
+        return a.first > b.first || (a.first == b.first && a.second < b.second);
+      }
+    }
+  }
+
+private:
+  const db::Layout *mp_layout;
+  CellTreeModel::Sorting m_sorting;
+  const std::vector<std::string> *mp_names;
+  const std::vector<size_t> *mp_cell_ranks;
+
+  const std::string &name (const std::pair<bool, size_t> &k) const
+  {
+    if (k.first) {
+      return mp_layout->pcell_header (k.second)->get_name ();
+    } else {
+      return (*mp_names) [k.second];
+    }
+  }
 };
 
 // --------------------------------------------------------------------
@@ -82,11 +180,55 @@ struct cmp_cell_tree_item_vs_name_f
   }
 };
 
+// --------------------------------------------------------------------
+//  The name filter task and worker
+//
+//  The filter works on the snapshot of the display names only and
+//  does not access the layout, hence it can run in worker threads.
+
+class CellNameFilterTask
+  : public tl::Task
+{
+public:
+  CellNameFilterTask (const tl::GlobPattern &pattern, const std::vector<std::string> *names, const db::cell_index_type *from, const db::cell_index_type *to, std::vector<char> *matches)
+    : m_pattern (pattern), mp_names (names), mp_from (from), mp_to (to), mp_matches (matches)
+  { }
+
+  void filter ()
+  {
+    for (const db::cell_index_type *c = mp_from; c != mp_to; ++c) {
+      (*mp_matches) [*c] = m_pattern.match ((*mp_names) [*c]);
+    }
+  }
+
+private:
+  tl::GlobPattern m_pattern;
+  const std::vector<std::string> *mp_names;
+  const db::cell_index_type *mp_from, *mp_to;
+  std::vector<char> *mp_matches;
+};
+
+class CellNameFilterWorker
+  : public tl::Worker
+{
+public:
+  CellNameFilterWorker ()
+    : tl::Worker ()
+  { }
+
+  virtual void perform_task (tl::Task *task)
+  {
+    CellNameFilterTask *ft = dynamic_cast<CellNameFilterTask *> (task);
+    tl_assert (ft != 0);
+    ft->filter ();
+  }
+};
+
 // --------------------------------------------------------------------
 //  CellTreeItem implementation
 
-CellTreeItem::CellTreeItem (const db::Layout *layout, bool is_pcell, size_t cell_or_pcell_index, bool flat, CellTreeModel::Sorting s)
-  : mp_layout (layout), mp_parent (0), m_sorting (s), m_is_pcell (is_pcell), m_index (0), m_children (), m_cell_or_pcell_index (cell_or_pcell_index)
+CellTreeItem::CellTreeItem (const db::Layout *layout, bool is_pcell, size_t cell_or_pcell_index, bool flat, CellTreeModel::Sorting s, const std::vector<size_t> *cell_ranks)
+  : mp_layout (layout), mp_parent (0), m_sorting (s), m_is_pcell (is_pcell), m_index (0), m_children (), m_cell_or_pcell_index (cell_or_pcell_index), mp_cell_ranks (cell_ranks)
 {
   if (! flat && ! is_pcell) {
     m_child_count = int (mp_layout->cell (cell_or_pcell_index).child_cells ());
@@ -127,26 +269,55 @@ CellTreeItem::children () const
   return m_child_count;
 }
 
-CellTreeItem *
-CellTreeItem::child (int index) 
+void
+CellTreeItem::build_child_cells ()
 {
-  if (! m_is_pcell && int (m_children.size ()) <= index) {
+  //  create the sorted list of child cells - the items are created on request
 
-    //  create a list of child sub-item
+  const db::Cell *cell = & mp_layout->cell (cell_or_pcell_index ());
 
-    const db::Cell *cell = & mp_layout->cell (cell_or_pcell_index ());
+  m_child_cells.clear ();
+  m_child_cells.reserve (m_child_count);
+  for (db::Cell::child_cell_iterator child = cell->begin_child_cells (); ! child.at_end (); ++child) {
+    m_child_cells.push_back (*child);
+  }
 
-    m_children.reserve (m_child_count);
+  std::sort (m_child_cells.begin (), m_child_cells.end (), cmp_cell_indexes_f (mp_layout, m_sorting, 0, mp_cell_ranks));
 
-    for (db::Cell::child_cell_iterator child = cell->begin_child_cells (); ! child.at_end (); ++child) {
-      add_child (new CellTreeItem (mp_layout, false, *child, false, m_sorting));
-    }
+  m_child_count = int (m_child_cells.size ());
+  m_children.resize (m_child_cells.size (), 0);
+}
+
+CellTreeItem *
+CellTreeItem::child (int index) 
+{
+  if (! m_is_pcell && int (m_children.size ()) < m_child_count) {
+    build_child_cells ();
+  }
+
+  CellTreeItem *c = m_children [index];
+  if (! c) {
+    c = new CellTreeItem (mp_layout, false, m_child_cells [index], false, m_sorting, mp_cell_ranks);
+    c->mp_parent = this;
+    c->set_index (index);
+    m_children [index] = c;
+  }
 
-    finish_children ();
+  return c;
+}
 
+db::cell_index_type
+CellTreeItem::child_cell_index (int index)
+{
+  if (! m_is_pcell && int (m_children.size ()) < m_child_count) {
+    build_child_cells ();
   }
 
-  return m_children [index];
+  if (m_children [index]) {
+    return m_children [index]->cell_or_pcell_index ();
+  } else {
+    return m_child_cells [index];
+  }
 }
 
 void
@@ -164,7 +335,7 @@ CellTreeItem::add_child (CellTreeItem *item)
 void
 CellTreeItem::finish_children ()
 {
-  std::sort (m_children.begin (), m_children.end (), cmp_cell_tree_items_f (m_sorting));
+  std::sort (m_children.begin (), m_children.end (), cmp_cell_tree_items_f (m_sorting, mp_cell_ranks));
 
   for (size_t i = 0; i < m_children.size (); ++i) {
     m_children [i]->set_index (i);
@@ -266,11 +437,11 @@ CellTreeModel::CellTreeModel (QWidget *parent, lay::LayoutView *view, int cv_ind
     mp_parent (parent), 
     mp_view (view), 
     m_cv_index (cv_index),
-    mp_base (base)
+    mp_base (base),
+    m_filter_glob (false),
+    m_filter_case_sensitive (false),
+    m_filter_valid (false)
 {
-  mp_view->cell_visibility_changed_event.add (this, &CellTreeModel::signal_data_changed);
-  mp_view->cellview_changed_event.add (this, &CellTreeModel::signal_data_changed_with_int);
-
   m_flat = ((flags & Flat) != 0) && ((flags & TopCells) == 0);
   m_pad = ((flags & NoPadding) == 0);
 
@@ -278,6 +449,8 @@ CellTreeModel::CellTreeModel (QWidget *parent, lay::LayoutView *view, int cv_ind
   mp_library = 0;
   tl_assert (! mp_layout->under_construction () && ! (mp_layout->manager () && mp_layout->manager ()->transacting ()));
 
+  attach_events ();
+
   build_top_level ();
 
   m_current_index = m_selected_indexes.begin ();
@@ -290,7 +463,10 @@ CellTreeModel::CellTreeModel (QWidget *parent, db::Layout *layout, unsigned int
     mp_parent (parent), 
     mp_view (0), 
     m_cv_index (-1),
-    mp_base (base)
+    mp_base (base),
+    m_filter_glob (false),
+    m_filter_case_sensitive (false),
+    m_filter_valid (false)
 {
   m_flat = ((flags & Flat) != 0) && ((flags & TopCells) == 0);
   m_pad = ((flags & NoPadding) == 0);
@@ -299,6 +475,8 @@ CellTreeModel::CellTreeModel (QWidget *parent, db::Layout *layout, unsigned int
   mp_library = 0;
   tl_assert (! mp_layout->under_construction () && ! (mp_layout->manager () && mp_layout->manager ()->transacting ()));
 
+  attach_events ();
+
   build_top_level ();
 
   m_current_index = m_selected_indexes.begin ();
@@ -311,7 +489,10 @@ CellTreeModel::CellTreeModel (QWidget *parent, db::Library *library, unsigned in
     mp_parent (parent),
     mp_view (0),
     m_cv_index (-1),
-    mp_base (base)
+    mp_base (base),
+    m_filter_glob (false),
+    m_filter_case_sensitive (false),
+    m_filter_valid (false)
 {
   m_flat = ((flags & Flat) != 0) && ((flags & TopCells) == 0);
   m_pad = ((flags & NoPadding) == 0);
@@ -320,6 +501,8 @@ CellTreeModel::CellTreeModel (QWidget *parent, db::Library *library, unsigned in
   mp_library = library;
   tl_assert (! mp_layout->under_construction () && ! (mp_layout->manager () && mp_layout->manager ()->transacting ()));
 
+  attach_events ();
+
   build_top_level ();
 
   m_current_index = m_selected_indexes.begin ();
@@ -365,19 +548,15 @@ CellTreeModel::do_configure (db::Layout *layout, db::Library *library, lay::Layo
   std::vector<lay::CellTreeItem *> old_toplevel_items;
   old_toplevel_items.swap (m_toplevel);
 
-  if (view != mp_view) {
+  if (view != mp_view || layout != mp_layout) {
 
-    if (mp_view) {
-      mp_view->cell_visibility_changed_event.remove (this, &CellTreeModel::signal_data_changed);
-      mp_view->cellview_changed_event.remove (this, &CellTreeModel::signal_data_changed_with_int);
-    }
+    //  the previous layout may be gone already, so we cannot detach from its events individually
+    detach_from_all_events ();
 
     mp_view = view;
+    mp_layout = layout;
 
-    if (mp_view) {
-      mp_view->cell_visibility_changed_event.add (this, &CellTreeModel::signal_data_changed);
-      mp_view->cellview_changed_event.add (this, &CellTreeModel::signal_data_changed_with_int);
-    }
+    attach_events ();
 
   }
 
@@ -433,15 +612,16 @@ CellTreeModel::do_configure (db::Layout *layout, db::Library *library, lay::Layo
           if ((! ci->first && ! layout->is_valid_cell_index (ci->second)) || (ci->first && ! layout->pcell_declaration (ci->second))) {
             //  can't translate this index
           } else if (parent == 0) {
-            for (int i = 0; i < int (m_toplevel.size ()) && !new_parent; ++i) {
-              if (m_toplevel [i]->cell_or_pcell_index () == ci->second && m_toplevel [i]->is_pcell () == ci->first) {
-                new_parent = m_toplevel [i];
+            for (int i = 0; i < int (m_toplevel_keys.size ()) && !new_parent; ++i) {
+              if (m_toplevel_keys [i].second == ci->second && m_toplevel_keys [i].first == ci->first) {
+                new_parent = toplevel_item_at (i);
                 row = i;
               }
             }
-          } else {
+          } else if (! ci->first) {
+            //  NOTE: child items are always cells, so we don't need to create the items for comparison
             for (int i = 0; i < parent->children () && !new_parent; ++i) {
-              if (parent->child (i)->cell_or_pcell_index () == ci->second && parent->child (i)->is_pcell () == ci->first) {
+              if (parent->child_cell_index (i) == ci->second) {
                 new_parent = parent->child (i);
                 row = i;
               }
@@ -488,6 +668,28 @@ CellTreeModel::signal_data_changed ()
   emit layoutChanged ();
 }
 
+void
+CellTreeModel::attach_events ()
+{
+  if (mp_view) {
+    mp_view->cell_visibility_changed_event.add (this, &CellTreeModel::signal_data_changed);
+    mp_view->cellview_changed_event.add (this, &CellTreeModel::signal_data_changed_with_int);
+  }
+
+  mp_layout->cell_name_changed_event.add (this, &CellTreeModel::cell_names_changed);
+}
+
+void
+CellTreeModel::cell_names_changed ()
+{
+  //  the sort keys and the name filter use the snapshot of the cell names - while the layout is
+  //  under construction (e.g. readers renaming cells), the model is reconfigured later anyway
+  if (! mp_layout->under_construction ()) {
+    build_sort_keys ();
+    signal_data_changed ();
+  }
+}
+
 void 
 CellTreeModel::clear_top_level ()
 {
@@ -495,20 +697,58 @@ CellTreeModel::clear_top_level ()
     delete *c;
   }
   m_toplevel.clear ();
+  m_toplevel_keys.clear ();
+}
+
+void
+CellTreeModel::build_sort_keys ()
+{
+  //  Takes a snapshot of the display names and computes the rank of each cell in the
+  //  sort order. Sorting the items then only requires comparing the ranks.
+
+  db::cell_index_type n = mp_layout->cells ();
+
+  m_cell_names.clear ();
+  m_cell_names.resize (n);
+  m_cell_ranks.clear ();
+  m_cell_ranks.resize (n, 0);
+
+  std::vector<db::cell_index_type> order;
+  order.reserve (n);
+
+  for (db::cell_index_type ci = 0; ci < n; ++ci) {
+    if (mp_layout->is_valid_cell_index (ci)) {
+      m_cell_names [ci] = mp_layout->cell (ci).get_display_name ();
+      order.push_back (ci);
+    }
+  }
+
+  std::sort (order.begin (), order.end (), cmp_cell_indexes_f (mp_layout, m_sorting, &m_cell_names));
+
+  for (size_t i = 0; i < order.size (); ++i) {
+    m_cell_ranks [order [i]] = i;
+  }
+
+  //  the name filter works on the names snapshot
+  m_filter_valid = false;
 }
 
 void 
 CellTreeModel::build_top_level ()
 {
+  m_toplevel.clear ();
+  m_toplevel_keys.clear ();
+
+  build_sort_keys ();
+
   if ((m_flags & Children) != 0) {
 
     m_flat = true; //  no "hierarchical children" yet.
 
     if (mp_base) {
-      m_toplevel.reserve (mp_base->child_cells ());
+      m_toplevel_keys.reserve (mp_base->child_cells ());
       for (db::Cell::child_cell_iterator child = mp_base->begin_child_cells (); ! child.at_end (); ++child) {
-        CellTreeItem *item = new CellTreeItem (mp_layout, false, *child, true, m_sorting);
-        m_toplevel.push_back (item);
+        m_toplevel_keys.push_back (std::make_pair (false, size_t (*child)));
       }
     }
 
@@ -517,29 +757,26 @@ CellTreeModel::build_top_level ()
     m_flat = true; //  no "hierarchical parents" yet.
 
     if (mp_base) {
-      m_toplevel.reserve (mp_base->parent_cells ());
+      m_toplevel_keys.reserve (mp_base->parent_cells ());
       for (db::Cell::parent_cell_iterator parent = mp_base->begin_parent_cells (); parent != mp_base->end_parent_cells (); ++parent) {
-        CellTreeItem *item = new CellTreeItem (mp_layout, false, *parent, true, m_sorting);
-        m_toplevel.push_back (item);
+        m_toplevel_keys.push_back (std::make_pair (false, size_t (*parent)));
       }
     }
 
   } else {
 
     if (m_flat) {
-      m_toplevel.reserve (mp_layout->cells ());
+      m_toplevel_keys.reserve (mp_layout->cells ());
     }
 
     db::Layout::top_down_const_iterator top = mp_layout->begin_top_down ();
     while (top != mp_layout->end_top_down ()) {
 
       if (m_flat) {
-        CellTreeItem *item = new CellTreeItem (mp_layout, false, *top, true, m_sorting);
-        m_toplevel.push_back (item);
+        m_toplevel_keys.push_back (std::make_pair (false, size_t (*top)));
       } else if (mp_layout->cell (*top).is_top ()) {
         if ((m_flags & BasicCells) == 0 || ! mp_layout->cell (*top).is_proxy ()) {
-          CellTreeItem *item = new CellTreeItem (mp_layout, false, *top, (m_flags & TopCells) != 0, m_sorting);
-          m_toplevel.push_back (item);
+          m_toplevel_keys.push_back (std::make_pair (false, size_t (*top)));
         }
       } else {
         break;
@@ -550,39 +787,51 @@ CellTreeModel::build_top_level ()
     }
 
     if ((m_flags & BasicCells) != 0) {
-
       for (db::Layout::pcell_iterator pc = mp_layout->begin_pcells (); pc != mp_layout->end_pcells (); ++pc) {
+        m_toplevel_keys.push_back (std::make_pair (true, size_t (pc->second)));
+      }
+    }
 
-        CellTreeItem *item = new CellTreeItem (mp_layout, true, pc->second, true, m_sorting);
-        m_toplevel.push_back (item);
+  }
 
-        if ((m_flags & WithVariants) != 0) {
+  std::sort (m_toplevel_keys.begin (), m_toplevel_keys.end (), cmp_toplevel_keys_f (mp_layout, m_sorting, &m_cell_names, &m_cell_ranks));
 
-          const db::PCellHeader *pcell_header = mp_layout->pcell_header (pc->second);
-          for (db::PCellHeader::variant_iterator v = pcell_header->begin (); v != pcell_header->end (); ++v) {
-            if (mp_library && mp_library->is_retired (v->second->cell_index ())) {
-              //  skip retired cells - this means we won't show variants which are just kept
-              //  as shadow variants for the transactions.
-            } else {
-              item->add_child (new CellTreeItem (mp_layout, false, v->second->cell_index (), true, m_sorting));
-            }
-          }
+  //  the items are created on demand
+  m_toplevel.resize (m_toplevel_keys.size (), 0);
+}
+
+CellTreeItem *
+CellTreeModel::toplevel_item_at (int row) const
+{
+  CellTreeItem *item = m_toplevel [row];
+  if (item) {
+    return item;
+  }
 
-          item->finish_children ();
+  const std::pair<bool, size_t> &key = m_toplevel_keys [row];
 
-        }
+  bool flat = m_flat || (m_flags & TopCells) != 0 || key.first;
+  item = new CellTreeItem (mp_layout, key.first, key.second, flat, m_sorting, &m_cell_ranks);
+  item->set_index (size_t (row));
+  m_toplevel [row] = item;
 
-      }
+  if (key.first && (m_flags & WithVariants) != 0) {
 
+    const db::PCellHeader *pcell_header = mp_layout->pcell_header (key.second);
+    for (db::PCellHeader::variant_iterator v = pcell_header->begin (); v != pcell_header->end (); ++v) {
+      if (mp_library && mp_library->is_retired (v->second->cell_index ())) {
+        //  skip retired cells - this means we won't show variants which are just kept
+        //  as shadow variants for the transactions.
+      } else {
+        item->add_child (new CellTreeItem (mp_layout, false, v->second->cell_index (), true, m_sorting, &m_cell_ranks));
+      }
     }
 
-  }
+    item->finish_children ();
 
-  std::sort (m_toplevel.begin (), m_toplevel.end (), cmp_cell_tree_items_f (m_sorting));
-
-  for (size_t i = 0; i < m_toplevel.size (); ++i) {
-    m_toplevel [i]->set_index (i);
   }
+
+  return item;
 }
 
 Qt::ItemFlags 
@@ -783,7 +1032,7 @@ CellTreeModel::rowCount (const QModelIndex &parent) const
       return int (item->children ());
     }
   } else {
-    return int (m_toplevel.size ());
+    return int (m_toplevel_keys.size ());
   }
 }
 
@@ -802,8 +1051,8 @@ CellTreeModel::index (int row, int column, const QModelIndex &parent) const
     } else {
       return createIndex (row, column, item->child (row));
     }
-  } else if (row >= 0 && row < int (m_toplevel.size ())) {
-    return createIndex (row, column, m_toplevel [row]);
+  } else if (row >= 0 && row < int (m_toplevel_keys.size ())) {
+    return createIndex (row, column, toplevel_item_at (row));
   } else {
     return QModelIndex ();
   }
@@ -836,7 +1085,7 @@ CellTreeModel::toplevel_items () const
   if (mp_layout->under_construction () || (mp_layout->manager () && mp_layout->manager ()->transacting ())) {
     return 0;
   } else {
-    return int (m_toplevel.size ());
+    return int (m_toplevel_keys.size ());
   }
 }
 
@@ -846,7 +1095,7 @@ CellTreeModel::toplevel_item (int index)
   if (mp_layout->under_construction () || (mp_layout->manager () && mp_layout->manager ()->transacting ())) {
     return 0;
   } else {
-    return m_toplevel [index];
+    return toplevel_item_at (index);
   }
 }
 
@@ -966,17 +1215,118 @@ CellTreeModel::locate_prev ()
 }
 
 void
-CellTreeModel::search_children (const tl::GlobPattern &pattern, CellTreeItem *item)
+CellTreeModel::update_name_filter (const std::string &text, bool glob_pattern, bool case_sensitive)
+{
+  //  The filter is incremental: if the new text extends the previous one, only the
+  //  cells matching the previous text need to be checked. This is true for plain
+  //  text as well as for "*" and "?" because the match is a header match.
+  bool refine = m_filter_valid &&
+                m_filter_glob == glob_pattern &&
+                m_filter_case_sensitive == case_sensitive &&
+                text.size () >= m_filter_text.size () &&
+                text.compare (0, m_filter_text.size (), m_filter_text) == 0 &&
+                (! glob_pattern || m_filter_text.find_first_of ("\\[{(") == std::string::npos);
+
+  if (refine && text == m_filter_text) {
+    return;
+  }
+
+  std::vector<db::cell_index_type> candidates;
+  if (refine) {
+    for (size_t ci = 0; ci < m_name_matches.size (); ++ci) {
+      if (m_name_matches [ci]) {
+        candidates.push_back (db::cell_index_type (ci));
+      }
+    }
+  } else {
+    candidates.reserve (m_cell_names.size ());
+    for (size_t ci = 0; ci < m_cell_names.size (); ++ci) {
+      if (mp_layout->is_valid_cell_index (db::cell_index_type (ci))) {
+        candidates.push_back (db::cell_index_type (ci));
+      }
+    }
+  }
+
+  m_name_matches.clear ();
+  m_name_matches.resize (m_cell_names.size (), 0);
+
+  m_filter_text = text;
+  m_filter_glob = glob_pattern;
+  m_filter_case_sensitive = case_sensitive;
+  m_filter_valid = true;
+
+  if (candidates.empty ()) {
+    return;
+  }
+
+  tl::GlobPattern p = tl::GlobPattern (text);
+  p.set_case_sensitive (case_sensitive);
+  p.set_exact (! glob_pattern);
+  p.set_header_match (true);
+
+  const size_t min_candidates_per_task = 10000;
+
+  int workers = mp_view ? mp_view->drawing_workers () : 0;
+  if (workers <= 0 || candidates.size () < 2 * min_candidates_per_task) {
+
+    CellNameFilterTask (p, &m_cell_names, &candidates.front (), &candidates.front () + candidates.size (), &m_name_matches).filter ();
+
+  } else {
+
+    //  Each task uses its own copy of the pattern and writes to different elements of the
+    //  match vector, so no synchronization is required.
+    tl::Job<CellNameFilterWorker> job (workers);
+
+    size_t per_task = std::max (min_candidates_per_task, (candidates.size () + workers - 1) / workers);
+    for (size_t from = 0; from < candidates.size (); from += per_task) {
+      size_t to = std::min (candidates.size (), from + per_task);
+      job.schedule (new CellNameFilterTask (p, &m_cell_names, &candidates.front () + from, &candidates.front () + to, &m_name_matches));
+    }
+
+    try {
+      job.start ();
+      job.wait ();
+    } catch (...) {
+      job.terminate ();
+      m_filter_valid = false;
+      throw;
+    }
+
+    if (job.has_error ()) {
+      m_filter_valid = false;
+      throw tl::Exception (job.error_messages ().front ());
+    }
+
+  }
+}
+
+void
+CellTreeModel::search_children (const std::vector<char> &in_subtree, CellTreeItem *item)
 {
+  //  only descends into subtrees with matching cells, so items are created
+  //  only along the paths leading to a match
+
   int children = item->children ();
   for (int i = 0; i < children; ++i) {
-    CellTreeItem *c = item->child (i);
-    if (c) {
-      if (c->name_matches (pattern)) {
+
+    db::cell_index_type ci = item->child_cell_index (i);
+    if (ci >= m_name_matches.size ()) {
+      continue;
+    }
+
+    bool descend = ci < in_subtree.size () && in_subtree [ci];
+    if (m_name_matches [ci] || descend) {
+
+      CellTreeItem *c = item->child (i);
+      if (m_name_matches [ci]) {
         m_selected_indexes.push_back (model_index (c));
       }
-      search_children (pattern, c);
+      if (descend) {
+        search_children (in_subtree, c);
+      }
+
     }
+
   }
 }
 
@@ -989,18 +1339,67 @@ CellTreeModel::locate (const char *name, bool glob_pattern, bool case_sensitive,
 
   m_selected_indexes.clear ();
 
-  tl::GlobPattern p = tl::GlobPattern (std::string (name));
-  p.set_case_sensitive (case_sensitive);
-  p.set_exact (!glob_pattern);
-  p.set_header_match (true);
+  update_name_filter (std::string (name), glob_pattern, case_sensitive);
+
+  //  Determine the cells which have a matching cell in their subtree (for the hierarchical search).
+  //  This is done bottom-up, so each cell is visited once.
+
+  std::vector<char> in_subtree;
+  if (! top_only && ! m_flat) {
 
-  for (std::vector <CellTreeItem *>::const_iterator lc = m_toplevel.begin (); lc != m_toplevel.end (); ++lc) {
-    if ((*lc)->name_matches (p)) {
-      m_selected_indexes.push_back (model_index (*lc));
+    in_subtree.resize (m_name_matches.size (), 0);
+
+    for (db::Layout::bottom_up_const_iterator c = mp_layout->begin_bottom_up (); c != mp_layout->end_bottom_up (); ++c) {
+      if (*c < in_subtree.size ()) {
+        const db::Cell &cell = mp_layout->cell (*c);
+        for (db::Cell::child_cell_iterator cc = cell.begin_child_cells (); ! cc.at_end () && ! in_subtree [*c]; ++cc) {
+          if (*cc < in_subtree.size () && (m_name_matches [*cc] || in_subtree [*cc])) {
+            in_subtree [*c] = 1;
+          }
+        }
+      }
     }
-    if (! top_only) {
-      search_children (p, *lc);
+
+  }
+
+  tl::GlobPattern p;
+  bool pcells_compiled = false;
+
+  for (size_t i = 0; i < m_toplevel_keys.size (); ++i) {
+
+    const std::pair<bool, size_t> &key = m_toplevel_keys [i];
+
+    if (key.first) {
+
+      //  PCell entries are not covered by the name filter
+      if (! pcells_compiled) {
+        p = tl::GlobPattern (std::string (name));
+        p.set_case_sensitive (case_sensitive);
+        p.set_exact (!glob_pattern);
+        p.set_header_match (true);
+        pcells_compiled = true;
+      }
+
+      CellTreeItem *item = toplevel_item_at (int (i));
+      if (item->name_matches (p)) {
+        m_selected_indexes.push_back (model_index (item));
+      }
+      if (! top_only) {
+        search_children (in_subtree, item);
+      }
+
+    } else if (key.second < m_name_matches.size ()) {
+
+      bool descend = key.second < in_subtree.size () && in_subtree [key.second];
+      if (m_name_matches [key.second]) {
+        m_selected_indexes.push_back (model_index (toplevel_item_at (int (i))));
+      }
+      if (descend) {
+        search_children (in_subtree, toplevel_item_at (int (i)));
+      }
+
     }
+
   }
 
   m_selected_indexes_set.clear ();
@@ -25,6 +25,7 @@
 #define HDR_layCellTreeModel
 
 #include <vector>
+#include <string>
 
 #include "dbLayout.h"
 
@@ -53,6 +54,10 @@ class CellTreeItem;
  *
  *  This model delivers data of the cell tree forming either a flat
  *  representation or a hierarchical one.
+ *
+ *  Items are created lazily: the order of the entries is computed up front
+ *  from a snapshot of the cell names and areas, but a CellTreeItem is only
+ *  created when the view asks for the corresponding row.
  */
 
 class CellTreeModel 
@@ -189,6 +194,11 @@ public:
    *
    *  If top_only is set, only top-level items are searched. An invalid model index is returned if
    *  no corresponding item could be found.
+   *
+   *  The name matching is incremental and for large layouts is distributed over the view's
+   *  drawing workers. This method still returns synchronously: the callers select and scroll
+   *  to the result immediately, so running the filter detached from the GUI thread would
+   *  require an asynchronous notification of the hierarchy panel.
    */
   QModelIndex locate (const char *name, bool glob_pattern = false, bool case_sensitive = true, bool top_only = true);
 
@@ -247,14 +257,25 @@ private:
   db::Library *mp_library;
   int m_cv_index;
   const db::Cell *mp_base;
-  std::vector <CellTreeItem *> m_toplevel;
+  std::vector <std::pair<bool, size_t> > m_toplevel_keys;
+  mutable std::vector <CellTreeItem *> m_toplevel;
+  std::vector <std::string> m_cell_names;
+  std::vector <size_t> m_cell_ranks;
   std::set <QModelIndex> m_selected_indexes_set;
   std::vector <QModelIndex> m_selected_indexes;
   std::vector <QModelIndex>::const_iterator m_current_index;
+  std::vector <char> m_name_matches;
+  std::string m_filter_text;
+  bool m_filter_glob, m_filter_case_sensitive, m_filter_valid;
 
   void build_top_level ();
+  void build_sort_keys ();
+  void attach_events ();
+  void cell_names_changed ();
   void clear_top_level ();
-  void search_children (const tl::GlobPattern &pattern, CellTreeItem *item);
+  CellTreeItem *toplevel_item_at (int row) const;
+  void update_name_filter (const std::string &text, bool glob_pattern, bool case_sensitive);
+  void search_children (const std::vector<char> &in_subtree, CellTreeItem *item);
   void do_configure (db::Layout *layout, db::Library *library, lay::LayoutView *view, int cv_index, unsigned int flags, const db::Cell *base, Sorting sorting);
 };
 
@@ -262,16 +283,19 @@ private:
  *  @brief The cell tree item object 
  *
  *  This object is used to represent a cell in the tree model.
+ *  The child cells are sorted on first access, but the child items are
+ *  created individually when requested.
  */
 
 class CellTreeItem
 {
 public:
-  CellTreeItem (const db::Layout *layout, bool is_pcell, size_t cell_or_pcell_index, bool flat, CellTreeModel::Sorting sorting);
+  CellTreeItem (const db::Layout *layout, bool is_pcell, size_t cell_or_pcell_index, bool flat, CellTreeModel::Sorting sorting, const std::vector<size_t> *cell_ranks = 0);
   ~CellTreeItem ();
 
   int children () const;
   CellTreeItem *child (int index);
+  db::cell_index_type child_cell_index (int index);
   db::cell_index_type cell_or_pcell_index () const;
   CellTreeItem *parent () const;
   bool by_name_less_than (const CellTreeItem *b) const;
@@ -307,10 +331,13 @@ private:
   bool m_is_pcell;
   size_t m_index;
   std::vector<CellTreeItem *> m_children;
+  std::vector<db::cell_index_type> m_child_cells;
   int m_child_count;
   size_t m_cell_or_pcell_index;
+  const std::vector<size_t> *mp_cell_ranks;
 
   const char *name () const;
+  void build_child_cells ();
 };
 
 }
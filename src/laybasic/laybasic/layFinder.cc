@@ -57,6 +57,104 @@ static int point_sel_tests = 10000;
 //  max. number of tries in single-click selection before giving up
 static int inst_point_sel_tests = 10000;
 
+// ----------------------------------------------------------------------
+//  FinderBoxCache implementation
+
+FinderBoxCache::FinderBoxCache ()
+{
+  //  .. nothing yet ..
+}
+
+FinderBoxCache &
+FinderBoxCache::instance ()
+{
+  static FinderBoxCache s_instance;
+  return s_instance;
+}
+
+void
+FinderBoxCache::clear ()
+{
+  m_entries.clear ();
+}
+
+size_t
+FinderBoxCache::cached_layer_sets (const db::Layout &layout) const
+{
+  std::map<const db::Layout *, LayoutEntry>::const_iterator e = m_entries.find (&layout);
+  if (e != m_entries.end () && e->second.layout.get () == &layout) {
+    return e->second.layer_sets.size ();
+  } else {
+    return 0;
+  }
+}
+
+void
+FinderBoxCache::layout_changed (const db::Layout *layout)
+{
+  std::map<const db::Layout *, LayoutEntry>::iterator e = m_entries.find (layout);
+  if (e != m_entries.end ()) {
+    e->second.layer_sets.clear ();
+  }
+}
+
+const db::Box &
+FinderBoxCache::bbox (const db::Layout &layout, const std::vector<int> &layers, const db::Cell &cell)
+{
+  //  limits the number of layer sets kept per layout
+  const size_t max_layer_sets = 16;
+
+  LayoutEntry &entry = m_entries [&layout];
+  if (entry.layout.get () != &layout) {
+
+    //  a new layout or a new one at the address of a deleted one: drop the entries of deleted layouts
+    for (std::map<const db::Layout *, LayoutEntry>::iterator e = m_entries.begin (); e != m_entries.end (); ) {
+      std::map<const db::Layout *, LayoutEntry>::iterator ee = e++;
+      if (ee->first != &layout && ee->second.layout.get () == 0) {
+        m_entries.erase (ee);
+      }
+    }
+
+    db::Layout *ly = const_cast<db::Layout *> (&layout);
+    entry.layout.reset (ly);
+    entry.layer_sets.clear ();
+
+    ly->hier_changed_event.add (this, &FinderBoxCache::layout_changed, &layout);
+    ly->bboxes_changed_any_event.add (this, &FinderBoxCache::layout_changed, &layout);
+
+  }
+
+  std::map<std::vector<int>, LayerSetBoxes>::iterator ls = entry.layer_sets.find (layers);
+  if (ls == entry.layer_sets.end ()) {
+    if (entry.layer_sets.size () >= max_layer_sets) {
+      entry.layer_sets.clear ();
+    }
+    ls = entry.layer_sets.insert (std::make_pair (layers, LayerSetBoxes ())).first;
+    ls->second.boxes.resize (layout.cells (), db::Box ());
+    ls->second.valid.resize (layout.cells (), false);
+  }
+
+  LayerSetBoxes &boxes = ls->second;
+
+  db::cell_index_type ci = cell.cell_index ();
+  if (ci >= boxes.boxes.size ()) {
+    //  should not happen as new cells trigger a hierarchy change event
+    boxes.boxes.resize (ci + 1, db::Box ());
+    boxes.valid.resize (ci + 1, false);
+  }
+
+  if (! boxes.valid [ci]) {
+    db::Box box;
+    for (std::vector<int>::const_iterator l = layers.begin (); l != layers.end (); ++l) {
+      box += cell.bbox ((unsigned int) *l);
+    }
+    boxes.boxes [ci] = box;
+    boxes.valid [ci] = true;
+  }
+
+  return boxes.boxes [ci];
+}
+
 // ----------------------------------------------------------------------
 //  Finder implementation
 
@@ -148,6 +246,17 @@ Finder::test_edge (const db::Edge &edg, double &distance, bool &match)
   return ret;
 }
 
+db::Box
+Finder::cell_bbox (const db::Cell &cell)
+{
+  if (m_layers.size () > 1) {
+    //  with multiple layers, use the box of the layer set: this skips cells without shapes on these layers
+    return FinderBoxCache::instance ().bbox (*mp_layout, m_layers, cell);
+  } else {
+    return m_cell_box_convert (cell);
+  }
+}
+
 void
 Finder::do_find (const db::Cell &cell, int level, const db::ICplxTrans &t)
 {
@@ -165,7 +274,7 @@ Finder::do_find (const db::Cell &cell, int level, const db::ICplxTrans &t)
     }
 
   } else if (level < m_max_level 
-      && (t * m_cell_box_convert (cell)).touches (m_region) 
+      && (t * cell_bbox (cell)).touches (m_region) 
       && (mp_view->select_inside_pcells_mode () || !cell.is_proxy ()) 
       && !mp_view->is_cell_hidden (cell.cell_index (), m_cv_index)) {
 
@@ -267,7 +376,6 @@ ShapeFinder::find (lay::LayoutView *view, const db::DBox &region_mu)
   mp_progress = &progress;
 
   m_context_layers.clear ();
-  m_cells_with_context.clear ();
 
   std::vector<lay::LayerPropertiesConstIterator> lprops;
   for (lay::LayerPropertiesConstIterator lp = view->begin_layers (); ! lp.at_end (); ++lp) {
@@ -317,7 +425,6 @@ ShapeFinder::find (lay::LayoutView *view, const db::DBox &region_mu)
   }
 
   mp_progress = 0;
-  m_cells_with_context.clear ();
   m_context_layers.clear ();
 
   return ! m_founds.empty ();
@@ -331,7 +438,6 @@ ShapeFinder::find (lay::LayoutView *view, const lay::LayerProperties &lprops, co
   progress.set_format ("");
   mp_progress = &progress;
 
-  m_cells_with_context.clear ();
   m_context_layers.clear ();
 
   std::vector<int> layers;
@@ -402,26 +508,9 @@ ShapeFinder::checkpoint ()
 void 
 ShapeFinder::visit_cell (const db::Cell &cell, const db::Box &search_box, const db::ICplxTrans &t, int /*level*/)
 {
-  if (! m_context_layers.empty ()) {
-
-    std::map<db::cell_index_type, bool>::const_iterator ctx = m_cells_with_context.find (cell.cell_index ());
-    if (ctx == m_cells_with_context.end ()) {
-
-      bool has_context = false;
-      for (std::vector<int>::const_iterator l = m_context_layers.begin (); l != m_context_layers.end () && ! has_context; ++l) {
-        if (! cell.bbox ((unsigned int) *l).empty ()) {
-          has_context = true;
-        }
-      }
-
-      ctx = m_cells_with_context.insert (std::make_pair (cell.cell_index (), has_context)).first;
-
-    }
-
-    if (! ctx->second) {
-      return;
-    }
-
+  //  only look into cells having shapes on one of the context layers
+  if (! m_context_layers.empty () && FinderBoxCache::instance ().bbox (layout (), m_context_layers, cell).empty ()) {
+    return;
   }
 
   if (! point_mode ()) {
@@ -730,9 +819,7 @@ InstFinder::visit_cell (const db::Cell &cell, const db::Box &search_box, const d
           } else if (! m_visible_layers || level == mp_view->get_max_hier_levels () - 1 || mp_view->is_cell_hidden (inst_cell.cell_index (), m_cv_index)) {
             ibox = inst_cell.bbox ();
           } else {
-            for (std::vector<int>::const_iterator l = m_visible_layer_indexes.begin (); l != m_visible_layer_indexes.end (); ++l) {
-              ibox += inst_cell.bbox (*l);
-            }
+            ibox = FinderBoxCache::instance ().bbox (layout (), m_visible_layer_indexes, inst_cell);
           }
 
           if (! ibox.empty ()) {
@@ -816,9 +903,7 @@ InstFinder::visit_cell (const db::Cell &cell, const db::Box &search_box, const d
           } else if (! m_visible_layers || level == mp_view->get_max_hier_levels () - 1 || mp_view->is_cell_hidden (inst_cell.cell_index (), m_cv_index)) {
             ibox = inst_cell.bbox ();
           } else {
-            for (std::vector<int>::const_iterator l = m_visible_layer_indexes.begin (); l != m_visible_layer_indexes.end (); ++l) {
-              ibox += inst_cell.bbox (*l);
-            }
+            ibox = FinderBoxCache::instance ().bbox (layout (), m_visible_layer_indexes, inst_cell);
           }
 
           if (! ibox.empty ()) {
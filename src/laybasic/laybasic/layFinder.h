@@ -27,8 +27,10 @@
 #include "laybasicCommon.h"
 
 #include <vector>
+#include <map>
 
 #include "tlVector.h"
+#include "tlObject.h"
 #include "layLayoutView.h"
 #include "dbBoxConvert.h"
 #include "dbLayout.h"
@@ -44,6 +46,67 @@ namespace tl
 namespace lay
 {
 
+/**
+ *  @brief A cache for the bounding boxes of cells on sets of layers
+ *
+ *  The finders use these boxes to skip cells which do not have shapes on any of the
+ *  layers searched. The boxes are computed on demand and kept until the hierarchy
+ *  or the bounding boxes of the layout change. For this, the cache attaches to the
+ *  layout's state model events.
+ *
+ *  The cache is not thread-safe and must be used from the main thread only.
+ */
+class LAYBASIC_PUBLIC FinderBoxCache
+  : public tl::Object
+{
+public:
+  /**
+   *  @brief Constructor
+   */
+  FinderBoxCache ();
+
+  /**
+   *  @brief Gets the singleton instance
+   */
+  static FinderBoxCache &instance ();
+
+  /**
+   *  @brief Gets the bounding box of the given cell on the given layers
+   *
+   *  The box is the union of the cell's bounding boxes on the individual layers.
+   */
+  const db::Box &bbox (const db::Layout &layout, const std::vector<int> &layers, const db::Cell &cell);
+
+  /**
+   *  @brief Clears the cache
+   */
+  void clear ();
+
+  /**
+   *  @brief Gets the number of layer sets cached for the given layout
+   *
+   *  This method is provided for testing purposes.
+   */
+  size_t cached_layer_sets (const db::Layout &layout) const;
+
+private:
+  struct LayerSetBoxes
+  {
+    std::vector<db::Box> boxes;
+    std::vector<bool> valid;
+  };
+
+  struct LayoutEntry
+  {
+    tl::weak_ptr<db::Layout> layout;
+    std::map<std::vector<int>, LayerSetBoxes> layer_sets;
+  };
+
+  std::map<const db::Layout *, LayoutEntry> m_entries;
+
+  void layout_changed (const db::Layout *layout);
+};
+
 /**
  *  @brief A generic finder class
  *
@@ -157,6 +220,8 @@ private:
    */
   virtual void visit_cell (const db::Cell &cell, const db::Box &search_box, const db::ICplxTrans &t, int level) = 0;
 
+  db::Box cell_bbox (const db::Cell &cell);
+
   int m_min_level, m_max_level;
   std::vector<db::InstElement> m_path;
   const db::Layout *mp_layout;
@@ -254,7 +319,6 @@ private:
   int m_tries;
   tl::AbsoluteProgress *mp_progress;
   std::vector<int> m_context_layers;
-  std::map<db::cell_index_type, bool> m_cells_with_context;
 };
 
 /**
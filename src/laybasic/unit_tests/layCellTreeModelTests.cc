@@ -0,0 +1,224 @@
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2020 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+#include "layCellTreeModel.h"
+#include "dbLayout.h"
+#include "tlUnitTest.h"
+
+//  TOP (0,0;140,40) -> A, B
+//  TOP2 (0,0;50,50) -> X
+//  A (0,0;30,30) -> C
+//  B (0,0;40,40) -> C
+//  C (0,0;10,10)
+//  X (0,0;20,20)
+static void make_layout (db::Layout &ly)
+{
+  unsigned int l1 = ly.insert_layer (db::LayerProperties (1, 0));
+
+  db::Cell &top = ly.cell (ly.add_cell ("TOP"));
+  db::Cell &top2 = ly.cell (ly.add_cell ("TOP2"));
+  db::Cell &a = ly.cell (ly.add_cell ("A"));
+  db::Cell &b = ly.cell (ly.add_cell ("B"));
+  db::Cell &c = ly.cell (ly.add_cell ("C"));
+  db::Cell &x = ly.cell (ly.add_cell ("X"));
+
+  c.shapes (l1).insert (db::Box (0, 0, 10, 10));
+  x.shapes (l1).insert (db::Box (0, 0, 20, 20));
+  a.shapes (l1).insert (db::Box (0, 0, 30, 30));
+  b.shapes (l1).insert (db::Box (0, 0, 40, 40));
+  top2.shapes (l1).insert (db::Box (0, 0, 50, 50));
+
+  a.insert (db::CellInstArray (db::CellInst (c.cell_index ()), db::Trans ()));
+  b.insert (db::CellInstArray (db::CellInst (c.cell_index ()), db::Trans ()));
+  top.insert (db::CellInstArray (db::CellInst (a.cell_index ()), db::Trans ()));
+  top.insert (db::CellInstArray (db::CellInst (b.cell_index ()), db::Trans (db::Vector (100, 0))));
+  top2.insert (db::CellInstArray (db::CellInst (x.cell_index ()), db::Trans ()));
+
+  ly.update ();
+}
+
+static std::string rows (const lay::CellTreeModel &model, const QModelIndex &parent)
+{
+  std::string s;
+  for (int i = 0; i < model.rowCount (parent); ++i) {
+    if (! s.empty ()) {
+      s += ",";
+    }
+    s += tl::to_string (model.data (model.index (i, 0, parent), Qt::DisplayRole).toString ());
+  }
+  return s;
+}
+
+static std::string path (const lay::CellTreeModel &model, const QModelIndex &index)
+{
+  std::string s;
+  for (QModelIndex i = index; i.isValid (); i = model.parent (i)) {
+    std::string n = model.cell_name (i);
+    s = s.empty () ? n : n + "/" + s;
+  }
+  return s;
+}
+
+TEST (1_Hierarchical)
+{
+  db::Layout ly;
+  make_layout (ly);
+
+  lay::CellTreeModel model (0, &ly, lay::CellTreeModel::NoPadding);
+
+  EXPECT_EQ (rows (model, QModelIndex ()), "TOP,TOP2");
+
+  QModelIndex top = model.index (0, 0, QModelIndex ());
+  EXPECT_EQ (path (model, top), "TOP");
+  EXPECT_EQ (model.parent (top).isValid (), false);
+  EXPECT_EQ (rows (model, top), "A,B");
+
+  QModelIndex b = model.index (1, 0, top);
+  EXPECT_EQ (path (model, b), "TOP/B");
+  EXPECT_EQ (model.parent (b) == top, true);
+  EXPECT_EQ (rows (model, b), "C");
+  EXPECT_EQ (path (model, model.index (0, 0, b)), "TOP/B/C");
+  EXPECT_EQ (model.rowCount (model.index (0, 0, b)), 0);
+
+  QModelIndex top2 = model.index (1, 0, QModelIndex ());
+  EXPECT_EQ (rows (model, top2), "X");
+
+  //  padding
+  lay::CellTreeModel padded (0, &ly, 0);
+  EXPECT_EQ (rows (padded, QModelIndex ()), " TOP , TOP2 ");
+}
+
+TEST (2_Sorting)
+{
+  db::Layout ly;
+  make_layout (ly);
+
+  lay::CellTreeModel model (0, &ly, lay::CellTreeModel::Flat | lay::CellTreeModel::NoPadding);
+  EXPECT_EQ (rows (model, QModelIndex ()), "A,B,C,TOP,TOP2,X");
+
+  model.set_sorting (lay::CellTreeModel::ByArea);
+  EXPECT_EQ (rows (model, QModelIndex ()), "C,X,A,B,TOP2,TOP");
+
+  model.set_sorting (lay::CellTreeModel::ByAreaReverse);
+  EXPECT_EQ (rows (model, QModelIndex ()), "TOP,TOP2,B,A,X,C");
+
+  lay::CellTreeModel hier (0, &ly, lay::CellTreeModel::NoPadding, 0, lay::CellTreeModel::ByAreaReverse);
+  EXPECT_EQ (rows (hier, QModelIndex ()), "TOP,TOP2");
+  EXPECT_EQ (rows (hier, hier.index (0, 0, QModelIndex ())), "B,A");
+
+  //  children and parents of a cell
+  db::cell_index_type ci_c = ly.cell_by_name ("C").second;
+  db::cell_index_type ci_top = ly.cell_by_name ("TOP").second;
+
+  lay::CellTreeModel parents (0, &ly, lay::CellTreeModel::Parents | lay::CellTreeModel::NoPadding, &ly.cell (ci_c));
+  EXPECT_EQ (rows (parents, QModelIndex ()), "A,B");
+
+  lay::CellTreeModel children (0, &ly, lay::CellTreeModel::Children | lay::CellTreeModel::NoPadding, &ly.cell (ci_top), lay::CellTreeModel::ByAreaReverse);
+  EXPECT_EQ (rows (children, QModelIndex ()), "B,A");
+}
+
+TEST (3_LocateFlat)
+{
+  db::Layout ly;
+  make_layout (ly);
+
+  lay::CellTreeModel model (0, &ly, lay::CellTreeModel::Flat | lay::CellTreeModel::NoPadding);
+
+  //  header match
+  QModelIndex i = model.locate ("TOP");
+  EXPECT_EQ (path (model, i), "TOP");
+  EXPECT_EQ (path (model, model.locate_next ()), "TOP2");
+  EXPECT_EQ (path (model, model.locate_next ()), "TOP");
+  EXPECT_EQ (path (model, model.locate_prev ()), "TOP2");
+
+  //  incremental refinement
+  EXPECT_EQ (path (model, model.locate ("TOP2")), "TOP2");
+  EXPECT_EQ (path (model, model.locate_next ()), "TOP2");
+  EXPECT_EQ (model.locate ("TOP23").isValid (), false);
+  EXPECT_EQ (model.locate_next ().isValid (), false);
+
+  //  back to a shorter text
+  EXPECT_EQ (path (model, model.locate ("T")), "TOP");
+
+  //  case sensitivity
+  EXPECT_EQ (model.locate ("top2").isValid (), false);
+  EXPECT_EQ (path (model, model.locate ("top2", false, false)), "TOP2");
+
+  //  glob pattern
+  EXPECT_EQ (path (model, model.locate ("*2", true)), "TOP2");
+  EXPECT_EQ (path (model, model.locate ("[BX]", true)), "B");
+  EXPECT_EQ (path (model, model.locate_next ()), "X");
+
+  //  no exact match for a glob pattern without wildcard
+  EXPECT_EQ (model.locate ("TOP*2", false).isValid (), false);
+
+  model.clear_locate ();
+  EXPECT_EQ (model.locate_next ().isValid (), false);
+}
+
+TEST (4_LocateHierarchical)
+{
+  db::Layout ly;
+  make_layout (ly);
+
+  lay::CellTreeModel model (0, &ly, lay::CellTreeModel::NoPadding);
+
+  //  top only
+  EXPECT_EQ (model.locate ("C").isValid (), false);
+  EXPECT_EQ (path (model, model.locate ("TOP")), "TOP");
+
+  //  C is found below A and B
+  EXPECT_EQ (path (model, model.locate ("C", false, true, false)), "TOP/A/C");
+  EXPECT_EQ (path (model, model.locate_next ()), "TOP/B/C");
+  EXPECT_EQ (path (model, model.locate_next ()), "TOP/A/C");
+
+  EXPECT_EQ (path (model, model.locate ("X", false, true, false)), "TOP2/X");
+  EXPECT_EQ (path (model, model.locate_next ()), "TOP2/X");
+
+  EXPECT_EQ (path (model, model.locate ("*", true, true, false)), "TOP");
+  EXPECT_EQ (path (model, model.locate_next ()), "TOP/A");
+  EXPECT_EQ (path (model, model.locate_next ()), "TOP/A/C");
+  EXPECT_EQ (path (model, model.locate_next ()), "TOP/B");
+  EXPECT_EQ (path (model, model.locate_next ()), "TOP/B/C");
+  EXPECT_EQ (path (model, model.locate_next ()), "TOP2");
+  EXPECT_EQ (path (model, model.locate_next ()), "TOP2/X");
+}
+
+TEST (5_Rename)
+{
+  db::Layout ly;
+  make_layout (ly);
+
+  lay::CellTreeModel model (0, &ly, lay::CellTreeModel::Flat | lay::CellTreeModel::NoPadding);
+  lay::CellTreeModel hier (0, &ly, lay::CellTreeModel::NoPadding);
+
+  EXPECT_EQ (path (model, model.locate ("A")), "A");
+
+  ly.rename_cell (ly.cell_by_name ("A").second, "Z");
+
+  //  the name filter sees the new name
+  EXPECT_EQ (model.locate ("A").isValid (), false);
+  EXPECT_EQ (path (model, model.locate ("Z")), "Z");
+  EXPECT_EQ (path (hier, hier.locate ("Z", false, true, false)), "TOP/Z");
+
+  //  the children are sorted by the new name
+  EXPECT_EQ (rows (hier, hier.index (0, 0, QModelIndex ())), "B,Z");
+}
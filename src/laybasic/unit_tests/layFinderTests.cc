@@ -0,0 +1,95 @@
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2020 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+#include "layFinder.h"
+#include "dbLayout.h"
+#include "tlUnitTest.h"
+
+TEST(1_FinderBoxCache)
+{
+  lay::FinderBoxCache cache;
+
+  db::Layout ly;
+  unsigned int l1 = ly.insert_layer (db::LayerProperties (1, 0));
+  unsigned int l2 = ly.insert_layer (db::LayerProperties (2, 0));
+
+  db::Cell &top = ly.cell (ly.add_cell ("TOP"));
+  db::Cell &a = ly.cell (ly.add_cell ("A"));
+  a.shapes (l1).insert (db::Box (0, 0, 100, 100));
+  a.shapes (l2).insert (db::Box (200, 0, 300, 100));
+  top.insert (db::CellInstArray (db::CellInst (a.cell_index ()), db::Trans (db::Vector (1000, 0))));
+  ly.update ();
+
+  std::vector<int> layers1;
+  layers1.push_back (int (l1));
+  std::vector<int> layers12 (layers1);
+  layers12.push_back (int (l2));
+
+  EXPECT_EQ (cache.cached_layer_sets (ly), size_t (0));
+
+  EXPECT_EQ (cache.bbox (ly, layers1, a).to_string (), "(0,0;100,100)");
+  EXPECT_EQ (cache.bbox (ly, layers12, a).to_string (), "(0,0;300,100)");
+  EXPECT_EQ (cache.bbox (ly, layers12, top).to_string (), "(1000,0;1300,100)");
+  EXPECT_EQ (cache.cached_layer_sets (ly), size_t (2));
+
+  //  a layer set hit delivers the cached box
+  const db::Box *b1 = &cache.bbox (ly, layers1, a);
+  EXPECT_EQ (b1 == &cache.bbox (ly, layers1, a), true);
+  EXPECT_EQ (cache.cached_layer_sets (ly), size_t (2));
+
+  //  a shape edit invalidates the cache
+  a.shapes (l1).insert (db::Box (0, 0, 100, 500));
+  EXPECT_EQ (cache.cached_layer_sets (ly), size_t (0));
+  ly.update ();
+  EXPECT_EQ (cache.bbox (ly, layers1, a).to_string (), "(0,0;100,500)");
+  EXPECT_EQ (cache.bbox (ly, layers12, top).to_string (), "(1000,0;1300,500)");
+  EXPECT_EQ (cache.cached_layer_sets (ly), size_t (2));
+
+  //  a hierarchy edit invalidates the cache
+  db::Cell &b = ly.cell (ly.add_cell ("B"));
+  b.insert (db::CellInstArray (db::CellInst (a.cell_index ()), db::Trans (db::Vector (0, 2000))));
+  top.insert (db::CellInstArray (db::CellInst (b.cell_index ()), db::Trans ()));
+  EXPECT_EQ (cache.cached_layer_sets (ly), size_t (0));
+  ly.update ();
+  EXPECT_EQ (cache.bbox (ly, layers1, b).to_string (), "(0,2000;100,2500)");
+  EXPECT_EQ (cache.bbox (ly, layers12, top).to_string (), "(0,0;1300,2500)");
+
+  //  the number of layer sets per layout is limited
+  std::vector<int> extra_layers;
+  for (unsigned int i = 0; i < 16; ++i) {
+    extra_layers.push_back (int (ly.insert_layer (db::LayerProperties (100 + i, 0))));
+  }
+  ly.update ();
+
+  cache.clear ();
+  for (unsigned int i = 0; i < 16; ++i) {
+    std::vector<int> layers (layers12);
+    layers.push_back (extra_layers [i]);
+    EXPECT_EQ (cache.bbox (ly, layers, a).to_string (), "(0,0;300,500)");
+  }
+  EXPECT_EQ (cache.cached_layer_sets (ly), size_t (16));
+
+  EXPECT_EQ (cache.bbox (ly, layers1, a).to_string (), "(0,0;100,500)");
+  EXPECT_EQ (cache.cached_layer_sets (ly), size_t (1));
+  EXPECT_EQ (cache.bbox (ly, layers12, a).to_string (), "(0,0;300,500)");
+  EXPECT_EQ (cache.cached_layer_sets (ly), size_t (2));
+}
@@ -16,7 +16,9 @@ SOURCES = \
   laySnap.cc \
   layNetlistBrowserModelTests.cc \
     layNetlistBrowserTreeModelTests.cc \
-    layAbstractMenuTests.cc
+    layAbstractMenuTests.cc \
+    layCellTreeModelTests.cc \
+    layFinderTests.cc
 
 INCLUDEPATH += $$TL_INC $$LAYBASIC_INC $$DB_INC $$GSI_INC $$OUT_PWD/../laybasic
 DEPENDPATH += $$TL_INC $$LAYBASIC_INC $$DB_INC $$GSI_INC $$OUT_PWD/../laybasic
@@ -201,6 +201,12 @@ BasicArc::produce (const db::Layout &layout, const std::vector<unsigned int> &la
   cell.shapes (layer_ids [p_layer]).insert (poly);
 }
 
+bool
+BasicArc::can_produce_in_parallel () const
+{
+  return true;
+}
+
 std::string 
 BasicArc::get_display_name (const db::pcell_parameters_type &parameters) const
 {
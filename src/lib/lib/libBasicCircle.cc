@@ -139,6 +139,12 @@ BasicCircle::produce (const db::Layout &layout, const std::vector<unsigned int>
   cell.shapes (layer_ids [p_layer]).insert (poly);
 }
 
+bool
+BasicCircle::can_produce_in_parallel () const
+{
+  return true;
+}
+
 std::string 
 BasicCircle::get_display_name (const db::pcell_parameters_type &parameters) const
 {
@@ -166,6 +166,12 @@ BasicDonut::produce (const db::Layout &layout, const std::vector<unsigned int> &
   cell.shapes (layer_ids [p_layer]).insert (poly);
 }
 
+bool
+BasicDonut::can_produce_in_parallel () const
+{
+  return true;
+}
+
 std::string 
 BasicDonut::get_display_name (const db::pcell_parameters_type &parameters) const
 {
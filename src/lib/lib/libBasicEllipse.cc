@@ -170,6 +170,12 @@ BasicEllipse::produce (const db::Layout &layout, const std::vector<unsigned int>
   cell.shapes (layer_ids [p_layer]).insert (poly);
 }
 
+bool
+BasicEllipse::can_produce_in_parallel () const
+{
+  return true;
+}
+
 std::string 
 BasicEllipse::get_display_name (const db::pcell_parameters_type &parameters) const
 {
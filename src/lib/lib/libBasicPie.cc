@@ -183,6 +183,12 @@ BasicPie::produce (const db::Layout &layout, const std::vector<unsigned int> &la
   cell.shapes (layer_ids [p_layer]).insert (poly);
 }
 
+bool
+BasicPie::can_produce_in_parallel () const
+{
+  return true;
+}
+
 std::string 
 BasicPie::get_display_name (const db::pcell_parameters_type &parameters) const
 {
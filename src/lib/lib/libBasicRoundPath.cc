@@ -105,6 +105,12 @@ BasicRoundPath::produce (const db::Layout &layout, const std::vector<unsigned in
   cell.shapes (layer_ids [p_layer]).insert (poly);
 }
 
+bool
+BasicRoundPath::can_produce_in_parallel () const
+{
+  return true;
+}
+
 std::string 
 BasicRoundPath::get_display_name (const db::pcell_parameters_type &parameters) const
 {
@@ -170,6 +170,19 @@ BasicText::produce (const db::Layout &layout, const std::vector<unsigned int> &l
   }
 }
 
+bool
+BasicText::can_produce_in_parallel () const
+{
+  return true;
+}
+
+void
+BasicText::prepare_parallel_production () const
+{
+  //  loads the fonts, so the productions do not need to do so concurrently
+  db::TextGenerator::generators ();
+}
+
 std::string 
 BasicText::get_display_name (const db::pcell_parameters_type &parameters) const
 {
@@ -73,6 +73,16 @@ public:
    */
   virtual void produce (const db::Layout &layout, const std::vector<unsigned int> &layer_ids, const db::pcell_parameters_type &parameters, db::Cell &cell) const;
 
+  /**
+   *  @brief This PCell only creates shapes, so variants can be produced in parallel
+   */
+  virtual bool can_produce_in_parallel () const;
+
+  /**
+   *  @brief Loads the fonts before the parallel production
+   */
+  virtual void prepare_parallel_production () const;
+
   /**
    *  @brief Get the display name for a PCell with the given parameters
    */
@@ -22,6 +22,16 @@
 
 
 #include "tlUnitTest.h"
+#include "tlThreads.h"
+#include "dbLayout.h"
+#include "dbLayoutDiff.h"
+#include "libBasicCircle.h"
+#include "libBasicEllipse.h"
+#include "libBasicDonut.h"
+#include "libBasicRoundPath.h"
+#include "libBasicText.h"
+
+#include <algorithm>
 
 TEST(1) 
 {
@@ -31,3 +41,66 @@ TEST(1)
   throw tl::CancelException ();  //  skip this test to indicate that there is nothing yet
 }
 
+
+static void make_basic_layout (db::Layout &layout, int n)
+{
+  db::Cell &top = layout.cell (layout.add_cell ("TOP"));
+
+  db::pcell_id_type circle = layout.register_pcell ("CIRCLE", new lib::BasicCircle ());
+  db::pcell_id_type ellipse = layout.register_pcell ("ELLIPSE", new lib::BasicEllipse ());
+  db::pcell_id_type donut = layout.register_pcell ("DONUT", new lib::BasicDonut ());
+  db::pcell_id_type round_path = layout.register_pcell ("ROUND_PATH", new lib::BasicRoundPath ());
+  db::pcell_id_type text = layout.register_pcell ("TEXT", new lib::BasicText ());
+
+  for (int i = 0; i < n; ++i) {
+
+    double r = 1.0 + 0.01 * i;
+    db::Trans t (db::Vector (i * 10000, 0));
+
+    std::map<std::string, tl::Variant> p;
+    p ["layer"] = tl::Variant (db::LayerProperties (1, 0));
+    p ["npoints"] = 64 + i % 100;
+
+    p ["radius"] = p ["actual_radius"] = r;
+    top.insert (db::CellInstArray (db::CellInst (layout.get_pcell_variant_dict (circle, p)), t));
+
+    p ["radius_x"] = p ["actual_radius_x"] = r;
+    p ["radius_y"] = p ["actual_radius_y"] = 0.5 * r;
+    top.insert (db::CellInstArray (db::CellInst (layout.get_pcell_variant_dict (ellipse, p)), t));
+
+    p ["radius1"] = p ["actual_radius1"] = r;
+    p ["radius2"] = p ["actual_radius2"] = 0.5 * r;
+    top.insert (db::CellInstArray (db::CellInst (layout.get_pcell_variant_dict (donut, p)), t));
+
+    db::DPoint pts [] = { db::DPoint (0, 0), db::DPoint (0, 5.0), db::DPoint (r, 5.0), db::DPoint (r, 10.0) };
+    p ["radius"] = 1.0;
+    p ["path"] = tl::Variant (db::DPath (pts + 0, pts + sizeof (pts) / sizeof (pts [0]), 0.5));
+    top.insert (db::CellInstArray (db::CellInst (layout.get_pcell_variant_dict (round_path, p)), t));
+
+    p ["text"] = "T" + tl::to_string (i);
+    top.insert (db::CellInstArray (db::CellInst (layout.get_pcell_variant_dict (text, p)), t));
+
+  }
+}
+
+//  Parallel production of the basic library PCells
+TEST(2)
+{
+  const int n = 200;
+
+  db::Layout layout_au;
+  make_basic_layout (layout_au, n);
+  EXPECT_EQ (layout_au.cells (), size_t (1 + 5 * n));
+
+  db::Layout layout;
+  make_basic_layout (layout, n);
+
+  //  uses one thread per core, but at least one so the parallel production is always exercised
+  unsigned int threads = (unsigned int) std::max (1, tl::available_cores ());
+
+  layout.refresh_pcell_variants (0);
+  EXPECT_EQ (db::compare_layouts (layout, layout_au, db::layout_diff::f_verbose, 0), true);
+
+  layout.refresh_pcell_variants (threads);
+  EXPECT_EQ (db::compare_layouts (layout, layout_au, db::layout_diff::f_verbose, 0), true);
+}
@@ -61,7 +61,7 @@ GDS2ReaderText::read (db::Layout &layout, const db::LoadLayoutOptions &options)
   db::GDS2ReaderOptions gds2_options = options.get_options<db::GDS2ReaderOptions> ();
   db::CommonReaderOptions common_options = options.get_options<db::CommonReaderOptions> ();
 
-  return basic_read (layout, common_options.layer_map, common_options.create_other_layers, common_options.enable_text_objects, common_options.enable_properties, false, gds2_options.box_mode);
+  return basic_read (layout, common_options.layer_map, common_options.create_other_layers, common_options.enable_text_objects, common_options.enable_properties, false, gds2_options.box_mode, common_options.pipeline_threads);
 }
 
 const LayerMap &
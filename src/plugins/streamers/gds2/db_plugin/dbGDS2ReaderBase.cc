@@ -84,7 +84,7 @@ GDS2ReaderBase::~GDS2ReaderBase ()
 }
 
 const LayerMap &
-GDS2ReaderBase::basic_read (db::Layout &layout, const LayerMap &layer_map, bool create_other_layers, bool enable_text_objects, bool enable_properties, bool allow_multi_xy_records, unsigned int box_mode)
+GDS2ReaderBase::basic_read (db::Layout &layout, const LayerMap &layer_map, bool create_other_layers, bool enable_text_objects, bool enable_properties, bool allow_multi_xy_records, unsigned int box_mode, unsigned int pipeline_threads)
 {
   m_layer_map = layer_map;
   m_layer_map.prepare (layout);
@@ -94,9 +94,16 @@ GDS2ReaderBase::basic_read (db::Layout &layout, const LayerMap &layer_map, bool
   m_allow_multi_xy_records = allow_multi_xy_records;
   m_box_mode = box_mode;
   m_create_layers = create_other_layers;
+  m_pipeline.set_threads (pipeline_threads);
 
   layout.start_changes ();
-  do_read (layout);
+  try {
+    do_read (layout);
+  } catch (...) {
+    //  the workers must not continue on a layout which may get discarded
+    m_pipeline.cancel ();
+    throw;
+  }
   layout.end_changes ();
 
   return m_layer_map;
@@ -355,8 +362,15 @@ GDS2ReaderBase::do_read (db::Layout &layout)
 
       db::Cell *cell = &layout.cell (cell_index);
 
+      //  a cell defined twice is reopened: the workers must be done with it before
+      if (m_pipeline.is_pending (*cell)) {
+        m_pipeline.wait ();
+      }
+
       std::map <tl::string, std::vector <std::string> >::const_iterator ctx = m_context_info.find (m_cellname);
       if (ctx != m_context_info.end ()) {
+        //  proxy recovery may update the layout, hence all cells need to be ready
+        m_pipeline.wait ();
         GDS2ReaderLayerMapping layer_mapping (this, &layout, m_create_layers);
         if (layout.recover_proxy_as (cell_index, ctx->second.begin (), ctx->second.end (), &layer_mapping)) {
           //  ignore everything in that cell since it is created by the import:
@@ -442,6 +456,11 @@ GDS2ReaderBase::do_read (db::Layout &layout)
         cell->prop_id (layout.properties_repository ().properties_id (cell_properties));
       }
 
+      //  the cell is complete now: sort the shapes in the background
+      if (cell) {
+        m_pipeline.cell_finished (*cell);
+      }
+
     }
 
     m_cellname = "";
@@ -453,6 +472,8 @@ GDS2ReaderBase::do_read (db::Layout &layout)
   if (rec_id != sENDLIB) {
     error (tl::to_string (tr ("ENDLIB record expected")));
   }
+
+  m_pipeline.wait ();
 }
 
 void
@@ -29,6 +29,7 @@
 #include "dbLayout.h"
 #include "dbReader.h"
 #include "dbStreamLayers.h"
+#include "dbCommonReader.h"
 
 #include "tlException.h"
 #include "tlInternational.h"
@@ -86,9 +87,10 @@ protected:
    *  @param enable_properties A flag indicating whether to read user properties
    *  @param allow_multi_xy_records If true, tries to check for multiple XY records for BOUNDARY elements
    *  @param box_mode How to treat BOX records (0: ignore, 1: as rectangles, 2: as boundaries, 3: error)
+   *  @param pipeline_threads The number of threads used for preparing finished cells while reading (0: none)
    *  @return The LayerMap object that tells where which layer was loaded
    */
-  const LayerMap &basic_read (db::Layout &layout, const LayerMap &layer_map, bool create_other_layers, bool enable_text_objects, bool enable_properties, bool allow_multi_xy_records, unsigned int box_mode);
+  const LayerMap &basic_read (db::Layout &layout, const LayerMap &layer_map, bool create_other_layers, bool enable_text_objects, bool enable_properties, bool allow_multi_xy_records, unsigned int box_mode, unsigned int pipeline_threads = 0);
 
   /**
    *  @brief Accessor method to the current cellname
@@ -110,6 +112,7 @@ private:
   std::map <tl::string, std::vector<std::string> > m_context_info;
   std::vector <db::Point> m_all_points;
   std::map <tl::string, tl::string> m_mapped_cellnames;
+  db::CellPreparationPipeline m_pipeline;
 
   void read_context_info_cell ();
   void read_boundary (db::Layout &layout, db::Cell &cell, bool from_box_record);
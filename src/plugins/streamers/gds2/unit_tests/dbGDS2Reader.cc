@@ -22,6 +22,7 @@
 
 #include "dbGDS2Reader.h"
 #include "dbLayoutDiff.h"
+#include "dbCommonReader.h"
 #include "dbTestSupport.h"
 #include "tlUnitTest.h"
 #include "tlStream.h"
@@ -391,6 +392,50 @@ TEST(Bug_121_2)
   db::compare_layouts (_this, layout, fn_au, db::WriteGDS2, 1);
 }
 
+//  Sorting finished cells in the background while reading
+
+TEST(4_Pipeline)
+{
+  db::Manager m (false);
+
+  db::Layout layout_ref (&m);
+  {
+    tl::InputStream file (tl::testsrc () + "/testdata/gds/alm.gds");
+    db::Reader reader (file);
+    reader.read (layout_ref);
+  }
+
+  db::LoadLayoutOptions options;
+  options.get_options<db::CommonReaderOptions> ().pipeline_threads = 4;
+
+  db::Layout layout (&m);
+  {
+    tl::InputStream file (tl::testsrc () + "/testdata/gds/alm.gds");
+    db::Reader reader (file);
+    reader.read (layout, options);
+  }
+
+  EXPECT_EQ (db::compare_layouts (layout, layout_ref, db::layout_diff::f_verbose, 0), true);
+
+  //  PCell context information requires waiting for the workers
+  db::Layout layout2 (&m);
+
+  {
+    tl::InputStream file (tl::testsrc () + "/testdata/gds/bug_121a.gds");
+    db::Reader reader (file);
+    reader.read (layout2, options);
+  }
+
+  {
+    tl::InputStream file (tl::testsrc () + "/testdata/gds/bug_121b.gds");
+    db::Reader reader (file);
+    reader.read (layout2, options);
+  }
+
+  std::string fn_au (tl::testsrc () + "/testdata/gds/bug_121_au1.gds");
+  db::compare_layouts (_this, layout2, fn_au, db::WriteGDS2, 1);
+}
+
 TEST(3_AdvancedMapping)
 {
   db::Manager m (false);
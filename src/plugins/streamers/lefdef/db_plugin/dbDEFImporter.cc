@@ -24,6 +24,7 @@
 #include "dbDEFImporter.h"
 #include "dbPolygonTools.h"
 #include "tlGlobPattern.h"
+#include "tlThreadedWorkers.h"
 
 #include <cmath>
 
@@ -136,6 +137,222 @@ struct Group
   std::vector<tl::GlobPattern> comp_match;
 };
 
+namespace
+{
+
+/**
+ *  @brief A wire collected from the NETS or SPECIALNETS section
+ *
+ *  "style" is either 0 (default style) or points to the STYLES polygon.
+ */
+struct DEFWire
+{
+  DEFWire ()
+    : layer (0), width (0), ext (0), style (0), prop_id (0)
+  { }
+
+  unsigned int layer;
+  db::Coord width, ext;
+  std::vector<db::Point> pts;
+  const db::Polygon *style;
+  db::properties_id_type prop_id;
+};
+
+/**
+ *  @brief The geometry produced from a sequence of wires
+ */
+struct DEFWireShapes
+{
+  std::vector<std::pair<unsigned int, db::object_with_properties<db::Path> > > paths;
+  std::vector<std::pair<unsigned int, db::object_with_properties<db::Polygon> > > polygons;
+
+  void insert (db::Cell &cell) const
+  {
+    for (std::vector<std::pair<unsigned int, db::object_with_properties<db::Path> > >::const_iterator p = paths.begin (); p != paths.end (); ++p) {
+      if (p->second.properties_id () != 0) {
+        cell.shapes (p->first).insert (p->second);
+      } else {
+        cell.shapes (p->first).insert (db::Path (p->second));
+      }
+    }
+    for (std::vector<std::pair<unsigned int, db::object_with_properties<db::Polygon> > >::const_iterator p = polygons.begin (); p != polygons.end (); ++p) {
+      if (p->second.properties_id () != 0) {
+        cell.shapes (p->first).insert (p->second);
+      } else {
+        cell.shapes (p->first).insert (db::Polygon (p->second));
+      }
+    }
+  }
+};
+
+/**
+ *  @brief Produces the geometry for a wire
+ *
+ *  "octagons" caches the octagon "pen" per width.
+ */
+static void
+produce_wire_shapes (const DEFWire &wire, DEFWireShapes &shapes, std::map<db::Coord, db::Polygon> &octagons)
+{
+  const std::vector<db::Point> &pts = wire.pts;
+  db::Coord w = wire.width;
+  db::Coord e = wire.ext;
+
+  if (! wire.style) {
+
+    //  Use the default style (octagon "pen" for non-manhattan segments, paths for
+    //  horizontal/vertical segments).
+
+    std::vector<db::Point>::const_iterator pt = pts.begin ();
+    while (pt != pts.end ()) {
+
+      std::vector<db::Point>::const_iterator pt0 = pt;
+      do {
+        ++pt;
+      } while (pt != pts.end () && (pt[-1].x () == pt[0].x () || pt[-1].y () == pt[0].y()));
+
+      if (pt - pt0 > 1) {
+
+        db::Path p (pt0, pt, w, pt0 == pts.begin () ? e : 0, pt == pts.end () ? e : 0, false);
+        shapes.paths.push_back (std::make_pair (wire.layer, db::object_with_properties<db::Path> (p, wire.prop_id)));
+
+        if (pt == pts.end ()) {
+          break;
+        }
+
+        --pt;
+
+      } else if (pt != pts.end ()) {
+
+        std::map<db::Coord, db::Polygon>::iterator k = octagons.find (w);
+        if (k == octagons.end ()) {
+
+          db::Coord s = (w + 1) / 2;
+          db::Coord t = db::Coord (ceil (w * (M_SQRT2 - 1) / 2));
+
+          db::Point octagon[8] = {
+            db::Point (-s, t),
+            db::Point (-t, s),
+            db::Point (t, s),
+            db::Point (s, t),
+            db::Point (s, -t),
+            db::Point (t, -s),
+            db::Point (-t, -s),
+            db::Point (-s, -t)
+          };
+
+          k = octagons.insert (std::make_pair (w, db::Polygon ())).first;
+          k->second.assign_hull (octagon, octagon + sizeof (octagon) / sizeof (octagon[0]));
+
+        }
+
+        db::Polygon p = db::minkowsky_sum (k->second, db::Edge (*pt0, *pt));
+        shapes.polygons.push_back (std::make_pair (wire.layer, db::object_with_properties<db::Polygon> (p, wire.prop_id)));
+
+      }
+
+    }
+
+  } else {
+
+    for (size_t i = 0; i < pts.size () - 1; ++i) {
+      db::Polygon p = db::minkowsky_sum (*wire.style, db::Edge (pts [i], pts [i + 1]));
+      shapes.polygons.push_back (std::make_pair (wire.layer, db::object_with_properties<db::Polygon> (p, wire.prop_id)));
+    }
+
+  }
+}
+
+class DEFWireTask
+  : public tl::Task
+{
+public:
+  DEFWireTask (std::vector<DEFWire>::const_iterator from, std::vector<DEFWire>::const_iterator to, DEFWireShapes *shapes)
+    : m_from (from), m_to (to), mp_shapes (shapes)
+  { }
+
+  void produce () const
+  {
+    std::map<db::Coord, db::Polygon> octagons;
+    for (std::vector<DEFWire>::const_iterator w = m_from; w != m_to; ++w) {
+      produce_wire_shapes (*w, *mp_shapes, octagons);
+    }
+  }
+
+private:
+  std::vector<DEFWire>::const_iterator m_from, m_to;
+  DEFWireShapes *mp_shapes;
+};
+
+class DEFWireWorker
+  : public tl::Worker
+{
+public:
+  DEFWireWorker ()
+    : tl::Worker ()
+  { }
+
+  virtual void perform_task (tl::Task *task)
+  {
+    DEFWireTask *wt = dynamic_cast<DEFWireTask *> (task);
+    tl_assert (wt != 0);
+    wt->produce ();
+  }
+};
+
+/**
+ *  @brief Produces the geometry for the given wires and clears the wire list
+ *
+ *  With "threads" > 0, the wires are processed in chunks by worker threads. The
+ *  shapes are inserted in the order of the wires in any case.
+ */
+static void
+produce_wires (std::vector<DEFWire> &wires, db::Cell &cell, unsigned int threads)
+{
+  if (wires.empty ()) {
+    return;
+  }
+
+  if (threads == 0) {
+
+    DEFWireShapes shapes;
+    DEFWireTask (wires.begin (), wires.end (), &shapes).produce ();
+    shapes.insert (cell);
+
+  } else {
+
+    const size_t chunk_size = 1000;
+    std::vector<DEFWireShapes> shapes ((wires.size () + chunk_size - 1) / chunk_size);
+
+    tl::Job<DEFWireWorker> job (threads);
+    for (size_t i = 0; i < shapes.size (); ++i) {
+      std::vector<DEFWire>::const_iterator from = wires.begin () + i * chunk_size;
+      std::vector<DEFWire>::const_iterator to = wires.begin () + std::min (wires.size (), (i + 1) * chunk_size);
+      job.schedule (new DEFWireTask (from, to, &shapes [i]));
+    }
+
+    try {
+      job.start ();
+      job.wait ();
+    } catch (...) {
+      job.terminate ();
+      throw;
+    }
+
+    if (job.has_error ()) {
+      throw tl::Exception (job.error_messages ().front ());
+    }
+
+    for (std::vector<DEFWireShapes>::const_iterator s = shapes.begin (); s != shapes.end (); ++s) {
+      s->insert (cell);
+    }
+
+  }
+
+  wires.clear ();
+}
+
+}
+
 void 
 DEFImporter::do_read (db::Layout &layout)
 {
@@ -426,6 +643,11 @@ DEFImporter::do_read (db::Layout &layout)
       get_long ();
       expect (";");
 
+      //  wires are collected and turned into geometry in batches
+      const size_t max_pending_wires = 100000;
+      unsigned int threads = options () ? options ()->threads () : 0;
+      std::vector<DEFWire> wires;
+
       while (test ("-")) {
 
         std::string net = get ();
@@ -638,81 +860,18 @@ DEFImporter::do_read (db::Layout &layout)
                     std::pair <bool, unsigned int> dl = open_layer (layout, ln, Routing);
                     if (dl.first) {
 
-                      if (! style) {
-
-                        //  Use the default style (octagon "pen" for non-manhattan segments, paths for 
-                        //  horizontal/vertical segments).
-
-                        db::Coord e = std::max (ext.front (), ext.back ());
-
-                        std::vector<db::Point>::const_iterator pt = pts.begin ();
-                        while (pt != pts.end ()) {
-
-                          std::vector<db::Point>::const_iterator pt0 = pt;
-                          do {
-                            ++pt;
-                          } while (pt != pts.end () && (pt[-1].x () == pt[0].x () || pt[-1].y () == pt[0].y()));
-
-                          if (pt - pt0 > 1) {
-
-                            db::Path p (pt0, pt, w, pt0 == pts.begin () ? e : 0, pt == pts.end () ? e : 0, false);
-                            if (prop_id != 0) {
-                              design.shapes (dl.second).insert (db::object_with_properties<db::Path> (p, prop_id));
-                            } else {
-                              design.shapes (dl.second).insert (p);
-                            }
-
-                            if (pt == pts.end ()) {
-                              break;
-                            }
-
-                            --pt;
-
-                          } else if (pt != pts.end ()) {
-
-                            db::Coord s = (w + 1) / 2;
-                            db::Coord t = db::Coord (ceil (w * (M_SQRT2 - 1) / 2));
-
-                            db::Point octagon[8] = {
-                              db::Point (-s, t),
-                              db::Point (-t, s),
-                              db::Point (t, s),
-                              db::Point (s, t),
-                              db::Point (s, -t),
-                              db::Point (t, -s),
-                              db::Point (-t, -s),
-                              db::Point (-s, -t)
-                            };
-
-                            db::Polygon k;
-                            k.assign_hull (octagon, octagon + sizeof (octagon) / sizeof (octagon[0]));
-
-                            db::Polygon p = db::minkowsky_sum (k, db::Edge (*pt0, *pt));
-                            if (prop_id != 0) {
-                              design.shapes (dl.second).insert (db::object_with_properties<db::Polygon> (p, prop_id));
-                            } else {
-                              design.shapes (dl.second).insert (p);
-                            }
-
-                          }
-
-                        }
-
-                      } else {
-
-                        for (size_t i = 0; i < pts.size () - 1; ++i) {
-                          db::Polygon p = db::minkowsky_sum (*style, db::Edge (pts [i], pts [i + 1]));
-                          if (prop_id != 0) {
-                            design.shapes (dl.second).insert (db::object_with_properties<db::Polygon> (p, prop_id));
-                          } else {
-                            design.shapes (dl.second).insert (p);
-                          }
-                        }
-
-                      }
+                      //  the geometry is produced later, potentially in parallel (see produce_wires)
+                      wires.push_back (DEFWire ());
+                      DEFWire &wire = wires.back ();
+                      wire.layer = dl.second;
+                      wire.width = w;
+                      wire.ext = std::max (ext.front (), ext.back ());
+                      wire.pts = pts;
+                      wire.style = style;
+                      wire.prop_id = prop_id;
 
                     }
-                    
+
                   }
 
                 } else if (! peek ("NEW") && ! peek ("+") && ! peek ("-") && ! peek (";")) {
@@ -794,8 +953,14 @@ DEFImporter::do_read (db::Layout &layout)
 
         expect (";");
 
+        if (wires.size () >= max_pending_wires) {
+          produce_wires (wires, design, threads);
+        }
+
       }
 
+      produce_wires (wires, design, threads);
+
       test ("END");
       if (specialnets) {
         test ("SPECIALNETS");
@@ -66,7 +66,8 @@ LEFDEFReaderOptions::LEFDEFReaderOptions ()
     m_labels_datatype (1),
     m_produce_routing (true),
     m_routing_suffix (""),
-    m_routing_datatype (0)
+    m_routing_datatype (0),
+    m_threads (0)
 {
   //  .. nothing yet ..
 }
@@ -115,6 +116,7 @@ LEFDEFReaderOptions &LEFDEFReaderOptions::operator= (const LEFDEFReaderOptions &
     m_routing_suffix = d.m_routing_suffix;
     m_routing_datatype = d.m_routing_datatype;
     m_lef_files = d.m_lef_files;
+    m_threads = d.m_threads;
   }
   return *this;
 }
@@ -463,7 +465,7 @@ LEFDEFImporter::at_end ()
 }
 
 bool  
-LEFDEFImporter::peek (const std::string &token)
+LEFDEFImporter::peek (const char *token)
 {
   if (m_last_token.empty ()) {
     if (next ().empty ()) {
@@ -472,7 +474,7 @@ LEFDEFImporter::peek (const std::string &token)
   }
 
   const char *a = m_last_token.c_str ();
-  const char *b = token.c_str ();
+  const char *b = token;
   while (*a && *b) {
     if (std::toupper (*a) != std::toupper (*b)) {
       return false;
@@ -483,7 +485,7 @@ LEFDEFImporter::peek (const std::string &token)
 }
 
 bool  
-LEFDEFImporter::test (const std::string &token)
+LEFDEFImporter::test (const char *token)
 {
   if (peek (token)) {
     //  consume when successful
@@ -495,10 +497,10 @@ LEFDEFImporter::test (const std::string &token)
 }
 
 void  
-LEFDEFImporter::expect (const std::string &token)
+LEFDEFImporter::expect (const char *token)
 {
   if (! test (token)) {
-    error ("Expected token: " + token);
+    error ("Expected token: " + std::string (token));
   }
 }
 
@@ -436,6 +436,16 @@ public:
     m_lef_files = lf;
   }
 
+  unsigned int threads () const
+  {
+    return m_threads;
+  }
+
+  void set_threads (unsigned int n)
+  {
+    m_threads = n;
+  }
+
 private:
   bool m_read_all_layers;
   db::LayerMap m_layer_map;
@@ -471,6 +481,7 @@ private:
   std::string m_routing_suffix;
   int m_routing_datatype;
   std::vector<std::string> m_lef_files;
+  unsigned int m_threads;
 };
 
 /**
@@ -623,17 +634,43 @@ protected:
   /**
    *  @brief Test whether the next token matches the given one and consume it in that case
    */
-  bool test (const std::string &token);
+  bool test (const std::string &token)
+  {
+    return test (token.c_str ());
+  }
+
+  /**
+   *  @brief Test whether the next token matches the given one and consume it in that case
+   *
+   *  This version avoids the construction of a temporary string for literal tokens.
+   */
+  bool test (const char *token);
+
+  /**
+   *  @brief Test whether the next token matches the given one, but don't consume it
+   */
+  bool peek (const std::string &token)
+  {
+    return peek (token.c_str ());
+  }
 
   /**
    *  @brief Test whether the next token matches the given one, but don't consume it
    */
-  bool peek (const std::string &token);
+  bool peek (const char *token);
 
   /**
    *  @brief Test whether the next token matches the given one and raise an error if it does not
    */
-  void expect (const std::string &token);
+  void expect (const std::string &token)
+  {
+    expect (token.c_str ());
+  }
+
+  /**
+   *  @brief Test whether the next token matches the given one and raise an error if it does not
+   */
+  void expect (const char *token);
 
   /**
    *  @brief Gets the next token
@@ -687,6 +724,14 @@ protected:
     m_cellname.clear ();
   }
 
+  /**
+   *  @brief Gets the reader options (may be 0)
+   */
+  const LEFDEFReaderOptions *options () const
+  {
+    return mp_layer_delegate ? mp_layer_delegate->tech_comp () : 0;
+  }
+
   /**
    *  @brief Gets a flag indicating whether net names shall be produced as properties
    */
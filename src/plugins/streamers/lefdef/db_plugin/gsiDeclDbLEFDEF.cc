@@ -390,6 +390,20 @@ gsi::Class<db::LEFDEFReaderOptions> decl_lefdef_config ("db", "LEFDEFReaderConfi
   gsi::method ("lef_files=", &db::LEFDEFReaderOptions::set_lef_files,
     "@brief Sets the list technology LEF files to additionally import\n"
     "See \\lef_files for details."
+  ) +
+  gsi::method ("threads", &db::LEFDEFReaderOptions::threads,
+    "@brief Gets the number of worker threads used for producing the routing geometry of DEF files\n"
+    "See \\threads= for details.\n"
+    "\n"
+    "This property has been introduced in version 0.27."
+  ) +
+  gsi::method ("threads=", &db::LEFDEFReaderOptions::set_threads, gsi::arg ("n"),
+    "@brief Sets the number of worker threads used for producing the routing geometry of DEF files\n"
+    "The DEF reader collects the wires of the NETS and SPECIALNETS sections and converts them into "
+    "paths and polygons in chunks. With a thread count larger than zero, the chunks are converted by "
+    "worker threads. The result does not depend on the number of threads. The default is 0 (no worker threads).\n"
+    "\n"
+    "This property has been introduced in version 0.27."
   ),
   "@brief Detailed LEF/DEF reader options\n"
   "This class is a aggregate belonging to the \\LoadLayoutOptions class. It provides options for the LEF/DEF reader. "
@@ -265,3 +265,63 @@ TEST(23)
   run_test (_this, "issue-517", "def:in.def", "au.oas.gz", default_options (), false);
 }
 
+
+static void read_def_with_threads (const std::string &fn, db::Layout &layout, unsigned int threads)
+{
+  db::LEFDEFReaderOptions tc = default_options ();
+  tc.set_threads (threads);
+
+  db::LEFDEFLayerDelegate ld (&tc);
+  ld.prepare (layout);
+
+  db::DEFImporter imp;
+  tl::InputStream stream (fn);
+  imp.read (stream, layout, ld);
+
+  ld.finish (layout);
+}
+
+//  multi-threaded wire production
+TEST(24)
+{
+  std::string fn = tmp_file ("in.def");
+
+  {
+    tl::OutputStream os (fn);
+    os << "VERSION 5.8 ;\n"
+          "DESIGN threads ;\n"
+          "UNITS DISTANCE MICRONS 1000 ;\n"
+          "DIEAREA ( 0 0 ) ( 1000000 1000000 ) ;\n"
+          "STYLES 1 ;\n"
+          "- STYLE 1 ( 30 10 ) ( 10 30 ) ( -10 30 ) ( -30 10 ) ( -30 -10 ) ( -10 -30 ) ( 10 -30 ) ( 30 -10 ) ;\n"
+          "END STYLES\n";
+    os << "SPECIALNETS 2500 ;\n";
+    for (int i = 0; i < 2500; ++i) {
+      int x = (i % 50) * 2000, y = (i / 50) * 2000;
+      os << "- net" << tl::to_string (i) << " + ROUTED M1 " << tl::to_string (100 + (i % 7) * 10)
+         << " ( " << tl::to_string (x) << " " << tl::to_string (y) << " ) ( " << tl::to_string (x + 1000) << " * ) ( * " << tl::to_string (y + 1000) << " )"
+         << " NEW M2 50 ( " << tl::to_string (x) << " " << tl::to_string (y) << " ) ( " << tl::to_string (x + 500) << " " << tl::to_string (y + 300) << " ) ( * " << tl::to_string (y + 1500) << " )"
+         << " NEW M3 20 + STYLE 1 ( " << tl::to_string (x) << " " << tl::to_string (y) << " ) ( " << tl::to_string (x + 700) << " " << tl::to_string (y + 900) << " ) ;\n";
+    }
+    os << "END SPECIALNETS\n"
+          "END DESIGN\n";
+  }
+
+  db::Layout layout, layout_mt;
+  read_def_with_threads (fn, layout, 0);
+  read_def_with_threads (fn, layout_mt, 3);
+
+  unsigned int n = 0;
+  for (db::Layout::layer_iterator l = layout.begin_layers (); l != layout.end_layers (); ++l) {
+    n += (unsigned int) layout.cell (*layout.begin_top_down ()).shapes ((*l).first).size ();
+  }
+  //  4 shapes per net plus the die area
+  EXPECT_EQ (n, 2500u * 4u + 1u);
+
+  EXPECT_EQ (db::compare_layouts (layout, layout_mt, db::layout_diff::f_verbose, 0), true);
+
+  //  the existing test data gives the same result with threads
+  db::LEFDEFReaderOptions opt = default_options ();
+  opt.set_threads (2);
+  run_test (_this, "issue-172", "lef:in.lef+def:in.def", "au.oas.gz", opt, false);
+}
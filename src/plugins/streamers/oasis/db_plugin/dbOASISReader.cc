@@ -143,12 +143,15 @@ OASISReader::read (db::Layout &layout, const db::LoadLayoutOptions &options)
   m_create_layers = common_options.create_other_layers;
   m_read_all_properties = oasis_options.read_all_properties;
   m_expect_strict_mode = oasis_options.expect_strict_mode;
+  m_pipeline.set_threads (common_options.pipeline_threads);
 
   layout.start_changes ();
   try {
     do_read (layout);
     layout.end_changes ();
   } catch (...) {
+    //  the workers must not continue on a layout which may get discarded
+    m_pipeline.cancel ();
     layout.end_changes ();
     throw;
   }
@@ -1215,6 +1218,9 @@ OASISReader::do_read (db::Layout &layout)
 
       do_read_cell (cell_index, layout);
 
+      //  the cell is complete now: sort the shapes in the background
+      m_pipeline.cell_finished (layout.cell (cell_index));
+
     } else if (r == 34 /*CBLOCK*/) {
 
       unsigned int type = get_uint ();
@@ -1234,6 +1240,9 @@ OASISReader::do_read (db::Layout &layout)
 
   }
 
+  //  the post-processing below modifies cells, hence the workers must be done
+  m_pipeline.wait ();
+
   if (! layout_properties.empty ()) {
     layout.prop_id (layout.properties_repository ().properties_id (layout_properties));
     layout_properties.clear ();
@@ -3575,6 +3584,8 @@ OASISReader::do_read_cell (db::cell_index_type cell_index, db::Layout &layout)
 
   //  Restore proxy cell (link to PCell or Library)
   if (has_context) {
+    //  proxy recovery may update the layout, hence all cells need to be ready
+    m_pipeline.wait ();
     OASISReaderLayerMapping layer_mapping (this, &layout, m_create_layers);
     layout.recover_proxy_as (cell_index, context_strings.begin (), context_strings.end (), &layer_mapping);
   }
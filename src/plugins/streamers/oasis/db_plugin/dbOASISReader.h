@@ -33,6 +33,7 @@
 #include "dbOASISFormat.h"
 #include "dbStreamLayers.h"
 #include "dbPropertiesRepository.h"
+#include "dbCommonReader.h"
 
 #include "tlException.h"
 #include "tlInternational.h"
@@ -198,6 +199,7 @@ private:
   std::map <unsigned long, db::properties_id_type> m_cellname_properties;
   std::map <unsigned long, std::string> m_textstrings;
   std::map <unsigned long, const db::StringRef *> m_text_forward_references;
+  db::CellPreparationPipeline m_pipeline;
   std::map <unsigned long, std::string> m_propstrings;
   std::map <unsigned long, std::string> m_propnames;
   tl::interval_map <db::ld_type, tl::interval_map <db::ld_type, std::string> > m_layernames;
@@ -22,7 +22,10 @@
 
 
 #include "dbOASISReader.h"
+#include "dbOASISWriter.h"
 #include "dbTextWriter.h"
+#include "dbCommonReader.h"
+#include "dbLayoutDiff.h"
 #include "dbTestSupport.h"
 #include "tlLog.h"
 #include "tlUnitTest.h"
@@ -579,3 +582,113 @@ TEST(Bug_121_2)
   std::string fn_au (tl::testsrc () + "/testdata/oasis/bug_121_au2.gds");
   db::compare_layouts (_this, layout, fn_au, db::WriteGDS2, 1);
 }
+
+//  Sorting finished cells in the background while reading
+
+TEST(Pipeline)
+{
+  db::Manager m (false);
+
+  db::LoadLayoutOptions options;
+  options.get_options<db::CommonReaderOptions> ().pipeline_threads = 4;
+
+  const char *files[] = { "t5.2.oas", "xgeometry_test.oas" };
+
+  for (size_t i = 0; i < sizeof (files) / sizeof (files [0]); ++i) {
+
+    db::Layout layout_ref (&m);
+    {
+      tl::InputStream file (tl::testsrc () + "/testdata/oasis/" + files [i]);
+      db::OASISReader reader (file);
+      reader.read (layout_ref);
+    }
+
+    db::Layout layout (&m);
+    {
+      tl::InputStream file (tl::testsrc () + "/testdata/oasis/" + files [i]);
+      db::OASISReader reader (file);
+      reader.read (layout, options);
+    }
+
+    EXPECT_EQ (db::compare_layouts (layout, layout_ref, db::layout_diff::f_verbose, 0), true);
+
+  }
+
+  //  PCell context information requires waiting for the workers
+  db::Layout layout (&m);
+
+  {
+    tl::InputStream file (tl::testsrc () + "/testdata/oasis/bug_121a.oas");
+    db::OASISReader reader (file);
+    reader.read (layout, options);
+  }
+
+  {
+    tl::InputStream file (tl::testsrc () + "/testdata/oasis/bug_121b.oas");
+    db::OASISReader reader (file);
+    reader.read (layout, options);
+  }
+
+  std::string fn_au (tl::testsrc () + "/testdata/oasis/bug_121_au1.gds");
+  db::compare_layouts (_this, layout, fn_au, db::WriteGDS2, 1);
+}
+
+//  Texts with forward-referenced TEXTSTRINGs share their strings across cells:
+//  the pipeline must not copy them while the parser continues
+
+TEST(Pipeline_ForwardTextStrings)
+{
+  db::Manager m (false);
+
+  db::Layout layout_org (false, &m);
+  unsigned int l1 = layout_org.insert_layer (db::LayerProperties (1, 0));
+  unsigned int l2 = layout_org.insert_layer (db::LayerProperties (2, 0));
+
+  db::Cell &top = layout_org.cell (layout_org.add_cell ("TOP"));
+  for (int c = 0; c < 100; ++c) {
+    db::Cell &cell = layout_org.cell (layout_org.add_cell (("C" + tl::to_string (c)).c_str ()));
+    for (int i = 0; i < 500; ++i) {
+      cell.shapes (l1).insert (db::Text ("T" + tl::to_string (i % 10), db::Trans (db::Vector (i * 10, (i * 7) % 1000))));
+      cell.shapes (l2).insert (db::Box (i * 10, 0, i * 10 + 5, 5 + i % 100));
+    }
+    top.insert (db::CellInstArray (db::CellInst (cell.cell_index ()), db::Trans (db::Vector (0, c * 2000))));
+  }
+
+  std::string tmp_file = _this->tmp_file ("tmp_fwd_textstrings.oas");
+
+  {
+    //  strict mode writes the TEXTSTRING table at the end of the file
+    tl::OutputStream stream (tmp_file);
+    db::OASISWriter writer;
+    db::SaveLayoutOptions options;
+    db::OASISWriterOptions oasis_options;
+    oasis_options.strict_mode = true;
+    options.set_options (oasis_options);
+    writer.write (layout_org, stream, options);
+  }
+
+  db::Layout layout_ref (false, &m);
+  {
+    tl::InputStream file (tmp_file);
+    db::OASISReader reader (file);
+    reader.read (layout_ref);
+  }
+
+  EXPECT_EQ (db::compare_layouts (layout_ref, layout_org, db::layout_diff::f_verbose, 0), true);
+
+  db::LoadLayoutOptions options;
+  options.get_options<db::CommonReaderOptions> ().pipeline_threads = 4;
+
+  for (int n = 0; n < 5; ++n) {
+
+    db::Layout layout (false, &m);
+    {
+      tl::InputStream file (tmp_file);
+      db::OASISReader reader (file);
+      reader.read (layout, options);
+    }
+
+    EXPECT_EQ (db::compare_layouts (layout, layout_ref, db::layout_diff::f_verbose, 0), true);
+
+  }
+}
@@ -389,6 +389,105 @@ NetTracerData::configure_l2n (db::LayoutToNetlist &l2n)
   }
 }
 
+std::map<unsigned int, const db::Region *>
+NetTracerData::l2n_regions () const
+{
+  std::map<unsigned int, const db::Region *> regions;
+  for (std::map<unsigned int, tl::shared_ptr<NetTracerLayerExpression::RegionHolder> >::const_iterator r = m_l2n_regions.begin (); r != m_l2n_regions.end (); ++r) {
+    regions.insert (std::make_pair (r->first, r->second->get ()));
+  }
+  return regions;
+}
+
+// -----------------------------------------------------------------------------------
+//  NetTracerClusters implementation
+
+NetTracerClusters::NetTracerClusters ()
+  : mp_layout (0), m_cell_index (0)
+{
+  //  .. nothing yet ..
+}
+
+NetTracerClusters::~NetTracerClusters ()
+{
+  clear ();
+}
+
+void
+NetTracerClusters::clear ()
+{
+  //  release the regions and texts before the LayoutToNetlist object they live in
+  mp_data.reset (0);
+  for (std::vector<db::Texts *>::const_iterator t = m_texts.begin (); t != m_texts.end (); ++t) {
+    delete *t;
+  }
+  m_texts.clear ();
+  mp_l2n.reset (0);
+  mp_layout = 0;
+  m_cell_index = 0;
+  m_log_layer_for_internal_layer.clear ();
+  m_cell_map.clear ();
+}
+
+void
+NetTracerClusters::build (const db::Layout &layout, const db::Cell &cell, const NetTracerData &data, int threads)
+{
+  clear ();
+
+  tl::SelfTimer timer (tl::verbosity () >= 11, tl::to_string (tr ("Building net tracer clusters")));
+
+  mp_l2n.reset (new db::LayoutToNetlist (db::RecursiveShapeIterator (layout, cell, std::vector<unsigned int> ())));
+  mp_l2n->set_threads (threads);
+
+  //  configure_l2n keeps the regions inside the data object, so we use our own copy
+  mp_data.reset (new NetTracerData (data));
+
+  try {
+
+    mp_data->configure_l2n (*mp_l2n);
+
+    std::map<unsigned int, const db::Region *> regions = mp_data->l2n_regions ();
+
+    //  attach the labels of the original layers, so the nets get named like in the flat trace
+    std::map<unsigned int, db::Texts *> texts;
+    for (std::map<unsigned int, const db::Region *>::const_iterator r = regions.begin (); r != regions.end (); ++r) {
+      std::set<unsigned int> ol = mp_data->expression (r->first).original_layers ();
+      for (std::set<unsigned int>::const_iterator o = ol.begin (); o != ol.end (); ++o) {
+        if (layout.is_valid_layer (*o)) {
+          std::map<unsigned int, db::Texts *>::iterator t = texts.find (*o);
+          if (t == texts.end ()) {
+            m_texts.push_back (mp_l2n->make_text_layer (*o));
+            t = texts.insert (std::make_pair (*o, m_texts.back ())).first;
+          }
+          mp_l2n->connect (*r->second, *t->second);
+        }
+      }
+    }
+
+    mp_l2n->extract_netlist ();
+
+    for (std::map<unsigned int, const db::Region *>::const_iterator r = regions.begin (); r != regions.end (); ++r) {
+      m_log_layer_for_internal_layer.insert (std::make_pair (mp_l2n->layer_of (*r->second), r->first));
+    }
+
+    //  map the cells of the internal layout back to the original ones
+    db::CellMapping cm = mp_l2n->const_cell_mapping_into (layout, cell);
+    const db::Layout &internal_layout = *mp_l2n->internal_layout ();
+    for (db::Layout::const_iterator c = internal_layout.begin (); c != internal_layout.end (); ++c) {
+      if (cm.has_mapping (c->cell_index ())) {
+        m_cell_map.insert (std::make_pair (c->cell_index (), cm.cell_mapping (c->cell_index ())));
+      }
+    }
+
+  } catch (...) {
+    clear ();
+    throw;
+  }
+
+  mp_layout = &layout;
+  m_cell_index = cell.cell_index ();
+}
+
 // -----------------------------------------------------------------------------------
 //  NetTracerLayerExpression implementation
 
@@ -913,6 +1012,159 @@ NetTracer::trace (const db::Layout &layout, const db::Cell &cell, const db::Poin
   m_shapes_graph.clear ();
 }
 
+/**
+ *  @brief Finds the cluster touching the test cluster in the given cell or below
+ *
+ *  Returns the cluster ID or 0 if no cluster is found. "rev_inst_path" receives the
+ *  instance path to the cell of the cluster in reverse order.
+ */
+static size_t
+find_cluster (const db::LayoutToNetlist &l2n, const db::ICplxTrans &trans, const db::Cell &cell, const db::local_cluster<db::NetShape> &test_cluster, std::vector<db::InstElement> &rev_inst_path)
+{
+  db::Box local_box = trans * test_cluster.bbox ();
+
+  const db::local_clusters<db::NetShape> &lcc = l2n.net_clusters ().clusters_per_cell (cell.cell_index ());
+  for (db::local_clusters<db::NetShape>::touching_iterator i = lcc.begin_touching (local_box); ! i.at_end (); ++i) {
+    if (i->interacts (test_cluster, trans, l2n.connectivity ())) {
+      return i->id ();
+    }
+  }
+
+  const db::Layout &layout = *l2n.internal_layout ();
+
+  for (db::Cell::touching_iterator i = cell.begin_touching (local_box); ! i.at_end (); ++i) {
+    for (db::CellInstArray::iterator ia = i->begin_touching (local_box, &layout); ! ia.at_end (); ++ia) {
+      db::ICplxTrans t = i->complex_trans (*ia).inverted () * trans;
+      size_t cluster_id = find_cluster (l2n, t, layout.cell (i->cell_index ()), test_cluster, rev_inst_path);
+      if (cluster_id > 0) {
+        rev_inst_path.push_back (db::InstElement (*i, ia));
+        return cluster_id;
+      }
+    }
+  }
+
+  return 0;
+}
+
+void
+NetTracer::trace (const NetTracerClusters &clusters, const db::Point &pt_start, unsigned int l_start)
+{
+  tl_assert (clusters.is_valid ());
+
+  mp_layout = &clusters.layout ();
+  mp_cell = &clusters.cell ();
+
+  m_shapes_graph.clear ();
+  m_shapes_found.clear ();
+  m_name.clear ();
+  m_name_hier_depth = -1;
+  m_incomplete = false;
+
+  tl::SelfTimer timer (tl::verbosity () >= 11, tl::to_string (tr ("Net Tracing (hierarchical)")));
+
+  const db::LayoutToNetlist &l2n = *clusters.mp_l2n;
+  const db::hier_clusters<db::NetShape> &hc = l2n.net_clusters ();
+  const db::Cell &top_cell = *l2n.internal_top_cell ();
+
+  std::map<unsigned int, unsigned int> internal_layer_for_log_layer;
+  for (std::map<unsigned int, unsigned int>::const_iterator l = clusters.m_log_layer_for_internal_layer.begin (); l != clusters.m_log_layer_for_internal_layer.end (); ++l) {
+    internal_layer_for_log_layer.insert (std::make_pair (l->second, l->first));
+  }
+
+  std::set<std::pair<db::cell_index_type, size_t> > roots_seen;
+
+  std::set<unsigned int> ll = clusters.data ().log_layers_for (l_start);
+  for (std::set<unsigned int>::const_iterator l = ll.begin (); l != ll.end (); ++l) {
+
+    std::map<unsigned int, unsigned int>::const_iterator il = internal_layer_for_log_layer.find (*l);
+    if (il == internal_layer_for_log_layer.end ()) {
+      continue;
+    }
+
+    //  locate the cluster at the seed point
+    db::GenericRepository sr;
+    db::local_cluster<db::NetShape> test_cluster;
+    test_cluster.add (db::PolygonRef (db::Polygon (db::Box (pt_start - db::Vector (1, 1), pt_start + db::Vector (1, 1))), sr), il->second);
+
+    std::vector<db::InstElement> inst_path;
+    size_t cluster_id = find_cluster (l2n, db::ICplxTrans (), top_cell, test_cluster, inst_path);
+    if (cluster_id == 0) {
+      continue;
+    }
+
+    std::reverse (inst_path.begin (), inst_path.end ());
+
+    std::vector<db::cell_index_type> cell_indexes;
+    cell_indexes.push_back (top_cell.cell_index ());
+    for (std::vector<db::InstElement>::const_iterator i = inst_path.begin (); i != inst_path.end (); ++i) {
+      cell_indexes.push_back (i->inst_ptr.cell_index ());
+    }
+
+    //  move up in the hierarchy as long as the cluster is connected to the parent
+    while (! inst_path.empty ()) {
+      db::ClusterInstance ci (cluster_id, inst_path.back ());
+      size_t parent_cluster_id = hc.clusters_per_cell (cell_indexes [cell_indexes.size () - 2]).find_cluster_with_connection (ci);
+      if (parent_cluster_id == 0) {
+        break;
+      }
+      cluster_id = parent_cluster_id;
+      inst_path.pop_back ();
+      cell_indexes.pop_back ();
+    }
+
+    db::cell_index_type root_cell = cell_indexes.back ();
+    if (! roots_seen.insert (std::make_pair (root_cell, cluster_id)).second) {
+      continue;
+    }
+
+    db::ICplxTrans root_trans;
+    for (std::vector<db::InstElement>::const_iterator i = inst_path.begin (); i != inst_path.end (); ++i) {
+      root_trans = root_trans * i->complex_trans ();
+    }
+
+    //  take the name from the topmost labelled part of the net
+    if (m_name.empty () && l2n.netlist ()) {
+      for (db::recursive_cluster_iterator<db::NetShape> rc (hc, root_cell, cluster_id); ! rc.at_end (); ++rc) {
+        int depth = int (rc.inst_path ().size ());
+        if (m_name_hier_depth >= 0 && depth >= m_name_hier_depth) {
+          continue;
+        }
+        const db::Circuit *circuit = l2n.netlist ()->circuit_by_cell_index (rc.cell_index ());
+        const db::Net *net = circuit ? circuit->net_by_cluster_id (rc.cluster_id ()) : 0;
+        if (net && ! net->name ().empty ()) {
+          m_name = net->name ();
+          m_name_hier_depth = depth;
+        }
+      }
+    }
+
+    //  collect the shapes of the net on all layers
+    for (std::map<unsigned int, unsigned int>::const_iterator li = clusters.m_log_layer_for_internal_layer.begin (); li != clusters.m_log_layer_for_internal_layer.end (); ++li) {
+
+      for (db::recursive_cluster_shape_iterator<db::NetShape> s (hc, li->first, root_cell, cluster_id); ! s.at_end (); ++s) {
+
+        if (s->type () != db::NetShape::Polygon) {
+          continue;
+        }
+
+        if (m_trace_depth > 0 && m_shapes_found.size () >= m_trace_depth) {
+          m_incomplete = true;
+          return;
+        }
+
+        std::map<db::cell_index_type, db::cell_index_type>::const_iterator cm = clusters.m_cell_map.find (s.cell_index ());
+        db::cell_index_type ci = cm != clusters.m_cell_map.end () ? cm->second : mp_cell->cell_index ();
+
+        db::Shape shape = m_shape_heap.insert (s->polygon_ref ().instantiate ());
+        m_shapes_found.insert (NetTracerShape (root_trans * s.trans (), shape, li->second, ci));
+
+      }
+
+    }
+
+  }
+}
+
 void
 NetTracer::compute_results_for_next_iteration (const std::vector <const NetTracerShape *> &new_seeds, unsigned int seed_layer, const std::set<unsigned int> &output_layers, std::set <std::pair<NetTracerShape, const NetTracerShape *> > &current, std::set <std::pair<NetTracerShape, const NetTracerShape *> > &output, const NetTracerData &data)
 {
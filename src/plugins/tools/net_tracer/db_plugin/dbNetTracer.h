@@ -38,6 +38,7 @@
 #include <vector>
 #include <map>
 #include <list>
+#include <memory>
 
 namespace db
 {
@@ -626,6 +627,11 @@ public:
    */
   void configure_l2n (db::LayoutToNetlist &l2n);
 
+  /**
+   *  @brief Gets the regions provided by "configure_l2n" per logical layer
+   */
+  std::map<unsigned int, const db::Region *> l2n_regions () const;
+
 private:
   unsigned int m_next_log_layer;
   std::vector <NetTracerConnection> m_connections;
@@ -642,6 +648,98 @@ private:
   void clean_l2n_regions ();
 };
 
+/**
+ *  @brief The connectivity clusters for hierarchical net tracing
+ *
+ *  This object extracts the connectivity of a layout once, using the hierarchical
+ *  cluster builder of LayoutToNetlist (set up through NetTracerData::configure_l2n).
+ *  After that, tracing a net with NetTracer::trace is a lookup in the cluster graph.
+ *  The net shapes are delivered hierarchically: in the coordinates of the cell they
+ *  live in, together with the transformation into the top cell.
+ *
+ *  The clusters are a snapshot of the layout. If the layout or the tracer setup
+ *  changes, the clusters need to be built again.
+ */
+class DB_PLUGIN_PUBLIC NetTracerClusters
+{
+public:
+  /**
+   *  @brief Creates an empty cluster object
+   */
+  NetTracerClusters ();
+
+  /**
+   *  @brief Destructor
+   */
+  ~NetTracerClusters ();
+
+  /**
+   *  @brief Extracts the clusters for the given cell and tracer setup
+   *
+   *  "threads" is the number of threads used for the extraction (0 for none).
+   */
+  void build (const db::Layout &layout, const db::Cell &cell, const NetTracerData &data, int threads = 0);
+
+  /**
+   *  @brief Releases the clusters
+   */
+  void clear ();
+
+  /**
+   *  @brief Returns true, if the clusters have been built
+   */
+  bool is_valid () const
+  {
+    return mp_l2n.get () != 0;
+  }
+
+  /**
+   *  @brief Returns true, if the clusters have been built for the given layout and cell
+   */
+  bool is_valid_for (const db::Layout &layout, const db::Cell &cell) const
+  {
+    return is_valid () && mp_layout == &layout && m_cell_index == cell.cell_index ();
+  }
+
+  /**
+   *  @brief Gets the layout the clusters have been built for
+   */
+  const db::Layout &layout () const
+  {
+    return *mp_layout;
+  }
+
+  /**
+   *  @brief Gets the cell the clusters have been built for
+   */
+  const db::Cell &cell () const
+  {
+    return mp_layout->cell (m_cell_index);
+  }
+
+  /**
+   *  @brief Gets the tracer setup the clusters have been built for
+   */
+  const NetTracerData &data () const
+  {
+    return *mp_data;
+  }
+
+private:
+  friend class NetTracer;
+
+  std::auto_ptr<db::LayoutToNetlist> mp_l2n;
+  std::auto_ptr<NetTracerData> mp_data;
+  std::vector<db::Texts *> m_texts;
+  const db::Layout *mp_layout;
+  db::cell_index_type m_cell_index;
+  std::map<unsigned int, unsigned int> m_log_layer_for_internal_layer;
+  std::map<db::cell_index_type, db::cell_index_type> m_cell_map;
+
+  NetTracerClusters (const NetTracerClusters &);
+  NetTracerClusters &operator= (const NetTracerClusters &);
+};
+
 /**
  *  @brief The net tracer
  *
@@ -679,6 +777,15 @@ public:
    */
   void trace (const db::Layout &layout, const db::Cell &cell, const db::Point &pt_start, unsigned int l_start, const db::Point &pt_stop, unsigned int l_stop, const NetTracerData &data);
 
+  /**
+   *  @brief Trace the net starting from the given point/layer seed using prebuilt clusters
+   *
+   *  The layout, cell and tracer setup are the ones the clusters have been built for.
+   *  Shapes on computed layers are delivered with the logical layer like in the flat
+   *  trace, but may be cut differently.
+   */
+  void trace (const NetTracerClusters &clusters, const db::Point &pt_start, unsigned int l_start);
+
   /**
    *  @brief Begin operator for the shapes found
    */
@@ -43,6 +43,7 @@ extern const std::string cfg_nt_window_mode ("nt-window-mode");
 extern const std::string cfg_nt_window_dim ("nt-window-dim");
 extern const std::string cfg_nt_max_shapes_highlighted ("nt-max-shapes-highlighted");
 extern const std::string cfg_nt_trace_depth ("nt-trace_depth");
+extern const std::string cfg_nt_hierarchical ("nt-hierarchical");
 
 // ------------------------------------------------------------
 
@@ -147,6 +148,11 @@ NetTracerConfigPage::setup (lay::Dispatcher *root)
   root->config_get (cfg_nt_max_shapes_highlighted, max_marker_count);
   le_max_markers->setText (tl::to_qstring (tl::to_string (max_marker_count)));
 
+  //  hierarchical mode
+  bool hierarchical = false;
+  root->config_get (cfg_nt_hierarchical, hierarchical);
+  hierarchical_cb->setChecked (hierarchical);
+
   //  enable controls
   window_changed (int (wmode));
 
@@ -250,6 +256,7 @@ NetTracerConfigPage::commit (lay::Dispatcher *root)
   root->config_set (cfg_nt_window_mode, lay::nt_window_type (cbx_window->currentIndex ()), NetTracerWindowModeConverter ());
   root->config_set (cfg_nt_window_dim, dim);
   root->config_set (cfg_nt_max_shapes_highlighted, max_shapes_highlighted);
+  root->config_set (cfg_nt_hierarchical, hierarchical_cb->isChecked ());
 
   root->config_set (cfg_nt_marker_cycle_colors_enabled, cycle_colors_cb->isChecked ());
   root->config_set (cfg_nt_marker_cycle_colors, m_palette.to_string ());
@@ -45,6 +45,7 @@ extern const std::string cfg_nt_window_mode;
 extern const std::string cfg_nt_window_dim;
 extern const std::string cfg_nt_max_shapes_highlighted;
 extern const std::string cfg_nt_trace_depth;
+extern const std::string cfg_nt_hierarchical;
 
 enum nt_window_type { NTDontChange = 0, NTFitNet, NTCenter, NTCenterSize };
 
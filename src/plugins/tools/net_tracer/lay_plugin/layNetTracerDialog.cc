@@ -43,6 +43,7 @@
 #include <QItemDelegate>
 #include <QHeaderView>
 #include <QPainter>
+#include <QThread>
 
 #include <fstream>
 #include <sstream>
@@ -68,7 +69,8 @@ NetTracerDialog::NetTracerDialog (lay::Dispatcher *root, lay::LayoutView *view)
     m_marker_intensity (0),
     m_auto_color_enabled (false),
     m_auto_color_index (0),
-    m_mouse_state (0)
+    m_mouse_state (0),
+    m_hierarchical (false)
 {
   mp_export_file_dialog = new lay::FileDialog (this, tl::to_string (QObject::tr ("Export Net")), tl::to_string (QObject::tr ("KLayout net files (*.lyn);;All files (*)")));
 
@@ -91,6 +93,12 @@ NetTracerDialog::NetTracerDialog (lay::Dispatcher *root, lay::LayoutView *view)
 
   view->layer_list_changed_event.add (this, &NetTracerDialog::layer_list_changed);
 
+  //  the hierarchical clusters are a snapshot which needs to be rebuilt on changes
+  view->geom_changed_event.add (this, &NetTracerDialog::invalidate_clusters);
+  view->hier_changed_event.add (this, &NetTracerDialog::invalidate_clusters);
+  view->cellviews_changed_event.add (this, &NetTracerDialog::invalidate_clusters);
+  db::Technologies::instance ()->technology_changed_event.add (this, &NetTracerDialog::technology_changed);
+
   update_info ();
 }
 
@@ -100,6 +108,19 @@ NetTracerDialog::~NetTracerDialog ()
   clear_nets ();
 }
 
+void
+NetTracerDialog::invalidate_clusters ()
+{
+  m_clusters.clear ();
+  m_clusters_tech_name.clear ();
+}
+
+void
+NetTracerDialog::technology_changed (db::Technology *)
+{
+  invalidate_clusters ();
+}
+
 void
 NetTracerDialog::clear_nets ()
 {
@@ -398,9 +419,23 @@ NetTracerDialog::do_trace (const db::DBox &start_search_box, const db::DBox &sto
 
   //  and trace
   if (trace_path) {
+
     net_tracer.trace (cv->layout (), *cv.cell (), start_point, start_layer, stop_point, stop_layer, tracer_data);
+
+  } else if (m_hierarchical) {
+
+    //  extract the connectivity once and look up the nets in the clusters
+    if (! m_clusters.is_valid_for (cv->layout (), *cv.cell ()) || m_clusters_tech_name != cv->tech_name ()) {
+      m_clusters.build (cv->layout (), *cv.cell (), tracer_data, QThread::idealThreadCount ());
+      m_clusters_tech_name = cv->tech_name ();
+    }
+
+    net_tracer.trace (m_clusters, start_point, start_layer);
+
   } else {
+
     net_tracer.trace (cv->layout (), *cv.cell (), start_point, start_layer, tracer_data);
+
   }
 
   if (net_tracer.begin () == net_tracer.end ()) {
@@ -468,6 +503,13 @@ NetTracerDialog::configure (const std::string &name, const std::string &value)
       need_update = true;
     }
 
+  } else if (name == cfg_nt_hierarchical) {
+
+    tl::from_string (value, m_hierarchical);
+    if (! m_hierarchical) {
+      invalidate_clusters ();
+    }
+
   } else if (name == cfg_nt_max_shapes_highlighted) {
 
     unsigned int mc = 0;
@@ -1238,6 +1280,7 @@ BEGIN_PROTECTED
   //  call the dialog and if successful, install the new technology
   lay::TechComponentSetupDialog dialog (this, &tech, db::net_tracer_component_name ());
   if (dialog.exec ()) {
+    invalidate_clusters ();
     *db::Technologies::instance ()->technology_by_name (tech.name ()) = tech;
   }
 
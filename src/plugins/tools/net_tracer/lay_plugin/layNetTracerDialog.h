@@ -107,6 +107,9 @@ private:
   std::string m_export_cell_name;
   lay::FileDialog *mp_export_file_dialog;
   std::string m_export_file_name;
+  bool m_hierarchical;
+  db::NetTracerClusters m_clusters;
+  std::string m_clusters_tech_name;
 
   void commit ();
   size_t get_trace_depth ();
@@ -121,6 +124,8 @@ private:
   db::NetTracerNet *do_trace (const db::DBox &start_search_box, const db::DBox &stop_search_box, bool trace_path);
   bool get_net_tracer_setup (const lay::CellView &cv, db::NetTracerData &data);
   void trace_all_nets (db::LayoutToNetlist *l2ndb, const lay::CellView &cv, bool flat);
+  void invalidate_clusters ();
+  void technology_changed (db::Technology *);
 };
 
 }
@@ -46,6 +46,7 @@ public:
     options.push_back (std::pair<std::string, std::string> (cfg_nt_window_mode, "fit-net"));
     options.push_back (std::pair<std::string, std::string> (cfg_nt_window_dim, "1.0"));
     options.push_back (std::pair<std::string, std::string> (cfg_nt_max_shapes_highlighted, "10000"));
+    options.push_back (std::pair<std::string, std::string> (cfg_nt_hierarchical, "false"));
     options.push_back (std::pair<std::string, std::string> (cfg_nt_marker_color, lay::ColorConverter ().to_string (QColor ())));
     options.push_back (std::pair<std::string, std::string> (cfg_nt_marker_cycle_colors_enabled, "false"));
     options.push_back (std::pair<std::string, std::string> (cfg_nt_marker_cycle_colors, "255,0,0 0,255,0 0,0,255 255,255,0 255,0,255 0,255,255 160,80,255 255,160,0"));
@@ -394,3 +394,158 @@ TEST(9)
   run_test (_this, file, tc, db::LayerProperties (8, 0), db::Point (3000, 6800), file_au, "A");
 }
 
+
+static db::Region net_layer_region (const db::Layout &layout, const db::LayerProperties &lp)
+{
+  int l = layer_for (layout, lp);
+  if (l < 0) {
+    return db::Region ();
+  }
+  return db::Region (db::RecursiveShapeIterator (layout, layout.cell (*layout.begin_top_down ()), (unsigned int) l)).merged ();
+}
+
+//  Compares hierarchical traces against the flat ones
+void run_test_hier (tl::TestBase *_this, const std::string &file, const db::NetTracerTechnologyComponent &tc, const db::LayerProperties &lp_start, const std::vector<db::Point> &p_start)
+{
+  db::Manager m (false);
+
+  db::Layout layout_org (&m);
+  {
+    std::string fn (tl::testsrc ());
+    fn += "/testdata/net_tracer/";
+    fn += file;
+    tl::InputStream stream (fn);
+    db::Reader reader (stream);
+    reader.read (layout_org);
+  }
+
+  const db::Cell &cell = layout_org.cell (*layout_org.begin_top_down ());
+
+  db::NetTracerClusters clusters;
+  clusters.build (layout_org, cell, tc.get_tracer_data (layout_org));
+  EXPECT_EQ (clusters.is_valid_for (layout_org, cell), true);
+
+  for (std::vector<db::Point>::const_iterator p = p_start.begin (); p != p_start.end (); ++p) {
+
+    db::NetTracer tracer;
+    db::NetTracerNet net = trace (tracer, layout_org, cell, tc, layer_for (layout_org, lp_start), *p);
+
+    db::NetTracer hier_tracer;
+    hier_tracer.trace (clusters, *p, layer_for (layout_org, lp_start));
+    db::NetTracerNet hier_net (hier_tracer, db::ICplxTrans (), layout_org, cell.cell_index (), std::string (), std::string (), clusters.data ());
+
+    EXPECT_EQ (hier_net.incomplete (), false);
+    EXPECT_EQ (hier_net.size () == 0, net.size () == 0);
+
+    db::Layout layout_net, layout_hier_net;
+    net.export_net (layout_net, layout_net.cell (layout_net.add_cell ("NET")));
+    hier_net.export_net (layout_hier_net, layout_hier_net.cell (layout_hier_net.add_cell ("NET")));
+
+    std::set<db::LayerProperties, db::LPLogicalLessFunc> layers;
+    for (db::Layout::layer_iterator l = layout_net.begin_layers (); l != layout_net.end_layers (); ++l) {
+      layers.insert (*(*l).second);
+    }
+    for (db::Layout::layer_iterator l = layout_hier_net.begin_layers (); l != layout_hier_net.end_layers (); ++l) {
+      layers.insert (*(*l).second);
+    }
+
+    for (std::set<db::LayerProperties, db::LPLogicalLessFunc>::const_iterator l = layers.begin (); l != layers.end (); ++l) {
+      CHECKPOINT ();
+      EXPECT_EQ ((net_layer_region (layout_net, *l) ^ net_layer_region (layout_hier_net, *l)).to_string (), "");
+    }
+
+  }
+}
+
+TEST(10)
+{
+  std::vector<db::Point> pts;
+  pts.push_back (db::Point (7000, 1500));
+  //  point is off net ...
+  pts.push_back (db::Point (7000, 15000));
+
+  db::NetTracerTechnologyComponent tc;
+  tc.add (connection ("1/0", "2/0", "3/0"));
+  run_test_hier (_this, "t1.oas.gz", tc, db::LayerProperties (1, 0), pts);
+  run_test_hier (_this, "t4.oas.gz", tc, db::LayerProperties (1, 0), pts);
+
+  db::NetTracerTechnologyComponent tc4b;
+  tc4b.add (connection ("1/0", "3/0"));
+  run_test_hier (_this, "t4.oas.gz", tc4b, db::LayerProperties (1, 0), pts);
+}
+
+TEST(10b)
+{
+  std::vector<db::Point> pts;
+  pts.push_back (db::Point (-2250, -900));
+
+  db::NetTracerTechnologyComponent tc;
+  tc.add (connection ("1-10", "2", "3"));
+  tc.add (connection ("3", "4", "5"));
+  run_test_hier (_this, "t6.oas.gz", tc, db::LayerProperties (1, 0), pts);
+}
+
+TEST(10c)
+{
+  std::vector<db::Point> pts;
+  pts.push_back (db::Point (-700, 300));
+
+  db::NetTracerTechnologyComponent tc;
+  tc.add (connection ("15", "14", "2-7"));
+  tc.add (connection ("15", "14", "7"));
+  run_test_hier (_this, "t7.oas.gz", tc, db::LayerProperties (15, 0), pts);
+}
+
+TEST(10d)
+{
+  std::vector<db::Point> pts;
+  pts.push_back (db::Point (3000, 6800));
+
+  db::NetTracerTechnologyComponent tc;
+  tc.add_symbol (symbol ("a", "8-12"));
+  tc.add_symbol (symbol ("b", "a+7"));
+  tc.add_symbol (symbol ("c", "15*26"));
+  tc.add (connection ("b", "7"));
+  tc.add (connection ("b", "c", "9"));
+  run_test_hier (_this, "t9.oas.gz", tc, db::LayerProperties (8, 0), pts);
+}
+
+//  hierarchical trace with trace depth and net name
+TEST(10e)
+{
+  db::Manager m (false);
+
+  db::Layout layout_org (&m);
+  {
+    std::string fn (tl::testsrc ());
+    fn += "/testdata/net_tracer/t6.oas.gz";
+    tl::InputStream stream (fn);
+    db::Reader reader (stream);
+    reader.read (layout_org);
+  }
+
+  const db::Cell &cell = layout_org.cell (*layout_org.begin_top_down ());
+
+  db::NetTracerTechnologyComponent tc;
+  tc.add (connection ("1-10", "2", "3"));
+  tc.add (connection ("3", "4", "5"));
+
+  db::NetTracerClusters clusters;
+  clusters.build (layout_org, cell, tc.get_tracer_data (layout_org), 2);
+
+  db::NetTracer tracer;
+  tracer.trace (clusters, db::Point (-2250, -900), layer_for (layout_org, db::LayerProperties (1, 0)));
+  EXPECT_EQ (tracer.incomplete (), false);
+  EXPECT_EQ (tracer.name (), "IN_B");
+
+  size_t n = tracer.size ();
+  EXPECT_EQ (n > 10, true);
+
+  tracer.set_trace_depth (10);
+  tracer.trace (clusters, db::Point (-2250, -900), layer_for (layout_org, db::LayerProperties (1, 0)));
+  EXPECT_EQ (tracer.incomplete (), true);
+  EXPECT_EQ (tracer.size (), size_t (10));
+
+  clusters.clear ();
+  EXPECT_EQ (clusters.is_valid (), false);
+}
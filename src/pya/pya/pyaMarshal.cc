@@ -24,6 +24,7 @@
 #include "pyaMarshal.h"
 #include "pyaObject.h"
 #include "pyaConvert.h"
+#include "pyaUtils.h"
 #include "pyaModule.h"
 
 #include "gsiTypes.h"
@@ -35,6 +36,29 @@ namespace pya
 // -------------------------------------------------------------------
 //  Serialization adaptors for strings, variants, vectors and maps
 
+/**
+ *  @brief Converts a Python object to a byte string for a binary (std::vector<char>) argument
+ *
+ *  In addition to the string types, objects supporting the buffer protocol (memoryview,
+ *  array.array or NumPy arrays) are accepted and deliver their raw bytes.
+ */
+static std::string
+python2c_binary (PyObject *obj)
+{
+#if PY_MAJOR_VERSION >= 3
+  if (! PyBytes_Check (obj) && ! PyUnicode_Check (obj) && ! PyByteArray_Check (obj) && PyObject_CheckBuffer (obj)) {
+    Py_buffer view;
+    if (PyObject_GetBuffer (obj, &view, PyBUF_C_CONTIGUOUS) != 0) {
+      check_error ();
+    }
+    std::string s ((const char *) view.buf, size_t (view.len));
+    PyBuffer_Release (&view);
+    return s;
+  }
+#endif
+  return python2c<std::string> (obj);
+}
+
 /**
  *  @brief An adaptor for a string from ruby objects
  */
@@ -42,8 +66,8 @@ class PythonBasedStringAdaptor
   : public gsi::StringAdaptor
 {
 public:
-  PythonBasedStringAdaptor (const PythonPtr &string)
-    : m_stdstr (python2c<std::string> (string.get ())), m_string (string)
+  PythonBasedStringAdaptor (const PythonPtr &string, bool binary = false)
+    : m_stdstr (binary ? python2c_binary (string.get ()) : python2c<std::string> (string.get ())), m_string (string)
   {
     //  .. nothing yet ..
   }
@@ -295,7 +319,7 @@ struct writer<gsi::StringType>
       } else {
 
         //  NOTE: by convention we pass the ownership to the receiver for adaptors.
-        aa->write<void *> ((void *)new PythonBasedStringAdaptor (arg));
+        aa->write<void *> ((void *)new PythonBasedStringAdaptor (arg, atype.is_binary ()));
 
       }
 
@@ -527,6 +551,13 @@ struct reader<gsi::StringType>
     std::auto_ptr<gsi::StringAdaptor> a ((gsi::StringAdaptor *) rr->read<void *>(*heap));
     if (!a.get ()) {
       *ret = PythonRef (Py_None, false /*borrowed*/);
+    } else if (a->is_binary ()) {
+      //  byte arrays are delivered as "bytes" objects which support the buffer protocol
+#if PY_MAJOR_VERSION < 3
+      *ret = PythonRef (PyString_FromStringAndSize (a->c_str (), Py_ssize_t (a->size ())));
+#else
+      *ret = PythonRef (PyBytes_FromStringAndSize (a->c_str (), Py_ssize_t (a->size ())));
+#endif
     } else {
       *ret = c2python (std::string (a->c_str (), a->size ()));
     }
@@ -909,7 +940,7 @@ struct test_arg_func<gsi::VariantType>
 template <>
 struct test_arg_func<gsi::StringType>
 {
-  void operator() (bool *ret, PyObject *arg, const gsi::ArgType &, bool)
+  void operator() (bool *ret, PyObject *arg, const gsi::ArgType &atype, bool)
   {
 #if PY_MAJOR_VERSION < 3
     if (PyString_Check (arg)) {
@@ -924,6 +955,11 @@ struct test_arg_func<gsi::StringType>
       *ret = true;
     } else if (PyByteArray_Check (arg)) {
       *ret = true;
+#if PY_MAJOR_VERSION >= 3
+    } else if (atype.is_binary () && PyObject_CheckBuffer (arg)) {
+      //  memoryview, array.array or NumPy arrays for byte array strings only
+      *ret = true;
+#endif
     } else {
       *ret = false;
     }
@@ -1020,7 +1056,7 @@ struct test_arg_func<gsi::ObjectType>
       *ret = false;
       return;
     }
-    if ((atype.is_ref () || atype.is_ptr ()) && ((PYAObjectBase *) arg)->const_ref ()) {
+    if ((atype.is_ref () || atype.is_ptr ()) && PYAObjectBase::from_pyobject (arg)->const_ref ()) {
       *ret = false;
       return;
     }
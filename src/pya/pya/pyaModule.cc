@@ -51,6 +51,113 @@ class MethodTableEntry
 public:
   typedef std::vector<const gsi::MethodBase *>::const_iterator method_iterator;
 
+  /**
+   *  @brief The key for the overload resolution cache
+   *
+   *  The argument type test only looks at the Python type of plain arguments and
+   *  at the class and the constness of the reference for script objects. Hence
+   *  these properties are sufficient to identify a resolution result.
+   *  Lists, tuples and dicts are tested by content, so arguments of this kind
+   *  (and of any other type) make the call non-cacheable.
+   *  The first max_args argument types are stored inline, so building the key
+   *  for the common short argument lists does not allocate memory. Longer
+   *  argument lists store the remaining types on the heap.
+   */
+  struct MethodVariantKey
+  {
+    enum { max_args = 4 };
+
+    MethodVariantKey ()
+      : m_argc (0), m_is_const (false)
+    { }
+
+    /**
+     *  @brief Fills the key from the given arguments
+     *  Returns false, if the call cannot be cached.
+     */
+    bool set (PyObject *args, int argc, bool is_const)
+    {
+      m_more_argtypes.clear ();
+      if (argc > int (max_args)) {
+        m_more_argtypes.reserve (argc - int (max_args));
+      }
+
+      m_argc = argc;
+      m_is_const = is_const;
+
+      for (int i = 0; i < argc; ++i) {
+
+        PyObject *arg = PyTuple_GetItem (args, i);
+        PyTypeObject *type = Py_TYPE (arg);
+
+        if (is_plain_type (type)) {
+          set_argtype (i, std::make_pair ((const void *) type, false));
+        } else {
+          const gsi::ClassBase *cls_decl = PythonModule::cls_for_type (type);
+          if (! cls_decl) {
+            return false;
+          }
+          set_argtype (i, std::make_pair ((const void *) cls_decl, PYAObjectBase::from_pyobject (arg)->const_ref ()));
+        }
+
+      }
+
+      return true;
+    }
+
+    bool operator< (const MethodVariantKey &other) const
+    {
+      if (m_argc != other.m_argc) {
+        return m_argc < other.m_argc;
+      }
+      if (m_is_const != other.m_is_const) {
+        return m_is_const < other.m_is_const;
+      }
+      for (int i = 0; i < m_argc; ++i) {
+        if (argtype (i) != other.argtype (i)) {
+          return argtype (i) < other.argtype (i);
+        }
+      }
+      return false;
+    }
+
+  private:
+    int m_argc;
+    bool m_is_const;
+    std::pair<const void *, bool> m_argtypes [max_args];
+    std::vector<std::pair<const void *, bool> > m_more_argtypes;
+
+    const std::pair<const void *, bool> &argtype (int i) const
+    {
+      return i < int (max_args) ? m_argtypes [i] : m_more_argtypes [i - int (max_args)];
+    }
+
+    void set_argtype (int i, const std::pair<const void *, bool> &t)
+    {
+      if (i < int (max_args)) {
+        m_argtypes [i] = t;
+      } else {
+        m_more_argtypes.push_back (t);
+      }
+    }
+
+    static bool is_plain_type (PyTypeObject *type)
+    {
+      //  Only exact built-in types are accepted: these objects are static, so the
+      //  type pointer is a unique identifier.
+      return type == Py_TYPE (Py_None) ||
+             type == &PyBool_Type ||
+             type == &PyLong_Type ||
+             type == &PyFloat_Type ||
+#if PY_MAJOR_VERSION < 3
+             type == &PyInt_Type ||
+#endif
+             type == &PyBytes_Type ||
+             type == &PyUnicode_Type ||
+             type == &PyByteArray_Type;
+    }
+  };
+
   MethodTableEntry (const std::string &name, bool st, bool prot)
     : m_name (name), m_is_static (st), m_is_protected (prot)
   { }
@@ -73,6 +180,7 @@ public:
   void add (const gsi::MethodBase *m)
   {
     m_methods.push_back (m);
+    m_variants.clear ();
   }
 
   void finish ()
@@ -81,6 +189,25 @@ public:
     std::vector<const gsi::MethodBase *> m = m_methods;
     std::sort(m.begin (), m.end ());
     m_methods.assign (m.begin (), std::unique (m.begin (), m.end ()));
+    m_variants.clear ();
+  }
+
+  /**
+   *  @brief Looks up a method in the overload resolution cache
+   *  Returns 0 if there is no entry for this key.
+   */
+  const gsi::MethodBase *cached_variant (const MethodVariantKey &key) const
+  {
+    std::map<MethodVariantKey, const gsi::MethodBase *>::const_iterator v = m_variants.find (key);
+    return v != m_variants.end () ? v->second : 0;
+  }
+
+  /**
+   *  @brief Enters a resolved method into the overload resolution cache
+   */
+  void cache_variant (const MethodVariantKey &key, const gsi::MethodBase *meth) const
+  {
+    m_variants.insert (std::make_pair (key, meth));
   }
 
   method_iterator begin () const
@@ -98,6 +225,7 @@ private:
   bool m_is_static : 1;
   bool m_is_protected : 1;
   std::vector<const gsi::MethodBase *> m_methods;
+  mutable std::map<MethodVariantKey, const gsi::MethodBase *> m_variants;
 };
 
 /**
@@ -319,6 +447,14 @@ public:
     return m_property_table[mid - m_property_offset].second.end ();
   }
 
+  /**
+   *  @brief Gets the method table entry for method ID mid
+   */
+  const MethodTableEntry &entry (size_t mid) const
+  {
+    return m_table[mid - m_method_offset];
+  }
+
   /**
    *  @brief Begins iteration of the overload variants for method ID mid
    */
@@ -739,6 +875,16 @@ match_method (int mid, PyObject *self, PyObject *args, bool strict)
 
   }
 
+  //  try the overload resolution cache first - it is keyed by the argument types
+  MethodTableEntry::MethodVariantKey key;
+  bool cacheable = key.set (args, argc, p != 0 && p->const_ref ());
+  if (cacheable) {
+    const gsi::MethodBase *cached = mt->entry (mid).cached_variant (key);
+    if (cached) {
+      return cached;
+    }
+  }
+
   for (MethodTableEntry::method_iterator m = mt->begin (mid); m != mt->end (mid); ++m) {
 
     if ((*m)->is_callback()) {
@@ -859,6 +1005,10 @@ match_method (int mid, PyObject *self, PyObject *args, bool strict)
     }
   }
 
+  if (cacheable) {
+    mt->entry (mid).cache_variant (key, meth);
+  }
+
   return meth;
 }
 
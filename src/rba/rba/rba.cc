@@ -146,6 +146,9 @@ private:
 // -------------------------------------------------------------------
 //  The lookup table for the method overload resolution
 
+static bool is_proxy (VALUE v);
+static bool proxy_const_ref (VALUE v);
+
 /**
  *  @brief A single entry in the method table
  *  This class provides an entry for one name. It provides flags
@@ -157,30 +160,65 @@ class MethodTableEntry
 public:
   typedef std::vector<const gsi::MethodBase *>::const_iterator method_iterator;
 
+  /**
+   *  @brief The key for the overload resolution cache
+   *
+   *  The argument type test only looks at the Ruby class of plain arguments and
+   *  at the class and the constness of the reference for script objects. Hence
+   *  these properties are sufficient to identify a resolution result.
+   *  The first max_args argument types are stored inline, so building the key
+   *  for the common short argument lists does not allocate memory. Longer
+   *  argument lists store the remaining types on the heap.
+   */
   struct MethodVariantKey
   {
-    MethodVariantKey (int argc, VALUE *argv, bool block_given, bool is_ctor, bool is_static, bool is_const)
-      : m_block_given (block_given), m_is_ctor (is_ctor), m_is_static (is_static), m_is_const (is_const)
+    enum { max_args = 4 };
+
+    MethodVariantKey ()
+      : m_argc (0), m_block_given (false), m_is_ctor (false), m_is_static (false), m_is_const (false)
+    { }
+
+    /**
+     *  @brief Fills the key from the given arguments
+     *  Returns false, if the call cannot be cached.
+     */
+    bool set (int argc, VALUE *argv, bool block_given, bool is_ctor, bool is_static, bool is_const)
     {
-      m_argtypes.reserve (size_t (argc));
+      m_more_argtypes.clear ();
+      if (argc > int (max_args)) {
+        m_more_argtypes.reserve (argc - int (max_args));
+      }
+
+      m_argc = argc;
+      m_block_given = block_given;
+      m_is_ctor = is_ctor;
+      m_is_static = is_static;
+      m_is_const = is_const;
+
       for (int i = 0; i < argc; ++i) {
-        m_argtypes.push_back (CLASS_OF (argv[i]));
+
+        int t = TYPE (argv[i]);
+        //  caching can't work for arrays or hashes as these are tested by content
+        if (t == T_ARRAY || t == T_HASH) {
+          return false;
+        }
+
+        set_argtype (i, std::make_pair (CLASS_OF (argv[i]), t == T_DATA && is_proxy (argv[i]) && proxy_const_ref (argv[i])));
+
       }
-    }
 
-    bool operator== (const MethodVariantKey &other) const
-    {
-      return m_argtypes == other.m_argtypes &&
-             m_block_given == other.m_block_given &&
-             m_is_ctor == other.m_is_ctor &&
-             m_is_static == other.m_is_static &&
-             m_is_const == other.m_is_const;
+      return true;
     }
 
     bool operator< (const MethodVariantKey &other) const
     {
-      if (m_argtypes != other.m_argtypes) {
-        return m_argtypes < other.m_argtypes;
+      if (m_argc != other.m_argc) {
+        return m_argc < other.m_argc;
+      }
+      for (int i = 0; i < m_argc; ++i) {
+        if (argtype (i) != other.argtype (i)) {
+          return argtype (i) < other.argtype (i);
+        }
       }
       if (m_block_given != other.m_block_given) {
         return m_block_given < other.m_block_given;
@@ -198,11 +236,27 @@ public:
     }
 
   private:
-    std::vector<size_t> m_argtypes;
+    int m_argc;
+    std::pair<VALUE, bool> m_argtypes [max_args];
+    std::vector<std::pair<VALUE, bool> > m_more_argtypes;
     bool m_block_given;
     bool m_is_ctor;
     bool m_is_static;
     bool m_is_const;
+
+    const std::pair<VALUE, bool> &argtype (int i) const
+    {
+      return i < int (max_args) ? m_argtypes [i] : m_more_argtypes [i - int (max_args)];
+    }
+
+    void set_argtype (int i, const std::pair<VALUE, bool> &t)
+    {
+      if (i < int (max_args)) {
+        m_argtypes [i] = t;
+      } else {
+        m_more_argtypes.push_back (t);
+      }
+    }
   };
 
   MethodTableEntry (const std::string &name, bool ctor, bool st, bool prot, bool signal)
@@ -237,6 +291,7 @@ public:
   void add (const gsi::MethodBase *m)
   {
     m_methods.push_back (m);
+    m_variants.clear ();
   }
 
   void finish ()
@@ -245,6 +300,7 @@ public:
     std::vector<const gsi::MethodBase *> m = m_methods;
     std::sort(m.begin (), m.end ());
     m_methods.assign (m.begin (), std::unique (m.begin (), m.end ()));
+    m_variants.clear ();
   }
 
   method_iterator begin () const
@@ -259,25 +315,20 @@ public:
 
   const gsi::MethodBase *get_variant (int argc, VALUE *argv, bool block_given, bool is_ctor, bool is_static, bool is_const) const
   {
-    //  caching can't work for arrays or hashes - in this case, give up
-
-    for (int i = 0; i < argc; ++i) {
-      int t = TYPE (argv[i]);
-      if (t == T_ARRAY || t == T_HASH) {
-        return find_variant (argc, argv, block_given, is_ctor, is_static, is_const);
-      }
+    MethodVariantKey key;
+    if (! key.set (argc, argv, block_given, is_ctor, is_static, is_const)) {
+      return find_variant (argc, argv, block_given, is_ctor, is_static, is_const);
     }
 
     //  try to find the variant in the cache
 
-    MethodVariantKey key (argc, argv, block_given, is_ctor, is_static, is_const);
     std::map<MethodVariantKey, const gsi::MethodBase *>::const_iterator v = m_variants.find (key);
     if (v != m_variants.end ()) {
       return v->second;
     }
 
     const gsi::MethodBase *meth = find_variant (argc, argv, block_given, is_ctor, is_static, is_const);
-    m_variants[key] = meth;
+    m_variants.insert (std::make_pair (key, meth));
     return meth;
   }
 
@@ -840,6 +891,18 @@ static void mark_proxy (void *p)
   ((Proxy *) p)->mark ();
 }
 
+static bool is_proxy (VALUE v)
+{
+  return RDATA (v)->dfree == (RUBY_DATA_FUNC) &free_proxy;
+}
+
+static bool proxy_const_ref (VALUE v)
+{
+  Proxy *p = 0;
+  Data_Get_Struct (v, Proxy, p);
+  return p->const_ref ();
+}
+
 static VALUE alloc_proxy (VALUE klass)
 {
   tl_assert (TYPE (klass) == T_CLASS);
@@ -1016,6 +1016,13 @@ static rdb::Item *create_item_from_objects (rdb::Database *db, rdb::Cell *cell,
   }
 }
 
+static std::map<std::string, size_t> rdb_mem_statistics (const rdb::Database *db)
+{
+  db::MemStatisticsCollector ms (false);
+  db->mem_stat (&ms, db::MemStatistics::ReportDatabase, 0);
+  return ms.size_per_purpose ();
+}
+
 Class<rdb::Database> decl_ReportDatabase ("rdb", "ReportDatabase",
   gsi::constructor ("new", &create_rdb, gsi::arg ("name"),
     "@brief Creates a report database\n"
@@ -1369,6 +1376,12 @@ Class<rdb::Database> decl_ReportDatabase ("rdb", "ReportDatabase",
     "@brief Saves the database to the given file\n"
     "@param filename The file to which to save the database\n"
     "The database is always saved in KLayout's XML-based format.\n"
+  ) +
+  gsi::method_ext ("mem_statistics", &rdb_mem_statistics,
+    "@brief Gets the memory used by the database\n"
+    "The result is a hash with the \"report_database\" and \"total\" keys giving the number of bytes used.\n"
+    "\n"
+    "This method has been introduced in version 0.27.\n"
   ),
   "@brief The report database object\n"
   "A report database is organised around a set of items which are associated with cells and categories. "
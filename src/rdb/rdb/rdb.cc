@@ -61,6 +61,17 @@ template <> RDB_PUBLIC int type_index_of<db::DBox> ()      { return 5; }
 template <> RDB_PUBLIC int type_index_of<db::DPath> ()     { return 6; }
 template <> RDB_PUBLIC int type_index_of<db::DText> ()     { return 7; }
 
+//  memory statistics implementation
+
+template <class C>
+void Value<C>::mem_stat (db::MemStatistics *stat, db::MemStatistics::purpose_t purpose, int cat, bool no_self, void *parent) const
+{
+  if (! no_self) {
+    stat->add (typeid (*this), (void *) this, sizeof (*this), sizeof (*this), parent, purpose, cat);
+  }
+  db::mem_stat (stat, purpose, cat, m_value, true, (void *) this);
+}
+
 //  Explicit instantiations to make VC++ happy in debug mode
 template class RDB_PUBLIC Value<double>;
 template class RDB_PUBLIC Value<std::string>;
@@ -1454,6 +1465,76 @@ Database::num_items_visited (id_type cell_id, id_type category_id) const
   }
 }
 
+static void
+mem_stat_categories (db::MemStatistics *stat, db::MemStatistics::purpose_t purpose, int cat, const Categories &categories, void *parent)
+{
+  stat->add (typeid (categories), (void *) &categories, sizeof (categories), sizeof (categories), parent, purpose, cat);
+  for (Categories::const_iterator c = categories.begin (); c != categories.end (); ++c) {
+    stat->add (typeid (*c), (void *) c.operator-> (), sizeof (*c), sizeof (*c), (void *) &categories, purpose, cat);
+    db::mem_stat (stat, purpose, cat, c->name (), true, (void *) c.operator-> ());
+    db::mem_stat (stat, purpose, cat, c->description (), true, (void *) c.operator-> ());
+    mem_stat_categories (stat, purpose, cat, c->sub_categories (), (void *) c.operator-> ());
+  }
+}
+
+void
+Database::mem_stat (db::MemStatistics *stat, db::MemStatistics::purpose_t purpose, int cat, bool no_self, void *parent) const
+{
+  if (! no_self) {
+    stat->add (typeid (*this), (void *) this, sizeof (*this), sizeof (*this), parent, purpose, cat);
+  }
+
+  db::mem_stat (stat, purpose, cat, m_generator, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_filename, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_description, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_original_file, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_name, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_topcell, true, (void *) this);
+
+  if (mp_categories) {
+    mem_stat_categories (stat, purpose, cat, *mp_categories, (void *) this);
+  }
+
+  for (Tags::const_iterator t = m_tags.begin_tags (); t != m_tags.end_tags (); ++t) {
+    stat->add (typeid (*t), (void *) t.operator-> (), sizeof (*t), sizeof (*t), (void *) this, purpose, cat);
+    db::mem_stat (stat, purpose, cat, t->name (), true, (void *) t.operator-> ());
+    db::mem_stat (stat, purpose, cat, t->description (), true, (void *) t.operator-> ());
+  }
+
+  for (Cells::const_iterator c = m_cells.begin (); c != m_cells.end (); ++c) {
+    stat->add (typeid (*c), (void *) c.operator-> (), sizeof (*c), sizeof (*c), (void *) this, purpose, cat);
+    db::mem_stat (stat, purpose, cat, c->name (), true, (void *) c.operator-> ());
+    db::mem_stat (stat, purpose, cat, c->variant (), true, (void *) c.operator-> ());
+    for (References::const_iterator r = c->references ().begin (); r != c->references ().end (); ++r) {
+      stat->add (typeid (*r), (void *) r.operator-> (), sizeof (*r), sizeof (*r), (void *) c.operator-> (), purpose, cat);
+    }
+  }
+
+  if (mp_items) {
+    for (Items::const_iterator i = mp_items->begin (); i != mp_items->end (); ++i) {
+      //  list nodes carry two pointers in addition to the item
+      stat->add (typeid (*i), (void *) i.operator-> (), sizeof (*i) + 2 * sizeof (void *), sizeof (*i) + 2 * sizeof (void *), (void *) mp_items, purpose, cat);
+      for (Values::const_iterator v = i->values ().begin (); v != i->values ().end (); ++v) {
+        stat->add (typeid (*v), (void *) v.operator-> (), sizeof (*v) + 2 * sizeof (void *), sizeof (*v) + 2 * sizeof (void *), (void *) i.operator-> (), purpose, cat);
+        if (v->get ()) {
+          v->get ()->mem_stat (stat, purpose, cat, false, (void *) v.operator-> ());
+        }
+      }
+    }
+  }
+
+  //  the lookup tables
+  db::mem_stat (stat, purpose, cat, m_cells_by_qname, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_cell_variants, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_cells_by_id, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_categories_by_id, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_items_by_cell_and_category_id, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_num_items_by_cell_and_category, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_num_items_visited_by_cell_and_category, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_items_by_cell_id, true, (void *) this);
+  db::mem_stat (stat, purpose, cat, m_items_by_category_id, true, (void *) this);
+}
+
 void
 Database::clear ()
 {
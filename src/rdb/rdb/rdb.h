@@ -27,6 +27,7 @@
 #include "rdbCommon.h"
 
 #include "dbTrans.h"
+#include "dbMemStatistics.h"
 #include "gsi.h"
 #include "tlObject.h"
 #include "tlObjectCollection.h"
@@ -443,6 +444,8 @@ public:
 
   virtual bool compare (const ValueBase *other) const = 0;
 
+  virtual void mem_stat (db::MemStatistics *stat, db::MemStatistics::purpose_t purpose, int cat, bool no_self = false, void *parent = 0) const = 0;
+
   static bool compare (const ValueBase *a, const ValueBase *b);
 
   static ValueBase *create_from_string (const std::string &s);
@@ -516,6 +519,8 @@ public:
     return new Value<C> (m_value);
   }
 
+  void mem_stat (db::MemStatistics *stat, db::MemStatistics::purpose_t purpose, int cat, bool no_self = false, void *parent = 0) const;
+
 private:
   C m_value;
 };
@@ -2293,6 +2298,13 @@ public:
    */
   void load (const std::string &filename);
 
+  /**
+   *  @brief Collects memory statistics
+   *
+   *  All contributions are reported with the given purpose (usually MemStatistics::ReportDatabase).
+   */
+  void mem_stat (db::MemStatistics *stat, db::MemStatistics::purpose_t purpose, int cat, bool no_self = false, void *parent = 0) const;
+
 private:
   std::string m_generator;
   std::string m_filename;
@@ -29,6 +29,7 @@ SOURCES = \
     tlStream.cc \
     tlString.cc \
     tlTimer.cc \
+    tlTrace.cc \
     tlVariant.cc \
     tlFileUtils.cc \
     tlArch.cc \
@@ -78,6 +79,7 @@ HEADERS = \
     tlStream.h \
     tlString.h \
     tlTimer.h \
+    tlTrace.h \
     tlTypeTraits.h \
     tlUtils.h \
     tlVariant.h \
@@ -235,6 +235,14 @@ public:
     mp_lvalue = 0;
   }
 
+  template <class T>
+  void set_value (T v)
+  {
+    //  avoids the temporary tl::Variant object
+    m_rvalue = v;
+    mp_lvalue = 0;
+  }
+
   tl::Variant &get () 
   {
     if (mp_lvalue != 0) {
@@ -435,6 +443,328 @@ ExpressionNode::add_child (ExpressionNode *node)
   m_c.push_back (node);
 }
 
+// ----------------------------------------------------------------------------
+//  The expression bytecode
+
+/**
+ *  @brief Numeric kinds for the specialized operations
+ *
+ *  The kinds are ordered by precedence: if two operands are combined, the
+ *  result has the larger kind of both (this is how the tree interpreter
+ *  promotes the types too).
+ */
+enum NumericKind
+{
+  NoNumber = 0,
+  LongNumber = 1,
+  LongLongNumber = 2,
+  DoubleNumber = 3
+};
+
+static inline int
+numeric_kind (const tl::Variant &v)
+{
+  if (v.is_long ()) {
+    return LongNumber;
+  } else if (v.is_double ()) {
+    return DoubleNumber;
+  } else if (v.is_longlong ()) {
+    return LongLongNumber;
+  } else {
+    return NoNumber;
+  }
+}
+
+/**
+ *  @brief A single instruction of the expression bytecode
+ *
+ *  The bytecode is register based. Binary operations take their operands from
+ *  registers "reg" and "reg + 1" and leave the result in "reg". Register 0 is
+ *  the evaluation target.
+ *
+ *  "node" is the node the instruction was compiled from. It provides the
+ *  location for error messages and the generic implementation of the operation.
+ *  "arg" is the constant index for "Const" and the target for the jump instructions.
+ *  "kind" is the numeric kind of the operands if known at compile time.
+ */
+struct ExpressionInstruction
+{
+  enum opcode_type
+  {
+    Tree = 0,             //  reg = node (tree interpreter)
+    Const,                //  reg = constant [arg]
+    Binary,               //  reg = reg <node> reg + 1 (generic)
+    Unary,                //  reg = <node> reg (generic)
+    Add,                  //  reg = reg + reg + 1
+    Sub,                  //  reg = reg - reg + 1
+    Mul,                  //  reg = reg * reg + 1
+    Div,                  //  reg = reg / reg + 1
+    Mod,                  //  reg = reg % reg + 1
+    Less,                 //  reg = reg < reg + 1
+    LessOrEqual,          //  reg = reg <= reg + 1
+    Greater,              //  reg = reg > reg + 1
+    GreaterOrEqual,       //  reg = reg >= reg + 1
+    Equal,                //  reg = reg == reg + 1
+    NotEqual,             //  reg = reg != reg + 1
+    Neg,                  //  reg = -reg
+    Not,                  //  reg = !reg
+    Jump,                 //  goto arg
+    JumpIfFalse,          //  if (!reg) goto arg
+    JumpIfAndFalse,       //  if (!reg) goto arg, objects count as true ('&&' semantics)
+    JumpIfOrTrue          //  if (reg) goto arg, objects count as true ('||' semantics)
+  };
+
+  ExpressionInstruction (opcode_type _op, unsigned int _reg, const ExpressionNode *_node, size_t _arg = 0, int _kind = NoNumber)
+    : op (_op), kind (_kind), reg (_reg), node (_node), arg (_arg)
+  {
+    //  .. nothing yet ..
+  }
+
+  opcode_type op;
+  int kind;
+  unsigned int reg;
+  const ExpressionNode *node;
+  size_t arg;
+};
+
+/**
+ *  @brief The compiled form of an expression
+ */
+class ExpressionProgram
+{
+public:
+  ExpressionProgram ()
+    : m_registers (1)
+  {
+    //  .. nothing yet ..
+  }
+
+  void execute (EvalTarget &v) const;
+
+private:
+  friend class ExpressionCompiler;
+
+  std::vector<ExpressionInstruction> m_code;
+  std::vector<tl::Variant> m_constants;
+  unsigned int m_registers;
+
+  void run (EvalTarget **regs) const;
+};
+
+/**
+ *  @brief The compiler turning an expression tree into bytecode
+ */
+class ExpressionCompiler
+{
+public:
+  ExpressionCompiler (ExpressionProgram &program)
+    : mp_program (&program)
+  {
+    //  .. nothing yet ..
+  }
+
+  /**
+   *  @brief Compiles the given node into the given register
+   *
+   *  Constant subtrees are evaluated at compile time. If that fails (e.g.
+   *  with a division by zero), the error is reported when the expression is
+   *  executed.
+   *
+   *  Returns the numeric kind of the result if known at compile time.
+   */
+  int compile (const ExpressionNode *node, unsigned int reg)
+  {
+    mp_program->m_registers = std::max (mp_program->m_registers, reg + 1);
+
+    if (node->is_constant ()) {
+      try {
+        EvalTarget v;
+        node->execute (v);
+        return emit_constant (*v, reg, node);
+      } catch (...) {
+        //  fall back to runtime evaluation
+      }
+    }
+
+    return node->compile (*this, reg);
+  }
+
+  /**
+   *  @brief Emits a constant load
+   */
+  int emit_constant (const tl::Variant &value, unsigned int reg, const ExpressionNode *node)
+  {
+    mp_program->m_constants.push_back (value);
+    emit (ExpressionInstruction::Const, reg, node, mp_program->m_constants.size () - 1);
+    return numeric_kind (value);
+  }
+
+  /**
+   *  @brief Emits an instruction
+   *  Returns the address of the instruction.
+   */
+  size_t emit (ExpressionInstruction::opcode_type op, unsigned int reg, const ExpressionNode *node, size_t arg = 0, int kind = NoNumber)
+  {
+    mp_program->m_code.push_back (ExpressionInstruction (op, reg, node, arg, kind));
+    return mp_program->m_code.size () - 1;
+  }
+
+  /**
+   *  @brief Gets the address of the next instruction
+   */
+  size_t address () const
+  {
+    return mp_program->m_code.size ();
+  }
+
+  /**
+   *  @brief Sets the jump target of the instruction at the given address
+   */
+  void set_target (size_t addr, size_t target)
+  {
+    mp_program->m_code [addr].arg = target;
+  }
+
+private:
+  ExpressionProgram *mp_program;
+};
+
+int
+ExpressionNode::compile (ExpressionCompiler &compiler, unsigned int reg) const
+{
+  //  by default, the node is executed with the tree interpreter
+  compiler.emit (ExpressionInstruction::Tree, reg, this);
+  return NoNumber;
+}
+
+bool
+ExpressionNode::is_constant () const
+{
+  return false;
+}
+
+// ----------------------------------------------------------------------------
+//  Base classes for operator nodes
+
+/**
+ *  @brief A base class for binary operator nodes
+ *
+ *  The operator is implemented by "apply" which receives the evaluated operands.
+ *  With this separation, the bytecode interpreter can use the operator implementation
+ *  as the generic case.
+ */
+class TL_PUBLIC BinaryExpressionNode
+  : public ExpressionNode
+{
+public:
+  BinaryExpressionNode (const ExpressionParserContext &context)
+    : ExpressionNode (context, 2)
+  {
+    //  .. nothing yet ..
+  }
+
+  BinaryExpressionNode (const BinaryExpressionNode &other, const tl::Expression *expr)
+    : ExpressionNode (other, expr)
+  {
+    //  .. nothing yet ..
+  }
+
+  void execute (EvalTarget &v) const
+  {
+    EvalTarget b;
+    m_c[0]->execute (v);
+    m_c[1]->execute (b);
+    apply (v, b);
+  }
+
+  int compile (ExpressionCompiler &compiler, unsigned int reg) const
+  {
+    int ka = compiler.compile (m_c[0], reg);
+    int kb = compiler.compile (m_c[1], reg + 1);
+
+    ExpressionInstruction::opcode_type op = opcode ();
+    int kind = (ka != NoNumber && kb != NoNumber) ? std::max (ka, kb) : NoNumber;
+    compiler.emit (op, reg, this, 0, kind);
+
+    if (op == ExpressionInstruction::Add || op == ExpressionInstruction::Sub || op == ExpressionInstruction::Mul || op == ExpressionInstruction::Div) {
+      return kind;
+    } else {
+      return NoNumber;
+    }
+  }
+
+  bool is_constant () const
+  {
+    return m_c[0]->is_constant () && m_c[1]->is_constant ();
+  }
+
+  /**
+   *  @brief Implements the operator: v = v <op> b
+   */
+  virtual void apply (EvalTarget &v, EvalTarget &b) const = 0;
+
+  /**
+   *  @brief Gets the opcode for the bytecode
+   *  The default implementation returns the generic opcode which calls "apply".
+   */
+  virtual ExpressionInstruction::opcode_type opcode () const
+  {
+    return ExpressionInstruction::Binary;
+  }
+};
+
+/**
+ *  @brief A base class for unary operator nodes
+ */
+class TL_PUBLIC UnaryExpressionNode
+  : public ExpressionNode
+{
+public:
+  UnaryExpressionNode (const ExpressionParserContext &context)
+    : ExpressionNode (context, 1)
+  {
+    //  .. nothing yet ..
+  }
+
+  UnaryExpressionNode (const UnaryExpressionNode &other, const tl::Expression *expr)
+    : ExpressionNode (other, expr)
+  {
+    //  .. nothing yet ..
+  }
+
+  void execute (EvalTarget &v) const
+  {
+    m_c[0]->execute (v);
+    apply (v);
+  }
+
+  int compile (ExpressionCompiler &compiler, unsigned int reg) const
+  {
+    int k = compiler.compile (m_c[0], reg);
+    ExpressionInstruction::opcode_type op = opcode ();
+    compiler.emit (op, reg, this, 0, k);
+    return op == ExpressionInstruction::Neg ? k : NoNumber;
+  }
+
+  bool is_constant () const
+  {
+    return m_c[0]->is_constant ();
+  }
+
+  /**
+   *  @brief Implements the operator: v = <op> v
+   */
+  virtual void apply (EvalTarget &v) const = 0;
+
+  /**
+   *  @brief Gets the opcode for the bytecode
+   */
+  virtual ExpressionInstruction::opcode_type opcode () const
+  {
+    return ExpressionInstruction::Unary;
+  }
+};
+
 // ----------------------------------------------------------------------------
 //  ExpressionNode implementations for some binary operators
 
@@ -480,18 +810,18 @@ public:
  *  @brief Less operator node
  */
 class TL_PUBLIC LessExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   LessExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b)
-    : ExpressionNode (context, 2)
+    : BinaryExpressionNode (context)
   {
     add_child (a);
     add_child (b);
   }
 
   LessExpressionNode (const LessExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : BinaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -501,12 +831,13 @@ public:
     return new LessExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  ExpressionInstruction::opcode_type opcode () const
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
+    return ExpressionInstruction::Less;
+  }
 
+  void apply (EvalTarget &v, EvalTarget &b) const 
+  {
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -530,18 +861,18 @@ public:
  *  @brief Less or equal operator node
  */
 class TL_PUBLIC LessOrEqualExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   LessOrEqualExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b)
-    : ExpressionNode (context, 2)
+    : BinaryExpressionNode (context)
   {
     add_child (a);
     add_child (b);
   }
 
   LessOrEqualExpressionNode (const LessOrEqualExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : BinaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -551,12 +882,13 @@ public:
     return new LessOrEqualExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  ExpressionInstruction::opcode_type opcode () const
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
+    return ExpressionInstruction::LessOrEqual;
+  }
 
+  void apply (EvalTarget &v, EvalTarget &b) const 
+  {
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -580,18 +912,18 @@ public:
  *  @brief Greater operator node
  */
 class TL_PUBLIC GreaterExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   GreaterExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b)
-    : ExpressionNode (context, 2)
+    : BinaryExpressionNode (context)
   {
     add_child (a);
     add_child (b);
   }
 
   GreaterExpressionNode (const GreaterExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : BinaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -601,12 +933,13 @@ public:
     return new GreaterExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  ExpressionInstruction::opcode_type opcode () const
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
+    return ExpressionInstruction::Greater;
+  }
 
+  void apply (EvalTarget &v, EvalTarget &b) const 
+  {
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -630,18 +963,18 @@ public:
  *  @brief Greater or equal operator node
  */
 class TL_PUBLIC GreaterOrEqualExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   GreaterOrEqualExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b)
-    : ExpressionNode (context, 2)
+    : BinaryExpressionNode (context)
   {
     add_child (a);
     add_child (b);
   }
 
   GreaterOrEqualExpressionNode (const GreaterOrEqualExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : BinaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -651,12 +984,13 @@ public:
     return new GreaterOrEqualExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  ExpressionInstruction::opcode_type opcode () const
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
+    return ExpressionInstruction::GreaterOrEqual;
+  }
 
+  void apply (EvalTarget &v, EvalTarget &b) const 
+  {
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -680,18 +1014,18 @@ public:
  *  @brief Equal operator node
  */
 class TL_PUBLIC EqualExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   EqualExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b)
-    : ExpressionNode (context, 2)
+    : BinaryExpressionNode (context)
   {
     add_child (a);
     add_child (b);
   }
 
   EqualExpressionNode (const EqualExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : BinaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -701,12 +1035,13 @@ public:
     return new EqualExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  ExpressionInstruction::opcode_type opcode () const
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
+    return ExpressionInstruction::Equal;
+  }
 
+  void apply (EvalTarget &v, EvalTarget &b) const 
+  {
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -730,18 +1065,18 @@ public:
  *  @brief Not equal operator node
  */
 class TL_PUBLIC NotEqualExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   NotEqualExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b)
-    : ExpressionNode (context, 2)
+    : BinaryExpressionNode (context)
   {
     add_child (a);
     add_child (b);
   }
 
   NotEqualExpressionNode (const NotEqualExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : BinaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -751,12 +1086,13 @@ public:
     return new NotEqualExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  ExpressionInstruction::opcode_type opcode () const
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
+    return ExpressionInstruction::NotEqual;
+  }
 
+  void apply (EvalTarget &v, EvalTarget &b) const 
+  {
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -780,18 +1116,18 @@ public:
  *  @brief Match operator node
  */
 class TL_PUBLIC MatchExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   MatchExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b, tl::Eval *eval)
-    : ExpressionNode (context, 2), mp_eval (eval)
+    : BinaryExpressionNode (context), mp_eval (eval)
   {
     add_child (a);
     add_child (b);
   }
 
   MatchExpressionNode (const MatchExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr), mp_eval (other.mp_eval)
+    : BinaryExpressionNode (other, expr), mp_eval (other.mp_eval)
   {
     //  .. nothing yet ..
   }
@@ -801,12 +1137,14 @@ public:
     return new MatchExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  bool is_constant () const
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
+    //  sets the match substrings, hence is not constant
+    return false;
+  }
 
+  void apply (EvalTarget &v, EvalTarget &b) const 
+  {
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -877,18 +1215,18 @@ private:
  *  @brief NoMatch operator node
  */
 class TL_PUBLIC NoMatchExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   NoMatchExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b)
-    : ExpressionNode (context, 2)
+    : BinaryExpressionNode (context)
   {
     add_child (a);
     add_child (b);
   }
 
   NoMatchExpressionNode (const NoMatchExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : BinaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -898,12 +1236,14 @@ public:
     return new NoMatchExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  bool is_constant () const
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
+    //  sets the match substrings, hence is not constant
+    return false;
+  }
 
+  void apply (EvalTarget &v, EvalTarget &b) const 
+  {
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -948,6 +1288,20 @@ public:
     return new LogAndExpressionNode (*this, expr);
   }
 
+  int compile (ExpressionCompiler &compiler, unsigned int reg) const
+  {
+    compiler.compile (m_c[0], reg);
+    size_t jump = compiler.emit (ExpressionInstruction::JumpIfAndFalse, reg, this);
+    compiler.compile (m_c[1], reg);
+    compiler.set_target (jump, compiler.address ());
+    return NoNumber;
+  }
+
+  bool is_constant () const
+  {
+    return m_c[0]->is_constant () && m_c[1]->is_constant ();
+  }
+
   void execute (EvalTarget &v) const 
   {
     m_c[0]->execute (v);
@@ -990,6 +1344,20 @@ public:
     return new LogOrExpressionNode (*this, expr);
   }
 
+  int compile (ExpressionCompiler &compiler, unsigned int reg) const
+  {
+    compiler.compile (m_c[0], reg);
+    size_t jump = compiler.emit (ExpressionInstruction::JumpIfOrTrue, reg, this);
+    compiler.compile (m_c[1], reg);
+    compiler.set_target (jump, compiler.address ());
+    return NoNumber;
+  }
+
+  bool is_constant () const
+  {
+    return m_c[0]->is_constant () && m_c[1]->is_constant ();
+  }
+
   void execute (EvalTarget &v) const 
   {
     m_c[0]->execute (v);
@@ -1032,6 +1400,23 @@ public:
     return new IfExpressionNode (*this, expr);
   }
 
+  int compile (ExpressionCompiler &compiler, unsigned int reg) const
+  {
+    compiler.compile (m_c[0], reg);
+    size_t jump_else = compiler.emit (ExpressionInstruction::JumpIfFalse, reg, this);
+    int k1 = compiler.compile (m_c[1], reg);
+    size_t jump_end = compiler.emit (ExpressionInstruction::Jump, reg, this);
+    compiler.set_target (jump_else, compiler.address ());
+    int k2 = compiler.compile (m_c[2], reg);
+    compiler.set_target (jump_end, compiler.address ());
+    return k1 == k2 ? k1 : NoNumber;
+  }
+
+  bool is_constant () const
+  {
+    return m_c[0]->is_constant () && m_c[1]->is_constant () && m_c[2]->is_constant ();
+  }
+
   void execute (EvalTarget &v) const 
   {
     m_c[0]->execute (v);
@@ -1048,18 +1433,18 @@ public:
  *  @brief Shift left expression node
  */
 class TL_PUBLIC ShiftLeftExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   ShiftLeftExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b)
-    : ExpressionNode (context, 2)
+    : BinaryExpressionNode (context)
   {
     add_child (a);
     add_child (b);
   }
 
   ShiftLeftExpressionNode (const ShiftLeftExpressionNode &other,const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : BinaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -1069,12 +1454,8 @@ public:
     return new ShiftLeftExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  void apply (EvalTarget &v, EvalTarget &b) const 
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
-
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -1104,18 +1485,18 @@ public:
  *  @brief Shift right expression node
  */
 class TL_PUBLIC ShiftRightExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   ShiftRightExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b)
-    : ExpressionNode (context, 2)
+    : BinaryExpressionNode (context)
   {
     add_child (a);
     add_child (b);
   }
 
   ShiftRightExpressionNode (const ShiftRightExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : BinaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -1125,12 +1506,8 @@ public:
     return new ShiftRightExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  void apply (EvalTarget &v, EvalTarget &b) const 
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
-
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -1160,18 +1537,18 @@ public:
  *  @brief Plus expression node
  */
 class TL_PUBLIC PlusExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   PlusExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b)
-    : ExpressionNode (context, 2)
+    : BinaryExpressionNode (context)
   {
     add_child (a);
     add_child (b);
   }
 
   PlusExpressionNode (const PlusExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : BinaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -1181,12 +1558,13 @@ public:
     return new PlusExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  ExpressionInstruction::opcode_type opcode () const
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
+    return ExpressionInstruction::Add;
+  }
 
+  void apply (EvalTarget &v, EvalTarget &b) const 
+  {
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -1222,18 +1600,18 @@ public:
  *  @brief Minus expression node
  */
 class TL_PUBLIC MinusExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   MinusExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b)
-    : ExpressionNode (context, 2)
+    : BinaryExpressionNode (context)
   {
     add_child (a);
     add_child (b);
   }
 
   MinusExpressionNode (const MinusExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : BinaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -1243,12 +1621,13 @@ public:
     return new MinusExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  ExpressionInstruction::opcode_type opcode () const
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
+    return ExpressionInstruction::Sub;
+  }
 
+  void apply (EvalTarget &v, EvalTarget &b) const 
+  {
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -1282,18 +1661,18 @@ public:
  *  @brief Star expression node
  */
 class TL_PUBLIC StarExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   StarExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b)
-    : ExpressionNode (context, 2)
+    : BinaryExpressionNode (context)
   {
     add_child (a);
     add_child (b);
   }
 
   StarExpressionNode (const StarExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : BinaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -1303,12 +1682,13 @@ public:
     return new StarExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  ExpressionInstruction::opcode_type opcode () const
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
+    return ExpressionInstruction::Mul;
+  }
 
+  void apply (EvalTarget &v, EvalTarget &b) const 
+  {
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -1372,18 +1752,18 @@ public:
  *  @brief Slash expression node
  */
 class TL_PUBLIC SlashExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   SlashExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b)
-    : ExpressionNode (context, 2)
+    : BinaryExpressionNode (context)
   {
     add_child (a);
     add_child (b);
   }
 
   SlashExpressionNode (const SlashExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : BinaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -1393,12 +1773,13 @@ public:
     return new SlashExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  ExpressionInstruction::opcode_type opcode () const
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
+    return ExpressionInstruction::Div;
+  }
 
+  void apply (EvalTarget &v, EvalTarget &b) const 
+  {
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -1456,18 +1837,18 @@ public:
  *  @brief Percent expression node
  */
 class TL_PUBLIC PercentExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   PercentExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b)
-    : ExpressionNode (context, 2)
+    : BinaryExpressionNode (context)
   {
     add_child (a);
     add_child (b);
   }
 
   PercentExpressionNode (const PercentExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : BinaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -1477,12 +1858,13 @@ public:
     return new PercentExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  ExpressionInstruction::opcode_type opcode () const
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
+    return ExpressionInstruction::Mod;
+  }
 
+  void apply (EvalTarget &v, EvalTarget &b) const 
+  {
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -1528,18 +1910,18 @@ public:
  *  @brief Ampersand expression node
  */
 class TL_PUBLIC AmpersandExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   AmpersandExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b)
-    : ExpressionNode (context, 2)
+    : BinaryExpressionNode (context)
   {
     add_child (a);
     add_child (b);
   }
 
   AmpersandExpressionNode (const AmpersandExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : BinaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -1549,12 +1931,8 @@ public:
     return new AmpersandExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  void apply (EvalTarget &v, EvalTarget &b) const 
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
-
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -1584,18 +1962,18 @@ public:
  *  @brief Pipe expression node
  */
 class TL_PUBLIC PipeExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   PipeExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b)
-    : ExpressionNode (context, 2)
+    : BinaryExpressionNode (context)
   {
     add_child (a);
     add_child (b);
   }
 
   PipeExpressionNode (const PipeExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : BinaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -1605,12 +1983,8 @@ public:
     return new PipeExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  void apply (EvalTarget &v, EvalTarget &b) const 
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
-
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -1640,18 +2014,18 @@ public:
  *  @brief Acute expression node
  */
 class TL_PUBLIC AcuteExpressionNode
-  : public ExpressionNode
+  : public BinaryExpressionNode
 {
 public:
   AcuteExpressionNode (const ExpressionParserContext &context, ExpressionNode *a, ExpressionNode *b)
-    : ExpressionNode (context, 2)
+    : BinaryExpressionNode (context)
   {
     add_child (a);
     add_child (b);
   }
 
   AcuteExpressionNode (const AcuteExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : BinaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -1661,12 +2035,8 @@ public:
     return new AcuteExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  void apply (EvalTarget &v, EvalTarget &b) const 
   {
-    EvalTarget b;
-    m_c[0]->execute (v);
-    m_c[1]->execute (b);
-
     if (v->is_user ()) {
 
       const EvalClass *c = v->user_cls () ? v->user_cls ()->eval_cls () : 0;
@@ -1778,17 +2148,17 @@ public:
  *  @brief Unary minus expression node
  */
 class TL_PUBLIC UnaryMinusExpressionNode
-  : public ExpressionNode
+  : public UnaryExpressionNode
 {
 public:
   UnaryMinusExpressionNode (const ExpressionParserContext &context, ExpressionNode *a)
-    : ExpressionNode (context, 1)
+    : UnaryExpressionNode (context)
   {
     add_child (a);
   }
 
   UnaryMinusExpressionNode (const UnaryMinusExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : UnaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -1798,10 +2168,13 @@ public:
     return new UnaryMinusExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  ExpressionInstruction::opcode_type opcode () const
   {
-    m_c[0]->execute (v);
+    return ExpressionInstruction::Neg;
+  }
 
+  void apply (EvalTarget &v) const 
+  {
     if (v->is_user ()) {
 
       throw EvalError (tl::to_string (tr ("Unary minus not implemented for objects")), m_context);
@@ -1835,17 +2208,17 @@ public:
  *  @brief Unary tilde expression node
  */
 class TL_PUBLIC UnaryTildeExpressionNode
-  : public ExpressionNode
+  : public UnaryExpressionNode
 {
 public:
   UnaryTildeExpressionNode (const ExpressionParserContext &context, ExpressionNode *a)
-    : ExpressionNode (context, 1)
+    : UnaryExpressionNode (context)
   {
     add_child (a);
   }
 
   UnaryTildeExpressionNode (const UnaryTildeExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : UnaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -1855,10 +2228,8 @@ public:
     return new UnaryTildeExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  void apply (EvalTarget &v) const 
   {
-    m_c[0]->execute (v);
-
     if (v->is_user ()) {
 
       throw EvalError (tl::to_string (tr ("Unary tilde not implemented for objects")), m_context);
@@ -1890,17 +2261,17 @@ public:
  *  @brief Unary not expression node
  */
 class TL_PUBLIC UnaryNotExpressionNode
-  : public ExpressionNode
+  : public UnaryExpressionNode
 {
 public:
   UnaryNotExpressionNode (const ExpressionParserContext &context, ExpressionNode *a)
-    : ExpressionNode (context, 1)
+    : UnaryExpressionNode (context)
   {
     add_child (a);
   }
 
   UnaryNotExpressionNode (const UnaryNotExpressionNode &other, const tl::Expression *expr)
-    : ExpressionNode (other, expr)
+    : UnaryExpressionNode (other, expr)
   {
     //  .. nothing yet ..
   }
@@ -1910,10 +2281,13 @@ public:
     return new UnaryNotExpressionNode (*this, expr);
   }
 
-  void execute (EvalTarget &v) const 
+  ExpressionInstruction::opcode_type opcode () const
   {
-    m_c[0]->execute (v);
+    return ExpressionInstruction::Not;
+  }
 
+  void apply (EvalTarget &v) const 
+  {
     if (v->is_user ()) {
       //  objects act as true
       v.set (false);
@@ -1947,6 +2321,16 @@ public:
     return new ConstantExpressionNode (*this, expr);
   }
 
+  int compile (ExpressionCompiler &compiler, unsigned int reg) const
+  {
+    return compiler.emit_constant (m_value, reg, this);
+  }
+
+  bool is_constant () const
+  {
+    return true;
+  }
+
   void execute (EvalTarget &v) const 
   {
     v.set (m_value);
@@ -2153,6 +2537,15 @@ public:
     return new SequenceExpressionNode (*this, expr);
   }
 
+  int compile (ExpressionCompiler &compiler, unsigned int reg) const
+  {
+    int k = NoNumber;
+    for (std::vector<ExpressionNode *>::const_iterator c = m_c.begin (); c != m_c.end (); ++c) {
+      k = compiler.compile (*c, reg);
+    }
+    return k;
+  }
+
   void execute (EvalTarget &v) const 
   {
     for (std::vector<ExpressionNode *>::const_iterator c = m_c.begin (); c != m_c.end (); ++c) {
@@ -2271,6 +2664,267 @@ private:
   tl::Variant *mp_var;
 };
 
+// ----------------------------------------------------------------------------
+//  Implementation of the bytecode interpreter
+
+/**
+ *  @brief Gets the numeric kind for a specialized binary operation
+ *  Returns NoNumber if the generic implementation needs to be used.
+ */
+static inline int
+binary_kind (const ExpressionInstruction &i, const tl::Variant &a, const tl::Variant &b)
+{
+  if (i.kind != NoNumber) {
+    return i.kind;
+  }
+  int ka = numeric_kind (a);
+  if (ka == NoNumber) {
+    return NoNumber;
+  }
+  int kb = numeric_kind (b);
+  if (kb == NoNumber) {
+    return NoNumber;
+  }
+  return std::max (ka, kb);
+}
+
+struct add_op { template <class T> T operator() (T a, T b) const { return a + b; } };
+struct sub_op { template <class T> T operator() (T a, T b) const { return a - b; } };
+struct mul_op { template <class T> T operator() (T a, T b) const { return a * b; } };
+struct less_op { template <class T> bool operator() (T a, T b) const { return a < b; } };
+struct less_or_equal_op { template <class T> bool operator() (T a, T b) const { return a <= b; } };
+struct greater_op { template <class T> bool operator() (T a, T b) const { return a > b; } };
+struct greater_or_equal_op { template <class T> bool operator() (T a, T b) const { return a >= b; } };
+struct equal_op { template <class T> bool operator() (T a, T b) const { return a == b; } };
+struct not_equal_op { template <class T> bool operator() (T a, T b) const { return a != b; } };
+
+template <class Op>
+static inline bool
+arith_op (const ExpressionInstruction &i, EvalTarget &a, EvalTarget &b, Op op)
+{
+  switch (binary_kind (i, *a, *b)) {
+  case LongNumber:
+    a.set_value (op (a->to_long (), b->to_long ()));
+    return true;
+  case LongLongNumber:
+    a.set_value (op (a->to_longlong (), b->to_longlong ()));
+    return true;
+  case DoubleNumber:
+    a.set_value (op (a->to_double (), b->to_double ()));
+    return true;
+  default:
+    return false;
+  }
+}
+
+template <class Op>
+static inline bool
+compare_op (const ExpressionInstruction &i, EvalTarget &a, EvalTarget &b, Op op)
+{
+  switch (binary_kind (i, *a, *b)) {
+  case LongNumber:
+  case LongLongNumber:
+    a.set_value (op (a->to_longlong (), b->to_longlong ()));
+    return true;
+  case DoubleNumber:
+    a.set_value (op (a->to_double (), b->to_double ()));
+    return true;
+  default:
+    return false;
+  }
+}
+
+void
+ExpressionProgram::execute (EvalTarget &v) const
+{
+  //  register 0 is the target, the others are temporaries
+  const unsigned int max_local = 8;
+
+  if (m_registers <= max_local) {
+
+    EvalTarget temps [max_local - 1];
+    EvalTarget *regs [max_local];
+    regs [0] = &v;
+    for (unsigned int i = 1; i < m_registers; ++i) {
+      regs [i] = temps + (i - 1);
+    }
+
+    run (regs);
+
+  } else {
+
+    std::vector<EvalTarget> temps (m_registers - 1);
+    std::vector<EvalTarget *> regs (m_registers, 0);
+    regs [0] = &v;
+    for (unsigned int i = 1; i < m_registers; ++i) {
+      regs [i] = &temps [i - 1];
+    }
+
+    run (&regs.front ());
+
+  }
+}
+
+void
+ExpressionProgram::run (EvalTarget **regs) const
+{
+  const ExpressionInstruction *code = m_code.empty () ? 0 : &m_code.front ();
+  size_t n = m_code.size ();
+
+  for (size_t pc = 0; pc < n; ) {
+
+    const ExpressionInstruction &i = code [pc++];
+    EvalTarget &a = *regs [i.reg];
+
+    switch (i.op) {
+
+    case ExpressionInstruction::Tree:
+      i.node->execute (a);
+      break;
+
+    case ExpressionInstruction::Const:
+      a.set (m_constants [i.arg]);
+      break;
+
+    case ExpressionInstruction::Add:
+      if (! arith_op (i, a, *regs [i.reg + 1], add_op ())) {
+        static_cast<const BinaryExpressionNode *> (i.node)->apply (a, *regs [i.reg + 1]);
+      }
+      break;
+
+    case ExpressionInstruction::Sub:
+      if (! arith_op (i, a, *regs [i.reg + 1], sub_op ())) {
+        static_cast<const BinaryExpressionNode *> (i.node)->apply (a, *regs [i.reg + 1]);
+      }
+      break;
+
+    case ExpressionInstruction::Mul:
+      if (! arith_op (i, a, *regs [i.reg + 1], mul_op ())) {
+        static_cast<const BinaryExpressionNode *> (i.node)->apply (a, *regs [i.reg + 1]);
+      }
+      break;
+
+    case ExpressionInstruction::Div:
+      {
+        EvalTarget &b = *regs [i.reg + 1];
+        int k = binary_kind (i, *a, *b);
+        //  division by zero is reported by the generic implementation
+        if (k == LongNumber && b->to_long () != 0) {
+          a.set_value (a->to_long () / b->to_long ());
+        } else if (k == LongLongNumber && b->to_longlong () != 0) {
+          a.set_value (a->to_longlong () / b->to_longlong ());
+        } else if (k == DoubleNumber && b->to_double () != 0.0) {
+          a.set_value (a->to_double () / b->to_double ());
+        } else {
+          static_cast<const BinaryExpressionNode *> (i.node)->apply (a, b);
+        }
+      }
+      break;
+
+    case ExpressionInstruction::Mod:
+      {
+        EvalTarget &b = *regs [i.reg + 1];
+        int k = binary_kind (i, *a, *b);
+        //  modulo by zero is reported by the generic implementation
+        if (k == LongNumber && b->to_long () != 0) {
+          a.set_value (a->to_long () % b->to_long ());
+        } else if (k == LongLongNumber && b->to_longlong () != 0) {
+          a.set_value (a->to_longlong () % b->to_longlong ());
+        } else {
+          static_cast<const BinaryExpressionNode *> (i.node)->apply (a, b);
+        }
+      }
+      break;
+
+    case ExpressionInstruction::Less:
+      if (! compare_op (i, a, *regs [i.reg + 1], less_op ())) {
+        static_cast<const BinaryExpressionNode *> (i.node)->apply (a, *regs [i.reg + 1]);
+      }
+      break;
+
+    case ExpressionInstruction::LessOrEqual:
+      if (! compare_op (i, a, *regs [i.reg + 1], less_or_equal_op ())) {
+        static_cast<const BinaryExpressionNode *> (i.node)->apply (a, *regs [i.reg + 1]);
+      }
+      break;
+
+    case ExpressionInstruction::Greater:
+      if (! compare_op (i, a, *regs [i.reg + 1], greater_op ())) {
+        static_cast<const BinaryExpressionNode *> (i.node)->apply (a, *regs [i.reg + 1]);
+      }
+      break;
+
+    case ExpressionInstruction::GreaterOrEqual:
+      if (! compare_op (i, a, *regs [i.reg + 1], greater_or_equal_op ())) {
+        static_cast<const BinaryExpressionNode *> (i.node)->apply (a, *regs [i.reg + 1]);
+      }
+      break;
+
+    case ExpressionInstruction::Equal:
+      if (! compare_op (i, a, *regs [i.reg + 1], equal_op ())) {
+        static_cast<const BinaryExpressionNode *> (i.node)->apply (a, *regs [i.reg + 1]);
+      }
+      break;
+
+    case ExpressionInstruction::NotEqual:
+      if (! compare_op (i, a, *regs [i.reg + 1], not_equal_op ())) {
+        static_cast<const BinaryExpressionNode *> (i.node)->apply (a, *regs [i.reg + 1]);
+      }
+      break;
+
+    case ExpressionInstruction::Binary:
+      static_cast<const BinaryExpressionNode *> (i.node)->apply (a, *regs [i.reg + 1]);
+      break;
+
+    case ExpressionInstruction::Neg:
+      {
+        int k = i.kind != NoNumber ? i.kind : numeric_kind (*a);
+        if (k == LongNumber) {
+          a.set_value (-a->to_long ());
+        } else if (k == LongLongNumber) {
+          a.set_value (-a->to_longlong ());
+        } else if (k == DoubleNumber) {
+          a.set_value (-a->to_double ());
+        } else {
+          static_cast<const UnaryExpressionNode *> (i.node)->apply (a);
+        }
+      }
+      break;
+
+    case ExpressionInstruction::Not:
+    case ExpressionInstruction::Unary:
+      static_cast<const UnaryExpressionNode *> (i.node)->apply (a);
+      break;
+
+    case ExpressionInstruction::Jump:
+      pc = i.arg;
+      break;
+
+    case ExpressionInstruction::JumpIfFalse:
+      if (! a->to_bool ()) {
+        pc = i.arg;
+      }
+      break;
+
+    case ExpressionInstruction::JumpIfAndFalse:
+      //  an object always evaluates to "true"
+      if (! a->is_user () && ! a->to_bool ()) {
+        pc = i.arg;
+      }
+      break;
+
+    case ExpressionInstruction::JumpIfOrTrue:
+      //  an object always evaluates to "true"
+      if (a->is_user () || a->to_bool ()) {
+        pc = i.arg;
+      }
+      break;
+
+    }
+
+  }
+}
+
 // ----------------------------------------------------------------------------
 //  Implementation of functions
 
@@ -3090,6 +3744,11 @@ Expression::Expression (Eval *eval, const char *expr)
   // .. nothing yet ..
 }
 
+Expression::~Expression ()
+{
+  //  .. nothing yet ..
+}
+
 Expression &
 Expression::operator= (const Expression &d)
 {
@@ -3102,10 +3761,22 @@ Expression::operator= (const Expression &d)
     } else {
       m_root.reset (0);
     }
+    compile ();
   }
   return *this;
 }
 
+void
+Expression::compile ()
+{
+  m_program.reset (0);
+  if (m_root.get ()) {
+    m_program.reset (new ExpressionProgram ());
+    ExpressionCompiler compiler (*m_program);
+    compiler.compile (m_root.get (), 0);
+  }
+}
+
 tl::Variant 
 Expression::execute () const
 {
@@ -3117,7 +3788,9 @@ Expression::execute () const
 void
 Expression::execute (EvalTarget &v) const
 {
-  if (m_root.get ()) {
+  if (m_program.get ()) {
+    m_program->execute (v);
+  } else if (m_root.get ()) {
     m_root->execute (v);
   } 
 }
@@ -3991,6 +4664,8 @@ Eval::parse (Expression &expr, const std::string &s, bool top)
   }
 
   context.expect_end ();
+
+  expr.compile ();
 }
 
 void 
@@ -4008,6 +4683,7 @@ Eval::parse (Expression &expr, tl::Extractor &ex, bool top)
   }
 
   expr.set_text (std::string (ex0.get (), ex.get () - ex0.get ())); 
+  expr.compile ();
 
   ex = context;
 }
@@ -43,6 +43,8 @@ class EvalTarget;
 class Expression;
 class ExpressionNode;
 class ExpressionParserContext;
+class ExpressionCompiler;
+class ExpressionProgram;
 
 /**
  *  @brief An interface handling the evaluation context
@@ -198,6 +200,22 @@ public:
    */
   virtual ExpressionNode *clone (const tl::Expression *expr) const = 0;
 
+  /**
+   *  @brief Compiles the node into bytecode
+   *
+   *  The code leaves the result in register "reg" and may use the registers above
+   *  "reg" as temporaries. The default implementation makes the bytecode interpreter
+   *  execute the node with the tree interpreter.
+   *  Returns the numeric kind of the result if it is known at compile time and 0 otherwise.
+   */
+  virtual int compile (ExpressionCompiler &compiler, unsigned int reg) const;
+
+  /**
+   *  @brief Returns a value indicating whether the node always delivers the same value
+   *  Such nodes are evaluated at compile time.
+   */
+  virtual bool is_constant () const;
+
 protected:
   std::vector <ExpressionNode *> m_c;
   ExpressionParserContext m_context;
@@ -289,6 +307,11 @@ public:
    */
   Expression (const Expression &d);
 
+  /**
+   *  @brief Destructor
+   */
+  ~Expression ();
+
   /**
    *  @brief Assignment
    */
@@ -332,6 +355,7 @@ private:
   const char *mp_text;
   std::string m_local_text;
   std::auto_ptr<ExpressionNode> m_root;
+  std::auto_ptr<ExpressionProgram> m_program;
   Eval *mp_eval;
 
   friend class Eval;
@@ -353,6 +377,12 @@ private:
   {
     return m_root;
   }
+
+  /**
+   *  @brief Compiles the expression tree into bytecode
+   *  This method needs to be called after the tree has been built.
+   */
+  void compile ();
 };
 
 /**
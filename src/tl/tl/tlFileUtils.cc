@@ -31,12 +31,14 @@
 
 #  include <sys/types.h>
 #  include <sys/stat.h>
+#  include <sys/utime.h>
 #  include <io.h>
 #  include <Windows.h>
 
 #elif defined(_WIN32)
 
 #  include <sys/stat.h>
+#  include <sys/utime.h>
 #  include <unistd.h>
 #  include <dirent.h>
 #  include <dir.h>
@@ -45,6 +47,7 @@
 #elif defined(__APPLE__)
 
 #  include <sys/stat.h>
+#  include <utime.h>
 #  include <unistd.h>
 #  include <dirent.h>
 #  include <libproc.h>
@@ -53,6 +56,7 @@
 #else
 
 #  include <sys/stat.h>
+#  include <utime.h>
 #  include <unistd.h>
 #  include <dirent.h>
 #  include <dlfcn.h>
@@ -726,6 +730,35 @@ bool is_dir (const std::string &p)
   }
 }
 
+size_t file_size (const std::string &p)
+{
+  stat_struct st;
+  if (stat_func (p, st) != 0) {
+    return 0;
+  } else {
+    return size_t (st.st_size);
+  }
+}
+
+long long file_last_modified (const std::string &p)
+{
+  stat_struct st;
+  if (stat_func (p, st) != 0) {
+    return 0;
+  } else {
+    return (long long) st.st_mtime;
+  }
+}
+
+bool touch_file (const std::string &path)
+{
+#if defined(_WIN32)
+  return _wutime (tl::to_wstring (path).c_str (), 0) == 0;
+#else
+  return utime (tl::to_local (path).c_str (), 0) == 0;
+#endif
+}
+
 std::string relative_path (const std::string &base, const std::string &p)
 {
   std::vector<std::string> rem;
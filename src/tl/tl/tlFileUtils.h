@@ -116,6 +116,23 @@ bool TL_PUBLIC is_readable (const std::string &s);
  */
 bool TL_PUBLIC is_dir (const std::string &s);
 
+/**
+ *  @brief Gets the size of the given file in bytes or 0 if the file does not exist
+ */
+size_t TL_PUBLIC file_size (const std::string &s);
+
+/**
+ *  @brief Gets the time of the last modification of the given file in seconds since the epoch
+ *  Returns 0 if the file does not exist.
+ */
+long long TL_PUBLIC file_last_modified (const std::string &s);
+
+/**
+ *  @brief Sets the time of the last modification of the given file to the current time
+ *  Returns true on success.
+ */
+bool TL_PUBLIC touch_file (const std::string &path);
+
 /**
  *  @brief Gets the directory entries for the given directory
  *  This method will NEVER return the ".." entry.
@@ -25,6 +25,7 @@
 #include "tlString.h"
 #include "tlAssert.h"
 #include "tlThreads.h"
+#include "tlTrace.h"
 
 #include <stdio.h>
 #include <math.h>
@@ -71,7 +72,8 @@ Progress::Progress (const std::string &desc, size_t yield_interval)
     m_yield_interval (yield_interval), 
     m_last_value (-1.0),
     m_can_cancel (true),
-    m_cancelled (false)
+    m_cancelled (false),
+    m_trace_start (-1)
 {
   //  .. nothing yet ..
 }
@@ -84,6 +86,8 @@ Progress::~Progress ()
 void
 Progress::initialize ()
 {
+  m_trace_start = tl::Tracer::is_enabled () ? tl::Tracer::now () : -1;
+
   ProgressAdaptor *a = adaptor ();
   if (a) {
     a->register_object (this);
@@ -97,6 +101,10 @@ Progress::shutdown ()
   if (a) {
     a->unregister_object (this);
   }
+
+  if (m_trace_start >= 0) {
+    tl::Tracer::record ("progress", m_desc, m_trace_start, tl::Tracer::now ());
+  }
 }
 
 void 
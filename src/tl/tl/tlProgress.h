@@ -226,6 +226,7 @@ private:
   bool m_can_cancel;
   bool m_cancelled;
   tl::Clock m_last_yield;
+  int64_t m_trace_start;
 
   static tl::ProgressAdaptor *adaptor ();
   static void register_adaptor (tl::ProgressAdaptor *pa);
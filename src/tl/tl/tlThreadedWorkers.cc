@@ -25,6 +25,8 @@
 #include "tlLog.h"
 #include "tlProgress.h"
 #include "tlAssert.h"
+#include "tlTrace.h"
+#include "tlString.h"
 
 #include <memory>
 #include <stdio.h>
@@ -281,6 +283,7 @@ JobBase::start ()
     while (! m_task_list.is_empty ()) {
       std::auto_ptr<Task> task (m_task_list.fetch ());
       try {
+        tl::TraceScope trace ("task", "task");
         sync_worker->perform_task (task.get ());
       } catch (TaskTerminatedException) {
         //  Stop the thread.
@@ -583,10 +586,15 @@ Worker::run ()
 {
   WorkerProgressAdaptor progress_adaptor (this);
 
+  if (tl::Tracer::is_enabled ()) {
+    tl::Tracer::set_thread_name (tl::sprintf ("Worker %d", m_worker_index));
+  }
+
   while (true)
   {
     try {
       std::auto_ptr<Task> task (mp_job->get_task (m_worker_index));
+      tl::TraceScope trace ("task", "task");
       perform_task (task.get ());
     } catch (TaskTerminatedException) {
       //  .. try again
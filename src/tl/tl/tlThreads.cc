@@ -20,9 +20,14 @@
 
 */
 
+#include "tlThreads.h"
+
+#if defined(HAVE_QT) && !defined(HAVE_PTHREADS)
+#  include <QThread>
+#endif
+
 #if !defined(HAVE_QT) || defined(HAVE_PTHREADS)
 
-#include "tlThreads.h"
 #include "tlUtils.h"
 #include "tlTimer.h"
 #include "tlLog.h"
@@ -404,3 +409,25 @@ ThreadStorageHolderBase *ThreadStorageBase::holder ()
 }
 
 #endif
+
+// -------------------------------------------------------------------------------
+//  Implementation of available_cores (for all thread implementations)
+
+namespace tl
+{
+
+int available_cores ()
+{
+#if defined(HAVE_QT) && !defined(HAVE_PTHREADS)
+  int n = QThread::idealThreadCount ();
+#elif defined(_WIN32)
+  SYSTEM_INFO si;
+  GetSystemInfo (&si);
+  int n = int (si.dwNumberOfProcessors);
+#else
+  int n = int (sysconf (_SC_NPROCESSORS_ONLN));
+#endif
+  return n < 1 ? 1 : n;
+}
+
+}
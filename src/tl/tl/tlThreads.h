@@ -259,6 +259,13 @@ public:
 
 #endif
 
+/**
+ *  @brief Gets the number of processor cores available
+ *
+ *  This is the number of threads which can run concurrently. The value is at least 1.
+ */
+TL_PUBLIC int available_cores ();
+
 }
 
 #endif
@@ -24,9 +24,11 @@
 #include "tlTimer.h"
 #include "tlLog.h"
 #include "tlString.h"
+#include "tlTrace.h"
 
 #ifndef _WIN32
 #  include <sys/times.h>
+#  include <sys/resource.h>
 #endif
 
 #include <stdio.h>
@@ -186,19 +188,12 @@ Timer::take ()
   m_wall_ms = wall_ms;
 }
 
-void
-SelfTimer::start_report () const
-{
-  tl::info << m_desc << ": " << tl::to_string (tr ("started"));
-}
-
-void
-SelfTimer::report () const
+size_t
+Timer::memory_size ()
 {
 #ifdef _WIN32
-  tl::info << m_desc << ": (user) " << sec_user () << " (sys) " << sec_sys ();
+  return 0;
 #else
-
   unsigned long memsize = 0;
   FILE *procfile = fopen ("/proc/self/stat", "r");
   if (procfile != NULL) {
@@ -250,6 +245,58 @@ SelfTimer::report () const
     }
   }
 
+  return size_t (memsize);
+#endif
+}
+
+size_t
+Timer::peak_memory_size ()
+{
+#ifdef _WIN32
+  return 0;
+#else
+  struct rusage usage;
+  if (getrusage (RUSAGE_SELF, &usage) != 0) {
+    return 0;
+  }
+#if defined(__MACH__)
+  //  on Mac OS, ru_maxrss is given in bytes
+  return size_t (usage.ru_maxrss);
+#else
+  return size_t (usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+void
+SelfTimer::trace_start ()
+{
+  //  scopes are traced independently from the reporting
+  m_trace_start = tl::Tracer::is_enabled () ? tl::Tracer::now () : -1;
+}
+
+void
+SelfTimer::trace_stop () const
+{
+  if (m_trace_start >= 0) {
+    tl::Tracer::record ("timer", m_desc, m_trace_start, tl::Tracer::now ());
+  }
+}
+
+void
+SelfTimer::start_report () const
+{
+  tl::info << m_desc << ": " << tl::to_string (tr ("started"));
+}
+
+void
+SelfTimer::report () const
+{
+#ifdef _WIN32
+  tl::info << m_desc << ": (user) " << sec_user () << " (sys) " << sec_sys ();
+#else
+  size_t memsize = memory_size ();
+
   tl::info << m_desc << ": " << sec_user () << " (user) "
            << sec_sys () << " (sys) "
            << sec_wall () << " (wall) "
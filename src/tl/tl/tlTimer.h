@@ -95,6 +95,21 @@ public:
     return (double (m_wall_ms_res) * 0.001);
   }
 
+  /**
+   *  @brief Gets the current virtual memory size of the process in bytes
+   *
+   *  Returns 0 if this information is not available on the platform.
+   */
+  static size_t memory_size ();
+
+  /**
+   *  @brief Gets the peak resident memory size of the process in bytes
+   *
+   *  This value is the high-water mark of the resident set size and never decreases.
+   *  Returns 0 if this information is not available on the platform.
+   */
+  static size_t peak_memory_size ();
+
 private:
   timer_t m_user_ms, m_sys_ms, m_wall_ms;
   timer_t m_user_ms_res, m_sys_ms_res, m_wall_ms_res;
@@ -117,6 +132,7 @@ public:
   SelfTimer (const std::string &desc) : Timer (), m_desc (desc)
   {
     m_enabled = true;
+    trace_start ();
     start ();
     start_report ();
   }
@@ -130,6 +146,7 @@ public:
   SelfTimer (bool enabled, const std::string &desc) : Timer (), m_desc (desc)
   {
     m_enabled = enabled;
+    trace_start ();
     if (enabled) {
       start ();
       start_report ();
@@ -142,14 +159,18 @@ public:
       stop ();
       report ();
     }
+    trace_stop ();
   }
 
 private:
   void report () const;
   void start_report () const;
+  void trace_start ();
+  void trace_stop () const;
 
   std::string m_desc;
   bool m_enabled;
+  int64_t m_trace_start;
 };
 
 /**
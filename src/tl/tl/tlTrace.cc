@@ -0,0 +1,444 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2020 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+#include "tlTrace.h"
+#include "tlThreads.h"
+#include "tlStream.h"
+#include "tlString.h"
+#include "tlEnv.h"
+
+#include <vector>
+#include <sstream>
+#include <time.h>
+
+#if defined(__MACH__)
+#  include <mach/clock.h>
+#  include <mach/mach.h>
+#endif
+
+#if defined(_MSC_VER)
+#  include <Windows.h>
+#endif
+
+namespace tl
+{
+
+namespace
+{
+
+/**
+ *  @brief A single complete event
+ */
+struct TraceEvent
+{
+  TraceEvent () : category (0), start (0), end (0) { }
+
+  const char *category;
+  std::string name;
+  int64_t start, end;
+};
+
+/**
+ *  @brief The per-thread ring buffer
+ */
+class TraceBuffer
+{
+public:
+  TraceBuffer (int tid)
+    : m_tid (tid), m_name (tl::sprintf ("Thread %d", tid)), m_first (0)
+  {
+    //  .. nothing yet ..
+  }
+
+  int tid () const
+  {
+    return m_tid;
+  }
+
+  void set_name (const std::string &name)
+  {
+    tl::MutexLocker locker (&m_lock);
+    m_name = name;
+  }
+
+  void add (size_t capacity, const char *category, const std::string &name, int64_t start, int64_t end)
+  {
+    tl::MutexLocker locker (&m_lock);
+
+    TraceEvent *e = 0;
+    if (m_events.size () < capacity) {
+      m_events.push_back (TraceEvent ());
+      e = &m_events.back ();
+    } else if (! m_events.empty ()) {
+      //  overwrite the oldest event
+      e = &m_events [m_first];
+      m_first = (m_first + 1) % m_events.size ();
+    } else {
+      return;
+    }
+
+    e->category = category;
+    e->name = name;
+    e->start = start;
+    e->end = end;
+  }
+
+  void clear ()
+  {
+    tl::MutexLocker locker (&m_lock);
+    m_events.clear ();
+    m_first = 0;
+  }
+
+  void write (std::ostream &os, int64_t t0, bool &first)
+  {
+    tl::MutexLocker locker (&m_lock);
+
+    if (m_events.empty ()) {
+      return;
+    }
+
+    os << (first ? "\n" : ",\n");
+    first = false;
+    os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << m_tid << ",\"args\":{\"name\":";
+    write_string (os, m_name);
+    os << "}}";
+
+    for (size_t i = 0; i < m_events.size (); ++i) {
+      const TraceEvent &e = m_events [(m_first + i) % m_events.size ()];
+      os << ",\n{\"name\":";
+      write_string (os, e.name);
+      os << ",\"cat\":";
+      write_string (os, e.category ? e.category : "");
+      os << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << m_tid << ",\"ts\":" << (e.start - t0) << ",\"dur\":" << (e.end - e.start) << "}";
+    }
+  }
+
+private:
+  int m_tid;
+  std::string m_name;
+  std::vector<TraceEvent> m_events;
+  size_t m_first;
+  tl::Mutex m_lock;
+
+  static void write_string (std::ostream &os, const std::string &s)
+  {
+    os << "\"";
+    for (const char *c = s.c_str (); *c; ++c) {
+      if (*c == '"' || *c == '\\') {
+        os << "\\" << *c;
+      } else if ((unsigned char) *c < 0x20) {
+        os << tl::sprintf ("\\u%04x", int ((unsigned char) *c));
+      } else {
+        os << *c;
+      }
+    }
+    os << "\"";
+  }
+};
+
+/**
+ *  @brief The global tracer state
+ *
+ *  The state is never destroyed as thread handles may refer to it while
+ *  the application shuts down.
+ */
+struct TraceState
+{
+  TraceState ()
+    : capacity (0), t0 (0)
+  {
+    //  .. nothing yet ..
+  }
+
+  TraceBuffer *acquire ()
+  {
+    tl::MutexLocker locker (&lock);
+
+    //  reuse the free buffer with the lowest thread ID
+    if (! free_buffers.empty ()) {
+      std::vector<TraceBuffer *>::iterator b = free_buffers.begin ();
+      for (std::vector<TraceBuffer *>::iterator i = free_buffers.begin (); i != free_buffers.end (); ++i) {
+        if ((*i)->tid () < (*b)->tid ()) {
+          b = i;
+        }
+      }
+      TraceBuffer *buffer = *b;
+      free_buffers.erase (b);
+      return buffer;
+    }
+
+    buffers.push_back (new TraceBuffer (int (buffers.size ()) + 1));
+    return buffers.back ();
+  }
+
+  void release (TraceBuffer *buffer)
+  {
+    tl::MutexLocker locker (&lock);
+    free_buffers.push_back (buffer);
+  }
+
+  tl::Mutex lock;
+  std::vector<TraceBuffer *> buffers;
+  std::vector<TraceBuffer *> free_buffers;
+  size_t capacity;
+  std::string output_file;
+  int64_t t0;
+};
+
+static TraceState *state ()
+{
+  static TraceState *s_state = new TraceState ();
+  return s_state;
+}
+
+static volatile bool s_enabled = false;
+
+/**
+ *  @brief The per-thread handle which returns the buffer to the pool when the thread terminates
+ *
+ *  The handle is stored by value in the thread-local storage, so it is destroyed when
+ *  the thread terminates. Copies do not own the buffer - the buffer is attached to the
+ *  handle inside the storage only.
+ */
+class TraceThreadHandle
+{
+public:
+  TraceThreadHandle ()
+    : mp_buffer (0)
+  {
+    //  .. nothing yet ..
+  }
+
+  TraceThreadHandle (const TraceThreadHandle &)
+    : mp_buffer (0)
+  {
+    //  .. nothing yet ..
+  }
+
+  TraceThreadHandle &operator= (const TraceThreadHandle &)
+  {
+    return *this;
+  }
+
+  ~TraceThreadHandle ()
+  {
+    if (mp_buffer) {
+      state ()->release (mp_buffer);
+    }
+  }
+
+  TraceBuffer *buffer ()
+  {
+    if (! mp_buffer) {
+      mp_buffer = state ()->acquire ();
+    }
+    return mp_buffer;
+  }
+
+private:
+  TraceBuffer *mp_buffer;
+};
+
+static tl::ThreadStorage<TraceThreadHandle> s_thread_handle;
+
+static TraceBuffer *current_buffer ()
+{
+  if (! s_thread_handle.hasLocalData ()) {
+    s_thread_handle.setLocalData (TraceThreadHandle ());
+  }
+  return s_thread_handle.localData ().buffer ();
+}
+
+}
+
+// -------------------------------------------------------------------------------------------
+//  Tracer implementation
+
+void
+Tracer::start (const std::string &output_file, size_t buffer_size)
+{
+  clear ();
+
+  {
+    TraceState *st = state ();
+    tl::MutexLocker locker (&st->lock);
+    st->output_file = output_file;
+    st->capacity = buffer_size;
+    st->t0 = now ();
+  }
+
+  s_enabled = true;
+  set_thread_name ("Main");
+}
+
+void
+Tracer::stop ()
+{
+  std::string output_file;
+
+  {
+    TraceState *st = state ();
+    tl::MutexLocker locker (&st->lock);
+    if (! s_enabled) {
+      return;
+    }
+    s_enabled = false;
+    output_file = st->output_file;
+  }
+
+  if (! output_file.empty ()) {
+    write (output_file);
+  }
+}
+
+bool
+Tracer::is_enabled ()
+{
+  return s_enabled;
+}
+
+int64_t
+Tracer::now ()
+{
+#if defined(__MACH__)
+
+  clock_serv_t cclock;
+  mach_timespec_t mts;
+  host_get_clock_service (mach_host_self (), SYSTEM_CLOCK, &cclock);
+  clock_get_time (cclock, &mts);
+  mach_port_deallocate (mach_task_self (), cclock);
+
+  return int64_t (mts.tv_sec) * 1000000 + int64_t (mts.tv_nsec / 1000);
+
+#elif defined(_MSC_VER)
+
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency (&freq);
+  QueryPerformanceCounter (&count);
+
+  return int64_t (count.QuadPart / freq.QuadPart) * 1000000 + int64_t ((count.QuadPart % freq.QuadPart) * 1000000 / freq.QuadPart);
+
+#else
+
+  timespec ts;
+  clock_gettime (CLOCK_MONOTONIC, &ts);
+  return int64_t (ts.tv_sec) * 1000000 + int64_t (ts.tv_nsec / 1000);
+
+#endif
+}
+
+void
+Tracer::record (const char *category, const std::string &name, int64_t start, int64_t end)
+{
+  current_buffer ()->add (state ()->capacity, category, name, start, end);
+}
+
+void
+Tracer::set_thread_name (const std::string &name)
+{
+  current_buffer ()->set_name (name);
+}
+
+void
+Tracer::write (std::ostream &os)
+{
+  TraceState *st = state ();
+
+  std::vector<TraceBuffer *> buffers;
+  int64_t t0 = 0;
+  {
+    tl::MutexLocker locker (&st->lock);
+    buffers = st->buffers;
+    t0 = st->t0;
+  }
+
+  os << "{\"traceEvents\":[";
+
+  bool first = true;
+  for (std::vector<TraceBuffer *>::const_iterator b = buffers.begin (); b != buffers.end (); ++b) {
+    (*b)->write (os, t0, first);
+  }
+
+  os << "\n],\n\"displayTimeUnit\":\"ms\"}\n";
+}
+
+void
+Tracer::write (const std::string &path)
+{
+  std::ostringstream os;
+  write (os);
+
+  std::string s = os.str ();
+  tl::OutputStream stream (path);
+  stream.put (s.c_str (), s.size ());
+}
+
+void
+Tracer::clear ()
+{
+  TraceState *st = state ();
+
+  std::vector<TraceBuffer *> buffers;
+  {
+    tl::MutexLocker locker (&st->lock);
+    buffers = st->buffers;
+  }
+
+  for (std::vector<TraceBuffer *>::const_iterator b = buffers.begin (); b != buffers.end (); ++b) {
+    (*b)->clear ();
+  }
+}
+
+// -------------------------------------------------------------------------------------------
+//  Enables tracing through KLAYOUT_TRACE and writes the trace on exit
+
+namespace
+{
+
+struct TraceInitializer
+{
+  TraceInitializer ()
+  {
+    std::string output_file = tl::get_env ("KLAYOUT_TRACE");
+    if (! output_file.empty ()) {
+      Tracer::start (output_file);
+    }
+  }
+
+  ~TraceInitializer ()
+  {
+    try {
+      Tracer::stop ();
+    } catch (...) {
+      //  ignore errors on exit
+    }
+  }
+};
+
+static TraceInitializer s_trace_initializer;
+
+}
+
+}
+
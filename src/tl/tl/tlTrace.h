@@ -0,0 +1,160 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2020 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+#ifndef HDR_tlTrace
+#define HDR_tlTrace
+
+#include "tlCommon.h"
+
+#include <string>
+#include <ostream>
+#include <stdint.h>
+
+namespace tl
+{
+
+/**
+ *  @brief A recorder for timing events in Chrome trace format
+ *
+ *  The tracer collects "complete" events (a name, a category, a start time and
+ *  a duration) per thread. Each thread writes into its own ring buffer, so recording
+ *  does not need to synchronize with other threads. If a ring buffer is full, the
+ *  oldest events of this thread are overwritten.
+ *
+ *  Buffers of threads which have terminated are reused by new threads. Hence the
+ *  thread IDs in the trace identify worker slots rather than system threads.
+ *
+ *  SelfTimer scopes, Progress objects and the tasks executed by the workers of
+ *  a JobBase are recorded automatically when tracing is enabled.
+ *
+ *  Tracing is enabled by calling "start" or by setting the KLAYOUT_TRACE environment
+ *  variable to the name of the output file. The output is written on "stop" or when
+ *  the application terminates. The resulting file can be loaded into chrome://tracing
+ *  or Perfetto.
+ */
+class TL_PUBLIC Tracer
+{
+public:
+  /**
+   *  @brief Enables tracing
+   *
+   *  @param output_file The file to write the trace to on "stop" (can be empty)
+   *  @param buffer_size The maximum number of events kept per thread
+   *
+   *  Starting the tracer will discard all events recorded so far.
+   */
+  static void start (const std::string &output_file, size_t buffer_size = 100000);
+
+  /**
+   *  @brief Disables tracing and writes the trace to the output file given in "start"
+   */
+  static void stop ();
+
+  /**
+   *  @brief Returns true if tracing is enabled
+   */
+  static bool is_enabled ();
+
+  /**
+   *  @brief Gets the current time stamp in microseconds
+   */
+  static int64_t now ();
+
+  /**
+   *  @brief Records an event for the current thread
+   *
+   *  "category" needs to be a static string. "start" and "end" are
+   *  time stamps delivered by "now".
+   */
+  static void record (const char *category, const std::string &name, int64_t start, int64_t end);
+
+  /**
+   *  @brief Sets the name of the current thread for the trace
+   */
+  static void set_thread_name (const std::string &name);
+
+  /**
+   *  @brief Writes the events recorded so far in Chrome trace JSON format
+   */
+  static void write (std::ostream &os);
+
+  /**
+   *  @brief Writes the events recorded so far to the given file
+   *
+   *  The file is compressed if the name ends with ".gz".
+   */
+  static void write (const std::string &path);
+
+  /**
+   *  @brief Discards all events recorded so far
+   */
+  static void clear ();
+};
+
+/**
+ *  @brief A scope object recording an event from construction to destruction
+ *
+ *  @code
+ *  {
+ *    tl::TraceScope trace ("category", "name");
+ *    ... the code to trace
+ *  }
+ *  @/code
+ *
+ *  If tracing is not enabled, this object does nothing.
+ */
+class TL_PUBLIC TraceScope
+{
+public:
+  /**
+   *  @brief Starts the event
+   *  "category" needs to be a static string.
+   */
+  TraceScope (const char *category, const std::string &name)
+    : mp_category (category), m_start (Tracer::is_enabled () ? Tracer::now () : -1)
+  {
+    if (m_start >= 0) {
+      m_name = name;
+    }
+  }
+
+  /**
+   *  @brief Finishes the event
+   */
+  ~TraceScope ()
+  {
+    if (m_start >= 0) {
+      Tracer::record (mp_category, m_name, m_start, Tracer::now ());
+    }
+  }
+
+private:
+  const char *mp_category;
+  int64_t m_start;
+  std::string m_name;
+};
+
+}
+
+#endif
+
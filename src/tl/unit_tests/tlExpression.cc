@@ -1189,3 +1189,66 @@ TEST(19)
   v = e.parse ("# A comment\nvar i=CellInstArray.new(17,tr,a,b,100,200); i.to_s(); # A final comment").execute ();
   EXPECT_EQ (v.to_string (), std::string ("#17 r90 10,20 [1,2*100;11,22*200]"));
 }
+
+// compiled expressions
+TEST(20)
+{
+  tl::Eval e;
+  tl::Variant v;
+
+  //  constant folding
+  v = e.parse ("1+2*3").execute ();
+  EXPECT_EQ (v.to_string (), std::string ("7"));
+  v = e.parse ("(1+2)/2.0").execute ();
+  EXPECT_EQ (v.to_string (), std::string ("1.5"));
+  v = e.parse ("7/2+7%3-(2+3)").execute ();
+  EXPECT_EQ (v.to_string (), std::string ("-0.5"));
+  v = e.parse ("1<2 && 'a'+'b'=='ab' ? 'x'*3 : 'y'").execute ();
+  EXPECT_EQ (v.to_string (), std::string ("xxx"));
+
+  //  errors in constant expressions are reported on execution
+  tl::Expression ex = e.parse ("1/(1-1)");
+  std::string msg;
+  try {
+    ex.execute ();
+  } catch (tl::EvalError &err) {
+    msg = err.msg ();
+  }
+  EXPECT_EQ (msg, std::string ("Division by zero at position 1 (../(1-1))"));
+
+  //  numeric operations with types only known at runtime
+  e.set_var ("x", tl::Variant (5l));
+  ex = e.parse ("x*2+1>10 ? x-1 : -x");
+  v = ex.execute ();
+  EXPECT_EQ (v.to_string (), std::string ("4"));
+  e.set_var ("x", tl::Variant (2l));
+  v = ex.execute ();
+  EXPECT_EQ (v.to_string (), std::string ("-2"));
+  EXPECT_EQ (v.is_long (), true);
+  e.set_var ("x", tl::Variant (2.5));
+  v = ex.execute ();
+  EXPECT_EQ (v.to_string (), std::string ("-2.5"));
+  e.set_var ("x", tl::Variant (6ll));
+  v = ex.execute ();
+  EXPECT_EQ (v.to_string (), std::string ("5"));
+  e.set_var ("x", tl::Variant (6u));
+  v = ex.execute ();
+  EXPECT_EQ (v.to_string (), std::string ("5"));
+
+  //  generic operations
+  e.set_var ("x", tl::Variant ("ab"));
+  v = e.parse ("x+1+x*2").execute ();
+  EXPECT_EQ (v.to_string (), std::string ("ab1abab"));
+  v = e.parse ("x==2 || x<'b'").execute ();
+  EXPECT_EQ (v.to_string (), std::string ("true"));
+
+  //  assignments and sequences
+  v = e.parse ("var y=1; y=y+1; y*10").execute ();
+  EXPECT_EQ (v.to_string (), std::string ("20"));
+
+  //  copies of expressions are compiled too
+  tl::Expression ex2 = ex;
+  e.set_var ("x", tl::Variant (1l));
+  v = ex2.execute ();
+  EXPECT_EQ (v.to_string (), std::string ("-1"));
+}
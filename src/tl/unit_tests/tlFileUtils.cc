@@ -676,3 +676,26 @@ TEST (17)
   EXPECT_EQ (tl::is_same_file (yfile, tl::combine_path (dpath, "../d/y")), true);
 }
 
+
+//  file_size, file_last_modified, touch_file
+TEST (18)
+{
+  std::string tp = tl::absolute_file_path (tmp_file ());
+  EXPECT_EQ (tl::mkpath (tp), true);
+  std::string xfile = tl::combine_path (tp, "x");
+  {
+    tl::OutputStream os (xfile);
+    os << "hello, world!";
+  }
+
+  EXPECT_EQ (tl::file_size (xfile), size_t (13));
+  EXPECT_EQ (tl::file_size (tl::combine_path (tp, "doesnotexist")), size_t (0));
+
+  long long t = tl::file_last_modified (xfile);
+  EXPECT_EQ (t > 0, true);
+  EXPECT_EQ (tl::file_last_modified (tl::combine_path (tp, "doesnotexist")) == 0, true);
+
+  EXPECT_EQ (tl::touch_file (xfile), true);
+  EXPECT_EQ (tl::file_last_modified (xfile) >= t, true);
+  EXPECT_EQ (tl::touch_file (tl::combine_path (tp, "doesnotexist")), false);
+}
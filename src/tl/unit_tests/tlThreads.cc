@@ -351,3 +351,8 @@ TEST(4_wakeOne)
   EXPECT_EQ (thr1.value (), 10000000);
   EXPECT_EQ (thr2.value (), 10000000);
 }
+
+TEST(5_AvailableCores)
+{
+  EXPECT_EQ (tl::available_cores () >= 1, true);
+}
@@ -0,0 +1,188 @@
+
+/*
+
+  KLayout Layout Viewer
+  Copyright (C) 2006-2020 Matthias Koefferlein
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+*/
+
+
+#include "tlTrace.h"
+#include "tlTimer.h"
+#include "tlProgress.h"
+#include "tlThreadedWorkers.h"
+#include "tlUnitTest.h"
+
+#include <sstream>
+#include <set>
+#include <cstdlib>
+
+namespace
+{
+
+class TraceTestTask
+  : public tl::Task
+{
+public:
+  TraceTestTask () { }
+};
+
+class TraceTestWorker
+  : public tl::Worker
+{
+public:
+  TraceTestWorker () : tl::Worker () { }
+
+protected:
+  void perform_task (tl::Task *)
+  {
+    tl::TraceScope trace ("test", "inner");
+  }
+};
+
+class TraceTestJob
+  : public tl::Job<TraceTestWorker>
+{
+public:
+  TraceTestJob (int nworkers) : tl::Job<TraceTestWorker> (nworkers) { }
+};
+
+static size_t count (const std::string &s, const std::string &what)
+{
+  size_t n = 0;
+  for (size_t p = s.find (what); p != std::string::npos; p = s.find (what, p + 1)) {
+    ++n;
+  }
+  return n;
+}
+
+}
+
+TEST(1_Basic)
+{
+  tl::Tracer::start (std::string ());
+  EXPECT_EQ (tl::Tracer::is_enabled (), true);
+
+  {
+    tl::SelfTimer timer (false, "A \"timer\"");
+    tl::RelativeProgress progress ("A progress", 10);
+    tl::TraceScope scope ("test", "A scope");
+  }
+
+  tl::Tracer::stop ();
+  EXPECT_EQ (tl::Tracer::is_enabled (), false);
+
+  //  not recorded as the tracer is disabled
+  {
+    tl::TraceScope scope ("test", "Another scope");
+  }
+
+  std::ostringstream os;
+  tl::Tracer::write (os);
+  std::string s = os.str ();
+
+  EXPECT_EQ (s.find ("{\"traceEvents\":["), size_t (0));
+  EXPECT_EQ (count (s, "\"ph\":\"X\""), size_t (3));
+  EXPECT_EQ (count (s, "\"name\":\"A \\\"timer\\\"\",\"cat\":\"timer\""), size_t (1));
+  EXPECT_EQ (count (s, "\"name\":\"A progress\",\"cat\":\"progress\""), size_t (1));
+  EXPECT_EQ (count (s, "\"name\":\"A scope\",\"cat\":\"test\""), size_t (1));
+  EXPECT_EQ (count (s, "Another scope"), size_t (0));
+  EXPECT_EQ (count (s, "\"args\":{\"name\":\"Main\"}"), size_t (1));
+}
+
+TEST(2_RingBuffer)
+{
+  tl::Tracer::start (std::string (), 3);
+
+  for (int i = 0; i < 5; ++i) {
+    tl::TraceScope scope ("test", tl::sprintf ("E%d", i));
+  }
+
+  tl::Tracer::stop ();
+
+  std::ostringstream os;
+  tl::Tracer::write (os);
+  std::string s = os.str ();
+
+  //  only the latest events are kept, in chronological order
+  EXPECT_EQ (count (s, "\"ph\":\"X\""), size_t (3));
+  EXPECT_EQ (count (s, "\"E0\""), size_t (0));
+  EXPECT_EQ (count (s, "\"E1\""), size_t (0));
+  EXPECT_EQ (s.find ("\"E2\"") < s.find ("\"E3\""), true);
+  EXPECT_EQ (s.find ("\"E3\"") < s.find ("\"E4\""), true);
+}
+
+TEST(3_Workers)
+{
+  tl::Tracer::start (std::string ());
+
+  TraceTestJob job (2);
+  for (int i = 0; i < 10; ++i) {
+    job.schedule (new TraceTestTask ());
+  }
+  job.start ();
+  job.wait ();
+
+  tl::Tracer::stop ();
+
+  std::ostringstream os;
+  tl::Tracer::write (os);
+  std::string s = os.str ();
+
+  EXPECT_EQ (count (s, "\"name\":\"task\",\"cat\":\"task\""), size_t (10));
+  EXPECT_EQ (count (s, "\"name\":\"inner\",\"cat\":\"test\""), size_t (10));
+  EXPECT_EQ (count (s, "\"args\":{\"name\":\"Worker ") > 0, true);
+}
+
+static std::set<int> task_tids (const std::string &s)
+{
+  std::set<int> tids;
+
+  std::string key = "\"cat\":\"task\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+  for (size_t p = s.find (key); p != std::string::npos; p = s.find (key, p + 1)) {
+    tids.insert (atoi (s.c_str () + p + key.size ()));
+  }
+
+  return tids;
+}
+
+TEST(4_BufferReuse)
+{
+  tl::Tracer::start (std::string ());
+
+  //  the buffers of the worker threads of the first job are reused by the second one
+  for (int n = 0; n < 2; ++n) {
+    TraceTestJob job (2);
+    for (int i = 0; i < 10; ++i) {
+      job.schedule (new TraceTestTask ());
+    }
+    job.start ();
+    job.wait ();
+  }
+
+  tl::Tracer::stop ();
+
+  std::ostringstream os;
+  tl::Tracer::write (os);
+  std::string s = os.str ();
+
+  EXPECT_EQ (count (s, "\"name\":\"task\",\"cat\":\"task\""), size_t (20));
+
+  std::set<int> tids = task_tids (s);
+  EXPECT_EQ (tids.size () <= size_t (2), true);
+  EXPECT_EQ (*tids.rbegin () <= 3, true);
+}
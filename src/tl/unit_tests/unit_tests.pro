@@ -39,7 +39,8 @@ SOURCES = \
     tlUniqueNameTests.cc \
     tlGlobPatternTests.cc \
     tlRecipeTests.cc \
-    tlUriTests.cc
+    tlUriTests.cc \
+    tlTraceTests.cc
 
 !equals(HAVE_QT, "0") {
 
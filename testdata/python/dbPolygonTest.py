@@ -728,6 +728,30 @@ class DBPolygonTests(unittest.TestCase):
     self.assertEqual(str(p1), "(21,42;21,62;41,62;41,42)")
     self.assertEqual(str(pp), "(21,42;21,62;41,62;41,42)")
 
+  def test_dispatchCache(self):
+
+    # repeated calls to overloaded methods with changing argument types
+    # exercise the overload resolution cache
+    p1 = pya.Polygon(pya.Box(10, 20, 30, 40))
+    for i in range(0, 3):
+      self.assertEqual(p1.touches(pya.Box(30, 20, 40, 50)), True)
+      self.assertEqual(p1.touches(pya.Edge(31, 20, 40, 50)), False)
+      self.assertEqual(p1.touches(pya.Polygon(pya.Box(29, 20, 40, 50))), True)
+      self.assertEqual(p1.touches(pya.SimplePolygon(pya.Box(31, 20, 40, 50))), False)
+      self.assertEqual(str(p1.moved(1, 2)), "(11,22;11,42;31,42;31,22)")
+      self.assertEqual(str(p1.moved(pya.Vector(2, 1))), "(12,21;12,41;32,41;32,21)")
+
+    b = pya.Box(0, 0, 100, 200)
+    for i in range(0, 3):
+      self.assertEqual(str(b + pya.Point(-10, 300)), "(-10,0;100,300)")
+      self.assertEqual(str(b + pya.Box(50, 50, 150, 150)), "(0,0;150,200)")
+      self.assertEqual(str(b.enlarged(10, 20)), "(-10,-20;110,220)")
+      self.assertEqual(str(b.enlarged(pya.Vector(1, 2))), "(-1,-2;101,202)")
+      # more than four arguments
+      self.assertEqual(str(pya.DCplxTrans(1.5, 90, False, 10, 20)), "r90 *1.5 10,20")
+      self.assertEqual(str(pya.DCplxTrans(1.5, 90, True, pya.DVector(10, 20))), "m45 *1.5 10,20")
+      self.assertEqual(str(pya.DCplxTrans(1.5, 90, True, 20, 10)), "m45 *1.5 20,10")
+
 # run unit tests
 if __name__ == '__main__':
   suite = unittest.TestLoader().loadTestsFromTestCase(DBPolygonTests)
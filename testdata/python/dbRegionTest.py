@@ -20,6 +20,7 @@ import pya
 import unittest
 import sys
 import os
+import array
 
 class DBRegionTest(unittest.TestCase):
 
@@ -40,6 +41,35 @@ class DBRegionTest(unittest.TestCase):
     r.merge()
     self.assertEqual(str(r), "(0,100;0,300;50,300;50,350;250,350;250,150;200,150;200,100)")
 
+  def test_2_Packed(self):
+
+    r = pya.Region()
+    r.insert(pya.Box(0, 0, 100, 200))
+    r.insert(pya.Polygon.from_s("(0,0;0,1000;1000,1000;1000,0/100,100;200,100;200,200;100,200)"))
+
+    (pts, ctrs, polys) = r.to_packed()
+    self.assertEqual(list(array.array("i", pts)), [ 0, 0, 0, 200, 100, 200, 100, 0, 0, 0, 0, 1000, 1000, 1000, 1000, 0, 100, 100, 200, 100, 200, 200, 100, 200 ])
+    self.assertEqual(list(array.array("i", ctrs)), [ 0, 4, 8, 12 ])
+    self.assertEqual(list(array.array("i", polys)), [ 0, 1, 3 ])
+
+    rr = pya.Region()
+    rr.insert_packed(pts, ctrs, polys)
+    self.assertEqual(str(rr), str(r))
+
+    #  any object supporting the buffer protocol can be used as input
+    rr = pya.Region()
+    rr.insert_packed(array.array("i", [ 0, 0, 0, 10, 10, 10, 10, 0 ]), array.array("i", [ 0, 4 ]), array.array("i", [ 0, 1 ]))
+    self.assertEqual(str(rr), "(0,0;0,10;10,10;10,0)")
+
+    #  ... but not for arguments which are plain strings
+    if sys.version_info[0] >= 3:
+      self.assertRaises(Exception, lambda: pya.Polygon.from_s(memoryview(b"(0,0;0,10;10,10;10,0)")))
+      self.assertEqual(str(pya.Polygon.from_s(b"(0,0;0,10;10,10;10,0)")), "(0,0;0,10;10,10;10,0)")
+
+    e = pya.Edges()
+    e.insert(pya.Edge(0, 0, 100, 200))
+    self.assertEqual(list(array.array("i", e.to_packed())), [ 0, 0, 100, 200 ])
+
   def test_deep1(self):
 
     ut_testsrc = os.getenv("TESTSRC")
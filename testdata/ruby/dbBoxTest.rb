@@ -456,6 +456,26 @@ class DBBox_TestClass < TestBase
 
   end
 
+  # Repeated calls to overloaded methods with changing argument types
+  # (exercises the overload resolution cache)
+  def test_9_Box
+
+    b = RBA::Box::new(0, 0, 100, 200)
+    3.times do
+      assert_equal((b + RBA::Point::new(-10, 300)).to_s, "(-10,0;100,300)")
+      assert_equal((b + RBA::Box::new(50, 50, 150, 150)).to_s, "(0,0;150,200)")
+      assert_equal(b.enlarged(10, 20).to_s, "(-10,-20;110,220)")
+      assert_equal(b.enlarged(RBA::Vector::new(1, 2)).to_s, "(-1,-2;101,202)")
+      assert_equal(b.contains?(RBA::Point::new(10, 10)), true)
+      assert_equal(b.contains?(-10, 10), false)
+      # more than four arguments
+      assert_equal(RBA::DCplxTrans::new(1.5, 90, false, 10, 20).to_s, "r90 *1.5 10,20")
+      assert_equal(RBA::DCplxTrans::new(1.5, 90, true, RBA::DVector::new(10, 20)).to_s, "m45 *1.5 10,20")
+      assert_equal(RBA::DCplxTrans::new(1.5, 90, true, 20, 10).to_s, "m45 *1.5 20,10")
+    end
+
+  end
+
 end
 
 load("test_epilogue.rb")
@@ -2033,6 +2033,39 @@ END
 
   end
 
+  # Memory budget for undo
+  def test_20
+
+    m = RBA::Manager::new
+    l = RBA::Layout::new(m)
+    c = l.cell(l.add_cell("TOP"))
+    li = l.insert_layer(RBA::LayerInfo::new(1, 0))
+
+    assert_equal(m.max_memory, 0)
+    assert_equal(m.memory_used, 0)
+
+    10.times do |i|
+      m.transaction("#{i}")
+      100.times { |j| c.shapes(li).insert(RBA::Box::new(j * 10, i * 10, j * 10 + 5, i * 10 + 5)) }
+      m.commit
+    end
+
+    assert_equal(m.memory_used > 0, true)
+    assert_equal(c.shapes(li).size, 1000)
+
+    m.max_memory = 1
+    assert_equal(m.max_memory, 1)
+    assert_equal(m.transaction_for_undo, "9")
+
+    m.undo
+    assert_equal(c.shapes(li).size, 900)
+    assert_equal(m.has_undo?, false)
+
+    m.redo
+    assert_equal(c.shapes(li).size, 1000)
+
+  end
+
 end
 
 load("test_epilogue.rb")
@@ -99,6 +99,23 @@ class DBLayoutQuery_TestClass < TestBase
 
   end
 
+  # batch collection, multi-threaded
+  def test_5
+
+    ly = RBA::Layout::new
+    ly.read(ENV["TESTSRC"] + "/testdata/gds/t11.gds")
+
+    ctx = RBA::ExpressionContext::new
+    ctx.var("suffix", "!")
+
+    q = RBA::LayoutQuery::new("select cell.name + suffix from *")
+    [ 0, 1, 4 ].each do |threads|
+      res = q.collect(ly, [ "data", "unknown" ], threads, ctx)
+      assert_equal(res.inspect, "[[[\"TOPTOP!\"], nil], [[\"TOP!\"], nil]]")
+    end
+
+  end
+
 end
 
 load("test_epilogue.rb")
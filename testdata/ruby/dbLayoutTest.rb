@@ -1122,6 +1122,25 @@ class DBLayout_TestClass < TestBase
 
   end
 
+  # Global thread settings
+  def test_14
+
+    assert_equal(RBA::ThreadSettings::cores >= 1, true)
+
+    saved = RBA::ThreadSettings::box_tree_sort_threads
+    RBA::ThreadSettings::box_tree_sort_threads = 3
+    assert_equal(RBA::ThreadSettings::box_tree_sort_threads, 3)
+    RBA::ThreadSettings::box_tree_sort_threads = saved
+    assert_equal(RBA::ThreadSettings::box_tree_sort_threads, saved)
+
+    saved = RBA::ThreadSettings::box_scanner_threads
+    RBA::ThreadSettings::box_scanner_threads = 2
+    assert_equal(RBA::ThreadSettings::box_scanner_threads, 2)
+    RBA::ThreadSettings::box_scanner_threads = saved
+    assert_equal(RBA::ThreadSettings::box_scanner_threads, saved)
+
+  end
+
 end
 
 load("test_epilogue.rb")
@@ -75,6 +75,34 @@ class BoxPCell < RBA::PCellDeclaration
     
 end
 
+class CachedBoxPCell < BoxPCell
+
+  @@produced = 0
+
+  def self.produced
+    @@produced
+  end
+
+  def cache_version
+    return "1"
+  end
+
+  def produce(layout, layers, parameters, cell)
+    @@produced += 1
+    super(layout, layers, parameters, cell)
+  end
+
+end
+
+class CachedPCellTestLib < RBA::Library
+
+  def initialize
+    layout.register_pcell("CachedBox", CachedBoxPCell::new)
+    register("CachedPCellTestLib")
+  end
+
+end
+
 class PCellTestLib < RBA::Library
 
   def initialize  
@@ -588,6 +616,39 @@ class DBPCell_TestClass < TestBase
 
   end
 
+  def test_9
+
+    saved_path = RBA::Library::pcell_cache_path
+
+    begin
+
+      RBA::Library::pcell_cache_path = File::join($ut_testtmp, "pcell_cache")
+      RBA::Library::clear_pcell_cache
+
+      param = { "w" => 2.0, "h" => 6.0, "l" => RBA::LayerInfo::new(5, 0) }
+
+      # first "session": the PCell is produced and the result is stored
+      CachedPCellTestLib::new
+      ly = RBA::Layout::new
+      cell = ly.create_cell("CachedBox", "CachedPCellTestLib", param)
+      assert_equal(CachedBoxPCell::produced, 1)
+      assert_equal(cell.begin_shapes_rec(ly.layer(5, 0)).shape.to_s, "box (-1000,-3000;1000,3000)")
+
+      # second "session": a new library instance takes the result from the cache
+      CachedPCellTestLib::new
+      ly = RBA::Layout::new
+      cell = ly.create_cell("CachedBox", "CachedPCellTestLib", param)
+      assert_equal(CachedBoxPCell::produced, 1)
+      assert_equal(cell.begin_shapes_rec(ly.layer(5, 0)).shape.to_s, "box (-1000,-3000;1000,3000)")
+      assert_equal(cell.display_title, "CachedPCellTestLib.Box(L=5/0,W=2.000,H=6.000)")
+
+    ensure
+      RBA::Library::clear_pcell_cache
+      RBA::Library::pcell_cache_path = saved_path
+    end
+
+  end
+
 end
 
 load("test_epilogue.rb")
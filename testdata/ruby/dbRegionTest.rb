@@ -789,6 +789,37 @@ class DBRegion_TestClass < TestBase
 
   end
 
+  # packed coordinates
+  def test_14a
+
+    r = RBA::Region::new
+    r.insert(RBA::Box::new(0, 0, 100, 200))
+    r.insert(RBA::Polygon::from_s("(0,0;0,1000;1000,1000;1000,0/100,100;200,100;200,200;100,200)"))
+
+    (pts, ctrs, polys) = r.to_packed
+    assert_equal(pts.unpack("l*").join(","), "0,0,0,200,100,200,100,0,0,0,0,1000,1000,1000,1000,0,100,100,200,100,200,200,100,200")
+    assert_equal(ctrs.unpack("l*").join(","), "0,4,8,12")
+    assert_equal(polys.unpack("l*").join(","), "0,1,3")
+
+    rr = RBA::Region::new
+    rr.insert_packed(pts, ctrs, polys)
+    assert_equal(rr.to_s, r.to_s)
+
+    (pts, ctrs, polys) = r.to_packed(true)
+    assert_equal(pts.unpack("q*").size, 24)
+    rr = RBA::Region::new
+    rr.insert_packed([ 0, 0, 0, 10, 10, 10, 10, 0 ].pack("q*"), [ 0, 4 ].pack("q*"), [ 0, 1 ].pack("q*"), true)
+    assert_equal(rr.to_s, "(0,0;0,10;10,10;10,0)")
+
+    e = RBA::Edges::new
+    e.insert(RBA::Edge::new(0, 0, 100, 200))
+    assert_equal(e.to_packed.unpack("l*").join(","), "0,0,100,200")
+    ee = RBA::Edges::new
+    ee.insert_packed([ 1, 2, 3, 4 ].pack("l*"))
+    assert_equal(ee.to_s, "(1,2;3,4)")
+
+  end
+
   # texts
   def test_15
 